@@ -0,0 +1,153 @@
+#include "common/memory_arena.h"
+#include "common/page_fault_handler.h"
+#include <cstring>
+#include <gtest/gtest.h>
+
+using Common::MemoryArena;
+namespace PageFaultHandler = Common::PageFaultHandler;
+
+TEST(MemoryArena, ViewsAliasTheSameMemory)
+{
+  const size_t size = MemoryArena::GetPageSize() * 4;
+  MemoryArena arena;
+  ASSERT_TRUE(arena.Create(size, true, false));
+  ASSERT_TRUE(arena.IsValid());
+
+  u8* view1 = static_cast<u8*>(arena.CreateViewPtr(0, size, true, false));
+  u8* view2 = static_cast<u8*>(arena.CreateViewPtr(0, size, true, false));
+  ASSERT_NE(view1, nullptr);
+  ASSERT_NE(view2, nullptr);
+  ASSERT_NE(view1, view2);
+
+  view1[0] = 0x12;
+  view1[size - 1] = 0x34;
+  ASSERT_EQ(view2[0], 0x12);
+  ASSERT_EQ(view2[size - 1], 0x34);
+
+  ASSERT_TRUE(arena.ReleaseViewPtr(view2, size));
+  ASSERT_TRUE(arena.ReleaseViewPtr(view1, size));
+}
+
+TEST(MemoryArena, ViewAtOffset)
+{
+  const size_t page_size = MemoryArena::GetPageSize();
+  MemoryArena arena;
+  ASSERT_TRUE(arena.Create(page_size * 2, true, false));
+
+  u8* whole = static_cast<u8*>(arena.CreateViewPtr(0, page_size * 2, true, false));
+  u8* second_page = static_cast<u8*>(arena.CreateViewPtr(page_size, page_size, true, false));
+  ASSERT_NE(whole, nullptr);
+  ASSERT_NE(second_page, nullptr);
+
+  second_page[8] = 0x56;
+  ASSERT_EQ(whole[page_size + 8], 0x56);
+
+  ASSERT_TRUE(arena.ReleaseViewPtr(second_page, page_size));
+  ASSERT_TRUE(arena.ReleaseViewPtr(whole, page_size * 2));
+}
+
+TEST(MemoryArena, MirroredViewsInReservedRegion)
+{
+  const size_t page_size = MemoryArena::GetPageSize();
+  MemoryArena arena;
+  ASSERT_TRUE(arena.Create(page_size, true, false));
+
+  u8* base = static_cast<u8*>(MemoryArena::ReserveAddressSpace(page_size * 4));
+  ASSERT_NE(base, nullptr);
+
+  u8* mirror0 = static_cast<u8*>(arena.CreateViewPtr(0, page_size, true, false, base));
+  u8* mirror2 = static_cast<u8*>(arena.CreateViewPtr(0, page_size, true, false, base + page_size * 2));
+  ASSERT_EQ(mirror0, base);
+  ASSERT_EQ(mirror2, base + page_size * 2);
+
+  mirror0[16] = 0x78;
+  ASSERT_EQ(mirror2[16], 0x78);
+
+  ASSERT_TRUE(arena.ReleaseViewPtr(mirror2, page_size, true));
+  ASSERT_TRUE(arena.ReleaseViewPtr(mirror0, page_size, true));
+  MemoryArena::ReleaseAddressSpace(base, page_size * 4);
+}
+
+namespace {
+struct FaultTestState
+{
+  u8* page;
+  size_t page_size;
+  void* last_fault_address;
+  u32 fault_count;
+};
+} // namespace
+
+static PageFaultHandler::HandlerResult UnprotectOnFault(void* context, void* exception_pc, void* fault_address)
+{
+  FaultTestState* state = static_cast<FaultTestState*>(context);
+  u8* const address = static_cast<u8*>(fault_address);
+  if (address < state->page || address >= (state->page + state->page_size))
+    return PageFaultHandler::HandlerResult::ExecuteNextHandler;
+
+  state->last_fault_address = fault_address;
+  state->fault_count++;
+  MemoryArena::SetPageProtection(state->page, state->page_size, true, true, false);
+  return PageFaultHandler::HandlerResult::ContinueExecution;
+}
+
+TEST(PageFaultHandler, WriteToProtectedPageIsHandled)
+{
+  const size_t page_size = MemoryArena::GetPageSize();
+  MemoryArena arena;
+  ASSERT_TRUE(arena.Create(page_size, true, false));
+
+  u8* page = static_cast<u8*>(arena.CreateViewPtr(0, page_size, true, false));
+  ASSERT_NE(page, nullptr);
+  page[0] = 1;
+
+  FaultTestState state = {page, page_size, nullptr, 0};
+  ASSERT_TRUE(PageFaultHandler::InstallHandler(&state, UnprotectOnFault));
+  ASSERT_TRUE(MemoryArena::SetPageProtection(page, page_size, true, false, false));
+
+  // Reads are still allowed, writes fault once and are re-executed after the handler fixes the protection.
+  volatile u8* vpage = page;
+  ASSERT_EQ(vpage[0], 1);
+  ASSERT_EQ(state.fault_count, 0u);
+  vpage[100] = 2;
+  ASSERT_EQ(state.fault_count, 1u);
+  ASSERT_EQ(state.last_fault_address, static_cast<void*>(page + 100));
+  ASSERT_EQ(vpage[100], 2);
+  vpage[101] = 3;
+  ASSERT_EQ(state.fault_count, 1u);
+
+  ASSERT_TRUE(PageFaultHandler::RemoveHandler(&state));
+  ASSERT_FALSE(PageFaultHandler::RemoveHandler(&state));
+  ASSERT_TRUE(arena.ReleaseViewPtr(page, page_size));
+}
+
+TEST(PageFaultHandler, HandlersAreCalledInOrder)
+{
+  const size_t page_size = MemoryArena::GetPageSize();
+  MemoryArena arena;
+  ASSERT_TRUE(arena.Create(page_size * 2, true, false));
+
+  u8* pages = static_cast<u8*>(arena.CreateViewPtr(0, page_size * 2, true, false));
+  ASSERT_NE(pages, nullptr);
+
+  // Each handler only claims faults in its own page.
+  FaultTestState state1 = {pages, page_size, nullptr, 0};
+  FaultTestState state2 = {pages + page_size, page_size, nullptr, 0};
+  ASSERT_TRUE(PageFaultHandler::InstallHandler(&state1, UnprotectOnFault));
+  ASSERT_TRUE(PageFaultHandler::InstallHandler(&state2, UnprotectOnFault));
+  ASSERT_TRUE(MemoryArena::SetPageProtection(pages, page_size * 2, false, false, false));
+
+  volatile u8* vpages = pages;
+  vpages[page_size + 4] = 5;
+  ASSERT_EQ(state1.fault_count, 0u);
+  ASSERT_EQ(state2.fault_count, 1u);
+  vpages[4] = 6;
+  ASSERT_EQ(state1.fault_count, 1u);
+  ASSERT_EQ(state2.fault_count, 1u);
+  ASSERT_EQ(vpages[4], 6);
+  ASSERT_EQ(vpages[page_size + 4], 5);
+
+  ASSERT_TRUE(PageFaultHandler::RemoveHandler(&state2));
+  ASSERT_TRUE(PageFaultHandler::RemoveHandler(&state1));
+  ASSERT_TRUE(arena.ReleaseViewPtr(pages, page_size * 2));
+}
@@ -0,0 +1,199 @@
+#include "memory_arena.h"
+#include "assert.h"
+#include "log.h"
+Log_SetChannel(Common::MemoryArena);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#else
+#include <cerrno>
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+MemoryArena::MemoryArena() = default;
+
+MemoryArena::~MemoryArena()
+{
+  Destroy();
+}
+
+size_t MemoryArena::GetPageSize()
+{
+#if defined(WIN32)
+  SYSTEM_INFO si = {};
+  GetSystemInfo(&si);
+  return static_cast<size_t>(si.dwPageSize);
+#else
+  static const size_t page_size = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+  return page_size;
+#endif
+}
+
+void* MemoryArena::ReserveAddressSpace(size_t size)
+{
+#if defined(WIN32)
+  // Windows can't map views over a reservation, so find a free region and release it straight away.
+  void* base = VirtualAlloc(nullptr, size, MEM_RESERVE, PAGE_NOACCESS);
+  if (!base)
+    return nullptr;
+
+  VirtualFree(base, 0, MEM_RELEASE);
+  return base;
+#else
+  void* base = mmap(nullptr, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+  if (base == MAP_FAILED)
+  {
+    Log_ErrorPrintf("Failed to reserve %zu bytes of address space: %d", size, errno);
+    return nullptr;
+  }
+
+  return base;
+#endif
+}
+
+void MemoryArena::ReleaseAddressSpace(void* base, size_t size)
+{
+#if defined(WIN32)
+  // Views are unmapped individually, nothing is left holding the region.
+#else
+  munmap(base, size);
+#endif
+}
+
+bool MemoryArena::SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable)
+{
+#if defined(WIN32)
+  static constexpr DWORD protection_table[2][2][2] = {
+    {{PAGE_NOACCESS, PAGE_EXECUTE}, {PAGE_WRITECOPY, PAGE_EXECUTE_WRITECOPY}},
+    {{PAGE_READONLY, PAGE_EXECUTE_READ}, {PAGE_READWRITE, PAGE_EXECUTE_READWRITE}}};
+
+  DWORD old_protect;
+  return static_cast<bool>(VirtualProtect(address, length,
+                                          protection_table[readable][writable][executable], &old_protect));
+#else
+  const int prot = (readable ? PROT_READ : 0) | (writable ? PROT_WRITE : 0) | (executable ? PROT_EXEC : 0);
+  return (mprotect(address, length, prot) == 0);
+#endif
+}
+
+bool MemoryArena::IsValid() const
+{
+#if defined(WIN32)
+  return (m_file_handle != nullptr);
+#else
+  return (m_shmem_fd >= 0);
+#endif
+}
+
+bool MemoryArena::Create(size_t size, bool writable, bool executable)
+{
+  Destroy();
+
+#if defined(WIN32)
+  const DWORD protect = (writable ? (executable ? PAGE_EXECUTE_READWRITE : PAGE_READWRITE) :
+                                    (executable ? PAGE_EXECUTE_READ : PAGE_READONLY));
+  m_file_handle = CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, protect, static_cast<DWORD>(size >> 32),
+                                     static_cast<DWORD>(size), nullptr);
+  if (!m_file_handle)
+  {
+    Log_ErrorPrintf("CreateFileMapping failed: %u", GetLastError());
+    return false;
+  }
+#else
+#if defined(__linux__) || defined(__ANDROID__)
+  m_shmem_fd = static_cast<int>(syscall(SYS_memfd_create, "duckstation", 0));
+#else
+  char name[64];
+  std::snprintf(name, sizeof(name), "/duckstation_%d", static_cast<int>(getpid()));
+  m_shmem_fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (m_shmem_fd >= 0)
+    shm_unlink(name);
+#endif
+
+  if (m_shmem_fd < 0)
+  {
+    Log_ErrorPrintf("Failed to create shared memory object: %d", errno);
+    return false;
+  }
+
+  if (ftruncate(m_shmem_fd, static_cast<off_t>(size)) < 0)
+  {
+    Log_ErrorPrintf("ftruncate(%zu) failed: %d", size, errno);
+    close(m_shmem_fd);
+    m_shmem_fd = -1;
+    return false;
+  }
+#endif
+
+  m_size = size;
+  m_writable = writable;
+  m_executable = executable;
+  return true;
+}
+
+void MemoryArena::Destroy()
+{
+#if defined(WIN32)
+  if (m_file_handle)
+  {
+    CloseHandle(m_file_handle);
+    m_file_handle = nullptr;
+  }
+#else
+  if (m_shmem_fd >= 0)
+  {
+    close(m_shmem_fd);
+    m_shmem_fd = -1;
+  }
+#endif
+
+  m_size = 0;
+}
+
+void* MemoryArena::CreateViewPtr(size_t offset, size_t size, bool writable, bool executable,
+                                 void* fixed_address /* = nullptr */)
+{
+  Assert((offset + size) <= m_size);
+  writable &= m_writable;
+  executable &= m_executable;
+
+#if defined(WIN32)
+  const DWORD desired_access = FILE_MAP_READ | (writable ? FILE_MAP_WRITE : 0) | (executable ? FILE_MAP_EXECUTE : 0);
+  void* base_pointer = MapViewOfFileEx(m_file_handle, desired_access, static_cast<DWORD>(offset >> 32),
+                                       static_cast<DWORD>(offset), size, fixed_address);
+  if (!base_pointer)
+    return nullptr;
+#else
+  const int flags = (fixed_address != nullptr) ? (MAP_SHARED | MAP_FIXED) : MAP_SHARED;
+  const int prot = PROT_READ | (writable ? PROT_WRITE : 0) | (executable ? PROT_EXEC : 0);
+  void* base_pointer = mmap(fixed_address, size, prot, flags, m_shmem_fd, static_cast<off_t>(offset));
+  if (base_pointer == MAP_FAILED)
+    return nullptr;
+#endif
+
+  return base_pointer;
+}
+
+bool MemoryArena::ReleaseViewPtr(void* address, size_t size, bool fixed /* = false */)
+{
+#if defined(WIN32)
+  return static_cast<bool>(UnmapViewOfFile(address));
+#else
+  if (fixed)
+  {
+    // Replace the view with inaccessible pages, so nothing else can be allocated in the reservation.
+    return (mmap(address, size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0) !=
+            MAP_FAILED);
+  }
+
+  return (munmap(address, size) == 0);
+#endif
+}
+
+} // namespace Common
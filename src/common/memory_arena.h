@@ -0,0 +1,49 @@
+#pragma once
+#include "types.h"
+
+namespace Common {
+
+/// A block of shared memory which can be mapped into the address space multiple times.
+/// Used for mirroring guest memory regions into a host address space window (fastmem).
+class MemoryArena
+{
+public:
+  MemoryArena();
+  ~MemoryArena();
+
+  /// Returns the host page size, i.e. the granularity of protection changes.
+  static size_t GetPageSize();
+
+  /// Reserves a region of address space which can later be populated with fixed views.
+  static void* ReserveAddressSpace(size_t size);
+
+  /// Releases a region of address space previously reserved with ReserveAddressSpace().
+  static void ReleaseAddressSpace(void* base, size_t size);
+
+  /// Changes the protection of a range of pages in the host address space.
+  static bool SetPageProtection(void* address, size_t length, bool readable, bool writable, bool executable);
+
+  bool IsValid() const;
+
+  bool Create(size_t size, bool writable, bool executable);
+  void Destroy();
+
+  /// Maps a view of the arena. If fixed_address is provided, it must lie within a reserved region.
+  void* CreateViewPtr(size_t offset, size_t size, bool writable, bool executable, void* fixed_address = nullptr);
+
+  /// Unmaps a view of the arena. Views created within a reserved region return the pages to the reservation.
+  bool ReleaseViewPtr(void* address, size_t size, bool fixed = false);
+
+private:
+#if defined(WIN32)
+  void* m_file_handle = nullptr;
+#else
+  int m_shmem_fd = -1;
+#endif
+
+  size_t m_size = 0;
+  bool m_writable = false;
+  bool m_executable = false;
+};
+
+} // namespace Common
@@ -0,0 +1,176 @@
+#include "page_fault_handler.h"
+#include "log.h"
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <vector>
+Log_SetChannel(Common::PageFaultHandler);
+
+#if defined(WIN32)
+#include "windows_headers.h"
+#else
+#include <signal.h>
+#include <ucontext.h>
+#endif
+
+namespace Common::PageFaultHandler {
+
+struct RegisteredHandler
+{
+  void* context;
+  Callback callback;
+};
+
+static std::vector<RegisteredHandler> s_handlers;
+static std::mutex s_handler_lock;
+static bool s_in_handler;
+
+static HandlerResult DispatchFault(void* exception_pc, void* fault_address)
+{
+  // A fault inside one of the handlers is not ours to fix.
+  if (s_in_handler)
+    return HandlerResult::ExecuteNextHandler;
+
+  s_in_handler = true;
+
+  HandlerResult result = HandlerResult::ExecuteNextHandler;
+  for (const RegisteredHandler& handler : s_handlers)
+  {
+    result = handler.callback(handler.context, exception_pc, fault_address);
+    if (result == HandlerResult::ContinueExecution)
+      break;
+  }
+
+  s_in_handler = false;
+  return result;
+}
+
+#if defined(WIN32)
+
+static PVOID s_veh_handle;
+
+static LONG ExceptionHandler(PEXCEPTION_POINTERS exi)
+{
+  if (exi->ExceptionRecord->ExceptionCode != EXCEPTION_ACCESS_VIOLATION)
+    return EXCEPTION_CONTINUE_SEARCH;
+
+#if defined(_M_X64)
+  void* const exception_pc = reinterpret_cast<void*>(exi->ContextRecord->Rip);
+#elif defined(_M_ARM64)
+  void* const exception_pc = reinterpret_cast<void*>(exi->ContextRecord->Pc);
+#else
+  void* const exception_pc = nullptr;
+#endif
+
+  void* const fault_address = reinterpret_cast<void*>(exi->ExceptionRecord->ExceptionInformation[1]);
+  if (DispatchFault(exception_pc, fault_address) == HandlerResult::ContinueExecution)
+    return EXCEPTION_CONTINUE_EXECUTION;
+
+  return EXCEPTION_CONTINUE_SEARCH;
+}
+
+static bool InstallSystemHandler()
+{
+  s_veh_handle = AddVectoredExceptionHandler(1, ExceptionHandler);
+  return (s_veh_handle != nullptr);
+}
+
+static void RemoveSystemHandler()
+{
+  RemoveVectoredExceptionHandler(s_veh_handle);
+  s_veh_handle = nullptr;
+}
+
+#else
+
+#if defined(__APPLE__)
+static constexpr int FAULT_SIGNAL = SIGBUS;
+#else
+static constexpr int FAULT_SIGNAL = SIGSEGV;
+#endif
+
+static struct sigaction s_old_sigaction;
+
+static void SignalHandler(int sig, siginfo_t* info, void* ctx)
+{
+  ucontext_t* const uc = static_cast<ucontext_t*>(ctx);
+
+#if defined(__APPLE__) && defined(__x86_64__)
+  void* const exception_pc = reinterpret_cast<void*>(uc->uc_mcontext->__ss.__rip);
+#elif defined(__APPLE__) && defined(__aarch64__)
+  void* const exception_pc = reinterpret_cast<void*>(uc->uc_mcontext->__ss.__pc);
+#elif defined(__x86_64__)
+  void* const exception_pc = reinterpret_cast<void*>(uc->uc_mcontext.gregs[REG_RIP]);
+#elif defined(__aarch64__)
+  void* const exception_pc = reinterpret_cast<void*>(uc->uc_mcontext.pc);
+#else
+  void* const exception_pc = nullptr;
+#endif
+
+  if (DispatchFault(exception_pc, info->si_addr) == HandlerResult::ContinueExecution)
+    return;
+
+  // Not ours, pass it on to whatever was installed before us.
+  if (s_old_sigaction.sa_flags & SA_SIGINFO)
+  {
+    s_old_sigaction.sa_sigaction(sig, info, ctx);
+  }
+  else if (s_old_sigaction.sa_handler == SIG_DFL)
+  {
+    // Restore the default handler, returning will re-execute the instruction and crash.
+    sigaction(sig, &s_old_sigaction, nullptr);
+  }
+  else if (s_old_sigaction.sa_handler != SIG_IGN)
+  {
+    s_old_sigaction.sa_handler(sig);
+  }
+}
+
+static bool InstallSystemHandler()
+{
+  struct sigaction sa = {};
+  sa.sa_sigaction = SignalHandler;
+  sa.sa_flags = SA_SIGINFO | SA_NODEFER;
+  sigemptyset(&sa.sa_mask);
+  if (sigaction(FAULT_SIGNAL, &sa, &s_old_sigaction) < 0)
+    return false;
+
+  return true;
+}
+
+static void RemoveSystemHandler()
+{
+  sigaction(FAULT_SIGNAL, &s_old_sigaction, nullptr);
+}
+
+#endif
+
+bool InstallHandler(void* context, Callback callback)
+{
+  std::lock_guard<std::mutex> guard(s_handler_lock);
+  if (s_handlers.empty() && !InstallSystemHandler())
+  {
+    Log_ErrorPrint("Failed to install system page fault handler");
+    return false;
+  }
+
+  s_handlers.push_back(RegisteredHandler{context, callback});
+  return true;
+}
+
+bool RemoveHandler(void* context)
+{
+  std::lock_guard<std::mutex> guard(s_handler_lock);
+  auto iter = std::find_if(s_handlers.begin(), s_handlers.end(),
+                           [context](const RegisteredHandler& rh) { return (rh.context == context); });
+  if (iter == s_handlers.end())
+    return false;
+
+  s_handlers.erase(iter);
+  if (s_handlers.empty())
+    RemoveSystemHandler();
+
+  return true;
+}
+
+} // namespace Common::PageFaultHandler
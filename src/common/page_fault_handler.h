@@ -0,0 +1,21 @@
+#pragma once
+#include "types.h"
+
+namespace Common::PageFaultHandler {
+
+enum class HandlerResult
+{
+  ContinueExecution,
+  ExecuteNextHandler,
+};
+
+/// Called on an access violation. exception_pc is the faulting host instruction, fault_address the accessed address.
+using Callback = HandlerResult (*)(void* context, void* exception_pc, void* fault_address);
+
+/// Registers a handler for access violations. Handlers are invoked in the order they were installed.
+bool InstallHandler(void* context, Callback callback);
+
+/// Removes a handler previously registered with the same context.
+bool RemoveHandler(void* context);
+
+} // namespace Common::PageFaultHandler
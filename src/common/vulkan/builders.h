@@ -137,6 +137,22 @@ private:
   VkPipelineMultisampleStateCreateInfo m_multisample_state;
 };
 
+class ComputePipelineBuilder
+{
+public:
+  ComputePipelineBuilder();
+
+  void Clear();
+
+  VkPipeline Create(VkDevice device, VkPipelineCache pipeline_cache = VK_NULL_HANDLE, bool clear = true);
+
+  void SetShader(VkShaderModule module, const char* entry_point = "main");
+  void SetPipelineLayout(VkPipelineLayout layout);
+
+private:
+  VkComputePipelineCreateInfo m_ci;
+};
+
 class SamplerBuilder
 {
 public:
@@ -174,6 +190,8 @@ public:
   void AddImageDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view,
                                VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   void AddSamplerDescriptorWrite(VkDescriptorSet set, u32 binding, VkSampler sampler);
+  void AddStorageImageDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view,
+                                      VkImageLayout layout = VK_IMAGE_LAYOUT_GENERAL);
   void AddCombinedImageSamplerDescriptorWrite(VkDescriptorSet set, u32 binding, VkImageView view, VkSampler sampler,
                                               VkImageLayout layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   void AddBufferDescriptorWrite(VkDescriptorSet set, u32 binding, VkDescriptorType dtype, VkBuffer buffer, u32 offset,
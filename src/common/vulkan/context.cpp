@@ -662,7 +662,8 @@ bool Context::CreateCommandBuffers()
     VkDescriptorPoolSize pool_sizes[] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024},
                                          {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
                                          {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 16},
-                                         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16}};
+                                         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16},
+                                         {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16}};
 
     VkDescriptorPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
                                                    nullptr,
@@ -720,7 +721,8 @@ bool Context::CreateGlobalDescriptorPool()
   VkDescriptorPoolSize pool_sizes[] = {{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1024},
                                        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1024},
                                        {VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 16},
-                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16}};
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 16},
+                                       {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 16}};
 
   VkDescriptorPoolCreateInfo pool_create_info = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
                                                  nullptr,
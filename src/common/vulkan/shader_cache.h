@@ -5,6 +5,7 @@
 #include "vulkan_loader.h"
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -27,6 +28,7 @@ public:
   /// Writes pipeline cache to file, saving all newly compiled pipelines.
   bool FlushPipelineCache();
 
+  /// Shaders can be fetched from multiple threads, the pipeline cache handle is internally synchronized by Vulkan.
   std::optional<ShaderCompiler::SPIRVCodeVector> GetShaderSPV(ShaderCompiler::Type type, std::string_view shader_code);
   VkShaderModule GetShaderModule(ShaderCompiler::Type type, std::string_view shader_code);
 
@@ -91,6 +93,7 @@ private:
   std::string m_pipeline_cache_filename;
 
   CacheIndex m_index;
+  std::mutex m_index_mutex;
 
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
   bool m_debug = false;
@@ -303,6 +303,12 @@ void Texture::TransitionToLayout(VkCommandBuffer command_buffer, VkImageLayout n
       srcStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
       break;
 
+    case VK_IMAGE_LAYOUT_GENERAL:
+      // Image was being used as a storage image or copied to itself, ensure all writes have finished.
+      barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+      srcStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+      break;
+
     default:
       srcStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
       break;
@@ -341,6 +347,12 @@ void Texture::TransitionToLayout(VkCommandBuffer command_buffer, VkImageLayout n
       dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
       break;
 
+    case VK_IMAGE_LAYOUT_GENERAL:
+      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_TRANSFER_READ_BIT |
+                              VK_ACCESS_TRANSFER_WRITE_BIT;
+      dstStageMask = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+      break;
+
     case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
       srcStageMask = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
       dstStageMask = VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT;
@@ -0,0 +1,152 @@
+#include "common/file_system.h"
+#include "core/gpu_dump.h"
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+class GPUDumpTest : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    m_filename = testing::TempDir() + "gpu_dump_test.bin";
+
+    auto recorder = GPUDump::Recorder::Create(m_filename.c_str(), STATE_DATA.data(), STATE_SIZE);
+    ASSERT_NE(recorder, nullptr);
+    recorder->WriteGP0(0xE1000000u);
+    recorder->WriteGP1(0xFFFFFFFFu);
+    recorder->WriteDMA(DMA_WORDS.data(), static_cast<u32>(DMA_WORDS.size()));
+    recorder->WriteDMA(nullptr, 0);
+    recorder->ReadGPUREAD(200);
+    recorder->CommandTicks(0);
+    recorder->CommandTicks(127);
+    recorder->CommandTicks(128);
+    recorder->CommandTicks(0x7FFFFFFF);
+    recorder->ActiveLineLSB(1);
+    recorder->VBlank();
+  }
+
+  void TearDown() override { FileSystem::DeleteFile(m_filename.c_str()); }
+
+  // Magic, version and state size.
+  static constexpr u32 HEADER_SIZE = 12;
+  static constexpr u32 STATE_SIZE = 16;
+  static constexpr std::array<u8, STATE_SIZE> STATE_DATA = {1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+  static constexpr std::array<u32, 3> DMA_WORDS = {0x28000000u, 0x00100010u, 0x12345678u};
+
+  std::string m_filename;
+};
+} // namespace
+
+TEST_F(GPUDumpTest, RoundTrip)
+{
+  GPUDump::Reader reader;
+  ASSERT_TRUE(reader.Open(m_filename.c_str()));
+  ASSERT_EQ(reader.GetStateSize(), STATE_SIZE);
+  ASSERT_EQ(std::memcmp(reader.GetStateData(), STATE_DATA.data(), STATE_SIZE), 0);
+
+  // Read twice, to check rewinding gets back to the first packet.
+  for (u32 pass = 0; pass < 2; pass++)
+  {
+    GPUDump::Packet packet;
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::GP0Write);
+    ASSERT_EQ(packet.value, 0xE1000000u);
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::GP1Write);
+    ASSERT_EQ(packet.value, 0xFFFFFFFFu);
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::DMAWrite);
+    ASSERT_EQ(packet.value, DMA_WORDS.size());
+    ASSERT_EQ(packet.words, std::vector<u32>(DMA_WORDS.begin(), DMA_WORDS.end()));
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::DMAWrite);
+    ASSERT_EQ(packet.value, 0u);
+    ASSERT_TRUE(packet.words.empty());
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::GPUREADRead);
+    ASSERT_EQ(packet.value, 200u);
+    for (const u32 ticks : {0u, 127u, 128u, 0x7FFFFFFFu})
+    {
+      ASSERT_TRUE(reader.ReadPacket(&packet));
+      ASSERT_EQ(packet.type, GPUDump::PacketType::CommandTicks);
+      ASSERT_EQ(packet.value, ticks);
+    }
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::ActiveLineLSB);
+    ASSERT_EQ(packet.value, 1u);
+    ASSERT_TRUE(reader.ReadPacket(&packet));
+    ASSERT_EQ(packet.type, GPUDump::PacketType::VBlank);
+    ASSERT_FALSE(reader.ReadPacket(&packet));
+
+    reader.Rewind();
+  }
+}
+
+TEST_F(GPUDumpTest, TruncatedPacketsAreRejected)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(m_filename.c_str());
+  ASSERT_TRUE(data.has_value());
+
+  // Cutting the file anywhere in the packets must stop the reader early, without reading past the end.
+  GPUDump::Reader full_reader;
+  GPUDump::Packet packet;
+  u32 full_packet_count = 0;
+  ASSERT_TRUE(full_reader.Open(m_filename.c_str()));
+  while (full_reader.ReadPacket(&packet))
+    full_packet_count++;
+
+  for (size_t size = HEADER_SIZE + STATE_SIZE; size < data->size(); size++)
+  {
+    ASSERT_TRUE(FileSystem::WriteBinaryFile(m_filename.c_str(), data->data(), size));
+
+    GPUDump::Reader reader;
+    ASSERT_TRUE(reader.Open(m_filename.c_str()));
+
+    u32 packet_count = 0;
+    while (reader.ReadPacket(&packet))
+      packet_count++;
+    ASSERT_LT(packet_count, full_packet_count) << "truncated to " << size << " bytes";
+  }
+}
+
+TEST_F(GPUDumpTest, TruncatedStateIsRejected)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(m_filename.c_str());
+  ASSERT_TRUE(data.has_value());
+
+  for (size_t size = 0; size < HEADER_SIZE + STATE_SIZE; size++)
+  {
+    ASSERT_TRUE(FileSystem::WriteBinaryFile(m_filename.c_str(), data->data(), size));
+
+    GPUDump::Reader reader;
+    ASSERT_FALSE(reader.Open(m_filename.c_str())) << "truncated to " << size << " bytes";
+  }
+}
+
+TEST_F(GPUDumpTest, OverlongVarIntIsRejected)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(m_filename.c_str());
+  ASSERT_TRUE(data.has_value());
+
+  // A command tick count with the continuation bit set in all five bytes, and a DMA block claiming more words than
+  // the file contains.
+  std::vector<u8> corrupted(data->begin(), data->begin() + HEADER_SIZE + STATE_SIZE);
+  corrupted.insert(corrupted.end(), {static_cast<u8>(GPUDump::PacketType::CommandTicks), 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                     0x01});
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(m_filename.c_str(), corrupted.data(), corrupted.size()));
+
+  GPUDump::Reader reader;
+  GPUDump::Packet packet;
+  ASSERT_TRUE(reader.Open(m_filename.c_str()));
+  ASSERT_FALSE(reader.ReadPacket(&packet));
+
+  corrupted.resize(HEADER_SIZE + STATE_SIZE);
+  corrupted.insert(corrupted.end(), {static_cast<u8>(GPUDump::PacketType::DMAWrite), 0xFF, 0xFF, 0xFF, 0xFF, 0x0F,
+                                     0x00, 0x00, 0x00, 0x00});
+  ASSERT_TRUE(FileSystem::WriteBinaryFile(m_filename.c_str(), corrupted.data(), corrupted.size()));
+  ASSERT_TRUE(reader.Open(m_filename.c_str()));
+  ASSERT_FALSE(reader.ReadPacket(&packet));
+}
@@ -0,0 +1,209 @@
+#include "core/gpu_sw.h"
+#include <algorithm>
+#include <array>
+#include <gtest/gtest.h>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Draws random triangles with DrawTriangle(), which shades spans of pixels at once, and with a reference rasterizer
+// which interpolates the attributes and calls ShadePixel() separately for each pixel, then compares the results.
+class GPU_SWRasterizerTest : public testing::Test
+{
+protected:
+  static constexpr u32 NUM_TRIANGLES = 1000;
+  static constexpr s32 MAX_TRIANGLE_SIZE = 96;
+
+  void SetUp() override
+  {
+    m_gpu = std::make_unique<GPU_SW>();
+
+    // Random texels and palettes. Some are zero so that fully transparent texels are covered too.
+    for (u16& value : m_gpu->m_vram)
+    {
+      const u32 bits = m_rng();
+      value = ((bits & 0xF0000) == 0) ? 0 : static_cast<u16>(bits);
+    }
+  }
+
+  void TearDown() override { m_gpu.reset(); }
+
+  void DrawAndCompare(u32 scale, bool scaled_dithering)
+  {
+    const u32 stride = GPU::VRAM_WIDTH * scale;
+    std::vector<u16> span_pixels(stride * GPU::VRAM_HEIGHT * scale);
+    for (u16& value : span_pixels)
+      value = static_cast<u16>(m_rng());
+    std::vector<u16> reference_pixels = span_pixels;
+
+    for (u32 i = 0; i < NUM_TRIANGLES; i++)
+    {
+      const bool shading_enable = RandomBool();
+      const bool texture_enable = RandomBool();
+      const bool raw_texture_enable = texture_enable && RandomBool();
+      const bool transparency_enable = RandomBool();
+      const bool dithering_enable = RandomBool();
+
+      const GPU_SW::SWRenderState state = GetRandomState();
+      std::array<GPU_SW::SWVertex, 3> vertices;
+      const s32 base_x = RandomRange(static_cast<s32>(state.drawing_area.left) - 32,
+                                     static_cast<s32>(state.drawing_area.right) - 32) -
+                         state.drawing_offset.x;
+      const s32 base_y = RandomRange(static_cast<s32>(state.drawing_area.top) - 32,
+                                     static_cast<s32>(state.drawing_area.bottom) - 32) -
+                         state.drawing_offset.y;
+      for (GPU_SW::SWVertex& v : vertices)
+      {
+        v.x = base_x + RandomRange(0, MAX_TRIANGLE_SIZE);
+        v.y = base_y + RandomRange(0, MAX_TRIANGLE_SIZE);
+        v.SetColorRGB24(m_rng());
+        v.SetTexcoord(static_cast<u16>(m_rng()));
+      }
+
+      GPU_SW::SWDrawContext span_ctx{&state, 0, 1, span_pixels.data(), stride, scale, scaled_dithering ? scale : 1u};
+      GPU_SW::SWDrawContext reference_ctx = span_ctx;
+      reference_ctx.pixels = reference_pixels.data();
+
+      (m_gpu.get()->*m_gpu->GetDrawTriangleFunction(shading_enable, texture_enable, raw_texture_enable,
+                                                     transparency_enable, dithering_enable))(
+        span_ctx, &vertices[0], &vertices[1], &vertices[2]);
+      DrawReferenceTriangle(reference_ctx, &vertices[0], &vertices[1], &vertices[2], shading_enable,
+                            m_gpu->GetShadePixelFunction(texture_enable, raw_texture_enable, transparency_enable,
+                                                         dithering_enable));
+
+      for (u32 y = state.drawing_area.top * scale; y < (state.drawing_area.bottom + 1) * scale; y++)
+      {
+        for (u32 x = state.drawing_area.left * scale; x < (state.drawing_area.right + 1) * scale; x++)
+        {
+          ASSERT_EQ(span_pixels[y * stride + x], reference_pixels[y * stride + x])
+            << "triangle " << i << " at (" << x << ", " << y << "), shading " << shading_enable << ", texture "
+            << texture_enable << ", raw texture " << raw_texture_enable << ", transparency " << transparency_enable
+            << " (mode " << static_cast<u32>(state.transparency_mode) << "), dithering " << dithering_enable
+            << ", mask and 0x" << std::hex << state.mask_and << " or 0x" << state.mask_or;
+        }
+      }
+    }
+  }
+
+private:
+  bool RandomBool() { return (m_rng() & 1u) != 0; }
+  s32 RandomRange(s32 min, s32 max) { return std::uniform_int_distribution<s32>(min, max)(m_rng); }
+
+  GPU_SW::SWRenderState GetRandomState()
+  {
+    GPU_SW::SWRenderState state = {};
+    state.drawing_offset.x = RandomRange(-32, 32);
+    state.drawing_offset.y = RandomRange(-32, 32);
+    state.drawing_area.left = static_cast<u32>(RandomRange(0, 960));
+    state.drawing_area.top = static_cast<u32>(RandomRange(0, 448));
+    state.drawing_area.right = state.drawing_area.left + static_cast<u32>(RandomRange(0, 63));
+    state.drawing_area.bottom = state.drawing_area.top + static_cast<u32>(RandomRange(0, 63));
+    state.texture_page_x = static_cast<u32>(RandomRange(0, 15)) * 64;
+    state.texture_page_y = static_cast<u32>(RandomRange(0, 1)) * 256;
+    state.texture_palette_x = static_cast<u32>(RandomRange(0, 63)) * 16;
+    state.texture_palette_y = static_cast<u32>(RandomRange(0, 511));
+    state.texture_window_mask_x = static_cast<u8>(RandomBool() ? RandomRange(0, 31) : 0);
+    state.texture_window_mask_y = static_cast<u8>(RandomBool() ? RandomRange(0, 31) : 0);
+    state.texture_window_offset_x = static_cast<u8>(RandomRange(0, 31));
+    state.texture_window_offset_y = static_cast<u8>(RandomRange(0, 31));
+    state.texture_mode = static_cast<GPU::TextureMode>(RandomRange(0, 2));
+    state.transparency_mode = static_cast<GPU::TransparencyMode>(RandomRange(0, 3));
+    state.mask_and = RandomBool() ? 0x8000 : 0;
+    state.mask_or = RandomBool() ? 0x8000 : 0;
+    state.interlaced_rendering = (RandomRange(0, 3) == 0);
+    state.active_line_lsb = static_cast<u32>(RandomRange(0, 1));
+    state.texture_cache_page = nullptr;
+    return state;
+  }
+
+  static u8 Interpolate(u8 v0, u8 v1, u8 v2, s32 w0, s32 w1, s32 w2, s32 ws, s32 half_ws)
+  {
+    const s64 v = s64(w0) * s32(v0) + s64(w1) * s32(v1) + s64(w2) * s32(v2);
+    const s64 vd = (v + half_ws) / ws;
+    return static_cast<u8>(std::clamp<s64>(vd, 0, 0xFF));
+  }
+
+  // DrawTriangle() as it was before it was split into spans, which tests every pixel of the bounding box against the
+  // edge functions and divides to interpolate the attributes.
+  void DrawReferenceTriangle(const GPU_SW::SWDrawContext& ctx, const GPU_SW::SWVertex* v0, const GPU_SW::SWVertex* v1,
+                             const GPU_SW::SWVertex* v2, bool shading_enable, GPU_SW::ShadePixelFunction shade_pixel)
+  {
+    const GPU_SW::SWRenderState& state = *ctx.state;
+#define orient2d(ax, ay, bx, by, cx, cy) ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax))
+
+    if (GPU_SW::IsClockwiseWinding(v0, v1, v2))
+      std::swap(v1, v2);
+
+    const s32 scale = static_cast<s32>(ctx.scale);
+    const s32 px0 = (v0->x + state.drawing_offset.x) * scale;
+    const s32 py0 = (v0->y + state.drawing_offset.y) * scale;
+    const s32 px1 = (v1->x + state.drawing_offset.x) * scale;
+    const s32 py1 = (v1->y + state.drawing_offset.y) * scale;
+    const s32 px2 = (v2->x + state.drawing_offset.x) * scale;
+    const s32 py2 = (v2->y + state.drawing_offset.y) * scale;
+
+    const s32 ws = orient2d(px0, py0, px1, py1, px2, py2);
+    const s32 half_ws = std::max<s32>((ws / 2) - 1, 0);
+    if (ws == 0)
+      return;
+
+    const s32 min_x = std::clamp(std::min(px0, std::min(px1, px2)), static_cast<s32>(state.drawing_area.left) * scale,
+                                 static_cast<s32>(state.drawing_area.right) * scale + (scale - 1));
+    const s32 max_x = std::clamp(std::max(px0, std::max(px1, px2)), static_cast<s32>(state.drawing_area.left) * scale,
+                                 static_cast<s32>(state.drawing_area.right) * scale + (scale - 1));
+    const s32 min_y = std::clamp(std::min(py0, std::min(py1, py2)), static_cast<s32>(state.drawing_area.top) * scale,
+                                 static_cast<s32>(state.drawing_area.bottom) * scale + (scale - 1));
+    const s32 max_y = std::clamp(std::max(py0, std::max(py1, py2)), static_cast<s32>(state.drawing_area.top) * scale,
+                                 static_cast<s32>(state.drawing_area.bottom) * scale + (scale - 1));
+
+    const s32 w0_bias = -s32(IsTopLeftEdge(px2 - px1, py1 - py2));
+    const s32 w1_bias = -s32(IsTopLeftEdge(px0 - px2, py2 - py0));
+    const s32 w2_bias = -s32(IsTopLeftEdge(px1 - px0, py0 - py1));
+
+    for (s32 y = min_y; y <= max_y; y++)
+    {
+      for (s32 x = min_x; x <= max_x; x++)
+      {
+        const s32 b0 = orient2d(px1, py1, px2, py2, x, y);
+        const s32 b1 = orient2d(px2, py2, px0, py0, x, y);
+        const s32 b2 = orient2d(px0, py0, px1, py1, x, y);
+        if (((b0 + w0_bias) | (b1 + w1_bias) | (b2 + w2_bias)) < 0)
+          continue;
+
+        const u8 r = shading_enable ? Interpolate(v0->color_r, v1->color_r, v2->color_r, b0, b1, b2, ws, half_ws) :
+                                      v0->color_r;
+        const u8 g = shading_enable ? Interpolate(v0->color_g, v1->color_g, v2->color_g, b0, b1, b2, ws, half_ws) :
+                                      v0->color_g;
+        const u8 b = shading_enable ? Interpolate(v0->color_b, v1->color_b, v2->color_b, b0, b1, b2, ws, half_ws) :
+                                      v0->color_b;
+        const u8 u = Interpolate(v0->texcoord_x, v1->texcoord_x, v2->texcoord_x, b0, b1, b2, ws, half_ws);
+        const u8 v = Interpolate(v0->texcoord_y, v1->texcoord_y, v2->texcoord_y, b0, b1, b2, ws, half_ws);
+        (m_gpu.get()->*shade_pixel)(ctx, static_cast<u32>(x), static_cast<u32>(y), r, g, b, u, v);
+      }
+    }
+
+#undef orient2d
+  }
+
+  static constexpr bool IsTopLeftEdge(s32 ex, s32 ey) { return (ey < 0 || (ey == 0 && ex < 0)); }
+
+  std::unique_ptr<GPU_SW> m_gpu;
+  std::mt19937 m_rng{0x53574750u};
+};
+
+TEST_F(GPU_SWRasterizerTest, SpansMatchPixels)
+{
+  DrawAndCompare(1, false);
+}
+
+TEST_F(GPU_SWRasterizerTest, UpscaledSpansMatchPixels)
+{
+  DrawAndCompare(2, false);
+  DrawAndCompare(4, false);
+}
+
+TEST_F(GPU_SWRasterizerTest, UpscaledSpansWithScaledDitheringMatchPixels)
+{
+  DrawAndCompare(2, true);
+  DrawAndCompare(3, true);
+}
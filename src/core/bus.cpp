@@ -32,9 +32,30 @@ ALWAYS_INLINE static void FixupUnalignedWordAccessW32(u32& offset, u32& value)
   value <<= byte_offset * 8;
 }
 
-Bus::Bus() = default;
+// Fastmem maps RAM and its mirrors at the KUSEG, KSEG0 and KSEG1 bases of the fastmem region.
+static constexpr u32 FASTMEM_KUSEG_BASE = UINT32_C(0x00000000);
+static constexpr u32 FASTMEM_KSEG0_BASE = UINT32_C(0x80000000);
+static constexpr u32 FASTMEM_KSEG1_BASE = UINT32_C(0xA0000000);
+static constexpr std::array<u32, 3> FASTMEM_SEGMENT_BASES = {
+  {FASTMEM_KUSEG_BASE, FASTMEM_KSEG0_BASE, FASTMEM_KSEG1_BASE}};
+static constexpr u32 FASTMEM_RAM_MIRROR_COUNT = Bus::RAM_MIRROR_END / Bus::RAM_SIZE;
 
-Bus::~Bus() = default;
+Bus::Bus()
+{
+  // RAM lives in shared memory so that it can be mirrored into the fastmem region.
+  if (!m_memory_arena.Create(RAM_SIZE, true, false))
+    Panic("Failed to create memory arena for RAM");
+
+  m_ram = static_cast<u8*>(m_memory_arena.CreateViewPtr(0, RAM_SIZE, true, false));
+  if (!m_ram)
+    Panic("Failed to map RAM");
+}
+
+Bus::~Bus()
+{
+  UpdateFastmemViews(false, false);
+  m_memory_arena.ReleaseViewPtr(m_ram, RAM_SIZE);
+}
 
 void Bus::Initialize(CPU::Core* cpu, CPU::CodeCache* cpu_code_cache, DMA* dma,
                      InterruptController* interrupt_controller, GPU* gpu, CDROM* cdrom, Pad* pad, Timers* timers,
@@ -55,7 +76,7 @@ void Bus::Initialize(CPU::Core* cpu, CPU::CodeCache* cpu_code_cache, DMA* dma,
 
 void Bus::Reset()
 {
-  std::memset(m_ram, 0, sizeof(m_ram));
+  std::memset(m_ram, 0, RAM_SIZE);
   m_MEMCTRL.exp1_base = 0x1F000000;
   m_MEMCTRL.exp2_base = 0x1F802000;
   m_MEMCTRL.exp1_delay_size.bits = 0x0013243F;
@@ -76,7 +97,7 @@ bool Bus::DoState(StateWrapper& sw)
   sw.Do(&m_bios_access_time);
   sw.Do(&m_cdrom_access_time);
   sw.Do(&m_spu_access_time);
-  sw.DoBytes(m_ram, sizeof(m_ram));
+  sw.DoBytes(m_ram, RAM_SIZE);
   sw.DoBytes(m_bios, sizeof(m_bios));
   sw.DoArray(m_MEMCTRL.regs, countof(m_MEMCTRL.regs));
   sw.Do(&m_ram_size_reg);
@@ -269,6 +290,174 @@ TickCount Bus::DoInvalidAccess(MemoryAccessType type, MemoryAccessSize size, Phy
   return 1;
 }
 
+Bus::MMIOReadHandler Bus::GetMMIOReadHandler(MemoryAccessSize size, PhysicalMemoryAddress address, u32* offset)
+{
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return LookupMMIOReadHandler<MemoryAccessSize::Byte>(address, offset);
+    case MemoryAccessSize::HalfWord:
+      return LookupMMIOReadHandler<MemoryAccessSize::HalfWord>(address, offset);
+    case MemoryAccessSize::Word:
+    default:
+      return LookupMMIOReadHandler<MemoryAccessSize::Word>(address, offset);
+  }
+}
+
+Bus::MMIOWriteHandler Bus::GetMMIOWriteHandler(MemoryAccessSize size, PhysicalMemoryAddress address, u32* offset)
+{
+  switch (size)
+  {
+    case MemoryAccessSize::Byte:
+      return LookupMMIOWriteHandler<MemoryAccessSize::Byte>(address, offset);
+    case MemoryAccessSize::HalfWord:
+      return LookupMMIOWriteHandler<MemoryAccessSize::HalfWord>(address, offset);
+    case MemoryAccessSize::Word:
+    default:
+      return LookupMMIOWriteHandler<MemoryAccessSize::Word>(address, offset);
+  }
+}
+
+// The ranges and offset masks here have to match DispatchAccess().
+template<MemoryAccessSize size>
+Bus::MMIOReadHandler Bus::LookupMMIOReadHandler(PhysicalMemoryAddress address, u32* offset)
+{
+  if (address < MEMCTRL_BASE)
+  {
+    return nullptr;
+  }
+  else if (address < (MEMCTRL_BASE + MEMCTRL_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadMemoryControl>;
+  }
+  else if (address < (PAD_BASE + PAD_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadPad>;
+  }
+  else if (address < (SIO_BASE + SIO_SIZE))
+  {
+    *offset = address & SIO_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadSIO>;
+  }
+  else if (address < (MEMCTRL2_BASE + MEMCTRL2_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadMemoryControl2>;
+  }
+  else if (address < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
+  {
+    *offset = address & INTERRUPT_CONTROLLER_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadInterruptController>;
+  }
+  else if (address < (DMA_BASE + DMA_SIZE))
+  {
+    *offset = address & DMA_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadDMA>;
+  }
+  else if (address < (TIMERS_BASE + TIMERS_SIZE))
+  {
+    *offset = address & TIMERS_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadTimers>;
+  }
+  else if (address < (CDROM_BASE + GPU_SIZE))
+  {
+    // CDROM access time depends on the memory control registers.
+    return nullptr;
+  }
+  else if (address < (GPU_BASE + GPU_SIZE))
+  {
+    *offset = address & GPU_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadGPU>;
+  }
+  else if (address < (MDEC_BASE + MDEC_SIZE))
+  {
+    *offset = address & MDEC_MASK;
+    return &MMIOReadThunk<size, &Bus::DoReadMDEC>;
+  }
+  else
+  {
+    return nullptr;
+  }
+}
+
+template<MemoryAccessSize size>
+Bus::MMIOWriteHandler Bus::LookupMMIOWriteHandler(PhysicalMemoryAddress address, u32* offset)
+{
+  if (address < MEMCTRL_BASE)
+  {
+    return nullptr;
+  }
+  else if (address < (MEMCTRL_BASE + MEMCTRL_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteMemoryControl>;
+  }
+  else if (address < (PAD_BASE + PAD_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWritePad>;
+  }
+  else if (address < (SIO_BASE + SIO_SIZE))
+  {
+    *offset = address & SIO_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteSIO>;
+  }
+  else if (address < (MEMCTRL2_BASE + MEMCTRL2_SIZE))
+  {
+    *offset = address & PAD_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteMemoryControl2>;
+  }
+  else if (address < (INTERRUPT_CONTROLLER_BASE + INTERRUPT_CONTROLLER_SIZE))
+  {
+    *offset = address & INTERRUPT_CONTROLLER_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteInterruptController>;
+  }
+  else if (address < (DMA_BASE + DMA_SIZE))
+  {
+    *offset = address & DMA_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteDMA>;
+  }
+  else if (address < (TIMERS_BASE + TIMERS_SIZE))
+  {
+    *offset = address & TIMERS_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteTimers>;
+  }
+  else if (address < CDROM_BASE)
+  {
+    return nullptr;
+  }
+  else if (address < (CDROM_BASE + GPU_SIZE))
+  {
+    *offset = address & CDROM_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteCDROM>;
+  }
+  else if (address < (GPU_BASE + GPU_SIZE))
+  {
+    *offset = address & GPU_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteGPU>;
+  }
+  else if (address < (MDEC_BASE + MDEC_SIZE))
+  {
+    *offset = address & MDEC_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteMDEC>;
+  }
+  else if (address < SPU_BASE)
+  {
+    return nullptr;
+  }
+  else if (address < (SPU_BASE + SPU_SIZE))
+  {
+    *offset = address & SPU_MASK;
+    return &MMIOWriteThunk<size, &Bus::DoWriteSPU>;
+  }
+  else
+  {
+    return nullptr;
+  }
+}
+
 u32 Bus::DoReadEXP1(MemoryAccessSize size, u32 offset)
 {
   if (m_exp1_rom.empty())
@@ -583,9 +772,201 @@ void Bus::DoWriteSPU(MemoryAccessSize size, u32 offset, u32 value)
   }
 }
 
-void Bus::DoInvalidateCodeCache(u32 page_index)
+void Bus::DoInvalidateCodeCache(u32 page_index, u32 offset, u32 size)
+{
+  m_cpu_code_cache->InvalidateBlocksInRange(page_index, offset, size);
+}
+
+void Bus::ClearRAMCodePageFlags()
+{
+  m_ram_code_bits.reset();
+
+  if (m_fastmem_base)
+  {
+    for (u32 segment_base : FASTMEM_SEGMENT_BASES)
+    {
+      if (IsFastmemSegmentMapped(segment_base))
+        SetFastmemViewProtection(segment_base, 0, RAM_SIZE, true);
+    }
+  }
+}
+
+bool Bus::UpdateFastmemViews(bool enabled, bool isolate_cache)
+{
+  if (!enabled)
+  {
+    if (!m_fastmem_base)
+      return true;
+
+    for (u32 segment_base : FASTMEM_SEGMENT_BASES)
+    {
+      if (IsFastmemSegmentMapped(segment_base))
+        UnmapFastmemViews(segment_base);
+    }
+
+    Common::MemoryArena::ReleaseAddressSpace(m_fastmem_base, static_cast<size_t>(FASTMEM_REGION_SIZE));
+    m_fastmem_base = nullptr;
+    return true;
+  }
+
+  if (!m_fastmem_base)
+  {
+    m_fastmem_base =
+      static_cast<u8*>(Common::MemoryArena::ReserveAddressSpace(static_cast<size_t>(FASTMEM_REGION_SIZE)));
+    if (!m_fastmem_base)
+    {
+      Log_ErrorPrint("Failed to reserve address space for fastmem");
+      return false;
+    }
+
+    // KSEG1 is never affected by cache isolation.
+    m_fastmem_cache_isolated = true;
+    if (!MapFastmemViews(FASTMEM_KSEG1_BASE))
+    {
+      Common::MemoryArena::ReleaseAddressSpace(m_fastmem_base, static_cast<size_t>(FASTMEM_REGION_SIZE));
+      m_fastmem_base = nullptr;
+      return false;
+    }
+  }
+
+  if (m_fastmem_cache_isolated == isolate_cache)
+    return true;
+
+  if (isolate_cache)
+  {
+    // Stores are discarded while the cache is isolated, so force them through the slow path.
+    UnmapFastmemViews(FASTMEM_KUSEG_BASE);
+    UnmapFastmemViews(FASTMEM_KSEG0_BASE);
+  }
+  else
+  {
+    if (!MapFastmemViews(FASTMEM_KUSEG_BASE))
+    {
+      UpdateFastmemViews(false, false);
+      return false;
+    }
+
+    if (!MapFastmemViews(FASTMEM_KSEG0_BASE))
+    {
+      UnmapFastmemViews(FASTMEM_KUSEG_BASE);
+      UpdateFastmemViews(false, false);
+      return false;
+    }
+  }
+
+  m_fastmem_cache_isolated = isolate_cache;
+  return true;
+}
+
+bool Bus::HandleFastmemCodeWrite(VirtualMemoryAddress address)
 {
-  m_cpu_code_cache->InvalidateBlocksWithPageIndex(page_index);
+  for (u32 segment_base : FASTMEM_SEGMENT_BASES)
+  {
+    if (address < segment_base || address >= (segment_base + RAM_MIRROR_END))
+      continue;
+
+    if (!IsFastmemSegmentMapped(segment_base))
+      return false;
+
+    // The whole host page was protected, so invalidate every code page within it.
+    const u32 host_page_size = static_cast<u32>(Common::MemoryArena::GetPageSize());
+    const u32 ram_offset = (address - segment_base) & RAM_MASK & ~(host_page_size - 1);
+    const u32 start_page = ram_offset / CPU_CODE_CACHE_PAGE_SIZE;
+    const u32 end_page = (ram_offset + host_page_size) / CPU_CODE_CACHE_PAGE_SIZE;
+    for (u32 page = start_page; page < end_page; page++)
+    {
+      if (m_ram_code_bits[page])
+        DoInvalidateCodeCache(page, page * CPU_CODE_CACHE_PAGE_SIZE, CPU_CODE_CACHE_PAGE_SIZE);
+    }
+
+    // Invalidation should have lifted the protection already, but make sure we don't fault forever.
+    for (u32 other_segment_base : FASTMEM_SEGMENT_BASES)
+    {
+      if (IsFastmemSegmentMapped(other_segment_base))
+        SetFastmemViewProtection(other_segment_base, ram_offset, host_page_size, true);
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+bool Bus::MapFastmemViews(u32 segment_base)
+{
+  for (u32 i = 0; i < FASTMEM_RAM_MIRROR_COUNT; i++)
+  {
+    u8* view_base = m_fastmem_base + segment_base + (i * RAM_SIZE);
+    if (m_memory_arena.CreateViewPtr(0, RAM_SIZE, true, false, view_base) != view_base)
+    {
+      Log_ErrorPrintf("Failed to map fastmem RAM view at 0x%08X", segment_base + (i * RAM_SIZE));
+      for (u32 j = 0; j < i; j++)
+        m_memory_arena.ReleaseViewPtr(m_fastmem_base + segment_base + (j * RAM_SIZE), RAM_SIZE, true);
+
+      return false;
+    }
+  }
+
+  // Pages containing code must stay write-protected in the new views too.
+  const u32 host_page_size = static_cast<u32>(Common::MemoryArena::GetPageSize());
+  for (u32 ram_offset = 0; ram_offset < RAM_SIZE; ram_offset += host_page_size)
+  {
+    if (GetCodePageCountInHostPage(ram_offset, host_page_size) > 0)
+      SetFastmemViewProtection(segment_base, ram_offset, host_page_size, false);
+  }
+
+  return true;
+}
+
+void Bus::UnmapFastmemViews(u32 segment_base)
+{
+  for (u32 i = 0; i < FASTMEM_RAM_MIRROR_COUNT; i++)
+    m_memory_arena.ReleaseViewPtr(m_fastmem_base + segment_base + (i * RAM_SIZE), RAM_SIZE, true);
+}
+
+bool Bus::IsFastmemSegmentMapped(u32 segment_base) const
+{
+  return (m_fastmem_base && (segment_base == FASTMEM_KSEG1_BASE || !m_fastmem_cache_isolated));
+}
+
+void Bus::SetFastmemViewProtection(u32 segment_base, u32 ram_offset, u32 size, bool writable)
+{
+  for (u32 i = 0; i < FASTMEM_RAM_MIRROR_COUNT; i++)
+  {
+    u8* address = m_fastmem_base + segment_base + (i * RAM_SIZE) + ram_offset;
+    if (!Common::MemoryArena::SetPageProtection(address, size, true, writable, false))
+    {
+      Log_ErrorPrintf("Failed to change protection of fastmem page at 0x%08X",
+                      segment_base + (i * RAM_SIZE) + ram_offset);
+    }
+  }
+}
+
+u32 Bus::GetCodePageCountInHostPage(u32 ram_offset, u32 host_page_size) const
+{
+  const u32 start_page = ram_offset / CPU_CODE_CACHE_PAGE_SIZE;
+  const u32 end_page = (ram_offset + host_page_size) / CPU_CODE_CACHE_PAGE_SIZE;
+  u32 count = 0;
+  for (u32 page = start_page; page < end_page; page++)
+    count += BoolToUInt32(m_ram_code_bits[page]);
+
+  return count;
+}
+
+void Bus::UpdateFastmemCodePageProtection(u32 index)
+{
+  // Protection only needs to change when the first code page in a host page is added, or the last is removed.
+  const u32 host_page_size = static_cast<u32>(Common::MemoryArena::GetPageSize());
+  const u32 ram_offset = (index * CPU_CODE_CACHE_PAGE_SIZE) & ~(host_page_size - 1);
+  const u32 count = GetCodePageCountInHostPage(ram_offset, host_page_size);
+  if (m_ram_code_bits[index] ? (count != 1) : (count != 0))
+    return;
+
+  for (u32 segment_base : FASTMEM_SEGMENT_BASES)
+  {
+    if (IsFastmemSegmentMapped(segment_base))
+      SetFastmemViewProtection(segment_base, ram_offset, host_page_size, !m_ram_code_bits[index]);
+  }
 }
 
 u32 Bus::DoReadDMA(MemoryAccessSize size, u32 offset)
@@ -1,5 +1,6 @@
 #pragma once
 #include "common/bitfield.h"
+#include "common/memory_arena.h"
 #include "types.h"
 #include <array>
 #include <bitset>
@@ -78,6 +79,19 @@ public:
     BIOS_SIZE = 0x80000
   };
 
+  /// Size of the host address space region reserved for fastmem, covering the whole 32-bit guest address space.
+  static constexpr u64 FASTMEM_REGION_SIZE = UINT64_C(0x100000000);
+
+  /// Cycles taken by a CPU read from RAM.
+  static constexpr TickCount RAM_READ_TICKS = 4;
+
+  /// Cycles taken by a CPU read from a device register with fixed timing, see GetMMIOReadHandler().
+  static constexpr TickCount MMIO_READ_TICKS = 2;
+
+  /// Device register accessors with the access size bound, which can be called without going through dispatch.
+  using MMIOReadHandler = u32 (*)(Bus* bus, u32 offset);
+  using MMIOWriteHandler = void (*)(Bus* bus, u32 offset, u32 value);
+
   Bus();
   ~Bus();
 
@@ -96,6 +110,13 @@ public:
   template<MemoryAccessType type, MemoryAccessSize size>
   TickCount DispatchAccess(PhysicalMemoryAddress address, u32& value);
 
+  /// Returns the read handler for a register of a device with fixed access timing, or nullptr if the address is not
+  /// one. The offset to pass to the handler is written to offset.
+  static MMIOReadHandler GetMMIOReadHandler(MemoryAccessSize size, PhysicalMemoryAddress address, u32* offset);
+
+  /// Returns the write handler for a device register, or nullptr if the address is not one.
+  static MMIOWriteHandler GetMMIOWriteHandler(MemoryAccessSize size, PhysicalMemoryAddress address, u32* offset);
+
   // Optimized variant for burst/multi-word read/writing.
   TickCount ReadWords(PhysicalMemoryAddress address, u32* words, u32 word_count);
   TickCount WriteWords(PhysicalMemoryAddress address, const u32* words, u32 word_count);
@@ -126,17 +147,44 @@ public:
   ALWAYS_INLINE static bool IsRAMAddress(PhysicalMemoryAddress address) { return address < RAM_MIRROR_END; }
 
   /// Flags a RAM region as code, so we know when to invalidate blocks.
-  ALWAYS_INLINE void SetRAMCodePage(u32 index) { m_ram_code_bits[index] = true; }
+  ALWAYS_INLINE void SetRAMCodePage(u32 index)
+  {
+    if (m_ram_code_bits[index])
+      return;
+
+    m_ram_code_bits[index] = true;
+    if (m_fastmem_base)
+      UpdateFastmemCodePageProtection(index);
+  }
 
   /// Unflags a RAM region as code, the code cache will no longer be notified when writes occur.
-  ALWAYS_INLINE void ClearRAMCodePage(u32 index) { m_ram_code_bits[index] = false; }
+  ALWAYS_INLINE void ClearRAMCodePage(u32 index)
+  {
+    if (!m_ram_code_bits[index])
+      return;
+
+    m_ram_code_bits[index] = false;
+    if (m_fastmem_base)
+      UpdateFastmemCodePageProtection(index);
+  }
 
   /// Clears all code bits for RAM regions.
-  ALWAYS_INLINE void ClearRAMCodePageFlags() { m_ram_code_bits.reset(); }
+  void ClearRAMCodePageFlags();
 
   /// Direct access to RAM - used by DMA.
   ALWAYS_INLINE u8* GetRAM() { return m_ram; }
 
+  /// Returns the base of the fastmem region, i.e. host address of virtual address zero. Null if fastmem is disabled.
+  ALWAYS_INLINE u8* GetFastmemBase() const { return m_fastmem_base; }
+
+  /// Maps or unmaps RAM in the fastmem region. When the cache is isolated, KUSEG/KSEG0 are left unmapped, so that
+  /// stores go through the slow path. Returns false if the address space could not be set up.
+  bool UpdateFastmemViews(bool enabled, bool isolate_cache);
+
+  /// Handles a store fault in the fastmem region. If the address is mapped RAM, the page was write-protected because it
+  /// contains code, so any blocks in it are invalidated. Returns false if the address is not mapped RAM.
+  bool HandleFastmemCodeWrite(VirtualMemoryAddress address);
+
 private:
   enum : u32
   {
@@ -200,6 +248,24 @@ private:
 
   TickCount DoInvalidAccess(MemoryAccessType type, MemoryAccessSize size, PhysicalMemoryAddress address, u32& value);
 
+  template<MemoryAccessSize size, u32 (Bus::*handler)(MemoryAccessSize, u32)>
+  static u32 MMIOReadThunk(Bus* bus, u32 offset)
+  {
+    return (bus->*handler)(size, offset);
+  }
+
+  template<MemoryAccessSize size, void (Bus::*handler)(MemoryAccessSize, u32, u32)>
+  static void MMIOWriteThunk(Bus* bus, u32 offset, u32 value)
+  {
+    (bus->*handler)(size, offset, value);
+  }
+
+  template<MemoryAccessSize size>
+  static MMIOReadHandler LookupMMIOReadHandler(PhysicalMemoryAddress address, u32* offset);
+
+  template<MemoryAccessSize size>
+  static MMIOWriteHandler LookupMMIOWriteHandler(PhysicalMemoryAddress address, u32* offset);
+
   u32 DoReadEXP1(MemoryAccessSize size, u32 offset);
   void DoWriteEXP1(MemoryAccessSize size, u32 offset, u32 value);
 
@@ -239,7 +305,14 @@ private:
   u32 DoReadSPU(MemoryAccessSize size, u32 offset);
   void DoWriteSPU(MemoryAccessSize size, u32 offset, u32 value);
 
-  void DoInvalidateCodeCache(u32 page_index);
+  void DoInvalidateCodeCache(u32 page_index, u32 offset, u32 size);
+
+  bool MapFastmemViews(u32 segment_base);
+  void UnmapFastmemViews(u32 segment_base);
+  bool IsFastmemSegmentMapped(u32 segment_base) const;
+  void SetFastmemViewProtection(u32 segment_base, u32 ram_offset, u32 size, bool writable);
+  u32 GetCodePageCountInHostPage(u32 ram_offset, u32 host_page_size) const;
+  void UpdateFastmemCodePageProtection(u32 index);
 
   /// Returns the number of cycles stolen by DMA RAM access.
   ALWAYS_INLINE static TickCount GetDMARAMTickCount(u32 word_count)
@@ -251,15 +324,16 @@ private:
     return static_cast<TickCount>(word_count + ((word_count + 15) / 16));
   }
 
-  /// Invalidates any code pages which overlap the specified range.
+  /// Invalidates any code which overlaps the specified range.
   ALWAYS_INLINE void InvalidateCodePages(PhysicalMemoryAddress address, u32 word_count)
   {
+    const u32 size = word_count * sizeof(u32);
     const u32 start_page = address / CPU_CODE_CACHE_PAGE_SIZE;
-    const u32 end_page = (address + word_count * sizeof(u32)) / CPU_CODE_CACHE_PAGE_SIZE;
+    const u32 end_page = (address + size) / CPU_CODE_CACHE_PAGE_SIZE;
     for (u32 page = start_page; page <= end_page; page++)
     {
       if (m_ram_code_bits[page])
-        DoInvalidateCodeCache(page);
+        DoInvalidateCodeCache(page, address, size);
     }
   }
 
@@ -282,7 +356,7 @@ private:
   std::array<TickCount, 3> m_spu_access_time = {};
 
   std::bitset<CPU_CODE_CACHE_PAGE_COUNT> m_ram_code_bits{};
-  u8 m_ram[RAM_SIZE]{};   // 2MB RAM
+  u8* m_ram = nullptr;    // 2MB RAM, backed by m_memory_arena
   u8 m_bios[BIOS_SIZE]{}; // 512K BIOS ROM
   std::vector<u8> m_exp1_rom;
 
@@ -290,6 +364,10 @@ private:
   u32 m_ram_size_reg = 0;
 
   std::string m_tty_line_buffer;
+
+  Common::MemoryArena m_memory_arena;
+  u8* m_fastmem_base = nullptr;
+  bool m_fastmem_cache_isolated = false;
 };
 
 #include "bus.inl"
@@ -27,7 +27,7 @@ TickCount Bus::DoRAMAccess(u32 offset, u32& value)
   {
     const u32 page_index = offset / CPU_CODE_CACHE_PAGE_SIZE;
     if (m_ram_code_bits[page_index])
-      DoInvalidateCodeCache(page_index);
+      DoInvalidateCodeCache(page_index, offset, UINT32_C(1) << static_cast<u32>(size));
 
     if constexpr (size == MemoryAccessSize::Byte)
     {
@@ -44,7 +44,7 @@ TickCount Bus::DoRAMAccess(u32 offset, u32& value)
     }
   }
 
-  return (type == MemoryAccessType::Read) ? 4 : 0;
+  return (type == MemoryAccessType::Read) ? RAM_READ_TICKS : 0;
 }
 
 template<MemoryAccessType type, MemoryAccessSize size>
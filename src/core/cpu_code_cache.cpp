@@ -1,8 +1,12 @@
 #include "cpu_code_cache.h"
+#include "bus.h"
 #include "common/log.h"
 #include "cpu_core.h"
 #include "cpu_disasm.h"
+#include "cpu_threaded_interpreter.h"
 #include "system.h"
+#include <cstring>
+#include <optional>
 Log_SetChannel(CPU::CodeCache);
 
 #ifdef WITH_RECOMPILER
@@ -17,27 +21,67 @@ constexpr bool USE_BLOCK_LINKING = true;
 static constexpr u32 RECOMPILER_CODE_CACHE_SIZE = 32 * 1024 * 1024;
 static constexpr u32 RECOMPILER_FAR_CODE_CACHE_SIZE = 32 * 1024 * 1024;
 
+static_assert(CodeCache::BLOCK_LUT_RAM_PAGES == (Bus::RAM_SIZE >> CodeCache::BLOCK_LUT_PAGE_SHIFT));
+static_assert(CodeCache::BLOCK_LUT_BIOS_PAGES == (Bus::BIOS_SIZE >> CodeCache::BLOCK_LUT_PAGE_SHIFT));
+
+#ifdef WITH_RECOMPILER
+static bool HasCodeSpaceForBlock(const JitCodeBuffer* code_buffer, const CodeBlock& block)
+{
+  // Inline GTE commands are much larger than other instructions, so they're accounted for separately.
+  u32 near_size = 0;
+  for (const CodeBlockInstruction& cbi : block.instructions)
+  {
+    const bool is_gte_command =
+      (cbi.instruction.op == InstructionOp::cop2 && !cbi.instruction.cop.IsCommonInstruction());
+    near_size += is_gte_command ? Recompiler::MAX_NEAR_HOST_BYTES_PER_GTE_INSTRUCTION :
+                                  Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION;
+  }
+
+  const u32 far_size = static_cast<u32>(block.instructions.size()) * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION;
+  return (code_buffer->GetFreeCodeSpace() >= near_size && code_buffer->GetFreeFarCodeSpace() >= far_size);
+}
+#endif
+
 CodeCache::CodeCache() = default;
 
 CodeCache::~CodeCache()
 {
   if (m_system)
     Flush();
+
+  if (m_invalidation_stats.code_page_writes > 0)
+  {
+    Log_InfoPrintf("Code invalidation: %u writes to code pages, %u ignored, %u blocks invalidated, %u blocks spared",
+                   m_invalidation_stats.code_page_writes, m_invalidation_stats.writes_ignored,
+                   m_invalidation_stats.blocks_invalidated, m_invalidation_stats.blocks_spared);
+  }
+
+  if (m_fastmem_handler_installed)
+    Common::PageFaultHandler::RemoveHandler(this);
+
+  for (CodeBlock** page : m_block_lut)
+    delete[] page;
 }
 
-void CodeCache::Initialize(System* system, Core* core, Bus* bus, bool use_recompiler)
+void CodeCache::Initialize(System* system, Core* core, Bus* bus, CPUExecutionMode execution_mode, bool use_fastmem,
+                           bool idle_loop_skipping)
 {
   m_system = system;
   m_core = core;
   m_bus = bus;
+  m_use_threaded_interpreter = (execution_mode == CPUExecutionMode::ThreadedInterpreter);
+  m_idle_loop_skipping = idle_loop_skipping;
 
 #ifdef WITH_RECOMPILER
-  m_use_recompiler = use_recompiler;
+  m_use_recompiler = (execution_mode == CPUExecutionMode::Recompiler);
+  m_use_fastmem = use_fastmem;
   m_code_buffer = std::make_unique<JitCodeBuffer>(RECOMPILER_CODE_CACHE_SIZE, RECOMPILER_FAR_CODE_CACHE_SIZE);
   m_asm_functions = std::make_unique<Recompiler::ASMFunctions>();
   m_asm_functions->Generate(m_code_buffer.get());
+  UpdateFastmemState();
 #else
   m_use_recompiler = false;
+  m_use_fastmem = false;
 #endif
 }
 
@@ -53,6 +97,9 @@ void CodeCache::Execute()
       m_core->SafeReadMemoryWord(m_core->m_regs.pc, &m_core->m_next_instruction.bits);
       m_core->DispatchInterrupt();
       next_block_key = GetNextBlockKey();
+
+      // the handler can change registers, so the loop has to be seen making no progress again
+      m_idle_loop_block = nullptr;
     }
 
     CodeBlock* block = LookupBlock(next_block_key);
@@ -76,14 +123,44 @@ void CodeCache::Execute()
 #endif
 
     if (m_use_recompiler)
+    {
+#ifdef WITH_RECOMPILER
+      if (m_asm_functions->dispatcher)
+      {
+        // Keeps running blocks until it can't find the next one, so there's nothing to link.
+        m_asm_functions->dispatcher(m_core, m_block_lut.data(), block->host_code);
+        if (m_core->m_pending_ticks >= m_core->m_downcount)
+          break;
+
+        next_block_key = GetNextBlockKey();
+        continue;
+      }
+#endif
+
+      // recompiled blocks call the block executed callback themselves
       block->host_code(m_core);
+    }
     else
-      InterpretCachedBlock(*block);
+    {
+      if (m_use_threaded_interpreter)
+        ThreadedInterpreter::ExecuteBlock(m_core, *block);
+      else
+        InterpretCachedBlock(*block);
+
+      if (block->idle_loop_candidate)
+        CheckIdleLoop(block);
+
+      if (m_block_executed_callback)
+        m_block_executed_callback(*block);
+    }
 
     if (m_core->m_pending_ticks >= m_core->m_downcount)
       break;
     else if (m_core->HasPendingInterrupt() || !USE_BLOCK_LINKING)
+    {
+      next_block_key = GetNextBlockKey();
       continue;
+    }
 
     next_block_key = GetNextBlockKey();
     if (next_block_key.bits == block->key.bits)
@@ -129,28 +206,111 @@ void CodeCache::Execute()
   m_core->m_regs.npc = m_core->m_regs.pc;
 }
 
-void CodeCache::SetUseRecompiler(bool enable)
+void CodeCache::SetExecutionMode(CPUExecutionMode mode)
 {
 #ifdef WITH_RECOMPILER
-  if (m_use_recompiler == enable)
+  const bool use_recompiler = (mode == CPUExecutionMode::Recompiler);
+#else
+  const bool use_recompiler = false;
+#endif
+  const bool use_threaded_interpreter = (mode == CPUExecutionMode::ThreadedInterpreter);
+  if (m_use_recompiler == use_recompiler && m_use_threaded_interpreter == use_threaded_interpreter)
     return;
 
-  m_use_recompiler = enable;
+  m_use_recompiler = use_recompiler;
+  m_use_threaded_interpreter = use_threaded_interpreter;
   Flush();
+  UpdateFastmemState();
+}
+
+void CodeCache::SetUseFastmem(bool enable)
+{
+#ifdef WITH_RECOMPILER
+  if (m_use_fastmem == enable)
+    return;
+
+  m_use_fastmem = enable;
+  Flush();
+  UpdateFastmemState();
+#endif
+}
+
+void CodeCache::SetIdleLoopSkipping(bool enable)
+{
+  if (m_idle_loop_skipping == enable)
+    return;
+
+  // idle loop candidates are found when blocks are compiled
+  m_idle_loop_skipping = enable;
+  Flush();
+}
+
+void CodeCache::SetBlockExecutedCallback(BlockExecutedCallback callback)
+{
+  // recompiled blocks only call the callback if it was set when they were compiled
+  m_block_executed_callback = std::move(callback);
+  Flush();
+}
+
+bool CodeCache::RecompileAndExecuteInstructions(const Instruction* instructions, u32 count)
+{
+#ifdef WITH_RECOMPILER
+  if (!m_use_recompiler || count == 0)
+    return false;
+
+  CodeBlock block(GetNextBlockKey());
+  u32 pc = block.GetPC();
+  for (u32 i = 0; i < count; i++)
+  {
+    CodeBlockInstruction cbi = {};
+    cbi.instruction.bits = instructions[i].bits;
+    cbi.pc = pc;
+    cbi.is_branch_delay_slot = (i > 0 && block.instructions.back().is_branch_instruction);
+    cbi.is_load_delay_slot = (i > 0 && block.instructions.back().has_load_delay);
+    cbi.is_branch_instruction = IsBranchInstruction(cbi.instruction);
+    cbi.is_load_instruction = IsMemoryLoadInstruction(cbi.instruction);
+    cbi.is_store_instruction = IsMemoryStoreInstruction(cbi.instruction);
+    cbi.has_load_delay = InstructionHasLoadDelay(cbi.instruction);
+    cbi.can_trap = CanInstructionTrap(cbi.instruction, m_core->InUserMode());
+    block.instructions.push_back(cbi);
+    pc += sizeof(cbi.instruction.bits);
+  }
+  block.instructions.back().is_last_instruction = true;
+
+  if (!HasCodeSpaceForBlock(m_code_buffer.get(), block))
+    Flush();
+
+  // The block isn't linked or registered anywhere, so its host code is simply left behind until the next flush.
+  Recompiler::CodeGenerator codegen(m_core, this, m_code_buffer.get(), *m_asm_functions.get());
+  if (!codegen.CompileBlock(&block, &block.host_code, &block.host_code_size))
+    return false;
+
+  block.host_code(m_core);
+  return true;
+#else
+  return false;
 #endif
 }
 
 void CodeCache::Flush()
 {
+  m_idle_loop_block = nullptr;
   m_bus->ClearRAMCodePageFlags();
   for (auto& it : m_ram_block_map)
     it.clear();
+  m_ram_code_subpage_masks.fill(0);
 
   for (const auto& it : m_blocks)
     delete it.second;
   m_blocks.clear();
+  m_unresolved_links.clear();
+  ClearBlockLUT();
 #ifdef WITH_RECOMPILER
+  m_host_code_to_backpatch_info.clear();
   m_code_buffer->Reset();
+
+  // The ASM functions live in the code buffer too.
+  m_asm_functions->Generate(m_code_buffer.get());
 #endif
 }
 
@@ -180,13 +340,23 @@ CodeBlockKey CodeCache::GetNextBlockKey() const
 
 CodeBlock* CodeCache::LookupBlock(CodeBlockKey key)
 {
+  CodeBlock* lut_block = LookupBlockInLUT(key);
+  if (lut_block && (!lut_block->invalidated || RevalidateBlock(lut_block)))
+    return lut_block;
+
   BlockMap::iterator iter = m_blocks.find(key.bits);
   if (iter != m_blocks.end())
   {
     // ensure it hasn't been invalidated
     CodeBlock* existing_block = iter->second;
     if (!existing_block || !existing_block->invalidated || RevalidateBlock(existing_block))
+    {
+      // the lookup table can only hold one segment's block for each address
+      if (existing_block)
+        AddBlockToLUT(existing_block);
+
       return existing_block;
+    }
   }
 
   CodeBlock* block = new CodeBlock(key);
@@ -194,6 +364,8 @@ CodeBlock* CodeCache::LookupBlock(CodeBlockKey key)
   {
     // add it to the page map if it's in ram
     AddBlockToPageMap(block);
+    AddBlockToLUT(block);
+    LinkBlockExits(block);
   }
   else
   {
@@ -224,6 +396,7 @@ bool CodeCache::RevalidateBlock(CodeBlock* block)
   // re-add it to the page map since it's still up-to-date
   block->invalidated = false;
   AddBlockToPageMap(block);
+  LinkBlockExits(block);
   return true;
 
 recompile:
@@ -236,9 +409,10 @@ recompile:
   }
 
   // re-add to page map again
-  if (block->IsInRAM())
-    AddBlockToPageMap(block);
+  block->invalidated = false;
+  AddBlockToPageMap(block);
 
+  LinkBlockExits(block);
   return true;
 }
 
@@ -315,61 +489,174 @@ bool CodeCache::CompileBlock(CodeBlock* block)
     return false;
   }
 
+  AnalyzeIdleLoop(block);
+
+  if (m_use_threaded_interpreter)
+    ThreadedInterpreter::DecodeBlock(block);
+
 #ifdef WITH_RECOMPILER
   if (m_use_recompiler)
   {
     // Ensure we're not going to run out of space while compiling this block.
-    if (m_code_buffer->GetFreeCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_NEAR_HOST_BYTES_PER_INSTRUCTION) ||
-        m_code_buffer->GetFreeFarCodeSpace() <
-          (block->instructions.size() * Recompiler::MAX_FAR_HOST_BYTES_PER_INSTRUCTION))
+    if (!HasCodeSpaceForBlock(m_code_buffer.get(), *block))
     {
       Log_WarningPrintf("Out of code space, flushing all blocks.");
       Flush();
     }
 
-    Recompiler::CodeGenerator codegen(m_core, m_code_buffer.get(), *m_asm_functions.get());
+    // Any previous host code for this block is gone, so it can't fault or be linked to anymore.
+    RemoveBlockBackpatchInfo(block);
+    UnlinkBlock(block);
+    RemoveUnresolvedLinks(block);
+    block->exit_links.clear();
+
+    Recompiler::CodeGenerator codegen(m_core, this, m_code_buffer.get(), *m_asm_functions.get());
     if (!codegen.CompileBlock(block, &block->host_code, &block->host_code_size))
     {
       Log_ErrorPrintf("Failed to compile host code for block at 0x%08X", block->key.GetPC());
       return false;
     }
+
+    for (const LoadStoreBackpatchInfo& lbi : block->loadstore_backpatch_info)
+      m_host_code_to_backpatch_info.emplace(lbi.host_pc, lbi);
   }
 #endif
 
   return true;
 }
 
-void CodeCache::InvalidateBlocksWithPageIndex(u32 page_index)
+void CodeCache::InvalidateBlocksInRange(u32 page_index, PhysicalMemoryAddress address, u32 size)
 {
   DebugAssert(page_index < CPU_CODE_CACHE_PAGE_COUNT);
+  m_invalidation_stats.code_page_writes++;
+
+  // Data which shares a page with code doesn't need to go through the block list.
+  if ((m_ram_code_subpage_masks[page_index] & GetCodeSubPageMask(page_index, address, size)) == 0)
+  {
+    m_invalidation_stats.writes_ignored++;
+    return;
+  }
+
+  // Invalidated blocks are removed from the list, and the next block moves down into their place.
   auto& blocks = m_ram_block_map[page_index];
-  for (CodeBlock* block : blocks)
+  for (size_t i = 0; i < blocks.size();)
   {
-    // Invalidate forces the block to be checked again.
-    Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
-    block->invalidated = true;
+    CodeBlock* block = blocks[i];
+    const PhysicalMemoryAddress block_start = block->key.GetPCPhysicalAddress();
+    if (address >= (block_start + block->GetSizeInBytes()) || (address + size) <= block_start)
+    {
+      m_invalidation_stats.blocks_spared++;
+      i++;
+      continue;
+    }
+
+    InvalidateBlock(block);
+    m_invalidation_stats.blocks_invalidated++;
   }
+}
+
+void CodeCache::InvalidateBlock(CodeBlock* block)
+{
+  // Invalidate forces the block to be checked again. It'll be re-added to the page map when it is.
+  Log_DebugPrintf("Invalidating block at 0x%08X", block->GetPC());
+  block->invalidated = true;
+  RemoveBlockFromPageMap(block);
 
-  // Block will be re-added next execution.
-  blocks.clear();
-  m_bus->ClearRAMCodePage(page_index);
+  // Other blocks can't jump straight to it until it's been checked.
+  UnlinkBlock(block);
+}
+
+u32 CodeCache::GetCodeSubPageMask(u32 page_index, PhysicalMemoryAddress address, u32 size)
+{
+  const u32 page_start = page_index * CPU_CODE_CACHE_PAGE_SIZE;
+  const u32 start = std::max(address, page_start) - page_start;
+  const u32 end = std::min(address + size, page_start + CPU_CODE_CACHE_PAGE_SIZE) - page_start;
+  if (end <= start)
+    return 0;
+
+  const u32 first_subpage = start / CODE_SUBPAGE_SIZE;
+  const u32 last_subpage = (end - 1) / CODE_SUBPAGE_SIZE;
+  return (UINT32_C(0xFFFFFFFF) >> (31 - last_subpage)) & (UINT32_C(0xFFFFFFFF) << first_subpage);
 }
 
 void CodeCache::FlushBlock(CodeBlock* block)
 {
-  BlockMap::iterator iter = m_blocks.find(block->key.GetPC());
+  BlockMap::iterator iter = m_blocks.find(block->key.bits);
   Assert(iter != m_blocks.end() && iter->second == block);
   Log_DevPrintf("Flushing block at address 0x%08X", block->GetPC());
 
   // if it's been invalidated it won't be in the page map
-  if (block->invalidated)
+  if (!block->invalidated)
     RemoveBlockFromPageMap(block);
 
+  RemoveBlockFromLUT(block);
+  RemoveBlockBackpatchInfo(block);
+  UnlinkBlock(block);
+  RemoveUnresolvedLinks(block);
+
+  if (m_idle_loop_block == block)
+    m_idle_loop_block = nullptr;
+
   m_blocks.erase(iter);
   delete block;
 }
 
+u32 CodeCache::GetBlockLUTPageIndex(CodeBlockKey key)
+{
+  const PhysicalMemoryAddress phys_addr = key.GetPCPhysicalAddress();
+  const u32 mode_base = key.user_mode ? BLOCK_LUT_PAGES_PER_MODE : 0;
+  if (phys_addr < Bus::RAM_MIRROR_END)
+    return mode_base + ((phys_addr & Bus::RAM_MASK) >> BLOCK_LUT_PAGE_SHIFT);
+  else if (phys_addr >= Bus::BIOS_BASE && phys_addr < (Bus::BIOS_BASE + Bus::BIOS_SIZE))
+    return mode_base + BLOCK_LUT_RAM_PAGES + ((phys_addr - Bus::BIOS_BASE) >> BLOCK_LUT_PAGE_SHIFT);
+  else
+    return BLOCK_LUT_PAGE_COUNT;
+}
+
+CodeBlock* CodeCache::LookupBlockInLUT(CodeBlockKey key) const
+{
+  const u32 page_index = GetBlockLUTPageIndex(key);
+  if (page_index == BLOCK_LUT_PAGE_COUNT || !m_block_lut[page_index])
+    return nullptr;
+
+  // mirrors and segments share entries, so the key has to be checked
+  CodeBlock* block = m_block_lut[page_index][(key.GetPC() & BLOCK_LUT_PAGE_MASK) / sizeof(u32)];
+  return (block && block->key == key) ? block : nullptr;
+}
+
+void CodeCache::AddBlockToLUT(CodeBlock* block)
+{
+  const u32 page_index = GetBlockLUTPageIndex(block->key);
+  if (page_index == BLOCK_LUT_PAGE_COUNT)
+    return;
+
+  CodeBlock**& page = m_block_lut[page_index];
+  if (!page)
+    page = new CodeBlock*[BLOCK_LUT_ENTRIES_PER_PAGE]();
+
+  page[(block->GetPC() & BLOCK_LUT_PAGE_MASK) / sizeof(u32)] = block;
+}
+
+void CodeCache::RemoveBlockFromLUT(CodeBlock* block)
+{
+  const u32 page_index = GetBlockLUTPageIndex(block->key);
+  if (page_index == BLOCK_LUT_PAGE_COUNT || !m_block_lut[page_index])
+    return;
+
+  CodeBlock*& entry = m_block_lut[page_index][(block->GetPC() & BLOCK_LUT_PAGE_MASK) / sizeof(u32)];
+  if (entry == block)
+    entry = nullptr;
+}
+
+void CodeCache::ClearBlockLUT()
+{
+  for (CodeBlock** page : m_block_lut)
+  {
+    if (page)
+      std::fill_n(page, BLOCK_LUT_ENTRIES_PER_PAGE, nullptr);
+  }
+}
+
 void CodeCache::AddBlockToPageMap(CodeBlock* block)
 {
   if (!block->IsInRAM())
@@ -380,6 +667,8 @@ void CodeCache::AddBlockToPageMap(CodeBlock* block)
   for (u32 page = start_page; page <= end_page; page++)
   {
     m_ram_block_map[page].push_back(block);
+    m_ram_code_subpage_masks[page] |=
+      GetCodeSubPageMask(page, block->key.GetPCPhysicalAddress(), block->GetSizeInBytes());
     m_bus->SetRAMCodePage(page);
   }
 }
@@ -397,12 +686,42 @@ void CodeCache::RemoveBlockFromPageMap(CodeBlock* block)
     auto page_block_iter = std::find(page_blocks.begin(), page_blocks.end(), block);
     Assert(page_block_iter != page_blocks.end());
     page_blocks.erase(page_block_iter);
+
+    u32 subpage_mask = 0;
+    for (const CodeBlock* page_block : page_blocks)
+    {
+      subpage_mask |=
+        GetCodeSubPageMask(page, page_block->key.GetPCPhysicalAddress(), page_block->GetSizeInBytes());
+    }
+    m_ram_code_subpage_masks[page] = subpage_mask;
+
+    // writes no longer need to be tracked once there's no code left on the page
+    if (page_blocks.empty())
+      m_bus->ClearRAMCodePage(page);
   }
 }
 
 void CodeCache::LinkBlock(CodeBlock* from, CodeBlock* to)
 {
   Log_DebugPrintf("Linking block %p(%08x) to %p(%08x)", from, from->GetPC(), to, to->GetPC());
+
+#ifdef WITH_RECOMPILER
+  if (m_use_recompiler && !m_block_executed_callback && from->key.user_mode == to->key.user_mode)
+  {
+    for (BlockLinkInfo& li : from->exit_links)
+    {
+      if (li.pc == to->GetPC() && !li.linked_block)
+      {
+        Recompiler::CodeGenerator::PatchBlockLink(li, reinterpret_cast<const void*>(to->host_code));
+        li.linked_block = to;
+      }
+    }
+  }
+#endif
+
+  if (std::find(from->link_successors.begin(), from->link_successors.end(), to) != from->link_successors.end())
+    return;
+
   from->link_successors.push_back(to);
   to->link_predecessors.push_back(from);
 }
@@ -414,6 +733,26 @@ void CodeCache::UnlinkBlock(CodeBlock* block)
     auto iter = std::find(predecessor->link_successors.begin(), predecessor->link_successors.end(), block);
     Assert(iter != predecessor->link_successors.end());
     predecessor->link_successors.erase(iter);
+
+#ifdef WITH_RECOMPILER
+    // relink the predecessor when this block is valid again
+    bool was_linked = false;
+    for (BlockLinkInfo& li : predecessor->exit_links)
+    {
+      if (li.linked_block == block)
+      {
+        Recompiler::CodeGenerator::PatchBlockLink(li, li.host_unlinked_pc);
+        li.linked_block = nullptr;
+        was_linked = true;
+      }
+    }
+    if (was_linked)
+    {
+      auto& waiting_blocks = m_unresolved_links[block->key.bits];
+      if (std::find(waiting_blocks.begin(), waiting_blocks.end(), predecessor) == waiting_blocks.end())
+        waiting_blocks.push_back(predecessor);
+    }
+#endif
   }
   block->link_predecessors.clear();
 
@@ -424,6 +763,318 @@ void CodeCache::UnlinkBlock(CodeBlock* block)
     successor->link_predecessors.erase(iter);
   }
   block->link_successors.clear();
+
+#ifdef WITH_RECOMPILER
+  for (BlockLinkInfo& li : block->exit_links)
+  {
+    if (li.linked_block)
+    {
+      Recompiler::CodeGenerator::PatchBlockLink(li, li.host_unlinked_pc);
+      li.linked_block = nullptr;
+    }
+  }
+#endif
+}
+
+void CodeCache::LinkBlockExits(CodeBlock* block)
+{
+  for (const BlockLinkInfo& li : block->exit_links)
+  {
+    if (li.linked_block)
+      continue;
+
+    CodeBlockKey key = block->key;
+    key.SetPC(li.pc);
+
+    CodeBlock* target = LookupBlockInLUT(key);
+    if (!target)
+    {
+      auto iter = m_blocks.find(key.bits);
+      if (iter != m_blocks.end())
+        target = iter->second;
+    }
+
+    if (target && !target->invalidated)
+    {
+      LinkBlock(block, target);
+    }
+    else
+    {
+      auto& waiting_blocks = m_unresolved_links[key.bits];
+      if (std::find(waiting_blocks.begin(), waiting_blocks.end(), block) == waiting_blocks.end())
+        waiting_blocks.push_back(block);
+    }
+  }
+
+  auto iter = m_unresolved_links.find(block->key.bits);
+  if (iter == m_unresolved_links.end())
+    return;
+
+  // invalidated blocks will link their exits again when they're revalidated
+  for (CodeBlock* waiting_block : iter->second)
+  {
+    if (!waiting_block->invalidated)
+      LinkBlock(waiting_block, block);
+  }
+  m_unresolved_links.erase(iter);
+}
+
+void CodeCache::RemoveUnresolvedLinks(CodeBlock* block)
+{
+  for (const BlockLinkInfo& li : block->exit_links)
+  {
+    CodeBlockKey key = block->key;
+    key.SetPC(li.pc);
+
+    auto iter = m_unresolved_links.find(key.bits);
+    if (iter == m_unresolved_links.end())
+      continue;
+
+    auto& waiting_blocks = iter->second;
+    waiting_blocks.erase(std::remove(waiting_blocks.begin(), waiting_blocks.end(), block), waiting_blocks.end());
+    if (waiting_blocks.empty())
+      m_unresolved_links.erase(iter);
+  }
+}
+
+void CodeCache::AnalyzeIdleLoop(CodeBlock* block)
+{
+  block->idle_loop_candidate = false;
+  block->idle_loop_runtime_loads.clear();
+  if (m_idle_loop_block == block)
+    m_idle_loop_block = nullptr;
+
+  // The loop has to end with the only branch in the block, and it has to branch back to the start.
+  const u32 instruction_count = static_cast<u32>(block->instructions.size());
+  if (!m_idle_loop_skipping || instruction_count < 2 ||
+      !block->instructions[instruction_count - 2].is_branch_instruction ||
+      block->instructions[instruction_count - 1].is_branch_instruction)
+  {
+    return;
+  }
+
+  const CodeBlockInstruction& branch = block->instructions[instruction_count - 2];
+  const Instruction branch_instruction = branch.instruction;
+  u32 branch_target;
+  switch (branch_instruction.op)
+  {
+    case InstructionOp::j:
+      branch_target = ((branch.pc + 4) & UINT32_C(0xF0000000)) | (branch_instruction.j.target << 2);
+      break;
+
+    case InstructionOp::b:
+      // bltzal/bgezal write ra
+      if ((static_cast<u8>(branch_instruction.i.rt.GetValue()) & u8(0x1E)) == u8(0x10))
+        return;
+
+      branch_target = branch.pc + 4 + (branch_instruction.i.imm_sext32() << 2);
+      break;
+
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+      branch_target = branch.pc + 4 + (branch_instruction.i.imm_sext32() << 2);
+      break;
+
+    default:
+      return;
+  }
+  if (branch_target != block->GetPC())
+    return;
+
+  // Registers written anywhere in the loop can't be used as a load base, unless they're a constant at that point.
+  u32 written_regs = 0;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const Instruction instruction = cbi.instruction;
+    if (instruction.op == InstructionOp::funct)
+      written_regs |= (1u << static_cast<u8>(instruction.r.rd.GetValue()));
+    else if (!cbi.is_branch_instruction)
+      written_regs |= (1u << static_cast<u8>(instruction.i.rt.GetValue()));
+  }
+
+  std::array<u32, 32> constant_values = {};
+  u32 constant_regs = 1u; // zero
+  for (u32 index = 0; index < instruction_count; index++)
+  {
+    const CodeBlockInstruction& cbi = block->instructions[index];
+    const Instruction instruction = cbi.instruction;
+    Reg written_reg = Reg::count;
+    std::optional<u32> written_value;
+    switch (instruction.op)
+    {
+      case InstructionOp::lui:
+        written_reg = instruction.i.rt;
+        written_value = instruction.i.imm_zext32() << 16;
+        break;
+
+      case InstructionOp::addiu:
+      case InstructionOp::andi:
+      case InstructionOp::ori:
+      case InstructionOp::xori:
+      case InstructionOp::slti:
+      case InstructionOp::sltiu:
+      {
+        written_reg = instruction.i.rt;
+
+        // only track what's needed to build addresses
+        const u8 rs = static_cast<u8>(instruction.i.rs.GetValue());
+        if (constant_regs & (1u << rs))
+        {
+          if (instruction.op == InstructionOp::addiu)
+            written_value = constant_values[rs] + instruction.i.imm_sext32();
+          else if (instruction.op == InstructionOp::ori)
+            written_value = constant_values[rs] | instruction.i.imm_zext32();
+        }
+      }
+      break;
+
+      case InstructionOp::lb:
+      case InstructionOp::lbu:
+      case InstructionOp::lh:
+      case InstructionOp::lhu:
+      case InstructionOp::lw:
+      {
+        written_reg = instruction.i.rt;
+
+        const u8 rs = static_cast<u8>(instruction.i.rs.GetValue());
+        if (constant_regs & (1u << rs))
+        {
+          if (!IsIdleLoopLoadAddress(constant_values[rs] + instruction.i.imm_sext32()))
+            return;
+        }
+        else if (written_regs & (1u << rs))
+        {
+          return;
+        }
+        else
+        {
+          block->idle_loop_runtime_loads.push_back(index);
+        }
+      }
+      break;
+
+      case InstructionOp::funct:
+      {
+        switch (instruction.r.funct)
+        {
+          case InstructionFunct::sll:
+          case InstructionFunct::srl:
+          case InstructionFunct::sra:
+          case InstructionFunct::sllv:
+          case InstructionFunct::srlv:
+          case InstructionFunct::srav:
+          case InstructionFunct::mfhi:
+          case InstructionFunct::mflo:
+          case InstructionFunct::addu:
+          case InstructionFunct::subu:
+          case InstructionFunct::and_:
+          case InstructionFunct::or_:
+          case InstructionFunct::xor_:
+          case InstructionFunct::nor:
+          case InstructionFunct::slt:
+          case InstructionFunct::sltu:
+            written_reg = instruction.r.rd;
+            break;
+
+          default:
+            return;
+        }
+      }
+      break;
+
+      case InstructionOp::j:
+      case InstructionOp::b:
+      case InstructionOp::beq:
+      case InstructionOp::bne:
+      case InstructionOp::blez:
+      case InstructionOp::bgtz:
+        // only the final branch, checked above
+        if (&cbi != &branch)
+          return;
+        break;
+
+      default:
+        // stores, calls, coprocessors, add/sub overflow and syscalls all have side effects
+        return;
+    }
+
+    if (written_reg != Reg::count && written_reg != Reg::zero)
+    {
+      const u32 bit = 1u << static_cast<u8>(written_reg);
+      if (written_value.has_value())
+      {
+        constant_values[static_cast<u8>(written_reg)] = written_value.value();
+        constant_regs |= bit;
+      }
+      else
+      {
+        constant_regs &= ~bit;
+      }
+    }
+  }
+
+  Log_DevPrintf("Block at 0x%08X is an idle loop candidate", block->GetPC());
+  block->idle_loop_candidate = true;
+}
+
+bool CodeCache::IsIdleLoopLoadAddress(VirtualMemoryAddress address)
+{
+  // KUSEG, KSEG0 and KSEG1 only, anything else will raise an exception.
+  const u32 segment = address >> 29;
+  if (segment != 0 && segment != 4 && segment != 5)
+    return false;
+
+  // I/O registers such as timers change with time, so they can't be skipped over.
+  const PhysicalMemoryAddress phys_addr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  return (phys_addr < Bus::RAM_MIRROR_END ||
+          (segment != 5 && (phys_addr & Core::DCACHE_LOCATION_MASK) == Core::DCACHE_LOCATION) ||
+          (phys_addr >= Bus::BIOS_BASE && phys_addr < (Bus::BIOS_BASE + Bus::BIOS_SIZE)) ||
+          (phys_addr >= Bus::INTERRUPT_CONTROLLER_BASE && phys_addr < (Bus::INTERRUPT_CONTROLLER_BASE + 8)));
+}
+
+void CodeCache::CheckIdleLoop(CodeBlock* block)
+{
+  const Registers& regs = m_core->m_regs;
+  if (regs.pc != block->GetPC())
+  {
+    // left the loop
+    m_idle_loop_block = nullptr;
+    return;
+  }
+
+  for (const u32 index : block->idle_loop_runtime_loads)
+  {
+    const Instruction instruction = block->instructions[index].instruction;
+    if (!IsIdleLoopLoadAddress(regs.r[static_cast<u8>(instruction.i.rs.GetValue())] + instruction.i.imm_sext32()))
+    {
+      m_idle_loop_block = nullptr;
+      return;
+    }
+  }
+
+  // The loop only reads memory, which can only change when an event runs or an interrupt is serviced. So if an
+  // iteration didn't change any registers, none of the following iterations will either.
+  if (m_idle_loop_block != block ||
+      std::memcmp(&regs, &m_idle_loop_regs, offsetof(Registers, pc)) != 0 ||
+      m_core->m_load_delay_reg != m_idle_loop_load_delay_reg ||
+      m_core->m_load_delay_value != m_idle_loop_load_delay_value)
+  {
+    m_idle_loop_block = block;
+    m_idle_loop_regs = regs;
+    m_idle_loop_load_delay_reg = m_core->m_load_delay_reg;
+    m_idle_loop_load_delay_value = m_core->m_load_delay_value;
+    return;
+  }
+
+  // pending interrupts are dispatched straight after this block
+  const TickCount skipped_ticks = m_core->m_downcount - m_core->m_pending_ticks;
+  if (skipped_ticks <= 0 || m_core->IsInterruptPending())
+    return;
+
+  m_core->m_pending_ticks = m_core->m_downcount;
+  m_idle_loop_skipped_ticks += skipped_ticks;
 }
 
 void CodeCache::InterpretCachedBlock(const CodeBlock& block)
@@ -504,4 +1155,107 @@ void CodeCache::InterpretUncachedBlock()
   }
 }
 
+void CodeCache::UpdateFastmemState()
+{
+#ifdef WITH_RECOMPILER
+  const bool enable = (m_use_recompiler && m_use_fastmem);
+  if (enable == (m_core->m_fastmem_base != nullptr))
+    return;
+
+  if (!enable)
+  {
+    Log_InfoPrint("Disabling fastmem");
+    m_core->m_fastmem_base = nullptr;
+    m_bus->UpdateFastmemViews(false, false);
+    if (m_fastmem_handler_installed)
+    {
+      Common::PageFaultHandler::RemoveHandler(this);
+      m_fastmem_handler_installed = false;
+    }
+
+    return;
+  }
+
+  if (!m_bus->UpdateFastmemViews(true, m_core->m_cop0_regs.sr.Isc))
+  {
+    Log_ErrorPrint("Failed to map fastmem region, falling back to slow memory access");
+    return;
+  }
+
+  if (!m_fastmem_handler_installed)
+  {
+    if (!Common::PageFaultHandler::InstallHandler(this, &CodeCache::PageFaultHandler))
+    {
+      Log_ErrorPrint("Failed to install page fault handler, falling back to slow memory access");
+      m_bus->UpdateFastmemViews(false, false);
+      return;
+    }
+
+    m_fastmem_handler_installed = true;
+  }
+
+  Log_InfoPrintf("Fastmem enabled, base %p", m_bus->GetFastmemBase());
+  m_core->m_fastmem_base = m_bus->GetFastmemBase();
+#endif
+}
+
+void CodeCache::RemoveBlockBackpatchInfo(CodeBlock* block)
+{
+  for (const LoadStoreBackpatchInfo& lbi : block->loadstore_backpatch_info)
+    m_host_code_to_backpatch_info.erase(lbi.host_pc);
+
+  block->loadstore_backpatch_info.clear();
+}
+
+Common::PageFaultHandler::HandlerResult CodeCache::PageFaultHandler(void* context, void* exception_pc,
+                                                                    void* fault_address)
+{
+  return static_cast<CodeCache*>(context)->HandleFastmemException(exception_pc, fault_address);
+}
+
+Common::PageFaultHandler::HandlerResult CodeCache::HandleFastmemException(void* exception_pc, void* fault_address)
+{
+#ifdef WITH_RECOMPILER
+  u8* const fastmem_base = m_core->m_fastmem_base;
+  u8* const fault_ptr = static_cast<u8*>(fault_address);
+  if (!fastmem_base || fault_ptr < fastmem_base ||
+      static_cast<u64>(fault_ptr - fastmem_base) >= Bus::FASTMEM_REGION_SIZE)
+  {
+    return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+  }
+
+  auto iter = m_host_code_to_backpatch_info.find(exception_pc);
+  if (iter == m_host_code_to_backpatch_info.end())
+    return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+
+  const VirtualMemoryAddress address = static_cast<VirtualMemoryAddress>(fault_ptr - fastmem_base);
+  const LoadStoreBackpatchInfo& lbi = iter->second;
+
+  // Stores to RAM only fault when the page contains code. Invalidating it makes the page writable again, but that
+  // throws away all the code in the host page. Stores to data next to code go down the slow path instead, which only
+  // invalidates the blocks which are actually written.
+  const PhysicalMemoryAddress phys_addr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (lbi.is_store && Bus::IsRAMAddress(phys_addr))
+  {
+    const u32 ram_offset = phys_addr & Bus::RAM_MASK;
+    const u32 page_index = ram_offset / CPU_CODE_CACHE_PAGE_SIZE;
+    if ((m_ram_code_subpage_masks[page_index] & GetCodeSubPageMask(page_index, ram_offset, sizeof(u32))) != 0 &&
+        m_bus->HandleFastmemCodeWrite(address))
+    {
+      Log_DevPrintf("Fastmem store to code page at 0x%08X (host pc %p)", address, exception_pc);
+      return Common::PageFaultHandler::HandlerResult::ContinueExecution;
+    }
+  }
+
+  // Anything else isn't RAM, so send this load/store down the slow path from now on.
+  Log_DevPrintf("Backpatching %s at %p (address 0x%08X) to slowmem", lbi.is_store ? "store" : "load", exception_pc,
+                address);
+  Recompiler::CodeGenerator::BackpatchLoadStore(lbi);
+  m_host_code_to_backpatch_info.erase(iter);
+  return Common::PageFaultHandler::HandlerResult::ContinueExecution;
+#else
+  return Common::PageFaultHandler::HandlerResult::ExecuteNextHandler;
+#endif
+}
+
 } // namespace CPU
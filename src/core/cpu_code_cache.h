@@ -1,7 +1,9 @@
 #pragma once
 #include "common/bitfield.h"
+#include "common/page_fault_handler.h"
 #include "cpu_types.h"
 #include <array>
+#include <functional>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -56,6 +58,41 @@ struct CodeBlockInstruction
   bool can_trap : 1;
 };
 
+/// Instruction with its operands extracted ahead of time, executed by calling the handler.
+struct ThreadedInstruction
+{
+  using Handler = void (*)(Core* cpu, const ThreadedInstruction& ti);
+
+  Handler handler;
+  Instruction instruction;
+  u32 pc;
+  u32 imm; // extended immediate, shift amount, or branch target
+  u8 rs;
+  u8 rt;
+  u8 rd;
+  bool is_branch_delay_slot;
+};
+
+/// Location of a fastmem load/store in host code, used to rewrite it to the slow path if it faults.
+struct LoadStoreBackpatchInfo
+{
+  void* host_pc;         // pointer to the faulting instruction
+  void* host_slowmem_pc; // pointer to the slow path code, in the far code region
+  u32 host_code_size;    // size of the fastmem sequence which can be overwritten
+  bool is_store;
+};
+
+struct CodeBlock;
+
+/// Patchable jump at the end of a block's host code, taken when the next PC matches and nothing needs servicing.
+struct BlockLinkInfo
+{
+  u32 pc;                   // guest pc the jump is taken for
+  void* host_jump_pc;       // pointer to the jump instruction
+  void* host_unlinked_pc;   // target of the jump when it's not linked, i.e. the block exit
+  CodeBlock* linked_block;  // block the jump currently goes to, if any
+};
+
 struct CodeBlock
 {
   using HostCodePointer = void (*)(Core*);
@@ -67,10 +104,17 @@ struct CodeBlock
   HostCodePointer host_code = nullptr;
 
   std::vector<CodeBlockInstruction> instructions;
+  std::vector<ThreadedInstruction> threaded_instructions;
   std::vector<CodeBlock*> link_predecessors;
   std::vector<CodeBlock*> link_successors;
+  std::vector<LoadStoreBackpatchInfo> loadstore_backpatch_info;
+  std::vector<BlockLinkInfo> exit_links;
+
+  // loads in an idle loop candidate whose address depends on registers from outside the block
+  std::vector<u32> idle_loop_runtime_loads;
 
   bool invalidated = false;
+  bool idle_loop_candidate = false;
 
   const u32 GetPC() const { return key.GetPC(); }
   const u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
@@ -89,20 +133,72 @@ struct CodeBlock
 class CodeCache
 {
 public:
+  /// Blocks in RAM and BIOS are also found through a flat table, indexed by mode and 4KB physical page, then by
+  /// instruction within the page. Pages of the table are allocated when the first block in them is compiled.
+  static constexpr u32 BLOCK_LUT_PAGE_SHIFT = 12;
+  static constexpr u32 BLOCK_LUT_PAGE_MASK = (1u << BLOCK_LUT_PAGE_SHIFT) - 1;
+  static constexpr u32 BLOCK_LUT_ENTRIES_PER_PAGE = (1u << BLOCK_LUT_PAGE_SHIFT) / sizeof(u32);
+  static constexpr u32 BLOCK_LUT_RAM_PAGES = 0x200000 >> BLOCK_LUT_PAGE_SHIFT;
+  static constexpr u32 BLOCK_LUT_BIOS_PAGES = 0x80000 >> BLOCK_LUT_PAGE_SHIFT;
+  static constexpr u32 BLOCK_LUT_PAGES_PER_MODE = BLOCK_LUT_RAM_PAGES + BLOCK_LUT_BIOS_PAGES;
+  static constexpr u32 BLOCK_LUT_PAGE_COUNT = BLOCK_LUT_PAGES_PER_MODE * 2;
+
+  using BlockLUT = std::array<CodeBlock**, BLOCK_LUT_PAGE_COUNT>;
+
+  /// Code pages are split into 32 sub-pages, so writes to data next to code don't invalidate every block on the page.
+  static constexpr u32 CODE_SUBPAGE_SIZE = CPU_CODE_CACHE_PAGE_SIZE / 32;
+
+  struct InvalidationStats
+  {
+    u32 code_page_writes;   // writes to RAM pages containing code
+    u32 writes_ignored;     // writes to code pages which didn't overlap any code
+    u32 blocks_invalidated; // blocks overlapping a written range
+    u32 blocks_spared;      // blocks on a written code page which didn't overlap the written range
+  };
+
   CodeCache();
   ~CodeCache();
 
-  void Initialize(System* system, Core* core, Bus* bus, bool use_recompiler);
+  void Initialize(System* system, Core* core, Bus* bus, CPUExecutionMode execution_mode, bool use_fastmem,
+                  bool idle_loop_skipping);
   void Execute();
 
   /// Flushes the code cache, forcing all blocks to be recompiled.
   void Flush();
 
-  /// Changes whether the recompiler is enabled.
-  void SetUseRecompiler(bool enable);
+  /// Changes how blocks are executed, i.e. cached interpreter, threaded interpreter or recompiler.
+  void SetExecutionMode(CPUExecutionMode mode);
+
+  /// Changes whether the recompiler accesses RAM directly through the fastmem region.
+  void SetUseFastmem(bool enable);
+
+  /// Changes whether loops which are waiting for an event are skipped over.
+  void SetIdleLoopSkipping(bool enable);
+
+  /// Calls the function after each block executes, including blocks which are chained to from other blocks. Used for
+  /// lockstep testing.
+  using BlockExecutedCallback = std::function<void(const CodeBlock& block)>;
+  void SetBlockExecutedCallback(BlockExecutedCallback callback);
+  bool HasBlockExecutedCallback() const { return static_cast<bool>(m_block_executed_callback); }
+  void CallBlockExecutedCallback(const CodeBlock& block) { m_block_executed_callback(block); }
+
+  /// Recompiles the instructions as a standalone block at the current PC and executes it once, without looking up or
+  /// caching the block. Used by the lockstep tester to compare single instructions against the interpreter. Returns
+  /// false if the recompiler isn't in use, or the block failed to compile.
+  bool RecompileAndExecuteInstructions(const Instruction* instructions, u32 count);
 
-  /// Invalidates all blocks which are in the range of the specified code page.
-  void InvalidateBlocksWithPageIndex(u32 page_index);
+  /// Called after an idle loop candidate executes. Skips to the downcount if the loop can't make any progress.
+  void CheckIdleLoop(CodeBlock* block);
+
+  /// Returns the number of cycles skipped in idle loops since the last reset.
+  TickCount GetIdleLoopSkippedTicks() const { return m_idle_loop_skipped_ticks; }
+  void ResetIdleLoopSkippedTicks() { m_idle_loop_skipped_ticks = 0; }
+
+  /// Invalidates the blocks on the specified code page which overlap the written RAM range.
+  void InvalidateBlocksInRange(u32 page_index, PhysicalMemoryAddress address, u32 size);
+
+  /// Returns counters for self-modifying code invalidation.
+  const InvalidationStats& GetInvalidationStats() const { return m_invalidation_stats; }
 
 private:
   using BlockMap = std::unordered_map<u32, CodeBlock*>;
@@ -115,6 +211,15 @@ private:
   /// Looks up the block in the cache if it's already been compiled.
   CodeBlock* LookupBlock(CodeBlockKey key);
 
+  /// Returns the index of the block lookup table page for the key, or BLOCK_LUT_PAGE_COUNT if it's not RAM/BIOS.
+  static u32 GetBlockLUTPageIndex(CodeBlockKey key);
+
+  /// Fast path of LookupBlock(), only checks the flat lookup table.
+  CodeBlock* LookupBlockInLUT(CodeBlockKey key) const;
+  void AddBlockToLUT(CodeBlock* block);
+  void RemoveBlockFromLUT(CodeBlock* block);
+  void ClearBlockLUT();
+
   /// Can the current block execute? This will re-validate the block if necessary.
   /// The block can also be flushed if recompilation failed, so ignore the pointer if false is returned.
   bool RevalidateBlock(CodeBlock* block);
@@ -124,15 +229,43 @@ private:
   void AddBlockToPageMap(CodeBlock* block);
   void RemoveBlockFromPageMap(CodeBlock* block);
 
-  /// Link block from to to.
+  /// Marks the block as needing to be checked before it runs again, and stops tracking writes to it.
+  void InvalidateBlock(CodeBlock* block);
+
+  /// Returns the sub-page bits of a code page which overlap the RAM range.
+  static u32 GetCodeSubPageMask(u32 page_index, PhysicalMemoryAddress address, u32 size);
+
+  /// Link block from to to. If from has an exit for to's PC, it is patched to jump straight to to's host code.
   void LinkBlock(CodeBlock* from, CodeBlock* to);
 
   /// Unlink all blocks which point to this block, and any that this block links to.
   void UnlinkBlock(CodeBlock* block);
 
+  /// Links the exits of a newly compiled or revalidated block, and any blocks which were waiting for it.
+  void LinkBlockExits(CodeBlock* block);
+
+  /// Removes the block from the lists of blocks waiting for their exits to be compiled.
+  void RemoveUnresolvedLinks(CodeBlock* block);
+
+  /// Checks whether the block is a loop which polls memory without side effects, and can be skipped when idle.
+  void AnalyzeIdleLoop(CodeBlock* block);
+
+  /// Returns true if reading the address doesn't have side effects, and its value only changes from events.
+  static bool IsIdleLoopLoadAddress(VirtualMemoryAddress address);
+
   void InterpretCachedBlock(const CodeBlock& block);
   void InterpretUncachedBlock();
 
+  /// Enables or disables fastmem depending on whether the recompiler is in use.
+  void UpdateFastmemState();
+
+  /// Forgets the fastmem loads/stores of a block, call before its host code is discarded.
+  void RemoveBlockBackpatchInfo(CodeBlock* block);
+
+  static Common::PageFaultHandler::HandlerResult PageFaultHandler(void* context, void* exception_pc,
+                                                                  void* fault_address);
+  Common::PageFaultHandler::HandlerResult HandleFastmemException(void* exception_pc, void* fault_address);
+
   System* m_system = nullptr;
   Core* m_core = nullptr;
   Bus* m_bus = nullptr;
@@ -143,10 +276,34 @@ private:
 #endif
 
   BlockMap m_blocks;
+  BlockLUT m_block_lut = {};
+
+  // blocks with exits to a block key which isn't compiled/valid yet
+  std::unordered_map<u32, std::vector<CodeBlock*>> m_unresolved_links;
 
   bool m_use_recompiler = false;
+  bool m_use_threaded_interpreter = false;
+  bool m_use_fastmem = false;
+  bool m_fastmem_handler_installed = false;
+  bool m_idle_loop_skipping = false;
+
+  BlockExecutedCallback m_block_executed_callback;
+
+  // state of the cpu after the last execution of an idle loop candidate, to see if the loop made progress
+  const CodeBlock* m_idle_loop_block = nullptr;
+  Registers m_idle_loop_regs = {};
+  Reg m_idle_loop_load_delay_reg = Reg::count;
+  u32 m_idle_loop_load_delay_value = 0;
+  TickCount m_idle_loop_skipped_ticks = 0;
+
+  std::unordered_map<void*, LoadStoreBackpatchInfo> m_host_code_to_backpatch_info;
 
   std::array<std::vector<CodeBlock*>, CPU_CODE_CACHE_PAGE_COUNT> m_ram_block_map;
+
+  // which sub-pages of each code page are covered by blocks
+  std::array<u32, CPU_CODE_CACHE_PAGE_COUNT> m_ram_code_subpage_masks = {};
+
+  InvalidationStats m_invalidation_stats = {};
 };
 
 } // namespace CPU
\ No newline at end of file
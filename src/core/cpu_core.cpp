@@ -67,6 +67,9 @@ void Core::Reset()
 
   m_cop2.Reset();
 
+  if (m_fastmem_base)
+    UpdateFastmemViews();
+
   SetPC(RESET_VECTOR);
 }
 
@@ -105,6 +108,9 @@ bool Core::DoState(StateWrapper& sw)
   if (!m_cop2.DoState(sw))
     return false;
 
+  if (sw.IsReading() && m_fastmem_base)
+    UpdateFastmemViews();
+
   return !sw.HasError();
 }
 
@@ -340,9 +346,7 @@ void Core::ClearExternalInterrupt(u8 bit)
 
 bool Core::HasPendingInterrupt()
 {
-  // const bool do_interrupt = m_cop0_regs.sr.IEc && ((m_cop0_regs.cause.Ip & m_cop0_regs.sr.Im) != 0);
-  const bool do_interrupt =
-    m_cop0_regs.sr.IEc && (((m_cop0_regs.cause.bits & m_cop0_regs.sr.bits) & (UINT32_C(0xFF) << 8)) != 0);
+  const bool do_interrupt = IsInterruptPending();
 
   const bool interrupt_delay = m_interrupt_delay;
   m_interrupt_delay = false;
@@ -509,6 +513,9 @@ void Core::WriteCop0Reg(Cop0Reg reg, u32 value)
       m_cop0_regs.sr.bits =
         (m_cop0_regs.sr.bits & ~Cop0Registers::SR::WRITE_MASK) | (value & Cop0Registers::SR::WRITE_MASK);
       Log_DebugPrintf("COP0 SR <- %08X (now %08X)", value, m_cop0_regs.sr.bits);
+
+      if (m_fastmem_base)
+        UpdateFastmemViews();
     }
     break;
 
@@ -526,6 +533,12 @@ void Core::WriteCop0Reg(Cop0Reg reg, u32 value)
   }
 }
 
+void Core::UpdateFastmemViews()
+{
+  DebugAssert(m_fastmem_base);
+  m_bus->UpdateFastmemViews(true, m_cop0_regs.sr.Isc);
+}
+
 void Core::WriteCacheControl(u32 value)
 {
   Log_WarningPrintf("Cache control <- 0x%08X", value);
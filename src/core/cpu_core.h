@@ -14,8 +14,10 @@ class System;
 namespace CPU {
 
 class CodeCache;
+class ThreadedInterpreter;
 
 namespace Recompiler {
+class ASMFunctions;
 class CodeGenerator;
 class Thunks;
 } // namespace Recompiler
@@ -30,6 +32,8 @@ public:
   static constexpr PhysicalMemoryAddress DCACHE_SIZE = UINT32_C(0x00000400);
 
   friend CodeCache;
+  friend ThreadedInterpreter;
+  friend Recompiler::ASMFunctions;
   friend Recompiler::CodeGenerator;
   friend Recompiler::Thunks;
 
@@ -123,6 +127,12 @@ private:
   bool HasPendingInterrupt();
   void DispatchInterrupt();
 
+  // returns true if an interrupt is pending, without consuming the delay after a GTE instruction
+  ALWAYS_INLINE bool IsInterruptPending() const
+  {
+    return m_cop0_regs.sr.IEc && (((m_cop0_regs.cause.bits & m_cop0_regs.sr.bits) & (UINT32_C(0xFF) << 8)) != 0);
+  }
+
   // clears pipeline of load/branch delays
   void FlushPipeline();
 
@@ -140,8 +150,14 @@ private:
   std::optional<u32> ReadCop0Reg(Cop0Reg reg);
   void WriteCop0Reg(Cop0Reg reg, u32 value);
 
+  // remaps the fastmem region after the cache isolation bit changes
+  void UpdateFastmemViews();
+
   Bus* m_bus = nullptr;
 
+  // host address of virtual address zero when fastmem is enabled, otherwise null
+  u8* m_fastmem_base = nullptr;
+
   // ticks the CPU has executed
   TickCount m_pending_ticks = 0;
   TickCount m_downcount = MAX_SLICE_SIZE;
@@ -10,19 +10,28 @@ Log_SetChannel(CPU::Recompiler);
 
 namespace CPU::Recompiler {
 
+static MemoryAccessSize GetMemoryAccessSize(RegSize size)
+{
+  return (size == RegSize_8) ? MemoryAccessSize::Byte :
+                               ((size == RegSize_16) ? MemoryAccessSize::HalfWord : MemoryAccessSize::Word);
+}
+
 u32 CodeGenerator::CalculateRegisterOffset(Reg reg)
 {
   return u32(offsetof(Core, m_regs.r[0]) + (static_cast<u32>(reg) * sizeof(u32)));
 }
 
-bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePointer* out_host_code,
+bool CodeGenerator::CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code,
                                  u32* out_host_code_size)
 {
   // TODO: Align code buffer.
 
   m_block = block;
+  m_use_fastmem = (m_cpu->m_fastmem_base != nullptr);
   m_block_start = block->instructions.data();
   m_block_end = block->instructions.data() + block->instructions.size();
+  m_block_exit_pcs.clear();
+  AnalyzeBlock();
 
   EmitBeginBlock();
   BlockPrologue();
@@ -40,6 +49,7 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
     {
       m_block_end = nullptr;
       m_block_start = nullptr;
+      m_last_exception_instruction = nullptr;
       m_block = nullptr;
       return false;
     }
@@ -48,6 +58,18 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
   }
 
   BlockEpilogue();
+
+  // Idle loops are detected after the branch has updated pc, and skip the block exit straight to the downcount.
+  if (m_block->idle_loop_candidate)
+  {
+    EmitFunctionCall(nullptr, &Thunks::CheckIdleLoop,
+                     Value::FromConstantU64(static_cast<u64>(reinterpret_cast<uintptr_t>(m_code_cache))),
+                     Value::FromConstantU64(static_cast<u64>(reinterpret_cast<uintptr_t>(m_block))));
+  }
+
+  EmitBlockExecutedCallback();
+
+  UpdateBlockExitPCs();
   EmitEndBlock();
 
   FinalizeBlock(out_host_code, out_host_code_size);
@@ -58,6 +80,7 @@ bool CodeGenerator::CompileBlock(const CodeBlock* block, CodeBlock::HostCodePoin
 
   m_block_end = nullptr;
   m_block_start = nullptr;
+  m_last_exception_instruction = nullptr;
   m_block = nullptr;
   return true;
 }
@@ -823,9 +846,101 @@ void CodeGenerator::GenerateExceptionExit(const CodeBlockInstruction& cbi, Excep
   EmitBindLabel(&skip_exception);
 }
 
+void CodeGenerator::UpdateBlockExitPCs()
+{
+  // Blocks which can change the execution mode can't be linked, since the next block's mode isn't known.
+  for (const CodeBlockInstruction* cbi = m_block_start; cbi != m_block_end; cbi++)
+  {
+    if (cbi->instruction.op == InstructionOp::cop0)
+    {
+      m_block_exit_pcs.clear();
+      return;
+    }
+  }
+
+  // Branches record their targets, otherwise the block falls through to the next instruction.
+  const CodeBlockInstruction& last_cbi = *(m_block_end - 1);
+  if (last_cbi.is_branch_instruction)
+    m_block_exit_pcs.clear();
+  else if (!last_cbi.is_branch_delay_slot)
+    m_block_exit_pcs.assign(1, last_cbi.pc + 4);
+}
+
+void CodeGenerator::AnalyzeBlock()
+{
+  m_last_exception_instruction = nullptr;
+  for (const CodeBlockInstruction* cbi = m_block_start; cbi != m_block_end; cbi++)
+  {
+    if (CanInstructionRaiseException(*cbi))
+      m_last_exception_instruction = cbi;
+  }
+}
+
+bool CodeGenerator::CanInstructionRaiseException(const CodeBlockInstruction& cbi)
+{
+  // Anything not listed here goes through a thunk or the interpreter, which can raise an exception.
+  // Branches to misaligned addresses are fine, since they raise the exception with explicit flags.
+  switch (cbi.instruction.op)
+  {
+    case InstructionOp::ori:
+    case InstructionOp::andi:
+    case InstructionOp::xori:
+    case InstructionOp::lui:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::j:
+    case InstructionOp::jal:
+    case InstructionOp::b:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::bgtz:
+    case InstructionOp::blez:
+      return false;
+
+    case InstructionOp::funct:
+    {
+      switch (cbi.instruction.r.funct)
+      {
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::mfhi:
+        case InstructionFunct::mflo:
+        case InstructionFunct::mthi:
+        case InstructionFunct::mtlo:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+        case InstructionFunct::jr:
+        case InstructionFunct::jalr:
+          return false;
+
+        default:
+          return true;
+      }
+    }
+
+    default:
+      return true;
+  }
+}
+
 void CodeGenerator::BlockPrologue()
 {
-  EmitStoreCPUStructField(offsetof(Core, m_exception_raised), Value::FromConstantU8(0));
+  // only the interpreter fallback reads the exception flag
+  if (m_last_exception_instruction)
+    EmitStoreCPUStructField(offsetof(Core, m_exception_raised), Value::FromConstantU8(0));
 
   // we don't know the state of the last block, so assume load delays might be in progress
   // TODO: Pull load delay into register cache
@@ -848,6 +963,18 @@ void CodeGenerator::BlockEpilogue()
   AddPendingCycles(true);
 }
 
+void CodeGenerator::EmitBlockExecutedCallback()
+{
+  // The callback is only set for lockstep testing, and blocks are recompiled when it changes. Calling it from the
+  // block means it still runs when the block is entered through a link or the dispatcher.
+  if (!m_code_cache->HasBlockExecutedCallback())
+    return;
+
+  EmitFunctionCall(nullptr, &Thunks::BlockExecuted,
+                   Value::FromConstantU64(static_cast<u64>(reinterpret_cast<uintptr_t>(m_code_cache))),
+                   Value::FromConstantU64(static_cast<u64>(reinterpret_cast<uintptr_t>(m_block))));
+}
+
 void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles,
                                         bool force_sync /* = false */)
 {
@@ -855,23 +982,31 @@ void CodeGenerator::InstructionPrologue(const CodeBlockInstruction& cbi, TickCou
   m_emit->nop();
 #endif
 
+  // The current instruction flags are only read when raising an exception. If nothing from here to the end of the
+  // block can raise one, they're dead, and the next block will reset them.
+  const bool exception_flags_live = (m_last_exception_instruction && &cbi <= m_last_exception_instruction);
+
   // reset dirty flags
   if (m_branch_was_taken_dirty)
   {
-    Value temp = m_register_cache.AllocateScratch(RegSize_8);
-    EmitLoadCPUStructField(temp.host_reg, RegSize_8, offsetof(Core, m_branch_was_taken));
-    EmitStoreCPUStructField(offsetof(Core, m_current_instruction_was_branch_taken), temp);
+    if (exception_flags_live)
+    {
+      Value temp = m_register_cache.AllocateScratch(RegSize_8);
+      EmitLoadCPUStructField(temp.host_reg, RegSize_8, offsetof(Core, m_branch_was_taken));
+      EmitStoreCPUStructField(offsetof(Core, m_current_instruction_was_branch_taken), temp);
+      m_current_instruction_was_branch_taken_dirty = true;
+    }
+
     EmitStoreCPUStructField(offsetof(Core, m_branch_was_taken), Value::FromConstantU8(0));
-    m_current_instruction_was_branch_taken_dirty = true;
     m_branch_was_taken_dirty = false;
   }
-  else if (m_current_instruction_was_branch_taken_dirty)
+  else if (m_current_instruction_was_branch_taken_dirty && exception_flags_live)
   {
     EmitStoreCPUStructField(offsetof(Core, m_current_instruction_was_branch_taken), Value::FromConstantU8(0));
     m_current_instruction_was_branch_taken_dirty = false;
   }
 
-  if (m_current_instruction_in_branch_delay_slot_dirty && !cbi.is_branch_delay_slot)
+  if (m_current_instruction_in_branch_delay_slot_dirty && !cbi.is_branch_delay_slot && exception_flags_live)
   {
     EmitStoreCPUStructField(offsetof(Core, m_current_instruction_in_branch_delay_slot), Value::FromConstantU8(0));
     m_current_instruction_in_branch_delay_slot_dirty = false;
@@ -937,6 +1072,136 @@ void CodeGenerator::AddPendingCycles(bool commit)
     m_delayed_cycles_add = 0;
 }
 
+bool CodeGenerator::CanUseFastmemForAddress(const Value& address, RegSize size) const
+{
+  if (!m_use_fastmem)
+    return false;
+
+  // Non-constant addresses are assumed to be RAM, and backpatched if they're not.
+  if (!address.IsConstant())
+    return true;
+
+  const VirtualMemoryAddress vaddr = static_cast<VirtualMemoryAddress>(address.constant_value);
+  const u32 alignment_mask = (size == RegSize_32) ? 3u : ((size == RegSize_16) ? 1u : 0u);
+  if ((vaddr & alignment_mask) != 0)
+    return false;
+
+  // Only the RAM mirrors in KUSEG/KSEG0/KSEG1 are mapped.
+  const u32 segment = vaddr >> 29;
+  return ((segment == 0x00 || segment == 0x04 || segment == 0x05) &&
+          (vaddr & PHYSICAL_MEMORY_ADDRESS_MASK) < Bus::RAM_MIRROR_END);
+}
+
+bool CodeGenerator::EmitLoadGuestMemoryConstant(const Value& address, RegSize size, Value* result)
+{
+  const VirtualMemoryAddress vaddr = static_cast<VirtualMemoryAddress>(address.constant_value);
+  const u32 alignment_mask = (size == RegSize_32) ? 3u : ((size == RegSize_16) ? 1u : 0u);
+  const u32 segment = vaddr >> 29;
+  if ((vaddr & alignment_mask) != 0 || (segment != 0x00 && segment != 0x04 && segment != 0x05))
+    return false;
+
+  const PhysicalMemoryAddress phys_addr = vaddr & PHYSICAL_MEMORY_ADDRESS_MASK;
+  if (segment != 0x05 && (phys_addr & Core::DCACHE_LOCATION_MASK) == Core::DCACHE_LOCATION)
+  {
+    // Scratchpad lives in the CPU struct, and doesn't take any cycles.
+    *result = m_register_cache.AllocateScratch(size);
+    EmitLoadCPUStructField(result->host_reg, size,
+                           static_cast<u32>(offsetof(Core, m_dcache)) + (phys_addr & Core::DCACHE_OFFSET_MASK));
+    return true;
+  }
+
+  if (Bus::IsRAMAddress(phys_addr))
+  {
+    // RAM reads don't have side effects, so they can go straight to the host memory.
+    *result = m_register_cache.AllocateScratch(size);
+    EmitLoadGlobal(result->host_reg, size, m_cpu->m_bus->GetRAM() + (phys_addr & Bus::RAM_MASK));
+    m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+    return true;
+  }
+
+  // Registers of devices with fixed timing can be read by calling the handler directly, skipping address decoding.
+  u32 mmio_offset;
+  const Bus::MMIOReadHandler mmio_handler =
+    Bus::GetMMIOReadHandler(GetMemoryAccessSize(size), phys_addr, &mmio_offset);
+  if (mmio_handler)
+  {
+    // Device reads can depend on the current time.
+    AddPendingCycles(true);
+
+    *result = m_register_cache.AllocateScratch(RegSize_32);
+    EmitFunctionCall(result, mmio_handler, Value::FromConstantU64(reinterpret_cast<uintptr_t>(m_cpu->m_bus)),
+                     Value::FromConstantU32(mmio_offset));
+    if (size != RegSize_32)
+      ConvertValueSizeInPlace(result, size, false);
+
+    m_delayed_cycles_add += Bus::MMIO_READ_TICKS;
+    return true;
+  }
+
+  return false;
+}
+
+bool CodeGenerator::EmitStoreGuestMemoryConstant(const Value& address, const Value& value)
+{
+  const VirtualMemoryAddress vaddr = static_cast<VirtualMemoryAddress>(address.constant_value);
+  const u32 alignment_mask = (value.size == RegSize_32) ? 3u : ((value.size == RegSize_16) ? 1u : 0u);
+  const u32 segment = vaddr >> 29;
+  if ((vaddr & alignment_mask) != 0 || (segment != 0x00 && segment != 0x04 && segment != 0x05))
+    return false;
+
+  // RAM stores have to go through the bus, since they can invalidate code.
+  const PhysicalMemoryAddress phys_addr = vaddr & PHYSICAL_MEMORY_ADDRESS_MASK;
+  const bool is_scratchpad = (segment != 0x05 && (phys_addr & Core::DCACHE_LOCATION_MASK) == Core::DCACHE_LOCATION);
+  u32 mmio_offset = 0;
+  const Bus::MMIOWriteHandler mmio_handler =
+    is_scratchpad ? nullptr : Bus::GetMMIOWriteHandler(GetMemoryAccessSize(value.size), phys_addr, &mmio_offset);
+  if (!is_scratchpad && !mmio_handler)
+    return false;
+
+  // Handlers take the value zero-extended to 32 bits.
+  Value hr_value;
+  if (is_scratchpad)
+    hr_value = GetValueInHostRegister(value);
+  else if (value.size != RegSize_32)
+    hr_value = ConvertValueSize(value, RegSize_32, false);
+  else
+    hr_value = value;
+
+  if (mmio_handler)
+  {
+    // Device writes can schedule events relative to the current time.
+    AddPendingCycles(true);
+  }
+
+  // Stores are dropped while the cache is isolated, apart from through KSEG1.
+  // Anything which could allocate a register has to happen before the branch, otherwise it could evict.
+  LabelType skip_store;
+  if (segment != 0x05)
+  {
+    Value sr_value = m_register_cache.AllocateScratch(RegSize_32);
+    EmitLoadCPUStructField(sr_value.host_reg, sr_value.size, offsetof(Core, m_cop0_regs.sr.bits));
+    EmitTest(sr_value.host_reg, Value::FromConstantU32(UINT32_C(1) << 16));
+    sr_value.ReleaseAndClear();
+    EmitConditionalBranch(Condition::NotZero, false, &skip_store);
+  }
+
+  if (is_scratchpad)
+  {
+    EmitStoreCPUStructField(static_cast<u32>(offsetof(Core, m_dcache)) + (phys_addr & Core::DCACHE_OFFSET_MASK),
+                            hr_value);
+  }
+  else
+  {
+    EmitFunctionCall(nullptr, mmio_handler, Value::FromConstantU64(reinterpret_cast<uintptr_t>(m_cpu->m_bus)),
+                     Value::FromConstantU32(mmio_offset), hr_value);
+  }
+
+  if (segment != 0x05)
+    EmitBindLabel(&skip_store);
+
+  return true;
+}
+
 void CodeGenerator::SetCurrentInstructionPC(const CodeBlockInstruction& cbi)
 {
   EmitStoreCPUStructField(offsetof(Core, m_current_instruction_pc), Value::FromConstantU32(cbi.pc));
@@ -1109,30 +1374,34 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
   Value offset = Value::FromConstantU32(cbi.instruction.i.imm_sext32());
   Value address = AddValues(base, offset, false);
 
-  Value result;
+  RegSize size;
+  bool sign_extend = false;
   switch (cbi.instruction.op)
   {
     case InstructionOp::lb:
     case InstructionOp::lbu:
-      result = EmitLoadGuestMemory(cbi, address, RegSize_8);
-      ConvertValueSizeInPlace(&result, RegSize_32, (cbi.instruction.op == InstructionOp::lb));
+      size = RegSize_8;
+      sign_extend = (cbi.instruction.op == InstructionOp::lb);
       break;
 
     case InstructionOp::lh:
     case InstructionOp::lhu:
-      result = EmitLoadGuestMemory(cbi, address, RegSize_16);
-      ConvertValueSizeInPlace(&result, RegSize_32, (cbi.instruction.op == InstructionOp::lh));
+      size = RegSize_16;
+      sign_extend = (cbi.instruction.op == InstructionOp::lh);
       break;
 
     case InstructionOp::lw:
-      result = EmitLoadGuestMemory(cbi, address, RegSize_32);
-      break;
-
     default:
-      UnreachableCode();
+      size = RegSize_32;
       break;
   }
 
+  Value result;
+  if (!address.IsConstant() || !EmitLoadGuestMemoryConstant(address, size, &result))
+    result = EmitLoadGuestMemory(cbi, address, size);
+  if (size != RegSize_32)
+    ConvertValueSizeInPlace(&result, RegSize_32, sign_extend);
+
   m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
 
   InstructionEpilogue(cbi);
@@ -1149,25 +1418,27 @@ bool CodeGenerator::Compile_Store(const CodeBlockInstruction& cbi)
   Value address = AddValues(base, offset, false);
   Value value = m_register_cache.ReadGuestRegister(cbi.instruction.i.rt);
 
+  RegSize size;
   switch (cbi.instruction.op)
   {
     case InstructionOp::sb:
-      EmitStoreGuestMemory(cbi, address, value.ViewAsSize(RegSize_8));
+      size = RegSize_8;
       break;
 
     case InstructionOp::sh:
-      EmitStoreGuestMemory(cbi, address, value.ViewAsSize(RegSize_16));
+      size = RegSize_16;
       break;
 
     case InstructionOp::sw:
-      EmitStoreGuestMemory(cbi, address, value);
-      break;
-
     default:
-      UnreachableCode();
+      size = RegSize_32;
       break;
   }
 
+  const Value store_value = value.ViewAsSize(size);
+  if (!address.IsConstant() || !EmitStoreGuestMemoryConstant(address, store_value))
+    EmitStoreGuestMemory(cbi, address, store_value);
+
   InstructionEpilogue(cbi);
   return true;
 }
@@ -1330,6 +1601,9 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
   InstructionPrologue(cbi, 1);
 
   auto DoBranch = [this](Condition condition, const Value& lhs, const Value& rhs, Reg lr_reg, Value&& branch_target) {
+    // the last branch in the block decides where it exits to
+    m_block_exit_pcs.clear();
+
     // ensure the lr register is flushed, since we want it's correct value after the branch
     // we don't want to invalidate it yet because of "jalr r0, r0", branch_target could be the lr_reg.
     if (lr_reg != Reg::count && lr_reg != Reg::zero)
@@ -1340,10 +1614,15 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
     if (condition != Condition::Always || lr_reg != Reg::count)
     {
       new_pc = AddValues(m_register_cache.ReadGuestRegister(Reg::pc), Value::FromConstantU32(4), false);
+      if (condition != Condition::Always && new_pc.IsConstant())
+        m_block_exit_pcs.push_back(Truncate32(new_pc.constant_value));
       if (!new_pc.IsInHostRegister())
         new_pc = GetValueInHostRegister(new_pc);
     }
 
+    if (branch_target.IsConstant() && (branch_target.constant_value & 0x3) == 0)
+      m_block_exit_pcs.push_back(Truncate32(branch_target.constant_value));
+
     LabelType skip_branch;
     if (condition != Condition::Always)
     {
@@ -1626,6 +1905,12 @@ bool CodeGenerator::Compile_cop0(const CodeBlockInstruction& cbi)
             }
 
             EmitStoreCPUStructField(offset, value);
+
+            if (reg == Cop0Reg::SR && m_use_fastmem)
+            {
+              // the cache isolation bit affects which regions are mapped for fastmem
+              EmitFunctionCall(nullptr, &Thunks::UpdateFastmemViews, m_register_cache.GetCPUPtr());
+            }
           }
         }
 
@@ -1723,7 +2008,8 @@ Value CodeGenerator::DoGTERegisterRead(u32 index)
 
     default:
     {
-      EmitLoadCPUStructField(value.host_reg, RegSize_32, offsetof(Core, m_cop2.m_regs.r32[index]));
+      EmitLoadCPUStructField(value.host_reg, RegSize_32,
+                             static_cast<u32>(offsetof(Core, m_cop2.m_regs.r32[0]) + (index * sizeof(u32))));
     }
     break;
   }
@@ -1752,7 +2038,8 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // sign-extend z component of vector registers
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, true);
-      EmitStoreCPUStructField(offsetof(Core, m_cop2.m_regs.r32[index]), temp);
+      EmitStoreCPUStructField(static_cast<u32>(offsetof(Core, m_cop2.m_regs.r32[0]) + (index * sizeof(u32))),
+                              temp);
       return;
     }
     break;
@@ -1765,7 +2052,8 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     {
       // zero-extend unsigned values
       Value temp = ConvertValueSize(value.ViewAsSize(RegSize_16), RegSize_32, false);
-      EmitStoreCPUStructField(offsetof(Core, m_cop2.m_regs.r32[index]), temp);
+      EmitStoreCPUStructField(static_cast<u32>(offsetof(Core, m_cop2.m_regs.r32[0]) + (index * sizeof(u32))),
+                              temp);
       return;
     }
     break;
@@ -1808,7 +2096,8 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     default:
     {
       // written as-is, 2x16 or 1x32 bits
-      EmitStoreCPUStructField(offsetof(Core, m_cop2.m_regs.r32[index]), value);
+      EmitStoreCPUStructField(static_cast<u32>(offsetof(Core, m_cop2.m_regs.r32[0]) + (index * sizeof(u32))),
+                              value);
       return;
     }
   }
@@ -1877,8 +2166,24 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
     // forward everything to the GTE.
     InstructionPrologue(cbi, 1);
 
-    Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
-    EmitFunctionCall(nullptr, &Thunks::ExecuteGTEInstruction, m_register_cache.GetCPUPtr(), instruction_bits);
+    const GTE::Instruction gte_instruction{cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK};
+    Value instruction_bits = Value::FromConstantU32(gte_instruction.bits);
+
+    // hot commands are emitted inline where the backend supports it, otherwise called directly with the shift/lm bits
+    // already resolved
+    if (!EmitGTEInstruction(gte_instruction))
+    {
+      const GTE::Core::InstructionImpl impl = GTE::Core::GetInstructionImpl(gte_instruction);
+      if (impl)
+      {
+        const Value gte_ptr = Value::FromConstantU64(static_cast<u64>(reinterpret_cast<uintptr_t>(&m_cpu->m_cop2)));
+        EmitFunctionCall(nullptr, impl, gte_ptr, instruction_bits);
+      }
+      else
+      {
+        EmitFunctionCall(nullptr, &Thunks::ExecuteGTEInstruction, m_register_cache.GetCPUPtr(), instruction_bits);
+      }
+    }
 
     InstructionEpilogue(cbi);
     return true;
@@ -10,20 +10,27 @@
 #include "cpu_recompiler_thunks.h"
 #include "cpu_recompiler_types.h"
 #include "cpu_types.h"
+#include "gte_types.h"
 
 namespace CPU::Recompiler {
 
 class CodeGenerator
 {
 public:
-  CodeGenerator(Core* cpu, JitCodeBuffer* code_buffer, const ASMFunctions& asm_functions);
+  CodeGenerator(Core* cpu, CodeCache* code_cache, JitCodeBuffer* code_buffer, const ASMFunctions& asm_functions);
   ~CodeGenerator();
 
   static u32 CalculateRegisterOffset(Reg reg);
   static const char* GetHostRegName(HostReg reg, RegSize size = HostPointerSize);
   static void AlignCodeBuffer(JitCodeBuffer* code_buffer);
 
-  bool CompileBlock(const CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
+  bool CompileBlock(CodeBlock* block, CodeBlock::HostCodePointer* out_host_code, u32* out_host_code_size);
+
+  /// Rewrites a faulting fastmem load/store to jump to its slow path.
+  static void BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi);
+
+  /// Points a block exit jump at the specified host code.
+  static void PatchBlockLink(const BlockLinkInfo& li, const void* target);
 
   //////////////////////////////////////////////////////////////////////////
   // Code Generation
@@ -65,7 +72,24 @@ public:
 
   // Automatically generates an exception handler.
   Value EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size);
+  void EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                  Value& result);
+  void EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                  Value& result, bool in_far_code);
   void EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, const Value& value);
+  void EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, const Value& value,
+                                   Value& result, bool in_far_code);
+
+  // Accesses to constant addresses which can be resolved at compile time. Returns false if the address isn't handled.
+  bool EmitLoadGuestMemoryConstant(const Value& address, RegSize size, Value* result);
+  bool EmitStoreGuestMemoryConstant(const Value& address, const Value& value);
+
+  // Loads from a fixed host address, outside the CPU struct.
+  void EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr);
+
+  // Emits a GTE command inline. Returns false if the command isn't handled, and it should be called instead.
+  bool EmitGTEInstruction(GTE::Instruction inst);
 
   // Unconditional branch to pointer. May allocate a scratch register.
   void EmitBranch(const void* address, bool allow_scratch = true);
@@ -161,11 +185,24 @@ private:
   // branch target, memory address, etc
   void BlockPrologue();
   void BlockEpilogue();
+  void UpdateBlockExitPCs();
   void InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles, bool force_sync = false);
   void InstructionEpilogue(const CodeBlockInstruction& cbi);
   void SetCurrentInstructionPC(const CodeBlockInstruction& cbi);
   void AddPendingCycles(bool commit);
 
+  /// Calls the code cache's block executed callback, if there is one. Must be called with the guest state flushed.
+  void EmitBlockExecutedCallback();
+
+  /// Returns true if the access can go through fastmem, i.e. it may hit RAM.
+  bool CanUseFastmemForAddress(const Value& address, RegSize size) const;
+
+  /// Finds the last instruction in the block which can raise an exception, i.e. read the branch/delay slot flags.
+  void AnalyzeBlock();
+
+  /// Returns true if the instruction can raise an exception through the interpreter's exception state.
+  static bool CanInstructionRaiseException(const CodeBlockInstruction& cbi);
+
   Value DoGTERegisterRead(u32 index);
   void DoGTERegisterWrite(u32 index, const Value& value);
 
@@ -189,17 +226,23 @@ private:
   bool Compile_cop2(const CodeBlockInstruction& cbi);
 
   Core* m_cpu;
+  CodeCache* m_code_cache;
   JitCodeBuffer* m_code_buffer;
   const ASMFunctions& m_asm_functions;
-  const CodeBlock* m_block = nullptr;
+  CodeBlock* m_block = nullptr;
   const CodeBlockInstruction* m_block_start = nullptr;
   const CodeBlockInstruction* m_block_end = nullptr;
+  const CodeBlockInstruction* m_last_exception_instruction = nullptr;
   RegisterCache m_register_cache;
   CodeEmitter m_near_emitter;
   CodeEmitter m_far_emitter;
   CodeEmitter* m_emit;
 
   TickCount m_delayed_cycles_add = 0;
+  bool m_use_fastmem = false;
+
+  // guest pcs the block can exit to, which get patchable jumps to the next block
+  std::vector<u32> m_block_exit_pcs;
 
   // whether various flags need to be reset.
   bool m_current_instruction_in_branch_delay_slot_dirty = false;
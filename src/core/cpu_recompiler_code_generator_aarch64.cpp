@@ -9,6 +9,7 @@ namespace a64 = vixl::aarch64;
 namespace CPU::Recompiler {
 
 constexpr HostReg RCPUPTR = 19;
+constexpr HostReg RMEMBASEPTR = 20;
 constexpr HostReg RRETURN = 0;
 constexpr HostReg RARG1 = 0;
 constexpr HostReg RARG2 = 1;
@@ -70,8 +71,15 @@ static const a64::XRegister GetCPUPtrReg()
   return GetHostReg64(RCPUPTR);
 }
 
-CodeGenerator::CodeGenerator(Core* cpu, JitCodeBuffer* code_buffer, const ASMFunctions& asm_functions)
-  : m_cpu(cpu), m_code_buffer(code_buffer), m_asm_functions(asm_functions), m_register_cache(*this),
+static const a64::XRegister GetFastmemBasePtrReg()
+{
+  return GetHostReg64(RMEMBASEPTR);
+}
+
+CodeGenerator::CodeGenerator(Core* cpu, CodeCache* code_cache, JitCodeBuffer* code_buffer,
+                             const ASMFunctions& asm_functions)
+  : m_cpu(cpu), m_code_cache(code_cache), m_code_buffer(code_buffer), m_asm_functions(asm_functions),
+    m_register_cache(*this),
     m_near_emitter(static_cast<vixl::byte*>(code_buffer->GetFreeCodePointer()), code_buffer->GetFreeCodeSpace(),
                    a64::PositionDependentCode),
     m_far_emitter(static_cast<vixl::byte*>(code_buffer->GetFreeFarCodePointer()), code_buffer->GetFreeFarCodeSpace(),
@@ -172,14 +180,77 @@ void CodeGenerator::EmitBeginBlock()
   const bool cpu_reg_allocated = m_register_cache.AllocateHostReg(RCPUPTR);
   DebugAssert(cpu_reg_allocated);
   m_emit->Mov(GetCPUPtrReg(), GetHostReg64(RARG1));
+
+  // Load the fastmem base pointer.
+  if (m_use_fastmem)
+  {
+    const bool fastmem_reg_allocated = m_register_cache.AllocateHostReg(RMEMBASEPTR);
+    DebugAssert(fastmem_reg_allocated);
+    m_emit->Ldr(GetFastmemBasePtrReg(), a64::MemOperand(GetCPUPtrReg(), offsetof(Core, m_fastmem_base)));
+  }
 }
 
 void CodeGenerator::EmitEndBlock()
 {
+  // Linked blocks are entered with the CPU pointer in the first argument register, as if they were called.
+  const bool link_exits = !m_block_exit_pcs.empty();
+  if (link_exits)
+    m_emit->Mov(GetHostReg64(RARG1), GetCPUPtrReg());
+
+  if (m_use_fastmem)
+    m_register_cache.FreeHostReg(RMEMBASEPTR);
+
   m_register_cache.FreeHostReg(RCPUPTR);
   m_register_cache.PopCalleeSavedRegisters(true);
 
   m_emit->Add(a64::sp, a64::sp, FUNCTION_STACK_SIZE);
+
+  if (link_exits)
+  {
+    const a64::XRegister cpu_reg = GetHostReg64(RARG1);
+    const a64::WRegister temp1 = GetHostReg32(RARG2);
+    const a64::WRegister temp2 = GetHostReg32(RARG3);
+    a64::Label no_interrupt;
+    a64::Label exit_block;
+
+    // if pending_ticks >= downcount then return
+    m_emit->Ldr(temp1, a64::MemOperand(cpu_reg, offsetof(Core, m_pending_ticks)));
+    m_emit->Ldr(temp2, a64::MemOperand(cpu_reg, offsetof(Core, m_downcount)));
+    m_emit->Cmp(temp1, temp2);
+    m_emit->B(a64::ge, &exit_block);
+
+    // Same as Core::HasPendingInterrupt(). Pending interrupts are left for the code cache to dispatch.
+    m_emit->Ldr(temp1, a64::MemOperand(cpu_reg, offsetof(Core, m_cop0_regs.sr.bits)));
+    m_emit->Tbz(temp1, 0, &no_interrupt);
+    m_emit->Ldr(temp2, a64::MemOperand(cpu_reg, offsetof(Core, m_cop0_regs.cause.bits)));
+    m_emit->And(temp1, temp1, temp2);
+    m_emit->Tst(temp1, UINT32_C(0xFF) << 8);
+    m_emit->B(a64::ne, &exit_block);
+    m_emit->Bind(&no_interrupt);
+    m_emit->Strb(a64::wzr, a64::MemOperand(cpu_reg, offsetof(Core, m_interrupt_delay)));
+
+    // The branches initially go to the next check, and are patched when the target block is compiled.
+    m_emit->Ldr(temp1, a64::MemOperand(cpu_reg, offsetof(Core, m_regs.pc)));
+    for (const u32 exit_pc : m_block_exit_pcs)
+    {
+      a64::Label next_exit;
+      m_emit->Mov(temp2, exit_pc);
+      m_emit->Cmp(temp1, temp2);
+      m_emit->B(a64::ne, &next_exit);
+
+      BlockLinkInfo li;
+      li.pc = exit_pc;
+      li.host_jump_pc = GetCurrentNearCodePointer();
+      li.linked_block = nullptr;
+      m_emit->b(1);
+      m_emit->Bind(&next_exit);
+      li.host_unlinked_pc = GetCurrentNearCodePointer();
+      m_block->exit_links.push_back(li);
+    }
+
+    m_emit->Bind(&exit_block);
+  }
+
   m_emit->Ret();
 }
 
@@ -195,6 +266,8 @@ void CodeGenerator::EmitExceptionExit()
   // technically RaiseException() and FlushPipeline() have already been called, but that should be okay
   m_register_cache.FlushLoadDelay(false);
 
+  EmitBlockExecutedCallback();
+
   m_register_cache.PopCalleeSavedRegisters(false);
 
   m_emit->Add(a64::sp, a64::sp, FUNCTION_STACK_SIZE);
@@ -1116,6 +1189,37 @@ void CodeGenerator::EmitLoadCPUStructField(HostReg host_reg, RegSize guest_size,
   }
 }
 
+void CodeGenerator::EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr)
+{
+  // The destination register doubles as the address register.
+  m_emit->Mov(GetHostReg64(host_reg), reinterpret_cast<uintptr_t>(ptr));
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->Ldrb(GetHostReg8(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_16:
+      m_emit->Ldrh(GetHostReg16(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_32:
+      m_emit->Ldr(GetHostReg32(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    case RegSize_64:
+      m_emit->Ldr(GetHostReg64(host_reg), a64::MemOperand(GetHostReg64(host_reg)));
+      break;
+
+    default:
+    {
+      UnreachableCode();
+    }
+    break;
+  }
+}
+
 void CodeGenerator::EmitStoreCPUStructField(u32 offset, const Value& value)
 {
   const Value hr_value = GetValueInHostRegister(value);
@@ -1212,12 +1316,137 @@ void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
 
 Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size)
 {
-  const Value pc = Value::FromConstantU32(cbi.pc);
-  AddPendingCycles(true);
-
   // We need to use the full 64 bits here since we test the sign bit result.
   Value result = m_register_cache.AllocateScratch(RegSize_64);
 
+  if (CanUseFastmemForAddress(address, size))
+  {
+    EmitLoadGuestMemoryFastmem(cbi, address, size, result);
+  }
+  else
+  {
+    AddPendingCycles(true);
+    EmitLoadGuestMemorySlowmem(cbi, address, size, result, false);
+  }
+
+  // Downcast to ignore upper 56/48/32 bits. This should be a noop.
+  switch (size)
+  {
+    case RegSize_8:
+      ConvertValueSizeInPlace(&result, RegSize_8, false);
+      break;
+
+    case RegSize_16:
+      ConvertValueSizeInPlace(&result, RegSize_16, false);
+      break;
+
+    case RegSize_32:
+      ConvertValueSizeInPlace(&result, RegSize_32, false);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  return result;
+}
+
+// Adds to the pending tick count without allocating a scratch register, for use in far code.
+static void EmitAddPendingTicks(a64::MacroAssembler* emit, TickCount ticks)
+{
+  if (ticks == 0)
+    return;
+
+  const a64::MemOperand pending_ticks(GetCPUPtrReg(), offsetof(Core, m_pending_ticks));
+  emit->Ldr(GetHostReg32(RARG4), pending_ticks);
+  emit->Add(GetHostReg32(RARG4), GetHostReg32(RARG4), ticks);
+  emit->Str(GetHostReg32(RARG4), pending_ticks);
+}
+
+void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result)
+{
+  // The slow path is the next thing written to far code, so misaligned addresses can jump straight to it.
+  void* const slowmem_pc = GetCurrentFarCodePointer();
+
+  // Scratch registers have to be allocated before branching to the slow path, in case something is evicted.
+  Value address_reg;
+  if (!address.IsConstant())
+  {
+    address_reg = Value::FromHostReg(&m_register_cache, address.host_reg, RegSize_32);
+    if (size != RegSize_8)
+    {
+      a64::Label aligned;
+      m_emit->Tst(GetHostReg32(address), (size == RegSize_32) ? 3 : 1);
+      m_emit->B(a64::eq, &aligned);
+      EmitBranch(slowmem_pc);
+      m_emit->Bind(&aligned);
+    }
+  }
+  else
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_32);
+    m_emit->Mov(GetHostReg32(address_reg), Truncate32(address.constant_value));
+  }
+
+  const a64::MemOperand ptr(GetFastmemBasePtrReg(), GetHostReg32(address_reg), a64::UXTW);
+
+  LoadStoreBackpatchInfo lbi;
+  lbi.host_pc = GetCurrentNearCodePointer();
+  lbi.host_slowmem_pc = slowmem_pc;
+  lbi.host_code_size = 4;
+  lbi.is_store = false;
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->Ldrb(GetHostReg32(result.host_reg), ptr);
+      break;
+
+    case RegSize_16:
+      m_emit->Ldrh(GetHostReg32(result.host_reg), ptr);
+      break;
+
+    case RegSize_32:
+      m_emit->Ldr(GetHostReg32(result.host_reg), ptr);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  DebugAssert((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc)) == 4);
+  m_block->loadstore_backpatch_info.push_back(lbi);
+
+  void* const return_pc = GetCurrentNearCodePointer();
+
+  m_register_cache.PushState();
+  SwitchToFarCode();
+  DebugAssert(GetCurrentFarCodePointer() == slowmem_pc);
+
+  // The slow path accounts for the access cycles itself, so undo what the fast path adds below.
+  // EmitAddCPUStructField() allocates a scratch register, which isn't safe here, so adjust the ticks directly.
+  const TickCount delayed_cycles = m_delayed_cycles_add;
+  EmitAddPendingTicks(m_emit, delayed_cycles);
+  m_delayed_cycles_add = 0;
+  EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
+  EmitAddPendingTicks(m_emit, -(delayed_cycles + Bus::RAM_READ_TICKS));
+  m_delayed_cycles_add = delayed_cycles;
+  EmitBranch(return_pc);
+
+  SwitchToNearCode();
+  m_register_cache.PopState();
+
+  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+}
+
+void CodeGenerator::EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result, bool in_far_code)
+{
+  const Value pc = Value::FromConstantU32(cbi.pc);
+
   // NOTE: This can leave junk in the upper bits
   switch (size)
   {
@@ -1242,29 +1471,90 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
 
   a64::Label load_okay;
   m_emit->Tbz(GetHostReg64(result.host_reg), 63, &load_okay);
-  EmitBranch(GetCurrentFarCodePointer());
-  m_emit->Bind(&load_okay);
 
-  // load exception path
-  SwitchToFarCode();
-  EmitExceptionExit();
-  SwitchToNearCode();
+  if (in_far_code)
+  {
+    // load exception path, inline since we're already in far code
+    EmitExceptionExit();
+  }
+  else
+  {
+    EmitBranch(GetCurrentFarCodePointer());
+
+    // load exception path
+    SwitchToFarCode();
+    EmitExceptionExit();
+    SwitchToNearCode();
+  }
+
+  m_emit->Bind(&load_okay);
 
   m_register_cache.PopState();
+}
 
-  // Downcast to ignore upper 56/48/32 bits. This should be a noop.
-  switch (size)
+void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  if (CanUseFastmemForAddress(address, value.size))
+  {
+    EmitStoreGuestMemoryFastmem(cbi, address, value);
+  }
+  else
+  {
+    AddPendingCycles(true);
+
+    Value result = m_register_cache.AllocateScratch(RegSize_8);
+    EmitStoreGuestMemorySlowmem(cbi, address, value, result, false);
+  }
+}
+
+void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value)
+{
+  // The slow path is the next thing written to far code, so misaligned addresses can jump straight to it.
+  void* const slowmem_pc = GetCurrentFarCodePointer();
+
+  // Scratch registers have to be allocated before branching to the slow path, in case something is evicted.
+  Value result = m_register_cache.AllocateScratch(RegSize_8);
+  const Value value_reg = GetValueInHostRegister(value);
+  Value address_reg;
+  if (!address.IsConstant())
+  {
+    address_reg = Value::FromHostReg(&m_register_cache, address.host_reg, RegSize_32);
+    if (value.size != RegSize_8)
+    {
+      a64::Label aligned;
+      m_emit->Tst(GetHostReg32(address), (value.size == RegSize_32) ? 3 : 1);
+      m_emit->B(a64::eq, &aligned);
+      EmitBranch(slowmem_pc);
+      m_emit->Bind(&aligned);
+    }
+  }
+  else
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_32);
+    m_emit->Mov(GetHostReg32(address_reg), Truncate32(address.constant_value));
+  }
+
+  const a64::MemOperand ptr(GetFastmemBasePtrReg(), GetHostReg32(address_reg), a64::UXTW);
+
+  LoadStoreBackpatchInfo lbi;
+  lbi.host_pc = GetCurrentNearCodePointer();
+  lbi.host_slowmem_pc = slowmem_pc;
+  lbi.host_code_size = 4;
+  lbi.is_store = true;
+
+  switch (value.size)
   {
     case RegSize_8:
-      ConvertValueSizeInPlace(&result, RegSize_8, false);
+      m_emit->Strb(GetHostReg32(value_reg.host_reg), ptr);
       break;
 
     case RegSize_16:
-      ConvertValueSizeInPlace(&result, RegSize_16, false);
+      m_emit->Strh(GetHostReg32(value_reg.host_reg), ptr);
       break;
 
     case RegSize_32:
-      ConvertValueSizeInPlace(&result, RegSize_32, false);
+      m_emit->Str(GetHostReg32(value_reg.host_reg), ptr);
       break;
 
     default:
@@ -1272,15 +1562,31 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
       break;
   }
 
-  return result;
+  DebugAssert((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc)) == 4);
+  m_block->loadstore_backpatch_info.push_back(lbi);
+
+  void* const return_pc = GetCurrentNearCodePointer();
+
+  m_register_cache.PushState();
+  SwitchToFarCode();
+  DebugAssert(GetCurrentFarCodePointer() == slowmem_pc);
+
+  const TickCount delayed_cycles = m_delayed_cycles_add;
+  EmitAddPendingTicks(m_emit, delayed_cycles);
+  m_delayed_cycles_add = 0;
+  EmitStoreGuestMemorySlowmem(cbi, address, value, result, true);
+  EmitAddPendingTicks(m_emit, -delayed_cycles);
+  m_delayed_cycles_add = delayed_cycles;
+  EmitBranch(return_pc);
+
+  SwitchToNearCode();
+  m_register_cache.PopState();
 }
 
-void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+void CodeGenerator::EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value, Value& result, bool in_far_code)
 {
   const Value pc = Value::FromConstantU32(cbi.pc);
-  AddPendingCycles(true);
-
-  Value result = m_register_cache.AllocateScratch(RegSize_8);
 
   switch (value.size)
   {
@@ -1305,17 +1611,54 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
 
   a64::Label store_okay;
   m_emit->Cbnz(GetHostReg64(result.host_reg), &store_okay);
-  EmitBranch(GetCurrentFarCodePointer());
-  m_emit->Bind(&store_okay);
 
-  // store exception path
-  SwitchToFarCode();
-  EmitExceptionExit();
-  SwitchToNearCode();
+  if (in_far_code)
+  {
+    // store exception path, inline since we're already in far code
+    EmitExceptionExit();
+  }
+  else
+  {
+    EmitBranch(GetCurrentFarCodePointer());
+
+    // store exception path
+    SwitchToFarCode();
+    EmitExceptionExit();
+    SwitchToNearCode();
+  }
+
+  m_emit->Bind(&store_okay);
 
   m_register_cache.PopState();
 }
 
+void CodeGenerator::BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi)
+{
+  // Turn the fastmem access into a branch to the slow path.
+  const s64 jump_distance = static_cast<s64>(reinterpret_cast<intptr_t>(lbi.host_slowmem_pc) -
+                                             reinterpret_cast<intptr_t>(lbi.host_pc));
+  Assert(a64::Instruction::IsValidImmPCOffset(a64::UncondBranchType, jump_distance >> 2));
+
+  a64::Assembler emit(static_cast<vixl::byte*>(lbi.host_pc), lbi.host_code_size, a64::PositionDependentCode);
+  emit.b(jump_distance >> 2);
+  emit.FinalizeCode();
+
+  JitCodeBuffer::FlushInstructionCache(lbi.host_pc, lbi.host_code_size);
+}
+
+void CodeGenerator::PatchBlockLink(const BlockLinkInfo& li, const void* target)
+{
+  const s64 jump_distance =
+    static_cast<s64>(reinterpret_cast<intptr_t>(target) - reinterpret_cast<intptr_t>(li.host_jump_pc));
+  Assert(a64::Instruction::IsValidImmPCOffset(a64::UncondBranchType, jump_distance >> 2));
+
+  a64::Assembler emit(static_cast<vixl::byte*>(li.host_jump_pc), sizeof(u32), a64::PositionDependentCode);
+  emit.b(jump_distance >> 2);
+  emit.FinalizeCode();
+
+  JitCodeBuffer::FlushInstructionCache(li.host_jump_pc, sizeof(u32));
+}
+
 void CodeGenerator::EmitFlushInterpreterLoadDelay()
 {
   Value reg = m_register_cache.AllocateScratch(RegSize_32);
@@ -1637,6 +1980,12 @@ void CodeGenerator::EmitBindLabel(LabelType* label)
   m_emit->Bind(label);
 }
 
+bool CodeGenerator::EmitGTEInstruction(GTE::Instruction inst)
+{
+  // Not implemented for AArch64 yet, the commands are called instead.
+  return false;
+}
+
 void ASMFunctions::Generate(JitCodeBuffer* code_buffer) {}
 
 } // namespace CPU::Recompiler
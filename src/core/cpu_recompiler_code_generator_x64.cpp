@@ -4,6 +4,9 @@
 
 namespace CPU::Recompiler {
 
+// Holds Core::m_fastmem_base for the duration of the block when fastmem is enabled.
+constexpr HostReg RMEMBASEPTR = Xbyak::Operand::RBX;
+
 #if defined(ABI_WIN64)
 constexpr HostReg RCPUPTR = Xbyak::Operand::RBP;
 constexpr HostReg RRETURN = Xbyak::Operand::RAX;
@@ -73,8 +76,15 @@ static const Xbyak::Reg64 GetCPUPtrReg()
   return GetHostReg64(RCPUPTR);
 }
 
-CodeGenerator::CodeGenerator(Core* cpu, JitCodeBuffer* code_buffer, const ASMFunctions& asm_functions)
-  : m_cpu(cpu), m_code_buffer(code_buffer), m_asm_functions(asm_functions), m_register_cache(*this),
+static const Xbyak::Reg64 GetFastmemBasePtrReg()
+{
+  return GetHostReg64(RMEMBASEPTR);
+}
+
+CodeGenerator::CodeGenerator(Core* cpu, CodeCache* code_cache, JitCodeBuffer* code_buffer,
+                             const ASMFunctions& asm_functions)
+  : m_cpu(cpu), m_code_cache(code_cache), m_code_buffer(code_buffer), m_asm_functions(asm_functions),
+    m_register_cache(*this),
     m_near_emitter(code_buffer->GetFreeCodeSpace(), code_buffer->GetFreeCodePointer()),
     m_far_emitter(code_buffer->GetFreeFarCodeSpace(), code_buffer->GetFreeFarCodePointer()), m_emit(&m_near_emitter)
 {
@@ -188,13 +198,71 @@ void CodeGenerator::EmitBeginBlock()
   const bool cpu_reg_allocated = m_register_cache.AllocateHostReg(RCPUPTR);
   DebugAssert(cpu_reg_allocated);
   m_emit->mov(GetCPUPtrReg(), GetHostReg64(RARG1));
+
+  // Load the fastmem base pointer.
+  if (m_use_fastmem)
+  {
+    const bool fastmem_reg_allocated = m_register_cache.AllocateHostReg(RMEMBASEPTR);
+    DebugAssert(fastmem_reg_allocated);
+    UNREFERENCED_VARIABLE(fastmem_reg_allocated);
+    m_emit->mov(GetFastmemBasePtrReg(), m_emit->qword[GetCPUPtrReg() + offsetof(Core, m_fastmem_base)]);
+  }
 }
 
 void CodeGenerator::EmitEndBlock()
 {
+  // Linked blocks are entered with the CPU pointer in the first argument register, as if they were called.
+  const bool link_exits = !m_block_exit_pcs.empty();
+  if (link_exits)
+    m_emit->mov(GetHostReg64(RARG1), GetCPUPtrReg());
+
+  if (m_use_fastmem)
+    m_register_cache.FreeHostReg(RMEMBASEPTR);
+
   m_register_cache.FreeHostReg(RCPUPTR);
   m_register_cache.PopCalleeSavedRegisters(true);
 
+  if (link_exits)
+  {
+    const Xbyak::Reg64 cpu_reg = GetHostReg64(RARG1);
+    Xbyak::Label no_interrupt;
+    Xbyak::Label exit_block;
+
+    // if pending_ticks >= downcount then return
+    m_emit->mov(m_emit->eax, m_emit->dword[cpu_reg + offsetof(Core, m_pending_ticks)]);
+    m_emit->cmp(m_emit->eax, m_emit->dword[cpu_reg + offsetof(Core, m_downcount)]);
+    m_emit->jge(exit_block, Xbyak::CodeGenerator::T_NEAR);
+
+    // Same as Core::HasPendingInterrupt(). Pending interrupts are left for the code cache to dispatch.
+    m_emit->mov(m_emit->eax, m_emit->dword[cpu_reg + offsetof(Core, m_cop0_regs.sr.bits)]);
+    m_emit->test(m_emit->eax, 1);
+    m_emit->jz(no_interrupt);
+    m_emit->and_(m_emit->eax, m_emit->dword[cpu_reg + offsetof(Core, m_cop0_regs.cause.bits)]);
+    m_emit->test(m_emit->eax, UINT32_C(0xFF) << 8);
+    m_emit->jnz(exit_block, Xbyak::CodeGenerator::T_NEAR);
+    m_emit->L(no_interrupt);
+    m_emit->mov(m_emit->byte[cpu_reg + offsetof(Core, m_interrupt_delay)], 0);
+
+    // The jumps initially go to the next check, and are patched when the target block is compiled.
+    for (const u32 exit_pc : m_block_exit_pcs)
+    {
+      Xbyak::Label next_exit;
+      m_emit->cmp(m_emit->dword[cpu_reg + offsetof(Core, m_regs.pc)], exit_pc);
+      m_emit->jne(next_exit);
+
+      BlockLinkInfo li;
+      li.pc = exit_pc;
+      li.host_jump_pc = GetCurrentNearCodePointer();
+      li.linked_block = nullptr;
+      m_emit->jmp(next_exit, Xbyak::CodeGenerator::T_NEAR);
+      m_emit->L(next_exit);
+      li.host_unlinked_pc = GetCurrentNearCodePointer();
+      m_block->exit_links.push_back(li);
+    }
+
+    m_emit->L(exit_block);
+  }
+
   m_emit->ret();
 }
 
@@ -212,6 +280,8 @@ void CodeGenerator::EmitExceptionExit()
   // technically RaiseException() and FlushPipeline() have already been called, but that should be okay
   m_register_cache.FlushLoadDelay(false);
 
+  EmitBlockExecutedCallback();
+
   m_register_cache.PopCalleeSavedRegisters(false);
   m_emit->ret();
 }
@@ -1497,6 +1567,45 @@ void CodeGenerator::EmitLoadCPUStructField(HostReg host_reg, RegSize guest_size,
   }
 }
 
+void CodeGenerator::EmitLoadGlobal(HostReg host_reg, RegSize size, const void* ptr)
+{
+  // Use a RIP-relative load if the pointer is within range of the code buffer, otherwise load the address first.
+  const s64 displacement =
+    static_cast<s64>(reinterpret_cast<intptr_t>(ptr) - reinterpret_cast<intptr_t>(GetCurrentCodePointer()));
+  const bool use_rip = (displacement >= -0x70000000 && displacement <= 0x70000000);
+  if (!use_rip)
+    m_emit->mov(GetHostReg64(host_reg), reinterpret_cast<size_t>(ptr));
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->mov(GetHostReg8(host_reg),
+                  use_rip ? m_emit->byte[m_emit->rip + ptr] : m_emit->byte[GetHostReg64(host_reg)]);
+      break;
+
+    case RegSize_16:
+      m_emit->mov(GetHostReg16(host_reg),
+                  use_rip ? m_emit->word[m_emit->rip + ptr] : m_emit->word[GetHostReg64(host_reg)]);
+      break;
+
+    case RegSize_32:
+      m_emit->mov(GetHostReg32(host_reg),
+                  use_rip ? m_emit->dword[m_emit->rip + ptr] : m_emit->dword[GetHostReg64(host_reg)]);
+      break;
+
+    case RegSize_64:
+      m_emit->mov(GetHostReg64(host_reg),
+                  use_rip ? m_emit->qword[m_emit->rip + ptr] : m_emit->qword[GetHostReg64(host_reg)]);
+      break;
+
+    default:
+    {
+      UnreachableCode();
+    }
+    break;
+  }
+}
+
 void CodeGenerator::EmitStoreCPUStructField(u32 offset, const Value& value)
 {
   DebugAssert(value.IsInHostRegister() || value.IsConstant());
@@ -1635,12 +1744,133 @@ void CodeGenerator::EmitAddCPUStructField(u32 offset, const Value& value)
 
 Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const Value& address, RegSize size)
 {
-  const Value pc = Value::FromConstantU32(cbi.pc);
-  AddPendingCycles(true);
-
   // We need to use the full 64 bits here since we test the sign bit result.
   Value result = m_register_cache.AllocateScratch(RegSize_64);
 
+  if (CanUseFastmemForAddress(address, size))
+  {
+    EmitLoadGuestMemoryFastmem(cbi, address, size, result);
+  }
+  else
+  {
+    AddPendingCycles(true);
+    EmitLoadGuestMemorySlowmem(cbi, address, size, result, false);
+  }
+
+  // Downcast to ignore upper 56/48/32 bits. This should be a noop.
+  switch (size)
+  {
+    case RegSize_8:
+      ConvertValueSizeInPlace(&result, RegSize_8, false);
+      break;
+
+    case RegSize_16:
+      ConvertValueSizeInPlace(&result, RegSize_16, false);
+      break;
+
+    case RegSize_32:
+      ConvertValueSizeInPlace(&result, RegSize_32, false);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  return result;
+}
+
+void CodeGenerator::EmitLoadGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result)
+{
+  // The slow path is the next thing written to far code, so misaligned addresses can jump straight to it.
+  void* const slowmem_pc = GetCurrentFarCodePointer();
+
+  // Addresses need to be zero-extended to 64 bits, constants above 2GB don't fit in a displacement.
+  // Scratch registers have to be allocated before branching to the slow path, in case something is evicted.
+  Value address_reg;
+  if (!address.IsConstant())
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_64);
+    if (size != RegSize_8)
+    {
+      m_emit->test(GetHostReg32(address), (size == RegSize_32) ? 3 : 1);
+      m_emit->jnz(slowmem_pc);
+    }
+
+    m_emit->mov(GetHostReg32(address_reg), GetHostReg32(address));
+  }
+  else if (address.constant_value >= UINT64_C(0x80000000))
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_64);
+    m_emit->mov(GetHostReg32(address_reg), Truncate32(address.constant_value));
+  }
+
+  const Xbyak::RegExp ptr = address_reg.IsValid() ?
+                              (GetFastmemBasePtrReg() + GetHostReg64(address_reg)) :
+                              (GetFastmemBasePtrReg() + static_cast<u32>(address.constant_value));
+
+  LoadStoreBackpatchInfo lbi;
+  lbi.host_pc = GetCurrentNearCodePointer();
+  lbi.host_slowmem_pc = slowmem_pc;
+  lbi.is_store = false;
+
+  switch (size)
+  {
+    case RegSize_8:
+      m_emit->movzx(GetHostReg32(result.host_reg), m_emit->byte[ptr]);
+      break;
+
+    case RegSize_16:
+      m_emit->movzx(GetHostReg32(result.host_reg), m_emit->word[ptr]);
+      break;
+
+    case RegSize_32:
+      m_emit->mov(GetHostReg32(result.host_reg), m_emit->dword[ptr]);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+
+  // Leave enough space to backpatch a jump.
+  while ((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc)) < 5)
+    m_emit->nop();
+
+  lbi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc));
+  m_block->loadstore_backpatch_info.push_back(lbi);
+
+  void* const return_pc = GetCurrentNearCodePointer();
+
+  m_register_cache.PushState();
+  SwitchToFarCode();
+  DebugAssert(GetCurrentFarCodePointer() == slowmem_pc);
+
+  // The slow path accounts for the access cycles itself, so undo what the fast path adds below.
+  const TickCount delayed_cycles = m_delayed_cycles_add;
+  AddPendingCycles(true);
+  EmitLoadGuestMemorySlowmem(cbi, address, size, result, true);
+  if ((delayed_cycles + Bus::RAM_READ_TICKS) != 0)
+  {
+    EmitAddCPUStructField(offsetof(Core, m_pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(-(delayed_cycles + Bus::RAM_READ_TICKS))));
+  }
+  m_delayed_cycles_add = delayed_cycles;
+  EmitBranch(return_pc);
+
+  SwitchToNearCode();
+  m_register_cache.PopState();
+
+  m_delayed_cycles_add += Bus::RAM_READ_TICKS;
+}
+
+void CodeGenerator::EmitLoadGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address, RegSize size,
+                                               Value& result, bool in_far_code)
+{
+  const Value pc = Value::FromConstantU32(cbi.pc);
+
   // NOTE: This can leave junk in the upper bits
   switch (size)
   {
@@ -1662,6 +1892,19 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
   }
 
   m_emit->test(GetHostReg64(result.host_reg), GetHostReg64(result.host_reg));
+
+  if (in_far_code)
+  {
+    // load exception path, inline since we're already in far code
+    Xbyak::Label load_okay;
+    m_emit->jns(load_okay);
+    m_register_cache.PushState();
+    EmitExceptionExit();
+    m_register_cache.PopState();
+    m_emit->L(load_okay);
+    return;
+  }
+
   m_emit->js(GetCurrentFarCodePointer());
 
   m_register_cache.PushState();
@@ -1672,36 +1915,126 @@ Value CodeGenerator::EmitLoadGuestMemory(const CodeBlockInstruction& cbi, const
   SwitchToNearCode();
 
   m_register_cache.PopState();
+}
 
-  // Downcast to ignore upper 56/48/32 bits. This should be a noop.
-  switch (size)
+void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+{
+  if (CanUseFastmemForAddress(address, value.size))
+  {
+    EmitStoreGuestMemoryFastmem(cbi, address, value);
+  }
+  else
+  {
+    AddPendingCycles(true);
+
+    Value result = m_register_cache.AllocateScratch(RegSize_8);
+    EmitStoreGuestMemorySlowmem(cbi, address, value, result, false);
+  }
+}
+
+void CodeGenerator::EmitStoreGuestMemoryFastmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value)
+{
+  // The slow path is the next thing written to far code, so misaligned addresses can jump straight to it.
+  void* const slowmem_pc = GetCurrentFarCodePointer();
+
+  // Addresses need to be zero-extended to 64 bits, constants above 2GB don't fit in a displacement.
+  // Scratch registers have to be allocated before branching to the slow path, in case something is evicted.
+  Value result = m_register_cache.AllocateScratch(RegSize_8);
+  Value address_reg;
+  if (!address.IsConstant())
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_64);
+    if (value.size != RegSize_8)
+    {
+      m_emit->test(GetHostReg32(address), (value.size == RegSize_32) ? 3 : 1);
+      m_emit->jnz(slowmem_pc);
+    }
+
+    m_emit->mov(GetHostReg32(address_reg), GetHostReg32(address));
+  }
+  else if (address.constant_value >= UINT64_C(0x80000000))
+  {
+    address_reg = m_register_cache.AllocateScratch(RegSize_64);
+    m_emit->mov(GetHostReg32(address_reg), Truncate32(address.constant_value));
+  }
+
+  const Xbyak::RegExp ptr = address_reg.IsValid() ?
+                              (GetFastmemBasePtrReg() + GetHostReg64(address_reg)) :
+                              (GetFastmemBasePtrReg() + static_cast<u32>(address.constant_value));
+
+  LoadStoreBackpatchInfo lbi;
+  lbi.host_pc = GetCurrentNearCodePointer();
+  lbi.host_slowmem_pc = slowmem_pc;
+  lbi.is_store = true;
+
+  switch (value.size)
   {
     case RegSize_8:
-      ConvertValueSizeInPlace(&result, RegSize_8, false);
-      break;
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->byte[ptr], Truncate8(value.constant_value));
+      else
+        m_emit->mov(m_emit->byte[ptr], GetHostReg8(value));
+    }
+    break;
 
     case RegSize_16:
-      ConvertValueSizeInPlace(&result, RegSize_16, false);
-      break;
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->word[ptr], Truncate16(value.constant_value));
+      else
+        m_emit->mov(m_emit->word[ptr], GetHostReg16(value));
+    }
+    break;
 
     case RegSize_32:
-      ConvertValueSizeInPlace(&result, RegSize_32, false);
-      break;
+    {
+      if (value.IsConstant())
+        m_emit->mov(m_emit->dword[ptr], Truncate32(value.constant_value));
+      else
+        m_emit->mov(m_emit->dword[ptr], GetHostReg32(value));
+    }
+    break;
 
     default:
       UnreachableCode();
       break;
   }
 
-  return result;
+  // Leave enough space to backpatch a jump.
+  while ((static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc)) < 5)
+    m_emit->nop();
+
+  lbi.host_code_size =
+    static_cast<u32>(static_cast<u8*>(GetCurrentNearCodePointer()) - static_cast<u8*>(lbi.host_pc));
+  m_block->loadstore_backpatch_info.push_back(lbi);
+
+  void* const return_pc = GetCurrentNearCodePointer();
+
+  m_register_cache.PushState();
+  SwitchToFarCode();
+  DebugAssert(GetCurrentFarCodePointer() == slowmem_pc);
+
+  const TickCount delayed_cycles = m_delayed_cycles_add;
+  AddPendingCycles(true);
+  EmitStoreGuestMemorySlowmem(cbi, address, value, result, true);
+  if (delayed_cycles != 0)
+  {
+    EmitAddCPUStructField(offsetof(Core, m_pending_ticks),
+                          Value::FromConstantU32(static_cast<u32>(-delayed_cycles)));
+  }
+  m_delayed_cycles_add = delayed_cycles;
+  EmitBranch(return_pc);
+
+  SwitchToNearCode();
+  m_register_cache.PopState();
 }
 
-void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const Value& address, const Value& value)
+void CodeGenerator::EmitStoreGuestMemorySlowmem(const CodeBlockInstruction& cbi, const Value& address,
+                                                const Value& value, Value& result, bool in_far_code)
 {
   const Value pc = Value::FromConstantU32(cbi.pc);
-  AddPendingCycles(true);
-
-  Value result = m_register_cache.AllocateScratch(RegSize_8);
 
   switch (value.size)
   {
@@ -1725,16 +2058,50 @@ void CodeGenerator::EmitStoreGuestMemory(const CodeBlockInstruction& cbi, const
   m_register_cache.PushState();
 
   m_emit->test(GetHostReg8(result), GetHostReg8(result));
-  m_emit->jz(GetCurrentFarCodePointer());
 
-  // store exception path
-  SwitchToFarCode();
-  EmitExceptionExit();
-  SwitchToNearCode();
+  if (in_far_code)
+  {
+    // store exception path, inline since we're already in far code
+    Xbyak::Label store_okay;
+    m_emit->jnz(store_okay);
+    EmitExceptionExit();
+    m_emit->L(store_okay);
+  }
+  else
+  {
+    m_emit->jz(GetCurrentFarCodePointer());
+
+    // store exception path
+    SwitchToFarCode();
+    EmitExceptionExit();
+    SwitchToNearCode();
+  }
 
   m_register_cache.PopState();
 }
 
+void CodeGenerator::BackpatchLoadStore(const LoadStoreBackpatchInfo& lbi)
+{
+  // Turn the fastmem access into a jump to the slow path, and pad the rest with nops.
+  Xbyak::CodeGenerator cg(lbi.host_code_size, lbi.host_pc);
+  cg.jmp(lbi.host_slowmem_pc, Xbyak::CodeGenerator::T_NEAR);
+
+  const u32 jump_size = static_cast<u32>(cg.getSize());
+  DebugAssert(jump_size <= lbi.host_code_size);
+  for (u32 i = jump_size; i < lbi.host_code_size; i++)
+    cg.nop();
+
+  JitCodeBuffer::FlushInstructionCache(lbi.host_pc, lbi.host_code_size);
+}
+
+void CodeGenerator::PatchBlockLink(const BlockLinkInfo& li, const void* target)
+{
+  // Always a 5 byte jmp rel32.
+  Xbyak::CodeGenerator cg(5, li.host_jump_pc);
+  cg.jmp(target, Xbyak::CodeGenerator::T_NEAR);
+  JitCodeBuffer::FlushInstructionCache(li.host_jump_pc, 5);
+}
+
 void CodeGenerator::EmitFlushInterpreterLoadDelay()
 {
   Value reg = m_register_cache.AllocateScratch(RegSize_8);
@@ -2047,6 +2414,829 @@ void CodeGenerator::EmitBindLabel(LabelType* label)
   m_emit->L(*label);
 }
 
-void ASMFunctions::Generate(JitCodeBuffer* code_buffer) {}
+namespace {
+
+/// Emits the GTE commands which are hot enough to be inlined. The code mirrors the interpreter in gte.cpp/gte.inl
+/// step by step, so the results and FLAG are bit-identical. FLAG is accumulated in a register for the whole command.
+class GTEEmitter
+{
+public:
+  static constexpr u32 NUM_TEMPS = 7;
+
+  GTEEmitter(Xbyak::CodeGenerator* emit, u32 regs_offset, u32 widescreen_hack_offset, const u8* unr_table,
+             const Xbyak::Reg32& flag, const std::array<Xbyak::Reg64, NUM_TEMPS>& temps)
+    : m_emit(emit), m_regs_offset(regs_offset), m_widescreen_hack_offset(widescreen_hack_offset),
+      m_unr_table(unr_table), m_flag(flag), m_temps(temps)
+  {
+  }
+
+  void Begin() { m_emit->xor_(m_flag, m_flag); }
+
+  void End()
+  {
+    // FLAG.UpdateError()
+    Xbyak::Label no_error;
+    m_emit->test(m_flag, ERROR_MASK);
+    m_emit->jz(no_error);
+    m_emit->or_(m_flag, UINT32_C(0x80000000));
+    m_emit->L(no_error);
+    m_emit->mov(Dword(offsetof(GTE::Regs, FLAG)), m_flag);
+  }
+
+  void NCLIP()
+  {
+    const Xbyak::Reg64& acc = m_temps[0];
+    const Xbyak::Reg64& temp = m_temps[1];
+    const Xbyak::Reg64& temp2 = m_temps[2];
+
+    // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+    MultiplyS16(acc, temp, SXYOffset(0, 0), SXYOffset(1, 1));
+    MultiplyS16(temp, temp2, SXYOffset(1, 0), SXYOffset(2, 1));
+    m_emit->add(acc, temp);
+    MultiplyS16(temp, temp2, SXYOffset(2, 0), SXYOffset(0, 1));
+    m_emit->add(acc, temp);
+    MultiplyS16(temp, temp2, SXYOffset(0, 0), SXYOffset(2, 1));
+    m_emit->sub(acc, temp);
+    MultiplyS16(temp, temp2, SXYOffset(1, 0), SXYOffset(0, 1));
+    m_emit->sub(acc, temp);
+    MultiplyS16(temp, temp2, SXYOffset(2, 0), SXYOffset(1, 1));
+    m_emit->sub(acc, temp);
+
+    CheckMACOverflow(0, acc, temp);
+    m_emit->mov(Dword(offsetof(GTE::Regs, MAC0)), acc.cvt32());
+  }
+
+  void AVSZ(bool four)
+  {
+    const Xbyak::Reg64& acc = m_temps[0];
+    const Xbyak::Reg64& sum = m_temps[1];
+    const Xbyak::Reg64& temp = m_temps[2];
+
+    // MAC0 = ZSF3*(SZ1+SZ2+SZ3) or ZSF4*(SZ0+SZ1+SZ2+SZ3), OTZ = MAC0 SAR 12
+    const u32 first_sz = four ? 0 : 1;
+    m_emit->movzx(sum.cvt32(), Word(offsetof(GTE::Regs, SZ0) + first_sz * sizeof(u32)));
+    for (u32 i = first_sz + 1; i < 4; i++)
+    {
+      m_emit->movzx(temp.cvt32(), Word(offsetof(GTE::Regs, SZ0) + i * sizeof(u32)));
+      m_emit->add(sum.cvt32(), temp.cvt32());
+    }
+    m_emit->movsx(acc, Word(four ? offsetof(GTE::Regs, ZSF4) : offsetof(GTE::Regs, ZSF3)));
+    m_emit->imul(acc, sum);
+
+    CheckMACOverflow(0, acc, temp);
+    m_emit->mov(Dword(offsetof(GTE::Regs, MAC0)), acc.cvt32());
+
+    // SetOTZ()
+    m_emit->sar(acc, 12);
+    Clamp(acc.cvt32(), 0, 0xFFFF, SZ1_OTZ_SATURATED);
+    m_emit->mov(Dword(offsetof(GTE::Regs, OTZ)), acc.cvt32());
+  }
+
+  void MVMVA(GTE::Instruction inst)
+  {
+    const Xbyak::Reg64& vx = m_temps[0];
+    const Xbyak::Reg64& vy = m_temps[1];
+    const Xbyak::Reg64& vz = m_temps[2];
+    const Xbyak::Reg64& acc = m_temps[3];
+    const Xbyak::Reg64& temp = m_temps[4];
+
+    const u32 matrix = inst.mvmva_multiply_matrix;
+    const u32 translation = inst.mvmva_translation_vector;
+    const u8 shift = inst.GetShift();
+    const bool lm = inst.lm;
+
+    // The vector is read up front, as IR1-3 are overwritten by each row.
+    if (inst.mvmva_multiply_vector < 3)
+    {
+      LoadVertex(vx, vy, vz, inst.mvmva_multiply_vector);
+    }
+    else
+    {
+      m_emit->movsx(vx, Word(offsetof(GTE::Regs, IR1)));
+      m_emit->movsx(vy, Word(offsetof(GTE::Regs, IR2)));
+      m_emit->movsx(vz, Word(offsetof(GTE::Regs, IR3)));
+    }
+
+    for (u32 i = 0; i < 3; i++)
+    {
+      if (translation == 2)
+      {
+        // MulMatVecBuggy(): the far color is only added to the first product, which sets IR but not MAC.
+        LoadTranslation(acc, offsetof(GTE::Regs, FC), i);
+        LoadMatrixElement(temp, matrix, i, 0);
+        m_emit->imul(temp, vx);
+        m_emit->add(acc, temp);
+        CheckMACOverflow(i + 1, acc, temp);
+        SignExtendMAC(acc);
+        if (shift > 0)
+          m_emit->sar(acc, shift);
+        SaturateIR(i + 1, acc.cvt32(), false);
+        m_emit->mov(Dword(IROffset(i + 1)), acc.cvt32());
+
+        LoadMatrixElement(acc, matrix, i, 1);
+        m_emit->imul(acc, vy);
+      }
+      else
+      {
+        MulMatVecRow(matrix, translation, i, vx, vy);
+      }
+
+      LoadMatrixElement(temp, matrix, i, 2);
+      m_emit->imul(temp, vz);
+      m_emit->add(acc, temp);
+      TruncateAndSetMACAndIR(i + 1, acc, shift, lm);
+    }
+  }
+
+  // NCDT shares one copy of the code for all three vertices, like RTPT.
+  void NCDT(u8 shift, bool lm)
+  {
+    const Xbyak::Reg64& vertex_offset = m_temps[6];
+    Xbyak::Label loop;
+    m_emit->xor_(vertex_offset.cvt32(), vertex_offset.cvt32());
+    m_emit->L(loop);
+    NCDS(&vertex_offset, shift, lm);
+    m_emit->add(vertex_offset.cvt32(), VERTEX_SIZE);
+    m_emit->cmp(vertex_offset.cvt32(), VERTEX_SIZE * 2);
+    m_emit->jbe(loop);
+  }
+
+  // Lights V0, or the vertex at vertex_offset for NCDT, and pushes the depth cued color to the FIFO.
+  void NCDS(const Xbyak::Reg64* vertex_offset, u8 shift, bool lm)
+  {
+    const Xbyak::Reg64& vx = m_temps[0];
+    const Xbyak::Reg64& vy = m_temps[1];
+    const Xbyak::Reg64& vz = m_temps[2];
+    const Xbyak::Reg64& acc = m_temps[3];
+    const Xbyak::Reg64& temp = m_temps[4];
+    const Xbyak::Reg64& color = m_temps[5];
+
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
+    if (vertex_offset)
+      LoadVertex(vx, vy, vz, *vertex_offset);
+    else
+      LoadVertex(vx, vy, vz, 0);
+    MulMatVec(1, 3, vx, vy, vz, shift, lm);
+
+    // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (BK*1000h + LCM*IR) SAR (sf*12)
+    m_emit->movsx(vx, Word(IROffset(1)));
+    m_emit->movsx(vy, Word(IROffset(2)));
+    m_emit->movsx(vz, Word(IROffset(3)));
+    MulMatVec(2, 1, vx, vy, vz, shift, lm);
+
+    // in_MAC = [R*IR1,G*IR2,B*IR3] SHL 4, which can't overflow.
+    const std::array<const Xbyak::Reg64*, 3> in_mac = {&vx, &vy, &vz};
+    for (u32 i = 0; i < 3; i++)
+    {
+      m_emit->movzx(in_mac[i]->cvt32(), Byte(offsetof(GTE::Regs, RGBC) + i));
+      m_emit->movsx(temp, Word(IROffset(i + 1)));
+      m_emit->imul(*in_mac[i], temp);
+      m_emit->shl(*in_mac[i], 4);
+    }
+
+    // InterpolateColor(). The rows don't depend on each other, so each is finished before starting the next.
+    for (u32 i = 0; i < 3; i++)
+    {
+      // [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - in_MAC) SAR (sf*12)
+      LoadTranslation(acc, offsetof(GTE::Regs, FC), i);
+      m_emit->sub(acc, *in_mac[i]);
+      TruncateAndSetMACAndIR(i + 1, acc, shift, false);
+
+      // [MAC1,MAC2,MAC3] = (([IR1,IR2,IR3] * IR0) + in_MAC) SAR (sf*12)
+      m_emit->movsxd(acc, acc.cvt32());
+      m_emit->movsx(temp, Word(IROffset(0)));
+      m_emit->imul(acc, temp);
+      m_emit->add(acc, *in_mac[i]);
+      TruncateAndSetMACAndIR(i + 1, acc, shift, lm);
+
+      // PushRGBFromMAC(), the color is built up in the low bytes of color.
+      m_emit->mov(temp.cvt32(), Dword(MACOffset(i + 1)));
+      m_emit->sar(temp.cvt32(), 4);
+      Clamp(temp.cvt32(), 0, 0xFF, UINT32_C(1) << (21 - i));
+      if (i == 0)
+      {
+        m_emit->mov(color.cvt32(), temp.cvt32());
+      }
+      else
+      {
+        m_emit->shl(temp.cvt32(), i * 8);
+        m_emit->or_(color.cvt32(), temp.cvt32());
+      }
+    }
+
+    m_emit->movzx(temp.cvt32(), Byte(offsetof(GTE::Regs, RGBC) + 3));
+    m_emit->shl(temp.cvt32(), 24);
+    m_emit->or_(color.cvt32(), temp.cvt32());
+    m_emit->mov(temp.cvt32(), Dword(offsetof(GTE::Regs, RGB1)));
+    m_emit->mov(Dword(offsetof(GTE::Regs, RGB0)), temp.cvt32());
+    m_emit->mov(temp.cvt32(), Dword(offsetof(GTE::Regs, RGB2)));
+    m_emit->mov(Dword(offsetof(GTE::Regs, RGB1)), temp.cvt32());
+    m_emit->mov(Dword(offsetof(GTE::Regs, RGB2)), color.cvt32());
+  }
+
+  // RTPT shares one copy of the code for all three vertices, with the byte offset of the vertex in a register.
+  void RTPT(u8 shift, bool lm)
+  {
+    const Xbyak::Reg64& vertex_offset = m_temps[6];
+    Xbyak::Label loop;
+    m_emit->xor_(vertex_offset.cvt32(), vertex_offset.cvt32());
+    m_emit->L(loop);
+    RTPS(&vertex_offset, shift, lm);
+    m_emit->add(vertex_offset.cvt32(), VERTEX_SIZE);
+    m_emit->cmp(vertex_offset.cvt32(), VERTEX_SIZE * 2);
+    m_emit->jbe(loop);
+  }
+
+  // Transforms V0, or the vertex at vertex_offset for RTPT. MAC0/IR0 are only written for the last vertex.
+  void RTPS(const Xbyak::Reg64* vertex_offset, u8 shift, bool lm)
+  {
+    const Xbyak::Reg64& vx = m_temps[0];
+    const Xbyak::Reg64& vy = m_temps[1];
+    const Xbyak::Reg64& vz = m_temps[2];
+    const Xbyak::Reg64& acc = m_temps[3];
+    const Xbyak::Reg64& temp = m_temps[4];
+    const Xbyak::Reg64& temp2 = m_temps[5];
+
+    // [MAC1,MAC2,MAC3] = (TR*1000h + RT*V) SAR (sf*12)
+    if (vertex_offset)
+      LoadVertex(vx, vy, vz, *vertex_offset);
+    else
+      LoadVertex(vx, vy, vz, 0);
+    for (u32 i = 0; i < 3; i++)
+    {
+      LoadTranslation(acc, offsetof(GTE::Regs, TR), i);
+      LoadMatrixElement(temp, 0, i, 0);
+      m_emit->imul(temp, vx);
+      m_emit->add(acc, temp);
+      CheckMACOverflow(i + 1, acc, temp);
+      SignExtendMAC(acc);
+      LoadMatrixElement(temp, 0, i, 1);
+      m_emit->imul(temp, vy);
+      m_emit->add(acc, temp);
+      CheckMACOverflow(i + 1, acc, temp);
+      SignExtendMAC(acc);
+      LoadMatrixElement(temp, 0, i, 2);
+      m_emit->imul(temp, vz);
+      m_emit->add(acc, temp);
+
+      // TruncateAndSetMAC(), the last row is kept in acc for SZ3.
+      CheckMACOverflow(i + 1, acc, temp);
+      m_emit->mov(temp, acc);
+      if (shift > 0)
+        m_emit->sar(temp, shift);
+      m_emit->mov(Dword(MACOffset(i + 1)), temp.cvt32());
+
+      if (i < 2)
+      {
+        SaturateIR(i + 1, temp.cvt32(), lm);
+      }
+      else
+      {
+        // IR3 is saturated from MAC3, but the flag is set from MAC3 SAR 12 regardless of sf.
+        Clamp(temp.cvt32(), lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE, 0);
+      }
+      m_emit->mov(Dword(IROffset(i + 1)), temp.cvt32());
+    }
+
+    // SZ3 = MAC3 SAR ((1-sf)*12)
+    const Xbyak::Reg32 sz = temp.cvt32();
+    m_emit->mov(temp, acc);
+    m_emit->sar(temp, 12);
+    m_emit->mov(temp2.cvt32(), sz);
+    Clamp(temp2.cvt32(), IR123_MIN_VALUE, IR123_MAX_VALUE, IR3_SATURATED);
+
+    // PushSZ()
+    Clamp(sz, 0, 0xFFFF, SZ1_OTZ_SATURATED);
+    for (u32 i = 0; i < 3; i++)
+    {
+      m_emit->mov(temp2.cvt32(), Dword(offsetof(GTE::Regs, SZ1) + i * sizeof(u32)));
+      m_emit->mov(Dword(offsetof(GTE::Regs, SZ0) + i * sizeof(u32)), temp2.cvt32());
+    }
+    m_emit->mov(Dword(offsetof(GTE::Regs, SZ3)), sz);
+
+    // result = UNRDivide(H, SZ3), in temp2.
+    const Xbyak::Reg64& result = temp2;
+    UNRDivide(result, sz, vx, vy);
+
+    // MAC0 = result*IR1+OFX, SX2 = MAC0/10000h
+    const Xbyak::Reg64& sx = vz;
+    m_emit->movsx(sx, Word(offsetof(GTE::Regs, IR1)));
+    m_emit->imul(sx, result);
+
+    // (4 / 3) / (16 / 9) -> 0.75 -> (3 / 4), the division rounds towards zero
+    Xbyak::Label no_widescreen_hack;
+    m_emit->cmp(m_emit->byte[GetCPUPtrReg() + m_widescreen_hack_offset], 0);
+    m_emit->je(no_widescreen_hack);
+    m_emit->imul(sx, sx, 3);
+    m_emit->lea(vx, m_emit->qword[sx + 3]);
+    m_emit->test(sx, sx);
+    m_emit->cmovs(sx, vx);
+    m_emit->sar(sx, 2);
+    m_emit->L(no_widescreen_hack);
+
+    m_emit->movsxd(vx, Dword(offsetof(GTE::Regs, OFX)));
+    m_emit->add(sx, vx);
+
+    // MAC0 = result*IR2+OFY, SY2 = MAC0/10000h
+    const Xbyak::Reg64& sy = acc;
+    m_emit->movsx(sy, Word(offsetof(GTE::Regs, IR2)));
+    m_emit->imul(sy, result);
+    m_emit->movsxd(vx, Dword(offsetof(GTE::Regs, OFY)));
+    m_emit->add(sy, vx);
+
+    CheckMACOverflow(0, sx, vx);
+    CheckMACOverflow(0, sy, vx);
+
+    // PushSXY()
+    m_emit->sar(sx, 16);
+    m_emit->sar(sy, 16);
+    Clamp(sx.cvt32(), -1024, 1023, SX2_SATURATED);
+    Clamp(sy.cvt32(), -1024, 1023, SY2_SATURATED);
+    m_emit->mov(vx.cvt32(), Dword(offsetof(GTE::Regs, SXY1)));
+    m_emit->mov(Dword(offsetof(GTE::Regs, SXY0)), vx.cvt32());
+    m_emit->mov(vx.cvt32(), Dword(offsetof(GTE::Regs, SXY2)));
+    m_emit->mov(Dword(offsetof(GTE::Regs, SXY1)), vx.cvt32());
+    m_emit->mov(Word(SXYOffset(2, 0)), sx.cvt16());
+    m_emit->mov(Word(SXYOffset(2, 1)), sy.cvt16());
+
+    // MAC0 = result*DQA+DQB, IR0 = MAC0/1000h
+    Xbyak::Label not_last;
+    if (vertex_offset)
+    {
+      m_emit->cmp(vertex_offset->cvt32(), VERTEX_SIZE * 2);
+      m_emit->jne(not_last);
+    }
+    m_emit->movsx(acc, Word(offsetof(GTE::Regs, DQA)));
+    m_emit->imul(acc, result);
+    m_emit->movsxd(vx, Dword(offsetof(GTE::Regs, DQB)));
+    m_emit->add(acc, vx);
+    CheckMACOverflow(0, acc, vx);
+    m_emit->mov(Dword(offsetof(GTE::Regs, MAC0)), acc.cvt32());
+    m_emit->sar(acc, 12);
+    SaturateIR(0, acc.cvt32(), true);
+    m_emit->mov(Dword(offsetof(GTE::Regs, IR0)), acc.cvt32());
+    m_emit->L(not_last);
+  }
+
+private:
+  static constexpr u32 VERTEX_SIZE = sizeof(u32) * 2;
+  static constexpr u32 ERROR_MASK = UINT32_C(0x7F87E000);
+  static constexpr u32 IR3_SATURATED = UINT32_C(1) << 22;
+  static constexpr u32 SZ1_OTZ_SATURATED = UINT32_C(1) << 18;
+  static constexpr u32 DIVIDE_OVERFLOW = UINT32_C(1) << 17;
+  static constexpr u32 SX2_SATURATED = UINT32_C(1) << 14;
+  static constexpr u32 SY2_SATURATED = UINT32_C(1) << 13;
+  static constexpr u32 IR0_SATURATED = UINT32_C(1) << 12;
+  static constexpr s32 IR123_MIN_VALUE = -0x8000;
+  static constexpr s32 IR123_MAX_VALUE = 0x7FFF;
+
+  static constexpr u32 MACOffset(u32 index)
+  {
+    return static_cast<u32>(offsetof(GTE::Regs, MAC0) + index * sizeof(u32));
+  }
+  static constexpr u32 IROffset(u32 index)
+  {
+    return static_cast<u32>(offsetof(GTE::Regs, IR0) + index * sizeof(u32));
+  }
+  static constexpr u32 SXYOffset(u32 index, u32 component)
+  {
+    return static_cast<u32>(offsetof(GTE::Regs, SXY0) + index * sizeof(u32) + component * sizeof(s16));
+  }
+
+  Xbyak::Address Byte(size_t offset) const
+  {
+    return m_emit->byte[GetCPUPtrReg() + (m_regs_offset + static_cast<u32>(offset))];
+  }
+  Xbyak::Address Word(size_t offset) const
+  {
+    return m_emit->word[GetCPUPtrReg() + (m_regs_offset + static_cast<u32>(offset))];
+  }
+  Xbyak::Address Dword(size_t offset) const
+  {
+    return m_emit->dword[GetCPUPtrReg() + (m_regs_offset + static_cast<u32>(offset))];
+  }
+
+  void MultiplyS16(const Xbyak::Reg64& dst, const Xbyak::Reg64& temp, u32 lhs_offset, u32 rhs_offset)
+  {
+    m_emit->movsx(dst, Word(lhs_offset));
+    m_emit->movsx(temp, Word(rhs_offset));
+    m_emit->imul(dst, temp);
+  }
+
+  void LoadVertex(const Xbyak::Reg64& vx, const Xbyak::Reg64& vy, const Xbyak::Reg64& vz, u32 vertex)
+  {
+    const u32 offset = static_cast<u32>(offsetof(GTE::Regs, V0) + vertex * VERTEX_SIZE);
+    m_emit->movsx(vx, Word(offset));
+    m_emit->movsx(vy, Word(offset + sizeof(s16)));
+    m_emit->movsx(vz, Word(offset + sizeof(s16) * 2));
+  }
+
+  // Loads the vertex at vertex_offset bytes from V0.
+  void LoadVertex(const Xbyak::Reg64& vx, const Xbyak::Reg64& vy, const Xbyak::Reg64& vz,
+                  const Xbyak::Reg64& vertex_offset)
+  {
+    const u32 offset = static_cast<u32>(m_regs_offset + offsetof(GTE::Regs, V0));
+    m_emit->movsx(vx, m_emit->word[GetCPUPtrReg() + vertex_offset + offset]);
+    m_emit->movsx(vy, m_emit->word[GetCPUPtrReg() + vertex_offset + (offset + sizeof(s16))]);
+    m_emit->movsx(vz, m_emit->word[GetCPUPtrReg() + vertex_offset + (offset + sizeof(s16) * 2)]);
+  }
+
+  // [MAC1,MAC2,MAC3] = [IR1,IR2,IR3] = (T*1000h + M*V) SAR (sf*12), with the MVMVA matrix and translation numbering.
+  void MulMatVec(u32 matrix, u32 translation, const Xbyak::Reg64& vx, const Xbyak::Reg64& vy,
+                 const Xbyak::Reg64& vz, u8 shift, bool lm)
+  {
+    const Xbyak::Reg64& acc = m_temps[3];
+    const Xbyak::Reg64& temp = m_temps[4];
+    for (u32 i = 0; i < 3; i++)
+    {
+      MulMatVecRow(matrix, translation, i, vx, vy);
+      LoadMatrixElement(temp, matrix, i, 2);
+      m_emit->imul(temp, vz);
+      m_emit->add(acc, temp);
+      TruncateAndSetMACAndIR(i + 1, acc, shift, lm);
+    }
+  }
+
+  // acc = T[i]*1000h + M[i][0]*Vx + M[i][1]*Vy, sign extended to 44 bits after each addition.
+  void MulMatVecRow(u32 matrix, u32 translation, u32 i, const Xbyak::Reg64& vx, const Xbyak::Reg64& vy)
+  {
+    const Xbyak::Reg64& acc = m_temps[3];
+    const Xbyak::Reg64& temp = m_temps[4];
+    if (translation < 2)
+    {
+      LoadTranslation(acc, (translation == 0) ? offsetof(GTE::Regs, TR) : offsetof(GTE::Regs, BK), i);
+      LoadMatrixElement(temp, matrix, i, 0);
+      m_emit->imul(temp, vx);
+      m_emit->add(acc, temp);
+    }
+    else
+    {
+      LoadMatrixElement(acc, matrix, i, 0);
+      m_emit->imul(acc, vx);
+    }
+
+    CheckMACOverflow(i + 1, acc, temp);
+    SignExtendMAC(acc);
+    LoadMatrixElement(temp, matrix, i, 1);
+    m_emit->imul(temp, vy);
+    m_emit->add(acc, temp);
+    CheckMACOverflow(i + 1, acc, temp);
+    SignExtendMAC(acc);
+  }
+
+  // TruncateAndSetMACAndIR(), value is left holding the saturated IR in the low 32 bits.
+  void TruncateAndSetMACAndIR(u32 index, const Xbyak::Reg64& value, u8 shift, bool lm)
+  {
+    CheckMACOverflow(index, value, m_temps[4]);
+    if (shift > 0)
+      m_emit->sar(value, shift);
+    m_emit->mov(Dword(MACOffset(index)), value.cvt32());
+    SaturateIR(index, value.cvt32(), lm);
+    m_emit->mov(Dword(IROffset(index)), value.cvt32());
+  }
+
+  // dst = T[i] SHL 12
+  void LoadTranslation(const Xbyak::Reg64& dst, size_t offset, u32 i)
+  {
+    m_emit->movsxd(dst, Dword(offset + i * sizeof(s32)));
+    m_emit->shl(dst, 12);
+  }
+
+  void LoadMatrixElement(const Xbyak::Reg64& dst, u32 matrix, u32 row, u32 col)
+  {
+    const u32 element_offset = (row * 3 + col) * sizeof(s16);
+    switch (matrix)
+    {
+      case 0:
+        m_emit->movsx(dst, Word(offsetof(GTE::Regs, RT) + element_offset));
+        break;
+
+      case 1:
+        m_emit->movsx(dst, Word(offsetof(GTE::Regs, LLM) + element_offset));
+        break;
+
+      case 2:
+        m_emit->movsx(dst, Word(offsetof(GTE::Regs, LCM) + element_offset));
+        break;
+
+      default:
+      {
+        // buggy, [-R*10h, R*10h, IR0], [RT13, RT13, RT13], [RT22, RT22, RT22]
+        if (row == 0)
+        {
+          if (col < 2)
+          {
+            m_emit->movzx(dst.cvt32(), Byte(offsetof(GTE::Regs, RGBC)));
+            m_emit->shl(dst.cvt32(), 4);
+            if (col == 0)
+              m_emit->neg(dst);
+          }
+          else
+          {
+            m_emit->movsx(dst, Word(offsetof(GTE::Regs, IR0)));
+          }
+        }
+        else
+        {
+          m_emit->movsx(dst, Word(offsetof(GTE::Regs, RT) + ((row == 1) ? 2 : 4) * sizeof(s16)));
+        }
+      }
+      break;
+    }
+  }
+
+  // Sets the MAC overflow/underflow flags if the value doesn't fit in 44 bits (MAC1-3) or 32 bits (MAC0).
+  void CheckMACOverflow(u32 index, const Xbyak::Reg64& value, const Xbyak::Reg64& temp)
+  {
+    const u32 overflow_bit = (index == 0) ? (UINT32_C(1) << 16) : (UINT32_C(1) << (31 - index));
+    const u32 underflow_bit = (index == 0) ? (UINT32_C(1) << 15) : (UINT32_C(1) << (28 - index));
+
+    // in range when the bits above the sign bit are all zero or all one, i.e. value SAR n is 0 or -1
+    Xbyak::Label in_range, underflow;
+    m_emit->mov(temp, value);
+    m_emit->sar(temp, (index == 0) ? 31 : 43);
+    m_emit->inc(temp);
+    m_emit->cmp(temp, 1);
+    m_emit->jbe(in_range);
+    m_emit->jl(underflow);
+    m_emit->or_(m_flag, overflow_bit);
+    m_emit->jmp(in_range);
+    m_emit->L(underflow);
+    m_emit->or_(m_flag, underflow_bit);
+    m_emit->L(in_range);
+  }
+
+  void SignExtendMAC(const Xbyak::Reg64& value)
+  {
+    m_emit->shl(value, 64 - 44);
+    m_emit->sar(value, 64 - 44);
+  }
+
+  void SaturateIR(u32 index, const Xbyak::Reg32& value, bool lm)
+  {
+    if (index == 0)
+      Clamp(value, 0, 0x1000, IR0_SATURATED);
+    else
+      Clamp(value, lm ? 0 : IR123_MIN_VALUE, IR123_MAX_VALUE, UINT32_C(1) << (25 - index));
+  }
+
+  // Clamps the value, setting flag_bit in FLAG if it was out of range.
+  void Clamp(const Xbyak::Reg32& value, s32 min_value, s32 max_value, u32 flag_bit)
+  {
+    Xbyak::Label not_below, done;
+    m_emit->cmp(value, static_cast<u32>(min_value));
+    m_emit->jge(not_below);
+    m_emit->mov(value, static_cast<u32>(min_value));
+    if (flag_bit != 0)
+      m_emit->or_(m_flag, flag_bit);
+    m_emit->jmp(done);
+    m_emit->L(not_below);
+    m_emit->cmp(value, static_cast<u32>(max_value));
+    m_emit->jle(done);
+    m_emit->mov(value, static_cast<u32>(max_value));
+    if (flag_bit != 0)
+      m_emit->or_(m_flag, flag_bit);
+    m_emit->L(done);
+  }
+
+  // result = UNRDivide(H, rhs). rhs is clobbered.
+  void UNRDivide(const Xbyak::Reg64& result, const Xbyak::Reg32& rhs, const Xbyak::Reg64& temp,
+                 const Xbyak::Reg64& temp2)
+  {
+    const Xbyak::Reg32 lhs = result.cvt32();
+    Xbyak::Label overflow, done;
+    m_emit->movzx(lhs, Word(offsetof(GTE::Regs, H)));
+    m_emit->lea(temp.cvt32(), m_emit->dword[rhs.cvt64() + rhs.cvt64()]);
+    m_emit->cmp(temp.cvt32(), lhs);
+    m_emit->jbe(overflow, Xbyak::CodeGenerator::T_NEAR);
+
+    // rhs is non-zero here, shift = CountLeadingZeros(u16(rhs)) = 15 - bsr(rhs). Multiply by 1 << shift instead of
+    // shifting, so cl doesn't have to be freed.
+    m_emit->bsr(temp2.cvt32(), rhs);
+    m_emit->mov(temp.cvt32(), 15);
+    m_emit->sub(temp.cvt32(), temp2.cvt32());
+    m_emit->xor_(temp2.cvt32(), temp2.cvt32());
+    m_emit->bts(temp2.cvt32(), temp.cvt32());
+    m_emit->imul(lhs, temp2.cvt32());
+    m_emit->imul(rhs, temp2.cvt32());
+
+    // x = 0x101 + unr_table[((divisor & 0x7FFF) + 0x40) >> 7]
+    m_emit->or_(rhs, 0x8000);
+    m_emit->mov(temp.cvt32(), rhs);
+    m_emit->and_(temp.cvt32(), 0x7FFF);
+    m_emit->add(temp.cvt32(), 0x40);
+    m_emit->shr(temp.cvt32(), 7);
+    m_emit->mov(temp2, reinterpret_cast<size_t>(m_unr_table));
+    m_emit->movzx(temp.cvt32(), m_emit->byte[temp2 + temp]);
+    m_emit->add(temp.cvt32(), 0x101);
+
+    // d = ((divisor * -x) + 0x80) >> 8
+    m_emit->mov(temp2.cvt32(), temp.cvt32());
+    m_emit->neg(temp2.cvt32());
+    m_emit->imul(temp2.cvt32(), rhs);
+    m_emit->add(temp2.cvt32(), 0x80);
+    m_emit->sar(temp2.cvt32(), 8);
+
+    // recip = ((x * (0x20000 + d)) + 0x80) >> 8
+    m_emit->add(temp2.cvt32(), 0x20000);
+    m_emit->imul(temp2.cvt32(), temp.cvt32());
+    m_emit->add(temp2.cvt32(), 0x80);
+    m_emit->sar(temp2.cvt32(), 8);
+
+    // result = min(0x1FFFF, (lhs * recip + 0x8000) >> 16), both are zero-extended by the 32-bit operations above
+    m_emit->imul(result, temp2);
+    m_emit->add(result, 0x8000);
+    m_emit->shr(result, 16);
+    m_emit->mov(temp.cvt32(), 0x1FFFF);
+    m_emit->cmp(lhs, temp.cvt32());
+    m_emit->cmova(lhs, temp.cvt32());
+    m_emit->jmp(done);
+
+    m_emit->L(overflow);
+    m_emit->or_(m_flag, DIVIDE_OVERFLOW);
+    m_emit->mov(lhs, 0x1FFFF);
+    m_emit->L(done);
+  }
+
+  Xbyak::CodeGenerator* m_emit;
+  u32 m_regs_offset;
+  u32 m_widescreen_hack_offset;
+  const u8* m_unr_table;
+  Xbyak::Reg32 m_flag;
+  std::array<Xbyak::Reg64, NUM_TEMPS> m_temps;
+};
+
+} // namespace
+
+bool CodeGenerator::EmitGTEInstruction(GTE::Instruction inst)
+{
+  switch (inst.command)
+  {
+    case 0x01: // RTPS
+    case 0x06: // NCLIP
+    case 0x12: // MVMVA
+    case 0x13: // NCDS
+    case 0x16: // NCDT
+    case 0x2D: // AVSZ3
+    case 0x2E: // AVSZ4
+    case 0x30: // RTPT
+      break;
+
+    default:
+      return false;
+  }
+
+  Value flag = m_register_cache.AllocateScratch(RegSize_32);
+  std::array<Value, GTEEmitter::NUM_TEMPS> temp_values;
+  std::array<Xbyak::Reg64, GTEEmitter::NUM_TEMPS> temps;
+  for (u32 i = 0; i < GTEEmitter::NUM_TEMPS; i++)
+  {
+    temp_values[i] = m_register_cache.AllocateScratch(RegSize_64);
+    temps[i] = GetHostReg64(temp_values[i]);
+  }
+
+  GTEEmitter gte(m_emit, static_cast<u32>(offsetof(Core, m_cop2.m_regs)),
+                 static_cast<u32>(offsetof(Core, m_cop2.m_widescreen_hack)), GTE::Core::s_unr_table.data(),
+                 GetHostReg32(flag), temps);
+  gte.Begin();
+
+  switch (inst.command)
+  {
+    case 0x01:
+      gte.RTPS(nullptr, inst.GetShift(), inst.lm);
+      break;
+
+    case 0x06:
+      gte.NCLIP();
+      break;
+
+    case 0x12:
+      gte.MVMVA(inst);
+      break;
+
+    case 0x13:
+      gte.NCDS(nullptr, inst.GetShift(), inst.lm);
+      break;
+
+    case 0x16:
+      gte.NCDT(inst.GetShift(), inst.lm);
+      break;
+
+    case 0x2D:
+      gte.AVSZ(false);
+      break;
+
+    case 0x2E:
+      gte.AVSZ(true);
+      break;
+
+    case 0x30:
+      gte.RTPT(inst.GetShift(), inst.lm);
+      break;
+  }
+
+  gte.End();
+  return true;
+}
+
+void ASMFunctions::Generate(JitCodeBuffer* code_buffer)
+{
+  Xbyak::CodeGenerator emit(code_buffer->GetFreeCodeSpace(), code_buffer->GetFreeCodePointer());
+
+  // rbx holds the CPU pointer and r12 the lookup table, both are callee-saved. r13 is only pushed for alignment.
+  const Xbyak::Reg64 cpu_reg = emit.rbx;
+  const Xbyak::Reg64 lut_reg = emit.r12;
+  const auto cpu_field = [&emit, &cpu_reg](size_t offset) { return emit.dword[cpu_reg + static_cast<u32>(offset)]; };
+
+  Xbyak::Label dispatch_loop;
+  Xbyak::Label no_interrupt;
+  Xbyak::Label not_ram;
+  Xbyak::Label have_page;
+  Xbyak::Label exit_dispatcher;
+
+  dispatcher = emit.getCurr<decltype(dispatcher)>();
+  emit.push(emit.rbx);
+  emit.push(emit.r12);
+  emit.push(emit.r13);
+  if (FUNCTION_CALL_SHADOW_SPACE > 0)
+    emit.sub(emit.rsp, FUNCTION_CALL_SHADOW_SPACE);
+
+  emit.mov(cpu_reg, GetHostReg64(RARG1));
+  emit.mov(lut_reg, GetHostReg64(RARG2));
+  emit.call(GetHostReg64(RARG3));
+
+  emit.L(dispatch_loop);
+
+  // if pending_ticks >= downcount then exit
+  emit.mov(emit.eax, cpu_field(offsetof(Core, m_pending_ticks)));
+  emit.cmp(emit.eax, cpu_field(offsetof(Core, m_downcount)));
+  emit.jge(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+
+  // Same as Core::HasPendingInterrupt(). Pending interrupts are left for the code cache to dispatch.
+  emit.mov(emit.eax, cpu_field(offsetof(Core, m_cop0_regs.sr.bits)));
+  emit.test(emit.eax, 1);
+  emit.jz(no_interrupt);
+  emit.and_(emit.eax, cpu_field(offsetof(Core, m_cop0_regs.cause.bits)));
+  emit.test(emit.eax, UINT32_C(0xFF) << 8);
+  emit.jnz(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+  emit.L(no_interrupt);
+  emit.mov(emit.byte[cpu_reg + static_cast<u32>(offsetof(Core, m_interrupt_delay))], 0);
+
+  // ecx = physical address of pc, must be RAM or BIOS
+  emit.mov(emit.eax, cpu_field(offsetof(Core, m_regs.pc)));
+  emit.mov(emit.ecx, emit.eax);
+  emit.and_(emit.ecx, PHYSICAL_MEMORY_ADDRESS_MASK);
+  emit.cmp(emit.ecx, Bus::RAM_MIRROR_END);
+  emit.jae(not_ram);
+  emit.and_(emit.ecx, Bus::RAM_MASK);
+  emit.shr(emit.ecx, CodeCache::BLOCK_LUT_PAGE_SHIFT);
+  emit.jmp(have_page);
+  emit.L(not_ram);
+  emit.sub(emit.ecx, Bus::BIOS_BASE);
+  emit.cmp(emit.ecx, Bus::BIOS_SIZE);
+  emit.jae(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+  emit.shr(emit.ecx, CodeCache::BLOCK_LUT_PAGE_SHIFT);
+  emit.add(emit.ecx, CodeCache::BLOCK_LUT_RAM_PAGES);
+  emit.L(have_page);
+
+  // edx = block key, i.e. aligned pc | user mode, user mode pages are after kernel pages
+  emit.mov(emit.edx, cpu_field(offsetof(Core, m_cop0_regs.sr.bits)));
+  emit.shr(emit.edx, 1);
+  emit.and_(emit.edx, 1);
+  emit.imul(emit.r8d, emit.edx, CodeCache::BLOCK_LUT_PAGES_PER_MODE);
+  emit.add(emit.ecx, emit.r8d);
+  emit.and_(emit.eax, ~UINT32_C(3));
+  emit.or_(emit.edx, emit.eax);
+
+  // rcx = lut[page][(pc & page_mask) / 4]
+  emit.mov(emit.rcx, emit.qword[lut_reg + emit.rcx * 8]);
+  emit.test(emit.rcx, emit.rcx);
+  emit.jz(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+  emit.and_(emit.eax, CodeCache::BLOCK_LUT_PAGE_MASK);
+  emit.mov(emit.rcx, emit.qword[emit.rcx + emit.rax * 2]);
+  emit.test(emit.rcx, emit.rcx);
+  emit.jz(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+
+  // if the block is for another segment or mode, or needs revalidating, let the code cache handle it
+  emit.cmp(emit.dword[emit.rcx + static_cast<u32>(offsetof(CodeBlock, key))], emit.edx);
+  emit.jne(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+  emit.cmp(emit.byte[emit.rcx + static_cast<u32>(offsetof(CodeBlock, invalidated))], 0);
+  emit.jne(exit_dispatcher, Xbyak::CodeGenerator::T_NEAR);
+
+  emit.mov(GetHostReg64(RARG1), cpu_reg);
+  emit.call(emit.qword[emit.rcx + static_cast<u32>(offsetof(CodeBlock, host_code))]);
+  emit.jmp(dispatch_loop, Xbyak::CodeGenerator::T_NEAR);
+
+  emit.L(exit_dispatcher);
+  if (FUNCTION_CALL_SHADOW_SPACE > 0)
+    emit.add(emit.rsp, FUNCTION_CALL_SHADOW_SPACE);
+  emit.pop(emit.r13);
+  emit.pop(emit.r12);
+  emit.pop(emit.rbx);
+  emit.ret();
+
+  emit.ready();
+  code_buffer->CommitCode(static_cast<u32>(emit.getSize()));
+}
 
 } // namespace CPU::Recompiler
@@ -164,4 +164,19 @@ void Thunks::WriteGTERegister(Core* cpu, u32 reg, u32 value)
   cpu->m_cop2.WriteRegister(reg, value);
 }
 
+void Thunks::UpdateFastmemViews(Core* cpu)
+{
+  cpu->UpdateFastmemViews();
+}
+
+void Thunks::CheckIdleLoop(CodeCache* code_cache, CodeBlock* block)
+{
+  code_cache->CheckIdleLoop(block);
+}
+
+void Thunks::BlockExecuted(CodeCache* code_cache, CodeBlock* block)
+{
+  code_cache->CallBlockExecutedCallback(*block);
+}
+
 } // namespace CPU::Recompiler
\ No newline at end of file
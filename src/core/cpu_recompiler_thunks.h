@@ -5,8 +5,10 @@ class JitCodeBuffer;
 
 namespace CPU {
 
+struct CodeBlock;
 struct CodeBlockInstruction;
 
+class CodeCache;
 class Core;
 
 namespace Recompiler {
@@ -47,6 +49,9 @@ public:
   static void ExecuteGTEInstruction(Core* cpu, u32 instruction_bits);
   static u32 ReadGTERegister(Core* cpu, u32 reg);
   static void WriteGTERegister(Core* cpu, u32 reg, u32 value);
+  static void UpdateFastmemViews(Core* cpu);
+  static void CheckIdleLoop(CodeCache* code_cache, CodeBlock* block);
+  static void BlockExecuted(CodeCache* code_cache, CodeBlock* block);
 };
 
 class ASMFunctions
@@ -59,6 +64,10 @@ public:
   void (*write_memory_word)(u32 address, u16 value);
   void (*write_memory_dword)(u32 address, u32 value);
 
+  /// Executes first_block, then keeps executing blocks found in the code cache's lookup table until the downcount is
+  /// reached, an interrupt is pending, or the next block is not in the table or has been invalidated.
+  void (*dispatcher)(Core* cpu, CodeBlock** const* block_lut, void (*first_block)(Core*));
+
   void Generate(JitCodeBuffer* code_buffer);
 };
 
@@ -74,6 +74,9 @@ constexpr RegSize HostPointerSize = RegSize_64;
 constexpr u32 MAX_NEAR_HOST_BYTES_PER_INSTRUCTION = 64;
 constexpr u32 MAX_FAR_HOST_BYTES_PER_INSTRUCTION = 128;
 
+// Inline GTE commands are much larger than the other instructions.
+constexpr u32 MAX_NEAR_HOST_BYTES_PER_GTE_INSTRUCTION = 3072;
+
 // Are shifts implicitly masked to 0..31?
 constexpr bool SHIFTS_ARE_IMPLICITLY_MASKED = true;
 
@@ -102,6 +105,9 @@ constexpr RegSize HostPointerSize = RegSize_64;
 constexpr u32 MAX_NEAR_HOST_BYTES_PER_INSTRUCTION = 64;
 constexpr u32 MAX_FAR_HOST_BYTES_PER_INSTRUCTION = 128;
 
+// GTE commands are always called.
+constexpr u32 MAX_NEAR_HOST_BYTES_PER_GTE_INSTRUCTION = MAX_NEAR_HOST_BYTES_PER_INSTRUCTION;
+
 // Are shifts implicitly masked to 0..31?
 constexpr bool SHIFTS_ARE_IMPLICITLY_MASKED = true;
 
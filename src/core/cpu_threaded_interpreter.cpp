@@ -0,0 +1,603 @@
+#include "cpu_threaded_interpreter.h"
+#include "cpu_core.h"
+
+namespace CPU {
+
+// Same as Core::WriteReg(), minus the $zero reset. Instructions writing to $zero are decoded as nops.
+ALWAYS_INLINE void ThreadedInterpreter::WriteReg(Core* cpu, u8 rd, u32 value)
+{
+  cpu->m_regs.r[rd] = value;
+  if (static_cast<u8>(cpu->m_load_delay_reg) == rd)
+    cpu->m_load_delay_reg = Reg::count;
+}
+
+void ThreadedInterpreter::DecodeBlock(CodeBlock* block)
+{
+  block->threaded_instructions.clear();
+  block->threaded_instructions.reserve(block->instructions.size());
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    ThreadedInstruction ti = {};
+    ti.instruction.bits = cbi.instruction.bits;
+    ti.pc = cbi.pc;
+    ti.is_branch_delay_slot = cbi.is_branch_delay_slot;
+    ti.handler = GetHandler(cbi, &ti);
+    block->threaded_instructions.push_back(ti);
+  }
+}
+
+void ThreadedInterpreter::ExecuteBlock(Core* cpu, const CodeBlock& block)
+{
+  // set up the state so we've already fetched the instruction
+  DebugAssert(cpu->m_regs.pc == block.GetPC());
+
+  cpu->m_regs.npc = block.GetPC() + 4;
+
+  for (const ThreadedInstruction& ti : block.threaded_instructions)
+  {
+    cpu->m_pending_ticks++;
+
+    // the current instruction is still needed for exceptions and fallbacks
+    cpu->m_current_instruction.bits = ti.instruction.bits;
+    cpu->m_current_instruction_pc = ti.pc;
+    cpu->m_current_instruction_in_branch_delay_slot = ti.is_branch_delay_slot;
+    cpu->m_current_instruction_was_branch_taken = cpu->m_branch_was_taken;
+    cpu->m_branch_was_taken = false;
+    cpu->m_exception_raised = false;
+
+    // update pc
+    cpu->m_regs.pc = cpu->m_regs.npc;
+    cpu->m_regs.npc += 4;
+
+    ti.handler(cpu, ti);
+
+    // next load delay
+    cpu->UpdateLoadDelay();
+
+    if (cpu->m_exception_raised)
+      break;
+  }
+
+  // cleanup so the interpreter can kick in if needed
+  cpu->m_next_instruction_is_branch_delay_slot = false;
+}
+
+ThreadedInterpreter::Handler ThreadedInterpreter::GetHandler(const CodeBlockInstruction& cbi, ThreadedInstruction* ti)
+{
+  const Instruction inst = cbi.instruction;
+  switch (inst.op)
+  {
+    case InstructionOp::funct:
+    {
+      ti->rs = static_cast<u8>(inst.r.rs.GetValue());
+      ti->rt = static_cast<u8>(inst.r.rt.GetValue());
+      ti->rd = static_cast<u8>(inst.r.rd.GetValue());
+      ti->imm = inst.r.shamt;
+
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::jr:
+          return &ThreadedInterpreter::jr;
+        case InstructionFunct::jalr:
+          return &ThreadedInterpreter::jalr;
+        case InstructionFunct::mthi:
+          return &ThreadedInterpreter::mthi;
+        case InstructionFunct::mtlo:
+          return &ThreadedInterpreter::mtlo;
+        case InstructionFunct::mult:
+          return &ThreadedInterpreter::mult;
+        case InstructionFunct::multu:
+          return &ThreadedInterpreter::multu;
+        default:
+          break;
+      }
+
+      // everything else writes rd
+      if (ti->rd == 0)
+      {
+        switch (inst.r.funct)
+        {
+          case InstructionFunct::sll:
+          case InstructionFunct::srl:
+          case InstructionFunct::sra:
+          case InstructionFunct::sllv:
+          case InstructionFunct::srlv:
+          case InstructionFunct::srav:
+          case InstructionFunct::and_:
+          case InstructionFunct::or_:
+          case InstructionFunct::xor_:
+          case InstructionFunct::nor:
+          case InstructionFunct::addu:
+          case InstructionFunct::subu:
+          case InstructionFunct::slt:
+          case InstructionFunct::sltu:
+          case InstructionFunct::mfhi:
+          case InstructionFunct::mflo:
+            return &ThreadedInterpreter::Nop;
+          default:
+            return &ThreadedInterpreter::Fallback;
+        }
+      }
+
+      switch (inst.r.funct)
+      {
+        case InstructionFunct::sll:
+          return &ThreadedInterpreter::sll;
+        case InstructionFunct::srl:
+          return &ThreadedInterpreter::srl;
+        case InstructionFunct::sra:
+          return &ThreadedInterpreter::sra;
+        case InstructionFunct::sllv:
+          return &ThreadedInterpreter::sllv;
+        case InstructionFunct::srlv:
+          return &ThreadedInterpreter::srlv;
+        case InstructionFunct::srav:
+          return &ThreadedInterpreter::srav;
+        case InstructionFunct::and_:
+          return &ThreadedInterpreter::and_;
+        case InstructionFunct::or_:
+          return &ThreadedInterpreter::or_;
+        case InstructionFunct::xor_:
+          return &ThreadedInterpreter::xor_;
+        case InstructionFunct::nor:
+          return &ThreadedInterpreter::nor;
+        case InstructionFunct::addu:
+          return &ThreadedInterpreter::addu;
+        case InstructionFunct::subu:
+          return &ThreadedInterpreter::subu;
+        case InstructionFunct::slt:
+          return &ThreadedInterpreter::slt;
+        case InstructionFunct::sltu:
+          return &ThreadedInterpreter::sltu;
+        case InstructionFunct::mfhi:
+          return &ThreadedInterpreter::mfhi;
+        case InstructionFunct::mflo:
+          return &ThreadedInterpreter::mflo;
+
+        // add/sub can overflow, div is rare enough to not be worth it, and syscall/break raise exceptions
+        default:
+          return &ThreadedInterpreter::Fallback;
+      }
+    }
+
+    case InstructionOp::j:
+    case InstructionOp::jal:
+    {
+      // pc is already pointing at the delay slot when the jump executes
+      ti->imm = ((cbi.pc + 4) & UINT32_C(0xF0000000)) | (inst.j.target << 2);
+      return (inst.op == InstructionOp::j) ? &ThreadedInterpreter::j : &ThreadedInterpreter::jal;
+    }
+
+    case InstructionOp::b:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+    {
+      ti->rs = static_cast<u8>(inst.i.rs.GetValue());
+      ti->rt = static_cast<u8>(inst.i.rt.GetValue());
+      ti->imm = cbi.pc + 4 + (inst.i.imm_sext32() << 2);
+      switch (inst.op)
+      {
+        case InstructionOp::beq:
+          return &ThreadedInterpreter::beq;
+        case InstructionOp::bne:
+          return &ThreadedInterpreter::bne;
+        case InstructionOp::blez:
+          return &ThreadedInterpreter::blez;
+        case InstructionOp::bgtz:
+          return &ThreadedInterpreter::bgtz;
+        default:
+        {
+          // bgez is the inverse of bltz, and the link variants have bit 4 set
+          const bool bgez = ConvertToBoolUnchecked(ti->rt & u8(1));
+          const bool link = (ti->rt & u8(0x1E)) == u8(0x10);
+          if (link)
+            return bgez ? &ThreadedInterpreter::bgezal : &ThreadedInterpreter::bltzal;
+          else
+            return bgez ? &ThreadedInterpreter::bgez : &ThreadedInterpreter::bltz;
+        }
+      }
+    }
+
+    case InstructionOp::lui:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    {
+      ti->rs = static_cast<u8>(inst.i.rs.GetValue());
+      ti->rt = static_cast<u8>(inst.i.rt.GetValue());
+      if (ti->rt == 0)
+        return &ThreadedInterpreter::Nop;
+
+      switch (inst.op)
+      {
+        case InstructionOp::lui:
+          ti->imm = inst.i.imm_zext32() << 16;
+          return &ThreadedInterpreter::lui;
+        case InstructionOp::andi:
+          ti->imm = inst.i.imm_zext32();
+          return &ThreadedInterpreter::andi;
+        case InstructionOp::ori:
+          ti->imm = inst.i.imm_zext32();
+          return &ThreadedInterpreter::ori;
+        case InstructionOp::xori:
+          ti->imm = inst.i.imm_zext32();
+          return &ThreadedInterpreter::xori;
+        case InstructionOp::addiu:
+          ti->imm = inst.i.imm_sext32();
+          return &ThreadedInterpreter::addiu;
+        case InstructionOp::slti:
+          ti->imm = inst.i.imm_sext32();
+          return &ThreadedInterpreter::slti;
+        default:
+          ti->imm = inst.i.imm_sext32();
+          return &ThreadedInterpreter::sltiu;
+      }
+    }
+
+    case InstructionOp::lb:
+    case InstructionOp::lbu:
+    case InstructionOp::lh:
+    case InstructionOp::lhu:
+    case InstructionOp::lw:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    {
+      // loads into $zero still access memory, and can raise exceptions
+      ti->rs = static_cast<u8>(inst.i.rs.GetValue());
+      ti->rt = static_cast<u8>(inst.i.rt.GetValue());
+      ti->imm = inst.i.imm_sext32();
+      switch (inst.op)
+      {
+        case InstructionOp::lb:
+          return &ThreadedInterpreter::lb;
+        case InstructionOp::lbu:
+          return &ThreadedInterpreter::lbu;
+        case InstructionOp::lh:
+          return &ThreadedInterpreter::lh;
+        case InstructionOp::lhu:
+          return &ThreadedInterpreter::lhu;
+        case InstructionOp::lw:
+          return &ThreadedInterpreter::lw;
+        case InstructionOp::sb:
+          return &ThreadedInterpreter::sb;
+        case InstructionOp::sh:
+          return &ThreadedInterpreter::sh;
+        default:
+          return &ThreadedInterpreter::sw;
+      }
+    }
+
+    // swc0/lwc0/cop1/cop3 are essentially no-ops
+    case InstructionOp::cop1:
+    case InstructionOp::cop3:
+    case InstructionOp::lwc0:
+    case InstructionOp::lwc1:
+    case InstructionOp::lwc3:
+    case InstructionOp::swc0:
+    case InstructionOp::swc1:
+    case InstructionOp::swc3:
+      return &ThreadedInterpreter::Nop;
+
+    // addi, unaligned loads/stores, and coprocessors 0/2
+    default:
+      return &ThreadedInterpreter::Fallback;
+  }
+}
+
+void ThreadedInterpreter::Fallback(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->ExecuteInstruction();
+}
+
+void ThreadedInterpreter::Nop(Core* cpu, const ThreadedInstruction& ti) {}
+
+void ThreadedInterpreter::sll(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rt] << ti.imm);
+}
+
+void ThreadedInterpreter::srl(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rt] >> ti.imm);
+}
+
+void ThreadedInterpreter::sra(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd,
+           static_cast<u32>(static_cast<s32>(cpu->m_regs.r[ti.rt]) >> ti.imm));
+}
+
+void ThreadedInterpreter::sllv(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd,
+           cpu->m_regs.r[ti.rt] << (cpu->m_regs.r[ti.rs] & UINT32_C(0x1F)));
+}
+
+void ThreadedInterpreter::srlv(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd,
+           cpu->m_regs.r[ti.rt] >> (cpu->m_regs.r[ti.rs] & UINT32_C(0x1F)));
+}
+
+void ThreadedInterpreter::srav(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd,
+           static_cast<u32>(static_cast<s32>(cpu->m_regs.r[ti.rt]) >> (cpu->m_regs.r[ti.rs] & UINT32_C(0x1F))));
+}
+
+void ThreadedInterpreter::and_(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rs] & cpu->m_regs.r[ti.rt]);
+}
+
+void ThreadedInterpreter::or_(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rs] | cpu->m_regs.r[ti.rt]);
+}
+
+void ThreadedInterpreter::xor_(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rs] ^ cpu->m_regs.r[ti.rt]);
+}
+
+void ThreadedInterpreter::nor(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, ~(cpu->m_regs.r[ti.rs] | cpu->m_regs.r[ti.rt]));
+}
+
+void ThreadedInterpreter::addu(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rs] + cpu->m_regs.r[ti.rt]);
+}
+
+void ThreadedInterpreter::subu(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.r[ti.rs] - cpu->m_regs.r[ti.rt]);
+}
+
+void ThreadedInterpreter::slt(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd,
+           BoolToUInt32(static_cast<s32>(cpu->m_regs.r[ti.rs]) < static_cast<s32>(cpu->m_regs.r[ti.rt])));
+}
+
+void ThreadedInterpreter::sltu(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, BoolToUInt32(cpu->m_regs.r[ti.rs] < cpu->m_regs.r[ti.rt]));
+}
+
+void ThreadedInterpreter::mfhi(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.hi);
+}
+
+void ThreadedInterpreter::mflo(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rd, cpu->m_regs.lo);
+}
+
+void ThreadedInterpreter::mthi(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->m_regs.hi = cpu->m_regs.r[ti.rs];
+}
+
+void ThreadedInterpreter::mtlo(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->m_regs.lo = cpu->m_regs.r[ti.rs];
+}
+
+void ThreadedInterpreter::mult(Core* cpu, const ThreadedInstruction& ti)
+{
+  const u64 result = static_cast<u64>(static_cast<s64>(SignExtend64(cpu->m_regs.r[ti.rs])) *
+                                      static_cast<s64>(SignExtend64(cpu->m_regs.r[ti.rt])));
+  cpu->m_regs.hi = Truncate32(result >> 32);
+  cpu->m_regs.lo = Truncate32(result);
+}
+
+void ThreadedInterpreter::multu(Core* cpu, const ThreadedInstruction& ti)
+{
+  const u64 result = ZeroExtend64(cpu->m_regs.r[ti.rs]) * ZeroExtend64(cpu->m_regs.r[ti.rt]);
+  cpu->m_regs.hi = Truncate32(result >> 32);
+  cpu->m_regs.lo = Truncate32(result);
+}
+
+void ThreadedInterpreter::jr(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->Branch(cpu->m_regs.r[ti.rs]);
+}
+
+void ThreadedInterpreter::jalr(Core* cpu, const ThreadedInstruction& ti)
+{
+  const u32 target = cpu->m_regs.r[ti.rs];
+  if (ti.rd != 0)
+    WriteReg(cpu, ti.rd, cpu->m_regs.npc);
+
+  cpu->Branch(target);
+}
+
+void ThreadedInterpreter::lui(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, ti.imm);
+}
+
+void ThreadedInterpreter::andi(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, cpu->m_regs.r[ti.rs] & ti.imm);
+}
+
+void ThreadedInterpreter::ori(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, cpu->m_regs.r[ti.rs] | ti.imm);
+}
+
+void ThreadedInterpreter::xori(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, cpu->m_regs.r[ti.rs] ^ ti.imm);
+}
+
+void ThreadedInterpreter::addiu(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, cpu->m_regs.r[ti.rs] + ti.imm);
+}
+
+void ThreadedInterpreter::slti(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt,
+           BoolToUInt32(static_cast<s32>(cpu->m_regs.r[ti.rs]) < static_cast<s32>(ti.imm)));
+}
+
+void ThreadedInterpreter::sltiu(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, ti.rt, BoolToUInt32(cpu->m_regs.r[ti.rs] < ti.imm));
+}
+
+void ThreadedInterpreter::lb(Core* cpu, const ThreadedInstruction& ti)
+{
+  u8 value;
+  if (cpu->ReadMemoryByte(cpu->m_regs.r[ti.rs] + ti.imm, &value))
+    cpu->WriteRegDelayed(static_cast<Reg>(ti.rt), SignExtend32(value));
+}
+
+void ThreadedInterpreter::lbu(Core* cpu, const ThreadedInstruction& ti)
+{
+  u8 value;
+  if (cpu->ReadMemoryByte(cpu->m_regs.r[ti.rs] + ti.imm, &value))
+    cpu->WriteRegDelayed(static_cast<Reg>(ti.rt), ZeroExtend32(value));
+}
+
+void ThreadedInterpreter::lh(Core* cpu, const ThreadedInstruction& ti)
+{
+  u16 value;
+  if (cpu->ReadMemoryHalfWord(cpu->m_regs.r[ti.rs] + ti.imm, &value))
+    cpu->WriteRegDelayed(static_cast<Reg>(ti.rt), SignExtend32(value));
+}
+
+void ThreadedInterpreter::lhu(Core* cpu, const ThreadedInstruction& ti)
+{
+  u16 value;
+  if (cpu->ReadMemoryHalfWord(cpu->m_regs.r[ti.rs] + ti.imm, &value))
+    cpu->WriteRegDelayed(static_cast<Reg>(ti.rt), ZeroExtend32(value));
+}
+
+void ThreadedInterpreter::lw(Core* cpu, const ThreadedInstruction& ti)
+{
+  u32 value;
+  if (cpu->ReadMemoryWord(cpu->m_regs.r[ti.rs] + ti.imm, &value))
+    cpu->WriteRegDelayed(static_cast<Reg>(ti.rt), value);
+}
+
+void ThreadedInterpreter::sb(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->WriteMemoryByte(cpu->m_regs.r[ti.rs] + ti.imm, Truncate8(cpu->m_regs.r[ti.rt]));
+}
+
+void ThreadedInterpreter::sh(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->WriteMemoryHalfWord(cpu->m_regs.r[ti.rs] + ti.imm, Truncate16(cpu->m_regs.r[ti.rt]));
+}
+
+void ThreadedInterpreter::sw(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->WriteMemoryWord(cpu->m_regs.r[ti.rs] + ti.imm, cpu->m_regs.r[ti.rt]);
+}
+
+// Targets of the immediate branches were calculated when decoding, and are always aligned.
+
+void ThreadedInterpreter::j(Core* cpu, const ThreadedInstruction& ti)
+{
+  cpu->m_regs.npc = ti.imm;
+  cpu->m_branch_was_taken = true;
+}
+
+void ThreadedInterpreter::jal(Core* cpu, const ThreadedInstruction& ti)
+{
+  WriteReg(cpu, static_cast<u8>(Reg::ra), cpu->m_regs.npc);
+  cpu->m_regs.npc = ti.imm;
+  cpu->m_branch_was_taken = true;
+}
+
+void ThreadedInterpreter::beq(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (cpu->m_regs.r[ti.rs] == cpu->m_regs.r[ti.rt])
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bne(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (cpu->m_regs.r[ti.rs] != cpu->m_regs.r[ti.rt])
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::blez(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (static_cast<s32>(cpu->m_regs.r[ti.rs]) <= 0)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bgtz(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (static_cast<s32>(cpu->m_regs.r[ti.rs]) > 0)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bltz(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (static_cast<s32>(cpu->m_regs.r[ti.rs]) < 0)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bgez(Core* cpu, const ThreadedInstruction& ti)
+{
+  if (static_cast<s32>(cpu->m_regs.r[ti.rs]) >= 0)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bltzal(Core* cpu, const ThreadedInstruction& ti)
+{
+  // register is still linked even if the branch isn't taken
+  const bool branch = (static_cast<s32>(cpu->m_regs.r[ti.rs]) < 0);
+  WriteReg(cpu, static_cast<u8>(Reg::ra), cpu->m_regs.npc);
+  if (branch)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+void ThreadedInterpreter::bgezal(Core* cpu, const ThreadedInstruction& ti)
+{
+  const bool branch = (static_cast<s32>(cpu->m_regs.r[ti.rs]) >= 0);
+  WriteReg(cpu, static_cast<u8>(Reg::ra), cpu->m_regs.npc);
+  if (branch)
+  {
+    cpu->m_regs.npc = ti.imm;
+    cpu->m_branch_was_taken = true;
+  }
+}
+
+} // namespace CPU
@@ -0,0 +1,81 @@
+#pragma once
+#include "cpu_code_cache.h"
+#include "cpu_types.h"
+
+namespace CPU {
+
+class Core;
+
+/// Interpreter which decodes each block once into a list of handlers with the operands already extracted, instead of
+/// going through the decoder in Core::ExecuteInstruction() for every instruction executed.
+class ThreadedInterpreter
+{
+public:
+  /// Fills in the threaded instructions of a block from its decoded instructions.
+  static void DecodeBlock(CodeBlock* block);
+
+  /// Runs the threaded instructions of a block, stopping early if an exception is raised.
+  static void ExecuteBlock(Core* cpu, const CodeBlock& block);
+
+private:
+  using Handler = ThreadedInstruction::Handler;
+
+  static Handler GetHandler(const CodeBlockInstruction& cbi, ThreadedInstruction* ti);
+  static void WriteReg(Core* cpu, u8 rd, u32 value);
+
+  static void Fallback(Core* cpu, const ThreadedInstruction& ti);
+  static void Nop(Core* cpu, const ThreadedInstruction& ti);
+
+  static void sll(Core* cpu, const ThreadedInstruction& ti);
+  static void srl(Core* cpu, const ThreadedInstruction& ti);
+  static void sra(Core* cpu, const ThreadedInstruction& ti);
+  static void sllv(Core* cpu, const ThreadedInstruction& ti);
+  static void srlv(Core* cpu, const ThreadedInstruction& ti);
+  static void srav(Core* cpu, const ThreadedInstruction& ti);
+  static void and_(Core* cpu, const ThreadedInstruction& ti);
+  static void or_(Core* cpu, const ThreadedInstruction& ti);
+  static void xor_(Core* cpu, const ThreadedInstruction& ti);
+  static void nor(Core* cpu, const ThreadedInstruction& ti);
+  static void addu(Core* cpu, const ThreadedInstruction& ti);
+  static void subu(Core* cpu, const ThreadedInstruction& ti);
+  static void slt(Core* cpu, const ThreadedInstruction& ti);
+  static void sltu(Core* cpu, const ThreadedInstruction& ti);
+  static void mfhi(Core* cpu, const ThreadedInstruction& ti);
+  static void mflo(Core* cpu, const ThreadedInstruction& ti);
+  static void mthi(Core* cpu, const ThreadedInstruction& ti);
+  static void mtlo(Core* cpu, const ThreadedInstruction& ti);
+  static void mult(Core* cpu, const ThreadedInstruction& ti);
+  static void multu(Core* cpu, const ThreadedInstruction& ti);
+  static void jr(Core* cpu, const ThreadedInstruction& ti);
+  static void jalr(Core* cpu, const ThreadedInstruction& ti);
+
+  static void lui(Core* cpu, const ThreadedInstruction& ti);
+  static void andi(Core* cpu, const ThreadedInstruction& ti);
+  static void ori(Core* cpu, const ThreadedInstruction& ti);
+  static void xori(Core* cpu, const ThreadedInstruction& ti);
+  static void addiu(Core* cpu, const ThreadedInstruction& ti);
+  static void slti(Core* cpu, const ThreadedInstruction& ti);
+  static void sltiu(Core* cpu, const ThreadedInstruction& ti);
+
+  static void lb(Core* cpu, const ThreadedInstruction& ti);
+  static void lbu(Core* cpu, const ThreadedInstruction& ti);
+  static void lh(Core* cpu, const ThreadedInstruction& ti);
+  static void lhu(Core* cpu, const ThreadedInstruction& ti);
+  static void lw(Core* cpu, const ThreadedInstruction& ti);
+  static void sb(Core* cpu, const ThreadedInstruction& ti);
+  static void sh(Core* cpu, const ThreadedInstruction& ti);
+  static void sw(Core* cpu, const ThreadedInstruction& ti);
+
+  static void j(Core* cpu, const ThreadedInstruction& ti);
+  static void jal(Core* cpu, const ThreadedInstruction& ti);
+  static void beq(Core* cpu, const ThreadedInstruction& ti);
+  static void bne(Core* cpu, const ThreadedInstruction& ti);
+  static void blez(Core* cpu, const ThreadedInstruction& ti);
+  static void bgtz(Core* cpu, const ThreadedInstruction& ti);
+  static void bltz(Core* cpu, const ThreadedInstruction& ti);
+  static void bgez(Core* cpu, const ThreadedInstruction& ti);
+  static void bltzal(Core* cpu, const ThreadedInstruction& ti);
+  static void bgezal(Core* cpu, const ThreadedInstruction& ti);
+};
+
+} // namespace CPU
@@ -3,6 +3,7 @@
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "dma.h"
+#include "gpu_dump.h"
 #include "host_display.h"
 #include "host_interface.h"
 #include "interrupt_controller.h"
@@ -10,6 +11,7 @@
 #include "system.h"
 #include "timers.h"
 #include <cmath>
+#include <cstring>
 #include <imgui.h>
 Log_SetChannel(GPU);
 
@@ -72,7 +74,7 @@ void GPU::Reset()
 
 void GPU::SoftReset()
 {
-  FlushRender();
+  FlushRender(FlushReason::Other);
 
   m_GPUSTAT.bits = 0x14802000;
   m_GPUSTAT.pal_mode = m_system->IsPALRegion();
@@ -232,6 +234,20 @@ void GPU::ResetGraphicsAPIState() {}
 
 void GPU::RestoreGraphicsAPIState() {}
 
+void GPU::PresentDisplay()
+{
+  ResetGraphicsAPIState();
+  m_host_display->Render();
+  RestoreGraphicsAPIState();
+}
+
+void GPU::ResizeDisplayWindow(s32 width, s32 height)
+{
+  ResetGraphicsAPIState();
+  m_host_display->ResizeRenderWindow(width, height);
+  RestoreGraphicsAPIState();
+}
+
 void GPU::UpdateDMARequest()
 {
   switch (m_blitter_state)
@@ -302,7 +318,12 @@ u32 GPU::ReadRegister(u32 offset)
   switch (offset)
   {
     case 0x00:
+    {
+      if (m_dump_recorder)
+        m_dump_recorder->ReadGPUREAD(1);
+
       return ReadGPUREAD();
+    }
 
     case 0x04:
     {
@@ -327,12 +348,18 @@ void GPU::WriteRegister(u32 offset, u32 value)
   switch (offset)
   {
     case 0x00:
+      if (m_dump_recorder)
+        m_dump_recorder->WriteGP0(value);
+
       m_fifo.Push(value);
       ExecuteCommands();
       UpdateCommandTickEvent();
       return;
 
     case 0x04:
+      if (m_dump_recorder)
+        m_dump_recorder->WriteGP1(value);
+
       WriteGP1(value);
       return;
 
@@ -351,6 +378,9 @@ void GPU::DMARead(u32* words, u32 word_count)
     return;
   }
 
+  if (m_dump_recorder)
+    m_dump_recorder->ReadGPUREAD(word_count);
+
   for (u32 i = 0; i < word_count; i++)
     words[i] = ReadGPUREAD();
 }
@@ -361,6 +391,9 @@ void GPU::DMAWrite(const u32* words, u32 word_count)
   {
     case DMADirection::CPUtoGP0:
     {
+      if (m_dump_recorder)
+        m_dump_recorder->WriteDMA(words, word_count);
+
       m_fifo.PushRange(words, word_count);
       m_fifo_pushed = true;
       if (!m_syncing)
@@ -747,8 +780,11 @@ void GPU::CRTCTickEvent(TickCount ticks)
         Log_DebugPrintf("Now in v-blank");
         m_interrupt_controller->InterruptRequest(InterruptController::IRQ::VBLANK);
 
+        if (m_dump_recorder)
+          m_dump_recorder->VBlank();
+
         // flush any pending draws and "scan out" the image
-        FlushRender();
+        FlushRender(FlushReason::VBlank);
         UpdateDisplay();
         m_system->IncrementFrameNumber();
 
@@ -772,6 +808,7 @@ void GPU::CRTCTickEvent(TickCount ticks)
   }
 
   // alternating even line bit in 240-line mode
+  const u8 old_active_line_lsb = m_crtc_state.active_line_lsb;
   if (m_GPUSTAT.vertical_interlace)
   {
     m_crtc_state.active_line_lsb =
@@ -784,11 +821,17 @@ void GPU::CRTCTickEvent(TickCount ticks)
     m_GPUSTAT.display_line_lsb = ConvertToBoolUnchecked((m_crtc_state.regs.Y + m_crtc_state.current_scanline) & u32(1));
   }
 
+  if (m_dump_recorder && m_crtc_state.active_line_lsb != old_active_line_lsb)
+    m_dump_recorder->ActiveLineLSB(m_crtc_state.active_line_lsb);
+
   UpdateCRTCTickEvent();
 }
 
 void GPU::CommandTickEvent(TickCount ticks)
 {
+  if (m_dump_recorder)
+    m_dump_recorder->CommandTicks(ticks);
+
   m_pending_command_ticks -= SystemTicksToGPUTicks(ticks);
 
   // we can be syncing if this came from a DMA write. recursively executing commands would be bad.
@@ -808,6 +851,49 @@ void GPU::CommandTickEvent(TickCount ticks)
   }
 }
 
+void GPU::BeginReplay()
+{
+  // Time doesn't pass during replays, the recorded command slices and vblanks are used instead. Dropping any time
+  // accumulated by the events from the state stops the syncs on register writes from running it a second time.
+  m_crtc_tick_event->Deactivate();
+  m_command_tick_event->Deactivate();
+}
+
+void GPU::ReplayGPUREADRead(u32 word_count)
+{
+  for (u32 i = 0; i < word_count; i++)
+    ReadGPUREAD();
+}
+
+void GPU::ReplayCommandTicks(TickCount ticks)
+{
+  CommandTickEvent(ticks);
+}
+
+void GPU::ReplayActiveLineLSB(u8 lsb)
+{
+  m_crtc_state.active_line_lsb = lsb;
+}
+
+void GPU::ReplayVBlank()
+{
+  FlushRender(FlushReason::VBlank);
+  UpdateDisplay();
+
+  // the active line LSB is recorded separately, since it's updated with the raster
+  if (m_GPUSTAT.vertical_interlace)
+    m_crtc_state.interlaced_field ^= 1u;
+  else
+    m_crtc_state.interlaced_field = 0;
+}
+
+const u16* GPU::GetVRAM()
+{
+  FlushRender(FlushReason::Other);
+  ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  return m_vram_ptr;
+}
+
 void GPU::UpdateCommandTickEvent()
 {
   if (m_pending_command_ticks <= 0)
@@ -1098,55 +1184,41 @@ void GPU::ReadVRAM(u32 x, u32 y, u32 width, u32 height) {}
 
 void GPU::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
-  const u16 color16 = RGBA8888ToRGBA5551(color);
-  if ((x + width) <= VRAM_WIDTH && !IsInterlacedRenderingEnabled())
-  {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      std::fill_n(&m_vram_ptr[row * VRAM_WIDTH + x], width, color16);
-    }
-  }
-  else if (IsInterlacedRenderingEnabled())
-  {
-    // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
-    if (IsCRTCScanlinePending())
-      SynchronizeCRTC();
+  // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
+  if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
+    SynchronizeCRTC();
 
-    const u32 active_field = GetActiveLineLSB();
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      if ((row & u32(1)) == active_field)
-        continue;
+  DoFillVRAM(x, y, width, height, color, IsInterlacedRenderingEnabled(), GetActiveLineLSB());
+}
 
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
-      {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
-      }
-    }
-  }
-  else
+void GPU::DoFillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u32 active_field)
+{
+  const u16 color16 = RGBA8888ToRGBA5551(color);
+
+  // Fills ignore the mask bit, so each row is one or two (when crossing the right edge of VRAM) solid runs.
+  const u32 first_width = std::min<u32>(width, VRAM_WIDTH - x);
+  const u32 second_width = width - first_width;
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
   {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
-    {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
-      {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
-      }
-    }
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    if (interlaced && (row & u32(1)) == active_field)
+      continue;
+
+    u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
+    std::fill_n(&row_ptr[x], first_width, color16);
+    std::fill_n(row_ptr, second_width, color16);
   }
 }
 
 void GPU::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
+{
+  DoUpdateVRAM(x, y, width, height, data, m_GPUSTAT.GetMaskAND(), m_GPUSTAT.GetMaskOR());
+}
+
+void GPU::DoUpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, u16 mask_and, u16 mask_or)
 {
   // Fast path when the copy is not oversized.
-  if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !m_GPUSTAT.IsMaskingEnabled())
+  if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && (mask_and | mask_or) == 0)
   {
     const u16* src_ptr = static_cast<const u16*>(data);
     u16* dst_ptr = &m_vram_ptr[y * VRAM_WIDTH + x];
@@ -1161,9 +1233,6 @@ void GPU::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
   {
     // Slow path when we need to handle wrap-around.
     const u16* src_ptr = static_cast<const u16*>(data);
-    const u16 mask_and = m_GPUSTAT.GetMaskAND();
-    const u16 mask_or = m_GPUSTAT.GetMaskOR();
-
     for (u32 row = 0; row < height;)
     {
       u16* dst_row_ptr = &m_vram_ptr[((y + row++) % VRAM_HEIGHT) * VRAM_WIDTH];
@@ -1179,6 +1248,11 @@ void GPU::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
 }
 
 void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+{
+  DoCopyVRAM(src_x, src_y, dst_x, dst_y, width, height, m_GPUSTAT.GetMaskAND(), m_GPUSTAT.GetMaskOR());
+}
+
+void GPU::DoCopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, u16 mask_and, u16 mask_or)
 {
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
@@ -1198,7 +1272,8 @@ void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 he
       {
         const u32 columns_to_copy =
           std::min<u32>(remaining_columns, std::min<u32>(VRAM_WIDTH - current_src_x, VRAM_WIDTH - current_dst_x));
-        CopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy);
+        DoCopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy, mask_and,
+                   mask_or);
         current_src_x = (current_src_x + columns_to_copy) % VRAM_WIDTH;
         current_dst_x = (current_dst_x + columns_to_copy) % VRAM_WIDTH;
         remaining_columns -= columns_to_copy;
@@ -1212,40 +1287,37 @@ void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 he
     return;
   }
 
-  // This doesn't have a fast path, but do we really need one? It's not common.
-  const u16 mask_and = m_GPUSTAT.GetMaskAND();
-  const u16 mask_or = m_GPUSTAT.GetMaskOR();
-
-  // Copy in reverse when src_x < dst_x, this is verified on console.
-  if (src_x < dst_x || ((src_x + width - 1) % VRAM_WIDTH) < ((dst_x + width - 1) % VRAM_WIDTH))
+  // Rows can't wrap around horizontally from here on.
+  for (u32 row = 0; row < height; row++)
   {
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+    const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH + src_x];
+    u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH + dst_x];
 
+    if (mask_and == 0)
+    {
+      // Without the mask check, copying forwards or in reverse within a row gives the same result as memmove().
+      std::memmove(dst_row_ptr, src_row_ptr, width * sizeof(u16));
+      if (mask_or != 0)
+      {
+        for (u32 col = 0; col < width; col++)
+          dst_row_ptr[col] |= mask_or;
+      }
+    }
+    else if (src_x < dst_x)
+    {
+      // Copy in reverse when src_x < dst_x, this is verified on console.
       for (s32 col = static_cast<s32>(width - 1); col >= 0; col--)
       {
-        const u16 src_pixel = src_row_ptr[(src_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
+        if ((dst_row_ptr[col] & mask_and) == 0)
+          dst_row_ptr[col] = src_row_ptr[col] | mask_or;
       }
     }
-  }
-  else
-  {
-    for (u32 row = 0; row < height; row++)
+    else
     {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-
       for (u32 col = 0; col < width; col++)
       {
-        const u16 src_pixel = src_row_ptr[(src_x + col) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + col) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
+        if ((dst_row_ptr[col] & mask_and) == 0)
+          dst_row_ptr[col] = src_row_ptr[col] | mask_or;
       }
     }
   }
@@ -1253,7 +1325,7 @@ void GPU::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 he
 
 void GPU::DispatchRenderCommand() {}
 
-void GPU::FlushRender() {}
+void GPU::FlushRender(FlushReason reason) {}
 
 void GPU::SetDrawMode(u16 value)
 {
@@ -1275,7 +1347,7 @@ void GPU::SetDrawMode(u16 value)
   m_draw_mode.mode_reg.bits = new_mode_reg.bits;
 
   if (m_GPUSTAT.draw_to_displayed_field != new_mode_reg.draw_to_displayed_field)
-    FlushRender();
+    FlushRender(FlushReason::DisplayField);
 
   // Bits 0..10 are returned in the GPU status register.
   m_GPUSTAT.bits =
@@ -1301,7 +1373,7 @@ void GPU::SetTextureWindow(u32 value)
   if (m_draw_mode.texture_window_value == value)
     return;
 
-  FlushRender();
+  FlushRender(FlushReason::TextureWindow);
 
   m_draw_mode.texture_window_mask_x = value & UINT32_C(0x1F);
   m_draw_mode.texture_window_mask_y = (value >> 5) & UINT32_C(0x1F);
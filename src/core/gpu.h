@@ -21,6 +21,10 @@ class DMA;
 class InterruptController;
 class Timers;
 
+namespace GPUDump {
+class Recorder;
+}
+
 class GPU
 {
 public:
@@ -83,6 +87,27 @@ public:
     Disabled = 4 // Not a register value
   };
 
+  // Why buffered primitives are being drawn, so backends can count batch breaks and skip ones they don't need.
+  enum class FlushReason : u8
+  {
+    Other,
+    VBlank,
+    VRAMTransfer,
+    DrawingArea,
+    DrawingOffset,
+    TextureWindow,
+    MaskBit,
+    DisplayField,
+    TexturePageDirty,
+    TextureMode,
+    TransparencyMode,
+    RenderState,
+    BufferFull,
+    VertexDepthReset,
+
+    Count
+  };
+
   enum : u32
   {
     VRAM_WIDTH = 1024,
@@ -99,6 +124,8 @@ public:
     DOT_TIMER_INDEX = 0,
     HBLANK_TIMER_INDEX = 1,
     MAX_RESOLUTION_SCALE = 16,
+    MAX_SOFTWARE_RESOLUTION_SCALE = 4,
+    MAX_RENDER_THREADS = 16,
     DITHER_MATRIX_SIZE = 4
   };
 
@@ -116,6 +143,16 @@ public:
                                                                                 {-3, +1, -4, +0},  // row 2
                                                                                 {+4, -1, +2, -2}}; // row 3
 
+  struct Stats
+  {
+    u32 num_vram_reads;
+    u32 num_vram_fills;
+    u32 num_vram_writes;
+    u32 num_vram_copies;
+    u32 num_vertices;
+    u32 num_polygons;
+  };
+
   // Base class constructor.
   GPU();
   virtual ~GPU();
@@ -131,6 +168,13 @@ public:
   virtual void ResetGraphicsAPIState();
   virtual void RestoreGraphicsAPIState();
 
+  /// Draws the display and the UI to the host's window, and presents it. Renderers with their own thread queue this
+  /// after the frame's rendering instead of waiting for it, so call this rather than HostDisplay::Render().
+  virtual void PresentDisplay();
+
+  /// Resizes the host's window from the thread which is rendering to it.
+  virtual void ResizeDisplayWindow(s32 width, s32 height);
+
   // Render statistics debug window.
   void DrawDebugStateWindow();
 
@@ -142,6 +186,22 @@ public:
   void DMARead(u32* words, u32 word_count);
   void DMAWrite(const u32* words, u32 word_count);
 
+  /// Returns the statistics accumulated since the debug window last displayed them.
+  ALWAYS_INLINE const Stats& GetStats() const { return m_stats; }
+
+  /// Sets the recorder which register writes, DMA blocks and vblanks are passed to, or null to stop recording.
+  ALWAYS_INLINE void SetDumpRecorder(GPUDump::Recorder* recorder) { m_dump_recorder = recorder; }
+
+  // Replaying of GPU dumps, standing in for the CPU and timing events when the rest of the system isn't running.
+  void BeginReplay();
+  void ReplayGPUREADRead(u32 word_count);
+  void ReplayCommandTicks(TickCount ticks);
+  void ReplayActiveLineLSB(u8 lsb);
+  void ReplayVBlank();
+
+  /// Flushes any pending rendering, and returns the contents of VRAM, downloading it from the host GPU if needed.
+  const u16* GetVRAM();
+
   /// Returns the number of pending GPU ticks.
   TickCount GetPendingCRTCTicks() const;
   TickCount GetPendingCommandTicks() const;
@@ -413,10 +473,15 @@ protected:
   virtual void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data);
   virtual void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height);
   virtual void DispatchRenderCommand();
-  virtual void FlushRender();
+  virtual void FlushRender(FlushReason reason);
   virtual void UpdateDisplay();
   virtual void DrawRendererStats(bool is_idle_frame);
 
+  // VRAM operations on m_vram_ptr, with the GPU state they depend on passed in.
+  void DoFillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u32 active_field);
+  void DoUpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, u16 mask_and, u16 mask_or);
+  void DoCopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, u16 mask_and, u16 mask_or);
+
   // These are **very** approximate.
   ALWAYS_INLINE void AddDrawTriangleTicks(u32 width, u32 height, bool shaded, bool textured, bool semitransparent)
   {
@@ -713,18 +778,11 @@ protected:
   u32 m_blit_remaining_words;
   RenderCommand m_render_command{};
 
+  GPUDump::Recorder* m_dump_recorder = nullptr;
+
   TickCount m_max_run_ahead = 128;
   u32 m_fifo_size = 128;
 
-  struct Stats
-  {
-    u32 num_vram_reads;
-    u32 num_vram_fills;
-    u32 num_vram_writes;
-    u32 num_vram_copies;
-    u32 num_vertices;
-    u32 num_polygons;
-  };
   Stats m_stats = {};
   Stats m_last_stats = {};
 
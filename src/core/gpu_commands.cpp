@@ -245,7 +245,7 @@ bool GPU::HandleSetDrawingAreaTopLeftCommand()
   Log_DebugPrintf("Set drawing area top-left: (%u, %u)", left, top);
   if (m_drawing_area.left != left || m_drawing_area.top != top)
   {
-    FlushRender();
+    FlushRender(FlushReason::DrawingArea);
 
     m_drawing_area.left = left;
     m_drawing_area.top = top;
@@ -266,7 +266,7 @@ bool GPU::HandleSetDrawingAreaBottomRightCommand()
   Log_DebugPrintf("Set drawing area bottom-right: (%u, %u)", m_drawing_area.right, m_drawing_area.bottom);
   if (m_drawing_area.right != right || m_drawing_area.bottom != bottom)
   {
-    FlushRender();
+    FlushRender(FlushReason::DrawingArea);
 
     m_drawing_area.right = right;
     m_drawing_area.bottom = bottom;
@@ -286,7 +286,7 @@ bool GPU::HandleSetDrawingOffsetCommand()
   Log_DebugPrintf("Set drawing offset (%d, %d)", m_drawing_offset.x, m_drawing_offset.y);
   if (m_drawing_offset.x != x || m_drawing_offset.y != y)
   {
-    FlushRender();
+    FlushRender(FlushReason::DrawingOffset);
 
     m_drawing_offset.x = x;
     m_drawing_offset.y = y;
@@ -305,7 +305,7 @@ bool GPU::HandleSetMaskBitCommand()
   const u32 gpustat_bits = (param & 0x03) << 11;
   if ((m_GPUSTAT.bits & gpustat_mask) != gpustat_bits)
   {
-    FlushRender();
+    FlushRender(FlushReason::MaskBit);
     m_GPUSTAT.bits = (m_GPUSTAT.bits & ~gpustat_mask) | gpustat_bits;
   }
   Log_DebugPrintf("Set mask bit %u %u", BoolToUInt32(m_GPUSTAT.set_mask_while_drawing),
@@ -450,7 +450,7 @@ bool GPU::HandleFillRectangleCommand()
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
 
-  FlushRender();
+  FlushRender(FlushReason::VRAMTransfer);
 
   const u32 color = m_fifo.Pop() & 0x00FFFFFF;
   const u32 dst_x = m_fifo.Peek() & 0x3F0;
@@ -506,7 +506,7 @@ void GPU::FinishVRAMWrite()
   if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
     SynchronizeCRTC();
 
-  FlushRender();
+  FlushRender(FlushReason::VRAMTransfer);
 
   UpdateVRAM(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height, m_blit_buffer.data());
   m_blit_buffer.clear();
@@ -530,7 +530,7 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
   DebugAssert(m_vram_transfer.col == 0 && m_vram_transfer.row == 0);
 
   // all rendering should be done first...
-  FlushRender();
+  FlushRender(FlushReason::VRAMTransfer);
 
   // ensure VRAM shadow is up to date
   ReadVRAM(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height);
@@ -564,7 +564,7 @@ bool GPU::HandleCopyRectangleVRAMToVRAMCommand()
   Log_DebugPrintf("Copy rectangle from VRAM to VRAM src=(%u,%u), dst=(%u,%u), size=(%u,%u)", src_x, src_y, dst_x, dst_y,
                   width, height);
 
-  FlushRender();
+  FlushRender(FlushReason::VRAMTransfer);
   CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
   m_stats.num_vram_copies++;
   AddCommandTicks(width * height * 2);
@@ -0,0 +1,249 @@
+#include "gpu_dump.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include <cstring>
+Log_SetChannel(GPUDump);
+
+namespace GPUDump {
+
+static constexpr u32 FILE_MAGIC = 0x50444744; // DGDP
+static constexpr u32 FILE_VERSION = 1;
+
+#pragma pack(push, 4)
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 state_size;
+};
+#pragma pack(pop)
+
+// Packets are a type byte, followed by the register value for writes, the variable-length word count and words of
+// DMA blocks, or a variable-length count/value for everything else.
+
+Recorder::Recorder(std::FILE* fp) : m_fp(fp)
+{
+  m_buffer.reserve(BUFFER_SIZE);
+}
+
+Recorder::~Recorder()
+{
+  FlushBuffer();
+  std::fclose(m_fp);
+}
+
+std::unique_ptr<Recorder> Recorder::Create(const char* filename, const void* state_data, u32 state_size)
+{
+  std::FILE* fp = FileSystem::OpenCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", filename);
+    return nullptr;
+  }
+
+  const FileHeader header = {FILE_MAGIC, FILE_VERSION, state_size};
+  if (std::fwrite(&header, sizeof(header), 1, fp) != 1 || std::fwrite(state_data, state_size, 1, fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write state to '%s'", filename);
+    std::fclose(fp);
+    return nullptr;
+  }
+
+  return std::unique_ptr<Recorder>(new Recorder(fp));
+}
+
+void Recorder::WriteGP0(u32 value)
+{
+  BeginPacket(PacketType::GP0Write);
+  WriteWords(&value, 1);
+}
+
+void Recorder::WriteGP1(u32 value)
+{
+  BeginPacket(PacketType::GP1Write);
+  WriteWords(&value, 1);
+}
+
+void Recorder::WriteDMA(const u32* words, u32 word_count)
+{
+  BeginPacket(PacketType::DMAWrite);
+  WriteVarInt(word_count);
+  WriteWords(words, word_count);
+}
+
+void Recorder::ReadGPUREAD(u32 word_count)
+{
+  BeginPacket(PacketType::GPUREADRead);
+  WriteVarInt(word_count);
+}
+
+void Recorder::CommandTicks(TickCount ticks)
+{
+  BeginPacket(PacketType::CommandTicks);
+  WriteVarInt(static_cast<u32>(ticks));
+}
+
+void Recorder::ActiveLineLSB(u8 lsb)
+{
+  BeginPacket(PacketType::ActiveLineLSB);
+  WriteVarInt(lsb);
+}
+
+void Recorder::VBlank()
+{
+  BeginPacket(PacketType::VBlank);
+}
+
+void Recorder::BeginPacket(PacketType type)
+{
+  if (m_buffer.size() >= BUFFER_SIZE)
+    FlushBuffer();
+
+  m_buffer.push_back(static_cast<u8>(type));
+}
+
+void Recorder::WriteVarInt(u32 value)
+{
+  while (value >= 0x80)
+  {
+    m_buffer.push_back(static_cast<u8>(value | 0x80));
+    value >>= 7;
+  }
+  m_buffer.push_back(static_cast<u8>(value));
+}
+
+void Recorder::WriteWords(const u32* words, u32 word_count)
+{
+  const size_t offset = m_buffer.size();
+  m_buffer.resize(offset + word_count * sizeof(u32));
+  std::memcpy(&m_buffer[offset], words, word_count * sizeof(u32));
+}
+
+void Recorder::FlushBuffer()
+{
+  if (m_buffer.empty())
+    return;
+
+  if (std::fwrite(m_buffer.data(), m_buffer.size(), 1, m_fp) != 1)
+    Log_ErrorPrintf("Failed to write %zu bytes to GPU dump", m_buffer.size());
+
+  m_buffer.clear();
+}
+
+Reader::Reader() = default;
+
+Reader::~Reader() = default;
+
+bool Reader::Open(const char* filename)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename);
+  if (!data.has_value())
+  {
+    Log_ErrorPrintf("Failed to read '%s'", filename);
+    return false;
+  }
+
+  FileHeader header;
+  if (data->size() < sizeof(header))
+  {
+    Log_ErrorPrintf("'%s' is too small to be a GPU dump", filename);
+    return false;
+  }
+
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (header.magic != FILE_MAGIC || header.version != FILE_VERSION ||
+      header.state_size > (data->size() - sizeof(header)))
+  {
+    Log_ErrorPrintf("'%s' is not a valid GPU dump, or is from a different version", filename);
+    return false;
+  }
+
+  m_data = std::move(data.value());
+  m_state_offset = sizeof(header);
+  m_state_size = header.state_size;
+  m_packets_offset = m_state_offset + m_state_size;
+  m_position = m_packets_offset;
+  return true;
+}
+
+void Reader::Rewind()
+{
+  m_position = m_packets_offset;
+}
+
+bool Reader::ReadPacket(Packet* packet)
+{
+  if (m_position == m_data.size())
+    return false;
+
+  const u8 type = m_data[m_position++];
+  if (type >= static_cast<u8>(PacketType::Count))
+  {
+    Log_ErrorPrintf("Corrupted packet at offset %u", m_position - 1);
+    return false;
+  }
+
+  packet->type = static_cast<PacketType>(type);
+  packet->value = 0;
+
+  switch (packet->type)
+  {
+    case PacketType::GP0Write:
+    case PacketType::GP1Write:
+    {
+      if ((m_data.size() - m_position) < sizeof(u32))
+        return false;
+
+      std::memcpy(&packet->value, &m_data[m_position], sizeof(u32));
+      m_position += sizeof(u32);
+    }
+    break;
+
+    case PacketType::DMAWrite:
+    {
+      if (!ReadVarInt(&packet->value) || ((m_data.size() - m_position) / sizeof(u32)) < packet->value)
+        return false;
+
+      packet->words.resize(packet->value);
+      std::memcpy(packet->words.data(), &m_data[m_position], packet->value * sizeof(u32));
+      m_position += packet->value * sizeof(u32);
+    }
+    break;
+
+    case PacketType::GPUREADRead:
+    case PacketType::CommandTicks:
+    case PacketType::ActiveLineLSB:
+    {
+      if (!ReadVarInt(&packet->value))
+        return false;
+    }
+    break;
+
+    default:
+      break;
+  }
+
+  return true;
+}
+
+bool Reader::ReadVarInt(u32* value)
+{
+  u32 result = 0;
+  for (u32 shift = 0; shift < 32; shift += 7)
+  {
+    if (m_position == m_data.size())
+      return false;
+
+    const u8 byte = m_data[m_position++];
+    result |= static_cast<u32>(byte & 0x7F) << shift;
+    if (!(byte & 0x80))
+    {
+      *value = result;
+      return true;
+    }
+  }
+
+  return false;
+}
+
+} // namespace GPUDump
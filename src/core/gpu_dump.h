@@ -0,0 +1,95 @@
+#pragma once
+#include "types.h"
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+/// Recording of the command stream sent to the GPU, for replaying against a renderer without the rest of the system.
+/// A dump consists of a save state taken when recording started, followed by every GP0/GP1 write, DMA block and
+/// GPUREAD read, plus the timing events which change what the GPU does with them: command execution slices, vblanks
+/// and changes of the field being drawn to.
+namespace GPUDump {
+
+enum class PacketType : u8
+{
+  GP0Write,
+  GP1Write,
+  DMAWrite,
+  GPUREADRead,
+  CommandTicks,
+  ActiveLineLSB,
+  VBlank,
+  Count
+};
+
+struct Packet
+{
+  PacketType type;
+
+  // Register value for writes, number of words for DMA blocks and GPUREAD reads, system ticks for command slices,
+  // or the new active line LSB.
+  u32 value;
+
+  // Words of a DMA block.
+  std::vector<u32> words;
+};
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Creates the dump file, writing the save state which replays will start from.
+  static std::unique_ptr<Recorder> Create(const char* filename, const void* state_data, u32 state_size);
+
+  void WriteGP0(u32 value);
+  void WriteGP1(u32 value);
+  void WriteDMA(const u32* words, u32 word_count);
+  void ReadGPUREAD(u32 word_count);
+  void CommandTicks(TickCount ticks);
+  void ActiveLineLSB(u8 lsb);
+  void VBlank();
+
+private:
+  static constexpr u32 BUFFER_SIZE = 64 * 1024;
+
+  Recorder(std::FILE* fp);
+
+  void BeginPacket(PacketType type);
+  void WriteVarInt(u32 value);
+  void WriteWords(const u32* words, u32 word_count);
+  void FlushBuffer();
+
+  std::FILE* m_fp;
+  std::vector<u8> m_buffer;
+};
+
+class Reader
+{
+public:
+  Reader();
+  ~Reader();
+
+  ALWAYS_INLINE const u8* GetStateData() const { return m_data.data() + m_state_offset; }
+  ALWAYS_INLINE u32 GetStateSize() const { return m_state_size; }
+
+  /// Reads the whole dump into memory, so replays aren't limited by file access.
+  bool Open(const char* filename);
+
+  /// Returns to the first packet.
+  void Rewind();
+
+  /// Decodes the next packet, returning false at the end of the dump.
+  bool ReadPacket(Packet* packet);
+
+private:
+  bool ReadVarInt(u32* value);
+
+  std::vector<u8> m_data;
+  u32 m_state_offset = 0;
+  u32 m_state_size = 0;
+  u32 m_packets_offset = 0;
+  u32 m_position = 0;
+};
+
+} // namespace GPUDump
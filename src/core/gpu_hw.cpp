@@ -1,5 +1,6 @@
 #include "gpu_hw.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
 #include "settings.h"
@@ -32,6 +33,7 @@ bool GPU_HW::Initialize(HostDisplay* host_display, System* system, DMA* dma, Int
   m_true_color = settings.gpu_true_color;
   m_scaled_dithering = settings.gpu_scaled_dithering;
   m_texture_filtering = settings.gpu_texture_filtering;
+  m_compute_vram_transfers = settings.gpu_compute_vram_transfers && m_supports_compute_vram_transfers;
   if (m_resolution_scale < 1 || m_resolution_scale > m_max_resolution_scale)
   {
     m_system->GetHostInterface()->AddFormattedOSDMessage(5.0f, "Invalid resolution scale %ux specified. Maximum is %u.",
@@ -48,6 +50,10 @@ void GPU_HW::Reset()
   GPU::Reset();
 
   m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_batch_bounds.SetInvalid();
+  m_batch_drawing_area_deferred = false;
+  m_vram_readback_history_frames = 0;
+  m_vram_readback_this_frame = false;
 
   m_vram_shadow.fill(0);
 
@@ -68,6 +74,8 @@ bool GPU_HW::DoState(StateWrapper& sw)
   if (sw.IsReading())
   {
     m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+    m_batch_bounds.SetInvalid();
+    m_batch_drawing_area_deferred = false;
     SetFullVRAMDirtyRectangle();
     ResetBatchVertexDepth();
   }
@@ -77,6 +85,10 @@ bool GPU_HW::DoState(StateWrapper& sw)
 
 void GPU_HW::UpdateSettings()
 {
+  // backends recreate their resources, which has to happen on this thread
+  StopGPUThread();
+  m_speculative_vram_readback_pending = false;
+
   GPU::UpdateSettings();
 
   const Settings& settings = m_system->GetSettings();
@@ -84,9 +96,224 @@ void GPU_HW::UpdateSettings()
   m_true_color = settings.gpu_true_color;
   m_scaled_dithering = settings.gpu_scaled_dithering;
   m_texture_filtering = settings.gpu_texture_filtering;
+  m_compute_vram_transfers = settings.gpu_compute_vram_transfers && m_supports_compute_vram_transfers;
   PrintSettingsToLog();
 }
 
+void GPU_HW::ResetGraphicsAPIState()
+{
+  if (!IsUsingGPUThread())
+  {
+    DoResetGraphicsAPIState();
+    return;
+  }
+
+  // hand the context back to the host once everything queued has been drawn
+  RunOnGPUThread([this]() {
+    DoResetGraphicsAPIState();
+    m_host_display->DoneRenderContextCurrent();
+  });
+  SyncGPUThread();
+
+  if (!m_host_display->MakeRenderContextCurrent())
+    Panic("Failed to make render context current on CPU thread");
+}
+
+void GPU_HW::RestoreGraphicsAPIState()
+{
+  if (!IsUsingGPUThread())
+  {
+    DoRestoreGraphicsAPIState();
+    return;
+  }
+
+  m_host_display->DoneRenderContextCurrent();
+  RunOnGPUThread([this]() {
+    if (!m_host_display->MakeRenderContextCurrent())
+      Panic("Failed to make render context current on GPU thread");
+
+    DoRestoreGraphicsAPIState();
+  });
+}
+
+void GPU_HW::PresentDisplay()
+{
+  if (!IsUsingGPUThread())
+  {
+    GPU::PresentDisplay();
+    return;
+  }
+
+  // The UI's draw data is built on this thread, so it has to be copied for the GPU thread. There's only one copy,
+  // which is free again once the last frame has been presented.
+  WaitForGPUThread(m_gpu_thread_present_pos);
+  m_host_display->SaveImGuiDrawData();
+
+  RunOnGPUThread([this]() {
+    DoResetGraphicsAPIState();
+    m_host_display->Render();
+    DoRestoreGraphicsAPIState();
+  });
+  m_gpu_thread_present_pos = m_gpu_thread_write_pos.load();
+}
+
+void GPU_HW::ResizeDisplayWindow(s32 width, s32 height)
+{
+  if (!IsUsingGPUThread())
+  {
+    GPU::ResizeDisplayWindow(width, height);
+    return;
+  }
+
+  RunOnGPUThread([this, width, height]() {
+    DoResetGraphicsAPIState();
+    m_host_display->ResizeRenderWindow(width, height);
+    DoRestoreGraphicsAPIState();
+  });
+
+  // The host display updates its window size and the UI's display size, which the caller uses straight away. Resizes
+  // are rare, so waiting here doesn't hold up emulation.
+  SyncGPUThread();
+}
+
+void GPU_HW::StartGPUThread()
+{
+  if (IsUsingGPUThread())
+    return;
+
+  FlushRender(FlushReason::Other);
+
+  m_gpu_thread_queue = std::make_unique<u8[]>(GPU_THREAD_QUEUE_SIZE);
+  m_gpu_thread_read_pos.store(0);
+  m_gpu_thread_write_pos.store(0);
+  m_gpu_thread_present_pos = 0;
+  m_gpu_thread_sleeping.store(false);
+  m_cpu_thread_waiting.store(false);
+  m_gpu_thread_exit = false;
+  m_batch_staging_vertices.resize(MAX_STAGED_BATCH_VERTEX_COUNT);
+
+  m_host_display->DoneRenderContextCurrent();
+  m_gpu_thread = std::thread(&GPU_HW::GPUThreadEntryPoint, this);
+  Log_InfoPrint("GPU thread started");
+}
+
+void GPU_HW::StopGPUThread()
+{
+  if (!IsUsingGPUThread())
+    return;
+
+  FlushRender(FlushReason::Other);
+  RunOnGPUThread([this]() {
+    m_host_display->DoneRenderContextCurrent();
+    m_gpu_thread_exit = true;
+  });
+  m_gpu_thread.join();
+
+  if (!m_host_display->MakeRenderContextCurrent())
+    Panic("Failed to make render context current on CPU thread");
+
+  m_gpu_thread_queue.reset();
+  m_batch_staging_vertices = {};
+  Log_InfoPrint("GPU thread stopped");
+}
+
+void GPU_HW::SyncGPUThread()
+{
+  if (IsUsingGPUThread())
+    WaitForGPUThread(m_gpu_thread_write_pos.load());
+}
+
+GPU_HW::GPUThreadCommand* GPU_HW::AllocateGPUThreadCommand(u32 size)
+{
+  DebugAssert(size <= (GPU_THREAD_QUEUE_SIZE / 2) && std::this_thread::get_id() != m_gpu_thread.get_id());
+
+  // commands are contiguous, so pad out the end of the queue if this one doesn't fit before it
+  u32 write_pos = m_gpu_thread_write_pos.load(std::memory_order_relaxed);
+  const u32 space_before_end = GPU_THREAD_QUEUE_SIZE - (write_pos % GPU_THREAD_QUEUE_SIZE);
+  const u32 required = (space_before_end < size) ? (space_before_end + size) : size;
+  WaitForGPUThread(write_pos + required - GPU_THREAD_QUEUE_SIZE);
+
+  if (space_before_end < size)
+  {
+    GPUThreadCommand* padding =
+      reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_queue[write_pos % GPU_THREAD_QUEUE_SIZE]);
+    padding->execute = nullptr;
+    padding->size = space_before_end;
+    write_pos += space_before_end;
+    m_gpu_thread_write_pos.store(write_pos);
+  }
+
+  GPUThreadCommand* cmd = reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_queue[write_pos % GPU_THREAD_QUEUE_SIZE]);
+  cmd->size = size;
+  return cmd;
+}
+
+void GPU_HW::PushGPUThreadCommand(u32 size)
+{
+  m_gpu_thread_write_pos.fetch_add(size);
+  if (m_gpu_thread_sleeping.load())
+  {
+    std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+    m_gpu_thread_wake_cv.notify_one();
+  }
+}
+
+void GPU_HW::WaitForGPUThread(u32 pos)
+{
+  // positions wrap, so compare the distance rather than the values
+  const auto reached = [this, pos]() { return static_cast<s32>(m_gpu_thread_read_pos.load() - pos) >= 0; };
+  if (reached())
+    return;
+
+  std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+  m_cpu_thread_waiting.store(true);
+  m_gpu_thread_done_cv.wait(lock, reached);
+  m_cpu_thread_waiting.store(false);
+}
+
+void GPU_HW::GPUThreadEntryPoint()
+{
+  if (!m_host_display->MakeRenderContextCurrent())
+    Panic("Failed to make render context current on GPU thread");
+
+  u32 read_pos = m_gpu_thread_read_pos.load();
+  while (!m_gpu_thread_exit)
+  {
+    if (read_pos == m_gpu_thread_write_pos.load())
+    {
+      // the CPU thread usually queues more work shortly, so don't go to sleep straight away
+      for (u32 i = 0; i < GPU_THREAD_SPIN_COUNT && read_pos == m_gpu_thread_write_pos.load(); i++)
+        std::this_thread::yield();
+
+      if (read_pos == m_gpu_thread_write_pos.load())
+      {
+        std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+        m_gpu_thread_sleeping.store(true);
+        m_gpu_thread_wake_cv.wait(lock, [this, read_pos]() { return read_pos != m_gpu_thread_write_pos.load(); });
+        m_gpu_thread_sleeping.store(false);
+      }
+    }
+
+    const u32 write_pos = m_gpu_thread_write_pos.load();
+    while (read_pos != write_pos)
+    {
+      GPUThreadCommand* cmd =
+        reinterpret_cast<GPUThreadCommand*>(&m_gpu_thread_queue[read_pos % GPU_THREAD_QUEUE_SIZE]);
+      const u32 size = cmd->size;
+      if (cmd->execute)
+        cmd->execute(cmd);
+
+      read_pos += size;
+      m_gpu_thread_read_pos.store(read_pos);
+      if (m_cpu_thread_waiting.load())
+      {
+        std::unique_lock<std::mutex> lock(m_gpu_thread_mutex);
+        m_gpu_thread_done_cv.notify_one();
+      }
+    }
+  }
+}
+
 void GPU_HW::PrintSettingsToLog()
 {
   Log_InfoPrintf("Resolution Scale: %u (%ux%u), maximum %u", m_resolution_scale, VRAM_WIDTH * m_resolution_scale,
@@ -95,12 +322,77 @@ void GPU_HW::PrintSettingsToLog()
                  (!m_true_color && m_scaled_dithering) ? " (Scaled)" : "");
   Log_InfoPrintf("Texture Filtering: %s", m_texture_filtering ? "Enabled" : "Disabled");
   Log_InfoPrintf("Dual-source blending: %s", m_supports_dual_source_blend ? "Supported" : "Not supported");
+  Log_InfoPrintf("Compute VRAM transfers: %s",
+                 m_compute_vram_transfers ? "Enabled" :
+                                            (m_supports_compute_vram_transfers ? "Disabled" : "Not supported"));
+}
+
+bool GPU_HW::IsVRAMDirty(const Common::Rectangle<u32>& rect) const
+{
+  const u32 column_mask = GetVRAMDirtyTileColumnMask(rect.left, rect.right);
+  const u32 bottom = std::min<u32>(rect.bottom, VRAM_HEIGHT);
+  if (column_mask == 0 || rect.top >= bottom)
+    return false;
+
+  const u32 last_row = (bottom - 1) / VRAM_DIRTY_TILE_SIZE;
+  for (u32 row = rect.top / VRAM_DIRTY_TILE_SIZE; row <= last_row; row++)
+  {
+    if (m_vram_dirty_tiles[row] & column_mask)
+      return true;
+  }
+
+  return false;
 }
 
-void GPU_HW::UpdateVRAMReadTexture()
+void GPU_HW::UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect)
 {
+  static_assert(VRAM_DIRTY_TILE_COLUMNS <= 16, "tile columns fit in the row mask");
+
+  const u32 column_mask = GetVRAMDirtyTileColumnMask(rect.left, rect.right);
+  const u32 bottom = std::min<u32>(rect.bottom, VRAM_HEIGHT);
+  if (column_mask == 0 || rect.top >= bottom)
+    return;
+
+  // Build a rectangle for each run of dirty columns in a row, extending the previous row's rectangles downwards
+  // instead when the runs are the same.
+  std::array<Common::Rectangle<u32>, MAX_VRAM_READ_TEXTURE_COPY_RECTS> rects;
+  u32 num_rects = 0;
+  u32 last_row_first_rect = 0;
+  u32 last_row_mask = 0;
+
+  const u32 last_row = (bottom - 1) / VRAM_DIRTY_TILE_SIZE;
+  for (u32 row = rect.top / VRAM_DIRTY_TILE_SIZE; row <= last_row; row++)
+  {
+    const u32 row_mask = m_vram_dirty_tiles[row] & column_mask;
+    m_vram_dirty_tiles[row] &= static_cast<u16>(~column_mask);
+    if (row_mask == last_row_mask)
+    {
+      for (u32 i = last_row_first_rect; i < num_rects; i++)
+        rects[i].bottom += VRAM_DIRTY_TILE_SIZE;
+
+      continue;
+    }
+
+    last_row_first_rect = num_rects;
+    last_row_mask = row_mask;
+
+    u32 remaining_mask = row_mask;
+    while (remaining_mask != 0)
+    {
+      const u32 first_column = CountTrailingZeros(remaining_mask);
+      const u32 num_columns = CountTrailingZeros(~(remaining_mask >> first_column));
+      rects[num_rects++] =
+        Common::Rectangle<u32>(first_column * VRAM_DIRTY_TILE_SIZE, row * VRAM_DIRTY_TILE_SIZE,
+                               (first_column + num_columns) * VRAM_DIRTY_TILE_SIZE, (row + 1) * VRAM_DIRTY_TILE_SIZE);
+      remaining_mask &= ~(((1u << num_columns) - 1u) << first_column);
+    }
+  }
+
+  if (num_rects == 0)
+    return;
+
   m_renderer_stats.num_vram_read_texture_updates++;
-  ClearVRAMDirtyRectangle();
+  CopyVRAMToReadTexture(rects.data(), num_rects);
 }
 
 void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
@@ -211,6 +503,7 @@ void GPU_HW::LoadVertices()
 {
   const RenderCommand rc{m_render_command.bits};
   const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  const u32 texwindow = m_draw_mode.texture_window_value;
 
   if (m_GPUSTAT.check_mask_before_draw)
     m_current_depth++;
@@ -234,7 +527,7 @@ void GPU_HW::LoadVertices()
         const u16 packed_texcoord = textured ? Truncate16(m_fifo.Pop()) : 0;
 
         vertices[i].Set(m_drawing_offset.x + vp.x, m_drawing_offset.y + vp.y, m_current_depth, color, texpage,
-                        packed_texcoord);
+                        texwindow, packed_texcoord);
       }
 
       if (rc.quad_polygon && m_resolution_scale > 1)
@@ -266,7 +559,8 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        SetVRAMDirtyTiles(clip_left, clip_right, clip_top, clip_bottom);
+        m_batch_bounds.Include(min_x, max_x + 1, min_y, max_y + 1);
         AddDrawTriangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable, rc.texture_enable,
                              rc.transparency_enable);
 
@@ -297,7 +591,8 @@ void GPU_HW::LoadVertices()
           const u32 clip_bottom =
             static_cast<u32>(std::clamp<s32>(max_y_123, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-          m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+          SetVRAMDirtyTiles(clip_left, clip_right, clip_top, clip_bottom);
+          m_batch_bounds.Include(min_x_123, max_x_123 + 1, min_y_123, max_y_123 + 1);
           AddDrawTriangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable, rc.texture_enable,
                                rc.transparency_enable);
 
@@ -374,13 +669,13 @@ void GPU_HW::LoadVertices()
           const s32 quad_end_x = quad_start_x + quad_width;
           const u16 tex_right = tex_left + static_cast<u16>(quad_width);
 
-          AddNewVertex(quad_start_x, quad_start_y, m_current_depth, color, texpage, tex_left, tex_top);
-          AddNewVertex(quad_end_x, quad_start_y, m_current_depth, color, texpage, tex_right, tex_top);
-          AddNewVertex(quad_start_x, quad_end_y, m_current_depth, color, texpage, tex_left, tex_bottom);
+          AddNewVertex(quad_start_x, quad_start_y, m_current_depth, color, texpage, texwindow, tex_left, tex_top);
+          AddNewVertex(quad_end_x, quad_start_y, m_current_depth, color, texpage, texwindow, tex_right, tex_top);
+          AddNewVertex(quad_start_x, quad_end_y, m_current_depth, color, texpage, texwindow, tex_left, tex_bottom);
 
-          AddNewVertex(quad_start_x, quad_end_y, m_current_depth, color, texpage, tex_left, tex_bottom);
-          AddNewVertex(quad_end_x, quad_start_y, m_current_depth, color, texpage, tex_right, tex_top);
-          AddNewVertex(quad_end_x, quad_end_y, m_current_depth, color, texpage, tex_right, tex_bottom);
+          AddNewVertex(quad_start_x, quad_end_y, m_current_depth, color, texpage, texwindow, tex_left, tex_bottom);
+          AddNewVertex(quad_end_x, quad_start_y, m_current_depth, color, texpage, texwindow, tex_right, tex_top);
+          AddNewVertex(quad_end_x, quad_end_y, m_current_depth, color, texpage, texwindow, tex_right, tex_bottom);
 
           x_offset += quad_width;
           tex_left = 0;
@@ -397,7 +692,8 @@ void GPU_HW::LoadVertices()
       const u32 clip_bottom =
         static_cast<u32>(std::clamp<s32>(pos_y + rectangle_height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-      m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+      SetVRAMDirtyTiles(clip_left, clip_right, clip_top, clip_bottom);
+      m_batch_bounds.Include(pos_x, pos_x + rectangle_width, pos_y, pos_y + rectangle_height);
       AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable, rc.transparency_enable);
     }
     break;
@@ -428,8 +724,8 @@ void GPU_HW::LoadVertices()
           return;
 
         BatchVertex start, end;
-        start.Set(m_drawing_offset.x + pos0.x, m_drawing_offset.y + pos0.y, m_current_depth, color0, 0, 0);
-        end.Set(m_drawing_offset.x + pos1.x, m_drawing_offset.y + pos1.y, m_current_depth, color1, 0, 0);
+        start.Set(m_drawing_offset.x + pos0.x, m_drawing_offset.y + pos0.y, m_current_depth, color0, 0, 0, 0);
+        end.Set(m_drawing_offset.x + pos1.x, m_drawing_offset.y + pos1.y, m_current_depth, color1, 0, 0, 0);
 
         const s32 min_x = std::min(start.x, end.x);
         const s32 max_x = std::max(start.x, end.x);
@@ -455,7 +751,8 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        SetVRAMDirtyTiles(clip_left, clip_right, clip_top, clip_bottom);
+        m_batch_bounds.Include(min_x, max_x + 1, min_y, max_y + 1);
         AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
       }
       else
@@ -478,7 +775,7 @@ void GPU_HW::LoadVertices()
           const VertexPosition vp{m_blit_buffer[buffer_pos++]};
 
           BatchVertex vertex;
-          vertex.Set(m_drawing_offset.x + vp.x, m_drawing_offset.y + vp.y, m_current_depth, color, 0, 0);
+          vertex.Set(m_drawing_offset.x + vp.x, m_drawing_offset.y + vp.y, m_current_depth, color, 0, 0, 0);
 
           if (i > 0)
           {
@@ -509,7 +806,8 @@ void GPU_HW::LoadVertices()
               const u32 clip_bottom =
                 static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-              m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+              SetVRAMDirtyTiles(clip_left, clip_right, clip_top, clip_bottom);
+              m_batch_bounds.Include(min_x, max_x + 1, min_y, max_y + 1);
               AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
             }
           }
@@ -528,10 +826,10 @@ void GPU_HW::LoadVertices()
 
 void GPU_HW::CalcScissorRect(int* left, int* top, int* right, int* bottom)
 {
-  *left = m_drawing_area.left * m_resolution_scale;
-  *right = std::max<u32>((m_drawing_area.right + 1) * m_resolution_scale, *left + 1);
-  *top = m_drawing_area.top * m_resolution_scale;
-  *bottom = std::max<u32>((m_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
+  *left = m_scissor_drawing_area.left * m_resolution_scale;
+  *right = std::max<u32>((m_scissor_drawing_area.right + 1) * m_resolution_scale, *left + 1);
+  *top = m_scissor_drawing_area.top * m_resolution_scale;
+  *bottom = std::max<u32>((m_scissor_drawing_area.bottom + 1) * m_resolution_scale, *top + 1);
 }
 
 GPU_HW::VRAMFillUBOData GPU_HW::GetVRAMFillUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const
@@ -604,6 +902,44 @@ GPU_HW::VRAMCopyUBOData GPU_HW::GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst
   return uniforms;
 }
 
+GPU_HW::VRAMTransferUBOData GPU_HW::GetVRAMFillTransferUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const
+{
+  const VRAMFillUBOData fill = GetVRAMFillUBOData(x, y, width, height, color);
+
+  // the field never matches when not interlaced, so no lines are skipped
+  VRAMTransferUBOData uniforms = {{x, y, width, height},
+                                  {},
+                                  {static_cast<u32>(VRAMTransferType::Fill), 0u, 0u,
+                                   IsInterlacedRenderingEnabled() ? fill.u_interlaced_displayed_field : 2u},
+                                  {}};
+  std::memcpy(uniforms.u_fill_color, fill.u_fill_color, sizeof(uniforms.u_fill_color));
+  return uniforms;
+}
+
+GPU_HW::VRAMTransferUBOData GPU_HW::GetVRAMWriteTransferUBOData(u32 x, u32 y, u32 width, u32 height,
+                                                               u32 buffer_offset) const
+{
+  const VRAMTransferUBOData uniforms = {{x % VRAM_WIDTH, y % VRAM_HEIGHT, width, height},
+                                       {buffer_offset, 0u, 0u, 0u},
+                                       {static_cast<u32>(VRAMTransferType::Write),
+                                        m_GPUSTAT.set_mask_while_drawing ? 0x8000u : 0x00,
+                                        BoolToUInt32(m_GPUSTAT.check_mask_before_draw), 0u},
+                                       {}};
+  return uniforms;
+}
+
+GPU_HW::VRAMTransferUBOData GPU_HW::GetVRAMCopyTransferUBOData(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width,
+                                                              u32 height) const
+{
+  const VRAMTransferUBOData uniforms = {{dst_x % VRAM_WIDTH, dst_y % VRAM_HEIGHT, width, height},
+                                       {src_x % VRAM_WIDTH, src_y % VRAM_HEIGHT, 0u, 0u},
+                                       {static_cast<u32>(VRAMTransferType::Copy),
+                                        BoolToUInt32(m_GPUSTAT.set_mask_while_drawing),
+                                        BoolToUInt32(m_GPUSTAT.check_mask_before_draw), 0u},
+                                       {}};
+  return uniforms;
+}
+
 GPU_HW::BatchPrimitive GPU_HW::GetPrimitiveForCommand(RenderCommand rc)
 {
   if (rc.primitive == Primitive::Line)
@@ -614,7 +950,7 @@ GPU_HW::BatchPrimitive GPU_HW::GetPrimitiveForCommand(RenderCommand rc)
 
 void GPU_HW::IncludeVRAMDityRectangle(const Common::Rectangle<u32>& rect)
 {
-  m_vram_dirty_rect.Include(rect);
+  SetVRAMDirtyTiles(rect.left, rect.right, rect.top, rect.bottom);
 
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
@@ -633,10 +969,10 @@ void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
     if (GetBatchVertexSpace() >= required_vertices)
       return;
 
-    FlushRender();
+    FlushRender(FlushReason::BufferFull);
   }
 
-  MapBatchVertexPointer(required_vertices);
+  MapBatchVertices(required_vertices);
 }
 
 void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
@@ -667,21 +1003,101 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
     if (GetBatchVertexSpace() >= required_vertices)
       return;
 
-    FlushRender();
+    FlushRender(FlushReason::BufferFull);
+  }
+
+  MapBatchVertices(required_vertices);
+}
+
+void GPU_HW::MapBatchVertices(u32 required_vertices)
+{
+  m_batch_bounds.SetInvalid();
+
+  if (!IsUsingGPUThread())
+  {
+    u32 space;
+    m_batch_start_vertex_ptr = MapBatchVertexPointer(required_vertices, &space);
+    m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+    m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + space;
+    return;
   }
 
-  MapBatchVertexPointer(required_vertices);
+  // copied to the vertex buffer on the GPU thread when the batch is flushed
+  m_batch_start_vertex_ptr = m_batch_staging_vertices.data();
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + m_batch_staging_vertices.size();
 }
 
 void GPU_HW::ResetBatchVertexDepth()
 {
   Log_PerfPrint("Resetting batch vertex depth");
-  FlushRender();
-  UpdateDepthBufferFromMaskBit();
+  FlushRender(FlushReason::VertexDepthReset);
+  RunOnGPUThread([this]() { UpdateDepthBufferFromMaskBit(); });
 
   m_current_depth = 1;
 }
 
+void GPU_HW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+{
+  // Get bounds with wrap-around handled.
+  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+
+  if (copy_rect == m_vram_readback_history_rect)
+  {
+    if (!m_vram_readback_this_frame)
+      m_vram_readback_history_frames++;
+  }
+  else
+  {
+    m_vram_readback_history_rect = copy_rect;
+    m_vram_readback_history_frames = 1;
+  }
+  m_vram_readback_this_frame = true;
+
+  ReadVRAMToShadow(copy_rect);
+}
+
+void GPU_HW::ReadAllVRAMForRoundTrip()
+{
+  ReadVRAMToShadow(Common::Rectangle<u32>(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+}
+
+void GPU_HW::ReadVRAMToShadow(const Common::Rectangle<u32>& rect)
+{
+  // nothing has written to the speculatively read area since it was started, so it's still current
+  const Common::Rectangle<u32>& spec_rect = m_speculative_vram_readback_rect;
+  if (std::exchange(m_speculative_vram_readback_pending, false) && rect.left >= spec_rect.left &&
+      rect.right <= spec_rect.right && rect.top >= spec_rect.top && rect.bottom <= spec_rect.bottom)
+  {
+    m_renderer_stats.num_speculative_vram_readback_hits++;
+    RunOnGPUThread([this, spec_rect = m_speculative_vram_readback_rect]() { FinishVRAMReadback(spec_rect); });
+  }
+  else
+  {
+    RunOnGPUThread([this, rect]() {
+      BeginVRAMReadback(rect);
+      FinishVRAMReadback(rect);
+    });
+  }
+
+  // the shadow copy is written on the GPU thread
+  SyncGPUThread();
+}
+
+void GPU_HW::StartSpeculativeVRAMReadback()
+{
+  if (!m_supports_async_vram_readback || m_speculative_vram_readback_pending ||
+      m_vram_readback_history_frames < SPECULATIVE_VRAM_READBACK_FRAMES)
+  {
+    return;
+  }
+
+  m_speculative_vram_readback_rect = m_vram_readback_history_rect;
+  m_speculative_vram_readback_pending = true;
+  m_renderer_stats.num_speculative_vram_readbacks++;
+  RunOnGPUThread([this, rect = m_speculative_vram_readback_rect]() { BeginVRAMReadback(rect); });
+}
+
 void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
   IncludeVRAMDityRectangle(
@@ -723,15 +1139,19 @@ void GPU_HW::DispatchRenderCommand()
     if (m_draw_mode.IsTexturePageChanged())
     {
       m_draw_mode.ClearTexturePageChangedFlag();
-      if (m_vram_dirty_rect.Valid() &&
-          (m_draw_mode.GetTexturePageRectangle().Intersects(m_vram_dirty_rect) ||
-           (m_draw_mode.IsUsingPalette() && m_draw_mode.GetTexturePaletteRectangle().Intersects(m_vram_dirty_rect))))
+
+      // only the tiles which are sampled need to be copied, the rest can stay dirty until they're used
+      const Common::Rectangle<u32> page_rect = m_draw_mode.GetTexturePageRectangle();
+      const Common::Rectangle<u32> palette_rect =
+        m_draw_mode.IsUsingPalette() ? m_draw_mode.GetTexturePaletteRectangle() : Common::Rectangle<u32>(0, 0, 0, 0);
+      if (IsVRAMDirty(page_rect) || IsVRAMDirty(palette_rect))
       {
         // Log_DevPrintf("Invalidating VRAM read cache due to drawing area overlap");
         if (!IsFlushed())
-          FlushRender();
+          FlushRender(FlushReason::TexturePageDirty);
 
-        UpdateVRAMReadTexture();
+        UpdateVRAMReadTexture(page_rect);
+        UpdateVRAMReadTexture(palette_rect);
       }
     }
 
@@ -752,10 +1172,27 @@ void GPU_HW::DispatchRenderCommand()
     rc.transparency_enable ? m_draw_mode.GetTransparencyMode() : TransparencyMode::Disabled;
   const BatchPrimitive rc_primitive = GetPrimitiveForCommand(rc);
   const bool dithering_enable = (!m_true_color && rc.IsDitheringEnabled()) ? m_GPUSTAT.dither_enable : false;
-  if (m_batch.texture_mode != texture_mode || m_batch.transparency_mode != transparency_mode ||
-      m_batch.primitive != rc_primitive || dithering_enable != m_batch.dithering)
+  if (m_batch.texture_mode != texture_mode)
+    FlushRender(FlushReason::TextureMode);
+  else if (m_batch.transparency_mode != transparency_mode)
+    FlushRender(FlushReason::TransparencyMode);
+  else if (m_batch.primitive != rc_primitive || dithering_enable != m_batch.dithering)
+    FlushRender(FlushReason::RenderState);
+
+  // the batch can carry on with the new drawing area if everything in it is inside both the old and new areas
+  if (m_batch_drawing_area_deferred)
   {
-    FlushRender();
+    if (IsBatchInsideDrawingArea())
+    {
+      m_batch_drawing_area_deferred = false;
+      m_drawing_area_changed |= m_batch_drawing_area_changed;
+      m_renderer_stats.num_batch_flushes_avoided++;
+    }
+    else
+    {
+      m_renderer_stats.num_batch_flushes[static_cast<u8>(FlushReason::DrawingArea)]++;
+      DrawBufferedBatch();
+    }
   }
 
   EnsureVertexBufferSpaceForCurrentCommand();
@@ -792,53 +1229,137 @@ void GPU_HW::DispatchRenderCommand()
   m_batch.transparency_mode = transparency_mode;
   m_batch.dithering = dithering_enable;
 
-  if (m_draw_mode.IsTextureWindowChanged())
+  if (m_batch_ubo_data.u_texture_mode != static_cast<u32>(texture_mode) ||
+      m_batch_ubo_data.u_dithering != BoolToUInt32(dithering_enable) ||
+      m_batch_ubo_data.u_interlacing != BoolToUInt32(m_batch.interlacing))
   {
-    m_draw_mode.ClearTextureWindowChangedFlag();
-
-    m_batch_ubo_data.u_texture_window_mask[0] = ZeroExtend32(m_draw_mode.texture_window_mask_x);
-    m_batch_ubo_data.u_texture_window_mask[1] = ZeroExtend32(m_draw_mode.texture_window_mask_y);
-    m_batch_ubo_data.u_texture_window_offset[0] = ZeroExtend32(m_draw_mode.texture_window_offset_x);
-    m_batch_ubo_data.u_texture_window_offset[1] = ZeroExtend32(m_draw_mode.texture_window_offset_y);
+    m_batch_ubo_data.u_texture_mode = static_cast<u32>(texture_mode);
+    m_batch_ubo_data.u_dithering = BoolToUInt32(dithering_enable);
+    m_batch_ubo_data.u_interlacing = BoolToUInt32(m_batch.interlacing);
     m_batch_ubo_dirty = true;
   }
 
   LoadVertices();
 }
 
-void GPU_HW::FlushRender()
+void GPU_HW::FlushRender(FlushReason reason)
 {
-  if (!m_batch_current_vertex_ptr)
-    return;
+  if (m_batch_current_vertex_ptr)
+  {
+    if (!IsFlushed())
+    {
+      switch (reason)
+      {
+        case FlushReason::DrawingOffset:
+        case FlushReason::TextureWindow:
+        {
+          // the offset is already applied to the vertices, and the texture window is stored in them
+          m_renderer_stats.num_batch_flushes_avoided++;
+          return;
+        }
+
+        case FlushReason::DrawingArea:
+        {
+          // primitives which weren't clipped by the old area might not be clipped by the new one either, but that
+          // isn't known until the new area is set, so hold onto the old one until the next draw
+          if (m_batch_drawing_area_deferred)
+            return;
+
+          if (IsBatchInsideDrawingArea())
+          {
+            m_batch_drawing_area_deferred = true;
+            m_batch_drawing_area = m_drawing_area;
+            m_batch_drawing_area_changed = std::exchange(m_drawing_area_changed, false);
+            return;
+          }
+        }
+        break;
+
+        default:
+          break;
+      }
+
+      m_renderer_stats.num_batch_flushes[static_cast<u8>(reason)]++;
+    }
+
+    DrawBufferedBatch();
+  }
+
+  // games usually finish drawing to an area they read back before moving the drawing area or the end of the frame
+  if (reason == FlushReason::VBlank)
+  {
+    if (!std::exchange(m_vram_readback_this_frame, false))
+      m_vram_readback_history_frames = 0;
+
+    StartSpeculativeVRAMReadback();
+  }
+  else if (reason == FlushReason::DrawingArea)
+  {
+    StartSpeculativeVRAMReadback();
+  }
+}
 
+void GPU_HW::DrawBufferedBatch()
+{
   const u32 vertex_count = GetBatchVertexCount();
-  UnmapBatchVertexPointer(vertex_count);
+  const BatchVertex* vertices = m_batch_start_vertex_ptr;
+  m_batch_start_vertex_ptr = nullptr;
+  m_batch_end_vertex_ptr = nullptr;
+  m_batch_current_vertex_ptr = nullptr;
+  if (!IsUsingGPUThread())
+    UnmapBatchVertexPointer(vertex_count);
 
   if (vertex_count == 0)
     return;
 
-  if (m_drawing_area_changed)
+  m_renderer_stats.num_batches += m_batch.NeedsTwoPassRendering() ? 2 : 1;
+
+  // a deferred drawing area change leaves the new area to be applied to the next batch
+  const bool drawing_area_deferred = std::exchange(m_batch_drawing_area_deferred, false);
+  const bool ubo_dirty = std::exchange(m_batch_ubo_dirty, false);
+  const bool drawing_area_changed =
+    drawing_area_deferred ? m_batch_drawing_area_changed : std::exchange(m_drawing_area_changed, false);
+  const Common::Rectangle<u32>& drawing_area = drawing_area_deferred ? m_batch_drawing_area : m_drawing_area;
+  if (!IsUsingGPUThread())
+  {
+    DrawBatch(m_batch, m_batch_ubo_data, ubo_dirty, drawing_area_changed, drawing_area, vertex_count);
+    return;
+  }
+
+  RunOnGPUThreadWithData(vertices, vertex_count * sizeof(BatchVertex),
+                         [this, batch = m_batch, ubo_data = m_batch_ubo_data, ubo_dirty, drawing_area_changed,
+                          drawing_area, vertex_count](const void* data) {
+                           u32 space;
+                           BatchVertex* mapped = MapBatchVertexPointer(vertex_count, &space);
+                           std::memcpy(mapped, data, vertex_count * sizeof(BatchVertex));
+                           UnmapBatchVertexPointer(vertex_count);
+                           DrawBatch(batch, ubo_data, ubo_dirty, drawing_area_changed, drawing_area, vertex_count);
+                         });
+}
+
+void GPU_HW::DrawBatch(const BatchConfig& batch, const BatchUBOData& ubo_data, bool ubo_dirty,
+                       bool drawing_area_changed, const Common::Rectangle<u32>& drawing_area, u32 num_vertices)
+{
+  if (drawing_area_changed)
   {
-    m_drawing_area_changed = false;
+    m_scissor_drawing_area = drawing_area;
     SetScissorFromDrawingArea();
   }
 
-  if (m_batch_ubo_dirty)
+  if (ubo_dirty || m_batch_ubo_invalidated)
   {
-    UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
-    m_batch_ubo_dirty = false;
+    UploadUniformBuffer(&ubo_data, sizeof(ubo_data));
+    m_batch_ubo_invalidated = false;
   }
 
-  if (m_batch.NeedsTwoPassRendering())
+  if (batch.NeedsTwoPassRendering())
   {
-    m_renderer_stats.num_batches += 2;
-    DrawBatchVertices(BatchRenderMode::OnlyTransparent, m_batch_base_vertex, vertex_count);
-    DrawBatchVertices(BatchRenderMode::OnlyOpaque, m_batch_base_vertex, vertex_count);
+    DrawBatchVertices(batch, BatchRenderMode::OnlyTransparent, m_batch_base_vertex, num_vertices);
+    DrawBatchVertices(batch, BatchRenderMode::OnlyOpaque, m_batch_base_vertex, num_vertices);
   }
   else
   {
-    m_renderer_stats.num_batches++;
-    DrawBatchVertices(m_batch.GetRenderMode(), m_batch_base_vertex, vertex_count);
+    DrawBatchVertices(batch, batch.GetRenderMode(), m_batch_base_vertex, num_vertices);
   }
 }
 
@@ -872,6 +1393,39 @@ void GPU_HW::DrawRendererStats(bool is_idle_frame)
     ImGui::Text("%u", stats.num_uniform_buffer_updates);
     ImGui::NextColumn();
 
+    ImGui::TextUnformatted("Batch Flushes Avoided:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_batch_flushes_avoided);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Speculative VRAM Readbacks:");
+    ImGui::NextColumn();
+    ImGui::Text("%u (%u used)", stats.num_speculative_vram_readbacks, stats.num_speculative_vram_readback_hits);
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+  }
+
+  if (ImGui::CollapsingHeader("Batch Flush Reasons"))
+  {
+    static constexpr std::array<const char*, static_cast<u8>(FlushReason::Count)> reason_names = {
+      {"Other:", "VBlank:", "VRAM Transfer:", "Drawing Area:", "Drawing Offset:", "Texture Window:", "Mask Bit:",
+       "Display Field:", "Texture Page Dirty:", "Texture Mode:", "Transparency Mode:", "Render State:", "Buffer Full:",
+       "Vertex Depth Reset:"}};
+
+    const auto& stats = m_last_renderer_stats;
+
+    ImGui::Columns(2);
+    ImGui::SetColumnWidth(0, 200.0f * ImGui::GetIO().DisplayFramebufferScale.x);
+
+    for (u32 i = 0; i < static_cast<u32>(reason_names.size()); i++)
+    {
+      ImGui::TextUnformatted(reason_names[i]);
+      ImGui::NextColumn();
+      ImGui::Text("%u", stats.num_batch_flushes[i]);
+      ImGui::NextColumn();
+    }
+
     ImGui::Columns(1);
   }
 }
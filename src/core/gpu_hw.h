@@ -2,9 +2,19 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
 #include <sstream>
 #include <string>
+#include <thread>
 #include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -32,6 +42,13 @@ public:
     SeparateFields
   };
 
+  enum class VRAMTransferType : u32
+  {
+    Fill,
+    Write,
+    Copy
+  };
+
   GPU_HW();
   virtual ~GPU_HW();
 
@@ -43,6 +60,13 @@ public:
   virtual bool DoState(StateWrapper& sw) override;
   virtual void UpdateSettings() override;
 
+  // When the GPU thread is running, these move the render context between it and the host, and wait for everything
+  // queued so far to be drawn. Presenting and resizing don't need them, they're queued for the GPU thread instead.
+  virtual void ResetGraphicsAPIState() override;
+  virtual void RestoreGraphicsAPIState() override;
+  virtual void PresentDisplay() override;
+  virtual void ResizeDisplayWindow(s32 width, s32 height) override;
+
 protected:
   enum : u32
   {
@@ -51,7 +75,14 @@ protected:
     UNIFORM_BUFFER_SIZE = 512 * 1024,
     MAX_BATCH_VERTEX_COUNTER_IDS = 65536 - 2,
     MAX_VERTICES_FOR_RECTANGLE = 6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
-                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u)
+                                 (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u),
+    VRAM_DIRTY_TILE_SIZE = 64,
+    VRAM_DIRTY_TILE_COLUMNS = VRAM_WIDTH / VRAM_DIRTY_TILE_SIZE,
+    VRAM_DIRTY_TILE_ROWS = VRAM_HEIGHT / VRAM_DIRTY_TILE_SIZE,
+    VRAM_DIRTY_TILE_ALL_COLUMNS = (1u << VRAM_DIRTY_TILE_COLUMNS) - 1u,
+
+    // Worst case is alternating dirty and clean tiles, where no rows can be merged.
+    MAX_VRAM_READ_TEXTURE_COPY_RECTS = (VRAM_DIRTY_TILE_COLUMNS / 2) * VRAM_DIRTY_TILE_ROWS
   };
 
   struct BatchVertex
@@ -63,13 +94,14 @@ protected:
     u32 texpage;
     u16 u; // 16-bit texcoords are needed for 256 extent rectangles
     u16 v;
+    u32 texwindow; // per-vertex so that texture window changes don't split batches
 
-    ALWAYS_INLINE void Set(s32 x_, s32 y_, s32 z_, u32 color_, u32 texpage_, u16 packed_texcoord)
+    ALWAYS_INLINE void Set(s32 x_, s32 y_, s32 z_, u32 color_, u32 texpage_, u32 texwindow_, u16 packed_texcoord)
     {
-      Set(x_, y_, z_, color_, texpage_, packed_texcoord & 0xFF, (packed_texcoord >> 8));
+      Set(x_, y_, z_, color_, texpage_, texwindow_, packed_texcoord & 0xFF, (packed_texcoord >> 8));
     }
 
-    ALWAYS_INLINE void Set(s32 x_, s32 y_, s32 z_, u32 color_, u32 texpage_, u16 u_, u16 v_)
+    ALWAYS_INLINE void Set(s32 x_, s32 y_, s32 z_, u32 color_, u32 texpage_, u32 texwindow_, u16 u_, u16 v_)
     {
       x = x_;
       y = y_;
@@ -78,6 +110,7 @@ protected:
       texpage = texpage_;
       u = u_;
       v = v_;
+      texwindow = texwindow_;
     }
   };
 
@@ -109,12 +142,15 @@ protected:
 
   struct BatchUBOData
   {
-    u32 u_texture_window_mask[2];
-    u32 u_texture_window_offset[2];
     float u_src_alpha_factor;
     float u_dst_alpha_factor;
     u32 u_interlaced_displayed_field;
     u32 u_set_mask_while_drawing;
+
+    // Only read by the ubershader, the specialised shaders have these baked in.
+    u32 u_texture_mode;
+    u32 u_dithering;
+    u32 u_interlacing;
   };
 
   struct VRAMFillUBOData
@@ -150,11 +186,24 @@ protected:
     float u_depth_value;
   };
 
+  /// One entry in the list of VRAM transfers executed by a single compute dispatch. Coordinates are native.
+  struct VRAMTransferUBOData
+  {
+    u32 u_dst_rect[4];           // x, y, width, height
+    u32 u_src[4];                // buffer offset for writes, x and y for copies
+    u32 u_params[4];             // type, mask bits to set, check mask bit, interlaced field to skip for fills
+    float u_fill_color[4];
+  };
+
   struct RendererStats
   {
     u32 num_batches;
     u32 num_vram_read_texture_updates;
     u32 num_uniform_buffer_updates;
+    u32 num_batch_flushes_avoided;
+    u32 num_speculative_vram_readbacks;
+    u32 num_speculative_vram_readback_hits;
+    std::array<u32, static_cast<u8>(FlushReason::Count)> num_batch_flushes;
   };
 
   static constexpr std::tuple<float, float, float, float> RGBA8ToFloat(u32 rgba)
@@ -165,24 +214,149 @@ protected:
                            static_cast<float>(rgba >> 24) * (1.0f / 255.0f));
   }
 
-  virtual void UpdateVRAMReadTexture();
+  /// Copies the dirty tiles which intersect the specified area of VRAM to the read texture, and marks them as clean.
+  void UpdateVRAMReadTexture(const Common::Rectangle<u32>& rect);
+
+  /// Copies the specified areas of VRAM, in native coordinates, to the read texture.
+  virtual void CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects) = 0;
+
+  // Everything below runs on the GPU thread when it's running, and must not read state owned by the CPU thread.
+  virtual void DoResetGraphicsAPIState() = 0;
+  virtual void DoRestoreGraphicsAPIState() = 0;
+
+  /// Encodes the specified area of VRAM and starts copying it to the readback buffer, without waiting for it.
+  virtual void BeginVRAMReadback(const Common::Rectangle<u32>& rect) = 0;
+
+  /// Waits for the copy started by BeginVRAMReadback() and writes it to the shadow copy of VRAM.
+  virtual void FinishVRAMReadback(const Common::Rectangle<u32>& rect) = 0;
+
   virtual void UpdateDepthBufferFromMaskBit() = 0;
   virtual void SetScissorFromDrawingArea() = 0;
-  virtual void MapBatchVertexPointer(u32 required_vertices) = 0;
+  virtual BatchVertex* MapBatchVertexPointer(u32 required_vertices, u32* space_vertices) = 0;
   virtual void UnmapBatchVertexPointer(u32 used_vertices) = 0;
   virtual void UploadUniformBuffer(const void* uniforms, u32 uniforms_size) = 0;
-  virtual void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) = 0;
+  virtual void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                 u32 num_vertices) = 0;
+
+  //////////////////////////////////////////////////////////////////////////
+  // GPU Thread
+  //////////////////////////////////////////////////////////////////////////
+  bool IsUsingGPUThread() const { return m_gpu_thread.joinable(); }
+
+  /// Moves the backend and the render context to a new thread. Backends call this at the end of Initialize() and
+  /// UpdateSettings() when the thread is enabled, and must stop it before recreating resources or being destroyed.
+  void StartGPUThread();
+  void StopGPUThread();
+
+  /// Waits for the GPU thread to execute everything queued so far. Must be called before results written by the GPU
+  /// thread, e.g. VRAM readbacks, are used on the CPU thread.
+  void SyncGPUThread();
+
+  /// Executes the function immediately when not using the thread, otherwise queues it for the GPU thread. Anything it
+  /// uses from the CPU thread's state must be captured by value.
+  template<typename F>
+  void RunOnGPUThread(F&& func)
+  {
+    if (!IsUsingGPUThread())
+    {
+      func();
+      return;
+    }
+
+    using Closure = std::decay_t<F>;
+    static_assert(alignof(Closure) <= GPU_THREAD_COMMAND_ALIGNMENT, "closure is over-aligned");
+    constexpr u32 size = GetGPUThreadCommandSize(sizeof(Closure));
+
+    GPUThreadCommand* cmd = AllocateGPUThreadCommand(size);
+    new (cmd + 1) Closure(std::forward<F>(func));
+    cmd->execute = [](GPUThreadCommand* cmd) {
+      Closure* closure = reinterpret_cast<Closure*>(cmd + 1);
+      (*closure)();
+      closure->~Closure();
+    };
+    PushGPUThreadCommand(size);
+  }
+
+  /// As above, but the data is copied into the queue and passed to the function, for when it isn't going to remain
+  /// valid on the CPU thread.
+  template<typename F>
+  void RunOnGPUThreadWithData(const void* data, u32 data_size, F&& func)
+  {
+    if (!IsUsingGPUThread())
+    {
+      func(data);
+      return;
+    }
+
+    using Closure = std::decay_t<F>;
+    static_assert(alignof(Closure) <= GPU_THREAD_COMMAND_ALIGNMENT, "closure is over-aligned");
+    constexpr u32 closure_size = GetGPUThreadCommandSize(sizeof(Closure));
+    const u32 size = closure_size + GetGPUThreadCommandSize(data_size) - GetGPUThreadCommandSize(0);
+
+    GPUThreadCommand* cmd = AllocateGPUThreadCommand(size);
+    new (cmd + 1) Closure(std::forward<F>(func));
+    std::memcpy(reinterpret_cast<u8*>(cmd) + closure_size, data, data_size);
+    cmd->execute = [](GPUThreadCommand* cmd) {
+      Closure* closure = reinterpret_cast<Closure*>(cmd + 1);
+      (*closure)(reinterpret_cast<const u8*>(cmd) + closure_size);
+      closure->~Closure();
+    };
+    PushGPUThreadCommand(size);
+  }
 
   void SetFullVRAMDirtyRectangle()
   {
-    m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    m_vram_dirty_tiles.fill(static_cast<u16>(VRAM_DIRTY_TILE_ALL_COLUMNS));
     m_draw_mode.SetTexturePageChanged();
+    m_speculative_vram_readback_pending = false;
   }
-  void ClearVRAMDirtyRectangle() { m_vram_dirty_rect.SetInvalid(); }
   void IncludeVRAMDityRectangle(const Common::Rectangle<u32>& rect);
 
+  /// Returns the bits of the tile columns covered by the specified horizontal span of VRAM.
+  ALWAYS_INLINE static u32 GetVRAMDirtyTileColumnMask(u32 left, u32 right)
+  {
+    right = std::min<u32>(right, VRAM_WIDTH);
+    if (left >= right)
+      return 0;
+
+    const u32 first_column = left / VRAM_DIRTY_TILE_SIZE;
+    const u32 last_column = (right - 1) / VRAM_DIRTY_TILE_SIZE;
+    return ((2u << last_column) - 1u) & ~((1u << first_column) - 1u);
+  }
+
+  /// Marks the tiles covered by the specified area of VRAM as dirty, i.e. no longer matching the read texture.
+  ALWAYS_INLINE void SetVRAMDirtyTiles(u32 left, u32 right, u32 top, u32 bottom)
+  {
+    const u32 column_mask = GetVRAMDirtyTileColumnMask(left, right);
+    bottom = std::min<u32>(bottom, VRAM_HEIGHT);
+    if (column_mask == 0 || top >= bottom)
+      return;
+
+    const u32 last_row = (bottom - 1) / VRAM_DIRTY_TILE_SIZE;
+    for (u32 row = top / VRAM_DIRTY_TILE_SIZE; row <= last_row; row++)
+      m_vram_dirty_tiles[row] |= static_cast<u16>(column_mask);
+
+    if (m_speculative_vram_readback_pending &&
+        m_speculative_vram_readback_rect.Intersects(Common::Rectangle<u32>(left, top, right, bottom)))
+    {
+      m_speculative_vram_readback_pending = false;
+    }
+  }
+
+  /// Returns true if any of the tiles covered by the specified area of VRAM are dirty.
+  bool IsVRAMDirty(const Common::Rectangle<u32>& rect) const;
+
   bool IsFlushed() const { return m_batch_current_vertex_ptr == m_batch_start_vertex_ptr; }
 
+  /// Returns true if none of the primitives in the current batch would be clipped by the drawing area.
+  bool IsBatchInsideDrawingArea() const
+  {
+    return (m_batch_bounds.left >= static_cast<s32>(m_drawing_area.left) &&
+            m_batch_bounds.right <= static_cast<s32>(m_drawing_area.right + 1) &&
+            m_batch_bounds.top >= static_cast<s32>(m_drawing_area.top) &&
+            m_batch_bounds.bottom <= static_cast<s32>(m_drawing_area.bottom + 1));
+  }
+
   u32 GetBatchVertexSpace() const { return static_cast<u32>(m_batch_end_vertex_ptr - m_batch_current_vertex_ptr); }
   u32 GetBatchVertexCount() const { return static_cast<u32>(m_batch_current_vertex_ptr - m_batch_start_vertex_ptr); }
   void EnsureVertexBufferSpace(u32 required_vertices);
@@ -209,13 +383,18 @@ protected:
     }
   }
 
+  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void DispatchRenderCommand() override;
-  void FlushRender() override;
+  void FlushRender(FlushReason reason) override;
   void DrawRendererStats(bool is_idle_frame) override;
 
+  /// Reads back all of VRAM to the shadow copy for an internal CPU round trip, without counting it as a read by the
+  /// game for predicting speculative readbacks.
+  void ReadAllVRAMForRoundTrip();
+
   void CalcScissorRect(int* left, int* top, int* right, int* bottom);
 
   std::tuple<s32, s32> ScaleVRAMCoordinates(s32 x, s32 y) const
@@ -232,6 +411,10 @@ protected:
   VRAMFillUBOData GetVRAMFillUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const;
   VRAMWriteUBOData GetVRAMWriteUBOData(u32 x, u32 y, u32 width, u32 height, u32 buffer_offset) const;
   VRAMCopyUBOData GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) const;
+  VRAMTransferUBOData GetVRAMFillTransferUBOData(u32 x, u32 y, u32 width, u32 height, u32 color) const;
+  VRAMTransferUBOData GetVRAMWriteTransferUBOData(u32 x, u32 y, u32 width, u32 height, u32 buffer_offset) const;
+  VRAMTransferUBOData GetVRAMCopyTransferUBOData(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width,
+                                                 u32 height) const;
 
   /// Handles quads with flipped texture coordinate directions.
   static void HandleFlippedQuadTextureCoordinates(BatchVertex* vertices);
@@ -242,7 +425,6 @@ protected:
   BatchVertex* m_batch_start_vertex_ptr = nullptr;
   BatchVertex* m_batch_end_vertex_ptr = nullptr;
   BatchVertex* m_batch_current_vertex_ptr = nullptr;
-  u32 m_batch_base_vertex = 0;
   s32 m_current_depth = 0;
 
   u32 m_resolution_scale = 1;
@@ -252,12 +434,33 @@ protected:
   bool m_scaled_dithering = false;
   bool m_texture_filtering = false;
   bool m_supports_dual_source_blend = false;
+  bool m_supports_async_vram_readback = false;
+  bool m_supports_compute_vram_transfers = false;
+  bool m_compute_vram_transfers = false;
 
   BatchConfig m_batch = {};
   BatchUBOData m_batch_ubo_data = {};
 
-  // Bounding box of VRAM area that the GPU has drawn into.
-  Common::Rectangle<u32> m_vram_dirty_rect;
+  // Area covered by the primitives in the current batch, before clipping to the drawing area.
+  Common::Rectangle<s32> m_batch_bounds;
+
+  // Drawing area to use for the current batch when it's been changed, but the batch may carry on with the new one.
+  Common::Rectangle<u32> m_batch_drawing_area;
+  bool m_batch_drawing_area_changed = false;
+  bool m_batch_drawing_area_deferred = false;
+
+  // One bit per 64x64 tile of VRAM which has been drawn into since it was last copied to the read texture, with a
+  // mask of columns for each row of tiles.
+  std::array<u16, VRAM_DIRTY_TILE_ROWS> m_vram_dirty_tiles = {};
+
+  // Area of VRAM which was last read back, and the number of consecutive frames it's been read in.
+  Common::Rectangle<u32> m_vram_readback_history_rect{0, 0, 0, 0};
+  u32 m_vram_readback_history_frames = 0;
+  bool m_vram_readback_this_frame = false;
+
+  // Readback started ahead of time for the predicted area, which is dropped if anything writes to that area.
+  Common::Rectangle<u32> m_speculative_vram_readback_rect;
+  bool m_speculative_vram_readback_pending = false;
 
   // Statistics
   RendererStats m_renderer_stats = {};
@@ -266,17 +469,73 @@ protected:
   // Changed state
   bool m_batch_ubo_dirty = true;
 
+  // Backend state, owned by the GPU thread when it's running.
+  Common::Rectangle<u32> m_scissor_drawing_area{0, 0, VRAM_WIDTH, VRAM_HEIGHT};
+  u32 m_batch_base_vertex = 0;
+
+  // Set by backends when they overwrite the uniform buffer binding, so the batch uniforms are uploaded again.
+  bool m_batch_ubo_invalidated = true;
+
 private:
   enum : u32
   {
     MIN_BATCH_VERTEX_COUNT = 6,
-    MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex)
+    MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex),
+
+    // Batches built while the GPU thread is running are copied to the vertex buffer in one go, which has to fit.
+    MAX_STAGED_BATCH_VERTEX_COUNT = MAX_BATCH_VERTEX_COUNT / 2,
+
+    // Number of consecutive frames the same area has to be read back in before it's downloaded speculatively.
+    SPECULATIVE_VRAM_READBACK_FRAMES = 2,
+
+    GPU_THREAD_QUEUE_SIZE = 4 * 1024 * 1024,
+    GPU_THREAD_COMMAND_ALIGNMENT = 16,
+    GPU_THREAD_SPIN_COUNT = 1000
   };
 
+  // Commands are the header, the closure, and any data copied with it, in a ring buffer which is only written by the
+  // CPU thread and only read by the GPU thread.
+  struct alignas(GPU_THREAD_COMMAND_ALIGNMENT) GPUThreadCommand
+  {
+    // Runs and destroys the closure. Null for the padding skipped when a command doesn't fit before the end.
+    void (*execute)(GPUThreadCommand* cmd);
+    u32 size;
+  };
+
+  static constexpr u32 GetGPUThreadCommandSize(u32 closure_size)
+  {
+    return (static_cast<u32>(sizeof(GPUThreadCommand)) + closure_size + (GPU_THREAD_COMMAND_ALIGNMENT - 1)) &
+           ~(GPU_THREAD_COMMAND_ALIGNMENT - 1);
+  }
+
   static BatchPrimitive GetPrimitiveForCommand(RenderCommand rc);
 
   void LoadVertices();
 
+  /// Points the batch at the backend's vertex buffer, or the staging buffer when using the GPU thread.
+  void MapBatchVertices(u32 required_vertices);
+
+  /// Draws the vertices in the current batch, regardless of whether a state change needs it.
+  void DrawBufferedBatch();
+
+  /// Starts a readback of the area the game has read in each of the last few frames, so that it's ready by the time
+  /// the game reads it again.
+  void StartSpeculativeVRAMReadback();
+
+  /// Copies the specified area to the shadow copy of VRAM, using the speculative readback if it covers the area.
+  void ReadVRAMToShadow(const Common::Rectangle<u32>& rect);
+
+  void DrawBatch(const BatchConfig& batch, const BatchUBOData& ubo_data, bool ubo_dirty, bool drawing_area_changed,
+                 const Common::Rectangle<u32>& drawing_area, u32 num_vertices);
+
+  GPUThreadCommand* AllocateGPUThreadCommand(u32 size);
+  void PushGPUThreadCommand(u32 size);
+
+  /// Waits until the GPU thread's read position reaches the specified position.
+  void WaitForGPUThread(u32 pos);
+
+  void GPUThreadEntryPoint();
+
   ALWAYS_INLINE void AddVertex(const BatchVertex& v)
   {
     std::memcpy(m_batch_current_vertex_ptr, &v, sizeof(BatchVertex));
@@ -291,4 +550,22 @@ private:
   }
 
   void PrintSettingsToLog();
+
+  std::vector<BatchVertex> m_batch_staging_vertices;
+
+  std::unique_ptr<u8[]> m_gpu_thread_queue;
+  std::atomic<u32> m_gpu_thread_read_pos{0};
+  std::atomic<u32> m_gpu_thread_write_pos{0};
+  std::atomic_bool m_gpu_thread_sleeping{false};
+  std::atomic_bool m_cpu_thread_waiting{false};
+  bool m_gpu_thread_exit = false;
+
+  // Queue position after the last present, so that the CPU thread stays at most one frame ahead of the display.
+  u32 m_gpu_thread_present_pos = 0;
+
+  // Only used for sleeping, the queue itself is lock-free.
+  std::mutex m_gpu_thread_mutex;
+  std::condition_variable m_gpu_thread_wake_cv;
+  std::condition_variable m_gpu_thread_done_cv;
+  std::thread m_gpu_thread;
 };
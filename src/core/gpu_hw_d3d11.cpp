@@ -83,7 +83,8 @@ bool GPU_HW_D3D11::Initialize(HostDisplay* host_display, System* system, DMA* dm
     return false;
   }
 
-  RestoreGraphicsAPIState();
+  // The GPU thread isn't used with D3D11, the context stays on the CPU thread.
+  DoRestoreGraphicsAPIState();
   return true;
 }
 
@@ -96,15 +97,18 @@ void GPU_HW_D3D11::Reset()
 
 void GPU_HW_D3D11::ResetGraphicsAPIState()
 {
+  // In D3D11 we can't leave a buffer mapped across a Present() call.
+  FlushRender(FlushReason::Other);
+
   GPU_HW::ResetGraphicsAPIState();
+}
 
+void GPU_HW_D3D11::DoResetGraphicsAPIState()
+{
   m_context->GSSetShader(nullptr, nullptr, 0);
-
-  // In D3D11 we can't leave a buffer mapped across a Present() call.
-  FlushRender();
 }
 
-void GPU_HW_D3D11::RestoreGraphicsAPIState()
+void GPU_HW_D3D11::DoRestoreGraphicsAPIState()
 {
   const UINT stride = sizeof(BatchVertex);
   const UINT offset = 0;
@@ -115,7 +119,7 @@ void GPU_HW_D3D11::RestoreGraphicsAPIState()
   m_context->RSSetState(m_cull_none_rasterizer_state.Get());
   SetViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
   SetScissorFromDrawingArea();
-  m_batch_ubo_dirty = true;
+  m_batch_ubo_invalidated = true;
 }
 
 void GPU_HW_D3D11::UpdateSettings()
@@ -125,30 +129,23 @@ void GPU_HW_D3D11::UpdateSettings()
   CreateFramebuffer();
   CreateStateObjects();
   CompileShaders();
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
   UpdateDisplay();
 }
 
-void GPU_HW_D3D11::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_D3D11::MapBatchVertexPointer(u32 required_vertices, u32* space_vertices)
 {
-  DebugAssert(!m_batch_start_vertex_ptr);
-
   const D3D11::StreamBuffer::MappingResult res =
     m_vertex_stream_buffer.Map(m_context.Get(), sizeof(BatchVertex), required_vertices * sizeof(BatchVertex));
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(res.pointer);
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + res.space_aligned;
   m_batch_base_vertex = res.index_aligned;
+  *space_vertices = res.space_aligned;
+  return static_cast<BatchVertex*>(res.pointer);
 }
 
 void GPU_HW_D3D11::UnmapBatchVertexPointer(u32 used_vertices)
 {
-  DebugAssert(m_batch_start_vertex_ptr);
   m_vertex_stream_buffer.Unmap(m_context.Get(), used_vertices * sizeof(BatchVertex));
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 void GPU_HW_D3D11::SetCapabilities()
@@ -158,6 +155,7 @@ void GPU_HW_D3D11::SetCapabilities()
 
   m_max_resolution_scale = max_texture_scale;
   m_supports_dual_source_blend = true;
+  m_supports_async_vram_readback = true;
 }
 
 bool GPU_HW_D3D11::CreateFramebuffer()
@@ -209,7 +207,7 @@ bool GPU_HW_D3D11::CreateFramebuffer()
 
   m_context->OMSetRenderTargets(1, m_vram_texture.GetD3DRTVArray(), nullptr);
   SetFullVRAMDirtyRectangle();
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
   return true;
 }
 
@@ -263,11 +261,12 @@ bool GPU_HW_D3D11::CreateTextureBuffer()
 
 bool GPU_HW_D3D11::CreateBatchInputLayout()
 {
-  static constexpr std::array<D3D11_INPUT_ELEMENT_DESC, 4> attributes = {
+  static constexpr std::array<D3D11_INPUT_ELEMENT_DESC, 5> attributes = {
     {{"ATTR", 0, DXGI_FORMAT_R32G32B32_SINT, 0, offsetof(BatchVertex, x), D3D11_INPUT_PER_VERTEX_DATA, 0},
      {"ATTR", 1, DXGI_FORMAT_R8G8B8A8_UNORM, 0, offsetof(BatchVertex, color), D3D11_INPUT_PER_VERTEX_DATA, 0},
      {"ATTR", 2, DXGI_FORMAT_R32_UINT, 0, offsetof(BatchVertex, u), D3D11_INPUT_PER_VERTEX_DATA, 0},
-     {"ATTR", 3, DXGI_FORMAT_R32_UINT, 0, offsetof(BatchVertex, texpage), D3D11_INPUT_PER_VERTEX_DATA, 0}}};
+     {"ATTR", 3, DXGI_FORMAT_R32_UINT, 0, offsetof(BatchVertex, texpage), D3D11_INPUT_PER_VERTEX_DATA, 0},
+     {"ATTR", 4, DXGI_FORMAT_R32_UINT, 0, offsetof(BatchVertex, texwindow), D3D11_INPUT_PER_VERTEX_DATA, 0}}};
 
   // we need a vertex shader...
   GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_true_color, m_scaled_dithering,
@@ -518,7 +517,7 @@ void GPU_HW_D3D11::DrawUtilityShader(ID3D11PixelShader* shader, const void* unif
   if (uniforms)
   {
     UploadUniformBuffer(uniforms, uniforms_size);
-    m_batch_ubo_dirty = true;
+    m_batch_ubo_invalidated = true;
   }
 
   m_context->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -530,31 +529,32 @@ void GPU_HW_D3D11::DrawUtilityShader(ID3D11PixelShader* shader, const void* unif
   m_context->Draw(3, 0);
 }
 
-void GPU_HW_D3D11::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_D3D11::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                     u32 num_vertices)
 {
-  const bool textured = (m_batch.texture_mode != TextureMode::Disabled);
+  const bool textured = (batch.texture_mode != TextureMode::Disabled);
 
   static constexpr std::array<D3D11_PRIMITIVE_TOPOLOGY, 2> d3d_primitives = {
     {D3D11_PRIMITIVE_TOPOLOGY_LINELIST, D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST}};
-  m_context->IASetPrimitiveTopology(d3d_primitives[static_cast<u8>(m_batch.primitive)]);
+  m_context->IASetPrimitiveTopology(d3d_primitives[static_cast<u8>(batch.primitive)]);
 
   m_context->VSSetShader(m_batch_vertex_shaders[BoolToUInt8(textured)].Get(), nullptr, 0);
 
-  m_context->GSSetShader((m_batch.primitive < GPU_HW::BatchPrimitive::Triangles && m_resolution_scale > 1) ?
+  m_context->GSSetShader((batch.primitive < GPU_HW::BatchPrimitive::Triangles && m_resolution_scale > 1) ?
                            m_batch_line_expand_geometry_shader.Get() :
                            nullptr,
                          nullptr, 0);
 
-  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                              [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
+  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(batch.texture_mode)]
+                                              [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)]
                                                 .Get(),
                          nullptr, 0);
 
   const TransparencyMode transparency_mode =
-    (render_mode == BatchRenderMode::OnlyOpaque) ? TransparencyMode::Disabled : m_batch.transparency_mode;
+    (render_mode == BatchRenderMode::OnlyOpaque) ? TransparencyMode::Disabled : batch.transparency_mode;
   m_context->OMSetBlendState(m_batch_blend_states[static_cast<u8>(transparency_mode)].Get(), nullptr, 0xFFFFFFFFu);
   m_context->OMSetDepthStencilState(
-    m_batch.check_mask_before_draw ? m_depth_test_less_state.Get() : m_depth_test_always_state.Get(), 0);
+    batch.check_mask_before_draw ? m_depth_test_less_state.Get() : m_depth_test_always_state.Get(), 0);
 
   m_context->Draw(num_vertices, base_vertex);
 }
@@ -624,7 +624,7 @@ void GPU_HW_D3D11::UpdateDisplay()
                                         m_display_texture.GetHeight(), 0, 0, scaled_display_width,
                                         scaled_display_height);
 
-      RestoreGraphicsAPIState();
+      DoRestoreGraphicsAPIState();
     }
 
     m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
@@ -634,37 +634,42 @@ void GPU_HW_D3D11::UpdateDisplay()
   }
 }
 
-void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+void GPU_HW_D3D11::BeginVRAMReadback(const Common::Rectangle<u32>& rect)
 {
-  // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
-  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
-  const u32 encoded_height = copy_rect.GetHeight();
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
 
   // Encode the 24-bit texture as 16-bit.
-  const u32 uniforms[4] = {copy_rect.left, copy_rect.top, copy_rect.GetWidth(), copy_rect.GetHeight()};
+  const u32 uniforms[4] = {rect.left, rect.top, rect.GetWidth(), rect.GetHeight()};
   m_context->OMSetRenderTargets(1, m_vram_encoding_texture.GetD3DRTVArray(), nullptr);
   m_context->OMSetDepthStencilState(m_depth_disabled_state.Get(), 0);
   m_context->PSSetShaderResources(0, 1, m_vram_texture.GetD3DSRVArray());
   SetViewportAndScissor(0, 0, encoded_width, encoded_height);
   DrawUtilityShader(m_vram_read_pixel_shader.Get(), uniforms, sizeof(uniforms));
 
-  // Stage the readback.
+  // Stage the readback, which completes in the background until the staging texture is mapped.
   m_vram_readback_texture.CopyFromTexture(m_context.Get(), m_vram_encoding_texture.GetD3DTexture(), 0, 0, 0, 0, 0,
                                           encoded_width, encoded_height);
+
+  DoRestoreGraphicsAPIState();
+}
+
+void GPU_HW_D3D11::FinishVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
+
   // And copy it into our shadow buffer.
   if (m_vram_readback_texture.Map(m_context.Get(), false))
   {
     m_vram_readback_texture.ReadPixels(0, 0, encoded_width * 2, encoded_height, VRAM_WIDTH,
-                                       &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
+                                       &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left]);
     m_vram_readback_texture.Unmap(m_context.Get());
   }
   else
   {
     Log_ErrorPrintf("Failed to map VRAM readback texture");
   }
-
-  RestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D11::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -673,7 +678,7 @@ void GPU_HW_D3D11::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   {
     // CPU round trip if oversized for now.
     Log_WarningPrintf("Oversized VRAM fill (%u-%u, %u-%u), CPU round trip", x, x + width, y, y + height);
-    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    ReadAllVRAMForRoundTrip();
     GPU::FillVRAM(x, y, width, height, color);
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_shadow.data());
     return;
@@ -691,7 +696,7 @@ void GPU_HW_D3D11::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
                                                      m_vram_fill_pixel_shader.Get(),
                     &uniforms, sizeof(uniforms));
 
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D11::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
@@ -715,7 +720,7 @@ void GPU_HW_D3D11::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* d
 
   DrawUtilityShader(m_vram_write_pixel_shader.Get(), &uniforms, sizeof(uniforms));
 
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
 }
 
 void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
@@ -724,8 +729,7 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexture(src_bounds);
     IncludeVRAMDityRectangle(dst_bounds);
 
     const VRAMCopyUBOData uniforms = GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height);
@@ -737,7 +741,7 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
       m_GPUSTAT.check_mask_before_draw ? m_depth_test_less_state.Get() : m_depth_test_always_state.Get(), 0);
     m_context->PSSetShaderResources(0, 1, m_vram_read_texture.GetD3DSRVArray());
     DrawUtilityShader(m_vram_copy_pixel_shader.Get(), &uniforms, sizeof(uniforms));
-    RestoreGraphicsAPIState();
+    DoRestoreGraphicsAPIState();
 
     if (m_GPUSTAT.check_mask_before_draw)
       m_current_depth++;
@@ -748,8 +752,7 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   // We can't CopySubresourceRegion to the same resource. So use the shadow texture if we can, but that may need to be
   // updated first. Copying to the same resource seemed to work on Windows 10, but breaks on Windows 7. But, it's
   // against the API spec, so better to be safe than sorry.
-  if (m_vram_dirty_rect.Intersects(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height)))
-    UpdateVRAMReadTexture();
+  UpdateVRAMReadTexture(Common::Rectangle<u32>::FromExtents(src_x, src_y, width, height));
 
   GPU_HW::CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
 
@@ -764,14 +767,15 @@ void GPU_HW_D3D11::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 widt
   m_context->CopySubresourceRegion(m_vram_texture, 0, dst_x, dst_y, 0, m_vram_read_texture, 0, &src_box);
 }
 
-void GPU_HW_D3D11::UpdateVRAMReadTexture()
+void GPU_HW_D3D11::CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-  const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
-  m_context->CopySubresourceRegion(m_vram_read_texture, 0, scaled_rect.left, scaled_rect.top, 0, m_vram_texture, 0,
-                                   &src_box);
-
-  GPU_HW::UpdateVRAMReadTexture();
+  for (u32 i = 0; i < num_rects; i++)
+  {
+    const auto scaled_rect = rects[i] * m_resolution_scale;
+    const CD3D11_BOX src_box(scaled_rect.left, scaled_rect.top, 0, scaled_rect.right, scaled_rect.bottom, 1);
+    m_context->CopySubresourceRegion(m_vram_read_texture, 0, src_box.left, src_box.top, 0, m_vram_texture, 0,
+                                     &src_box);
+  }
 }
 
 void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
@@ -786,7 +790,7 @@ void GPU_HW_D3D11::UpdateDepthBufferFromMaskBit()
   DrawUtilityShader(m_vram_update_depth_pixel_shader.Get(), nullptr, 0);
 
   m_context->PSSetShaderResources(0, 1, m_vram_read_texture.GetD3DSRVArray());
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
 }
 
 std::unique_ptr<GPU> GPU::CreateHardwareD3D11Renderer()
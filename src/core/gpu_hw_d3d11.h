@@ -24,22 +24,25 @@ public:
   void Reset() override;
 
   void ResetGraphicsAPIState() override;
-  void RestoreGraphicsAPIState() override;
   void UpdateSettings() override;
 
 protected:
+  void DoResetGraphicsAPIState() override;
+  void DoRestoreGraphicsAPIState() override;
   void UpdateDisplay() override;
-  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  void BeginVRAMReadback(const Common::Rectangle<u32>& rect) override;
+  void FinishVRAMReadback(const Common::Rectangle<u32>& rect) override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
-  void MapBatchVertexPointer(u32 required_vertices) override;
+  BatchVertex* MapBatchVertexPointer(u32 required_vertices, u32* space_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
 
 private:
   enum : u32
@@ -1,6 +1,7 @@
 #include "gpu_hw_opengl.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/timer.h"
 #include "gpu_hw_shadergen.h"
 #include "host_display.h"
 #include "system.h"
@@ -10,6 +11,8 @@ GPU_HW_OpenGL::GPU_HW_OpenGL() : GPU_HW() {}
 
 GPU_HW_OpenGL::~GPU_HW_OpenGL()
 {
+  StopGPUThread();
+
   // Destroy objects which don't have destructors to clean them up
   if (m_vram_fbo_id != 0)
     glDeleteFramebuffers(1, &m_vram_fbo_id);
@@ -19,11 +22,15 @@ GPU_HW_OpenGL::~GPU_HW_OpenGL()
     glDeleteVertexArrays(1, &m_attributeless_vao_id);
   if (m_texture_buffer_r16ui_texture != 0)
     glDeleteTextures(1, &m_texture_buffer_r16ui_texture);
+  if (m_vram_readback_fence)
+    glDeleteSync(m_vram_readback_fence);
+  if (m_vram_readback_pbo_id != 0)
+    glDeleteBuffers(1, &m_vram_readback_pbo_id);
 
   if (m_host_display)
   {
     m_host_display->ClearDisplayTexture();
-    ResetGraphicsAPIState();
+    DoResetGraphicsAPIState();
   }
 }
 
@@ -74,7 +81,10 @@ bool GPU_HW_OpenGL::Initialize(HostDisplay* host_display, System* system, DMA* d
     return false;
   }
 
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
+  if (system->GetSettings().gpu_use_thread)
+    StartGPUThread();
+
   return true;
 }
 
@@ -85,10 +95,8 @@ void GPU_HW_OpenGL::Reset()
   ClearFramebuffer();
 }
 
-void GPU_HW_OpenGL::ResetGraphicsAPIState()
+void GPU_HW_OpenGL::DoResetGraphicsAPIState()
 {
-  GPU_HW::ResetGraphicsAPIState();
-
   glEnable(GL_CULL_FACE);
   glDisable(GL_SCISSOR_TEST);
   glDisable(GL_BLEND);
@@ -97,7 +105,7 @@ void GPU_HW_OpenGL::ResetGraphicsAPIState()
   glBindVertexArray(0);
 }
 
-void GPU_HW_OpenGL::RestoreGraphicsAPIState()
+void GPU_HW_OpenGL::DoRestoreGraphicsAPIState()
 {
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   glViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
@@ -112,7 +120,7 @@ void GPU_HW_OpenGL::RestoreGraphicsAPIState()
   glBindVertexArray(m_vao_id);
 
   SetScissorFromDrawingArea();
-  m_batch_ubo_dirty = true;
+  m_batch_ubo_invalidated = true;
 }
 
 void GPU_HW_OpenGL::UpdateSettings()
@@ -122,30 +130,25 @@ void GPU_HW_OpenGL::UpdateSettings()
   CreateFramebuffer();
   CompilePrograms();
   UpdateDisplay();
+
+  if (m_system->GetSettings().gpu_use_thread)
+    StartGPUThread();
 }
 
-void GPU_HW_OpenGL::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_OpenGL::MapBatchVertexPointer(u32 required_vertices, u32* space_vertices)
 {
-  DebugAssert(!m_batch_start_vertex_ptr);
-
   const GL::StreamBuffer::MappingResult res =
     m_vertex_stream_buffer->Map(sizeof(BatchVertex), required_vertices * sizeof(BatchVertex));
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(res.pointer);
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + res.space_aligned;
   m_batch_base_vertex = res.index_aligned;
+  *space_vertices = res.space_aligned;
+  return static_cast<BatchVertex*>(res.pointer);
 }
 
 void GPU_HW_OpenGL::UnmapBatchVertexPointer(u32 used_vertices)
 {
-  DebugAssert(m_batch_start_vertex_ptr);
-
   m_vertex_stream_buffer->Unmap(used_vertices * sizeof(BatchVertex));
   m_vertex_stream_buffer->Bind();
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 std::tuple<s32, s32> GPU_HW_OpenGL::ConvertToFramebufferCoordinates(s32 x, s32 y)
@@ -201,6 +204,12 @@ void GPU_HW_OpenGL::SetCapabilities(HostDisplay* host_display)
   if (!m_supports_dual_source_blend)
     Log_WarningPrintf("Dual-source blending is not supported, this may break some mask effects.");
 
+  // readbacks go through a pixel buffer so they can be started ahead of time, but that needs a fence to wait on
+  m_supports_sync = (GLAD_GL_VERSION_3_2 || GLAD_GL_ARB_sync || GLAD_GL_ES_VERSION_3_0);
+  m_supports_async_vram_readback = m_supports_sync;
+  if (!m_supports_sync)
+    Log_WarningPrintf("Sync objects are not supported, VRAM readbacks will be slower.");
+
   m_supports_geometry_shaders = GLAD_GL_VERSION_3_2 || GLAD_GL_ARB_geometry_shader4 || GLAD_GL_ES_VERSION_3_2;
   if (!m_supports_geometry_shaders)
   {
@@ -238,6 +247,14 @@ bool GPU_HW_OpenGL::CreateFramebuffer()
     return false;
   }
 
+  if (m_supports_sync && m_vram_readback_pbo_id == 0)
+  {
+    glGenBuffers(1, &m_vram_readback_pbo_id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+    glBufferData(GL_PIXEL_PACK_BUFFER, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+
   glGenFramebuffers(1, &m_vram_fbo_id);
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
   glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_vram_texture.GetGLId(), 0);
@@ -270,11 +287,14 @@ bool GPU_HW_OpenGL::CreateFramebuffer()
 
 void GPU_HW_OpenGL::ClearFramebuffer()
 {
-  glDisable(GL_SCISSOR_TEST);
-  glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
-  IsGLES() ? glClearDepthf(0.0f) : glClearDepth(0.0f);
-  glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-  glEnable(GL_SCISSOR_TEST);
+  RunOnGPUThread([this]() {
+    glDisable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    IsGLES() ? glClearDepthf(0.0f) : glClearDepth(0.0f);
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glEnable(GL_SCISSOR_TEST);
+  });
+
   SetFullVRAMDirtyRectangle();
 }
 
@@ -292,12 +312,15 @@ bool GPU_HW_OpenGL::CreateVertexBuffer()
   glEnableVertexAttribArray(1);
   glEnableVertexAttribArray(2);
   glEnableVertexAttribArray(3);
+  glEnableVertexAttribArray(4);
   glVertexAttribIPointer(0, 3, GL_INT, sizeof(BatchVertex), reinterpret_cast<void*>(offsetof(BatchVertex, x)));
   glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, true, sizeof(BatchVertex),
                         reinterpret_cast<void*>(offsetof(BatchVertex, color)));
   glVertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(BatchVertex), reinterpret_cast<void*>(offsetof(BatchVertex, u)));
   glVertexAttribIPointer(3, 1, GL_UNSIGNED_INT, sizeof(BatchVertex),
                          reinterpret_cast<void*>(offsetof(BatchVertex, texpage)));
+  glVertexAttribIPointer(4, 1, GL_UNSIGNED_INT, sizeof(BatchVertex),
+                         reinterpret_cast<void*>(offsetof(BatchVertex, texwindow)));
   glBindVertexArray(0);
 
   glGenVertexArrays(1, &m_attributeless_vao_id);
@@ -331,6 +354,97 @@ bool GPU_HW_OpenGL::CreateTextureBuffer()
   return true;
 }
 
+std::optional<GL::Program> GPU_HW_OpenGL::CompileBatchProgram(const std::string& vs, const std::string& gs,
+                                                               const std::string& fs, bool textured)
+{
+  const bool use_binding_layout = GPU_HW_ShaderGen::UseGLSLBindingLayout();
+  std::optional<GL::Program> prog =
+    m_shader_cache.GetProgram(vs, gs, fs, [this, textured, use_binding_layout](GL::Program& prog) {
+      if (!use_binding_layout)
+      {
+        prog.BindAttribute(0, "a_pos");
+        prog.BindAttribute(1, "a_col0");
+        if (textured)
+        {
+          prog.BindAttribute(2, "a_texcoord");
+          prog.BindAttribute(3, "a_texpage");
+          prog.BindAttribute(4, "a_texwindow");
+        }
+
+        if (!IsGLES() || m_supports_dual_source_blend)
+        {
+          if (m_supports_dual_source_blend)
+          {
+            prog.BindFragDataIndexed(0, "o_col0");
+            prog.BindFragDataIndexed(1, "o_col1");
+          }
+          else
+          {
+            prog.BindFragData(0, "o_col0");
+          }
+        }
+      }
+    });
+  if (!prog)
+    return std::nullopt;
+
+  if (!use_binding_layout)
+  {
+    prog->BindUniformBlock("UBOBlock", 1);
+    if (textured)
+    {
+      prog->Bind();
+      prog->Uniform1i("samp0", 0);
+    }
+  }
+
+  return prog;
+}
+
+void GPU_HW_OpenGL::CompilePendingBatchPrograms()
+{
+  if (m_next_pending_batch_program == NUM_BATCH_PROGRAMS)
+    return;
+
+  GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_true_color, m_scaled_dithering,
+                             m_texture_filtering, m_supports_dual_source_blend);
+
+  // always make some progress, even if a single program blows the budget
+  Common::Timer timer;
+  do
+  {
+    // [render_mode][texture_mode][dithering][interlacing]
+    const u32 index = m_next_pending_batch_program++;
+    const u8 interlacing = Truncate8(index % 2);
+    const u8 dithering = Truncate8((index / 2) % 2);
+    const u8 texture_mode = Truncate8((index / 4) % 9);
+    const u8 render_mode = Truncate8(index / 36);
+    const bool textured = (static_cast<TextureMode>(texture_mode) != TextureMode::Disabled);
+
+    const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
+    const std::string fs = shadergen.GenerateBatchFragmentShader(
+      static_cast<BatchRenderMode>(render_mode), static_cast<TextureMode>(texture_mode),
+      ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+
+    // failures aren't fatal here, the ubershader is used for anything which doesn't compile
+    std::optional<GL::Program> prog = CompileBatchProgram(batch_vs, {}, fs, textured);
+    if (prog)
+      m_render_programs[render_mode][texture_mode][dithering][interlacing] = std::move(*prog);
+    else
+      Log_ErrorPrintf("Failed to compile batch program %u", index);
+
+    if (!textured && m_supports_geometry_shaders)
+    {
+      prog = CompileBatchProgram(batch_vs, shadergen.GenerateBatchLineExpandGeometryShader(), fs, false);
+      if (prog)
+        m_line_render_programs[render_mode][dithering][interlacing] = std::move(*prog);
+      else
+        Log_ErrorPrintf("Failed to compile batch line program %u", index);
+    }
+  } while (m_next_pending_batch_program < NUM_BATCH_PROGRAMS &&
+           timer.GetTimeMilliseconds() < BATCH_PROGRAM_COMPILE_BUDGET_MS);
+}
+
 bool GPU_HW_OpenGL::CompilePrograms()
 {
   const bool use_binding_layout = GPU_HW_ShaderGen::UseGLSLBindingLayout();
@@ -339,76 +453,47 @@ bool GPU_HW_OpenGL::CompilePrograms()
 
   m_system->GetHostInterface()->DisplayLoadingScreen("Compiling Shaders...");
 
-  for (u32 render_mode = 0; render_mode < 4; render_mode++)
+  // Only the ubershaders are compiled up front, the specialised programs are built a few at a time each frame.
+  for (auto& programs : m_render_programs)
   {
-    for (u32 texture_mode = 0; texture_mode < 9; texture_mode++)
+    for (auto& texture_mode_programs : programs)
     {
-      for (u8 dithering = 0; dithering < 2; dithering++)
+      for (auto& dithering_programs : texture_mode_programs)
       {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const bool textured = (static_cast<TextureMode>(texture_mode) != TextureMode::Disabled);
-          const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<TextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          const auto link_callback = [this, textured, use_binding_layout](GL::Program& prog) {
-            if (!use_binding_layout)
-            {
-              prog.BindAttribute(0, "a_pos");
-              prog.BindAttribute(1, "a_col0");
-              if (textured)
-              {
-                prog.BindAttribute(2, "a_texcoord");
-                prog.BindAttribute(3, "a_texpage");
-              }
-
-              if (!IsGLES() || m_supports_dual_source_blend)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  prog.BindFragDataIndexed(0, "o_col0");
-                  prog.BindFragDataIndexed(1, "o_col1");
-                }
-                else
-                {
-                  prog.BindFragData(0, "o_col0");
-                }
-              }
-            }
-          };
-
-          std::optional<GL::Program> prog = m_shader_cache.GetProgram(batch_vs, {}, fs, link_callback);
-          if (!prog)
-            return false;
-
-          if (!use_binding_layout)
-          {
-            prog->BindUniformBlock("UBOBlock", 1);
-            if (textured)
-            {
-              prog->Bind();
-              prog->Uniform1i("samp0", 0);
-            }
-          }
-
-          m_render_programs[render_mode][texture_mode][dithering][interlacing] = std::move(*prog);
-
-          if (!textured && m_supports_geometry_shaders)
-          {
-            const std::string line_expand_gs = shadergen.GenerateBatchLineExpandGeometryShader();
+        for (GL::Program& prog : dithering_programs)
+          prog.Destroy();
+      }
+    }
+  }
+  for (auto& programs : m_line_render_programs)
+  {
+    for (auto& dithering_programs : programs)
+    {
+      for (GL::Program& prog : dithering_programs)
+        prog.Destroy();
+    }
+  }
+  m_next_pending_batch_program = 0;
 
-            prog = m_shader_cache.GetProgram(batch_vs, line_expand_gs, fs, link_callback);
-            if (!prog)
-              return false;
+  const std::string uber_vs = shadergen.GenerateBatchVertexShader(true);
+  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  {
+    const std::string fs =
+      shadergen.GenerateBatchUberFragmentShader(static_cast<BatchRenderMode>(render_mode), true);
+    std::optional<GL::Program> prog = CompileBatchProgram(uber_vs, {}, fs, true);
+    if (!prog)
+      return false;
+    m_batch_uber_programs[render_mode] = std::move(*prog);
 
-            if (!use_binding_layout)
-              prog->BindUniformBlock("UBOBlock", 1);
-            m_line_render_programs[render_mode][dithering][interlacing] = std::move(*prog);
-          }
-        }
-      }
+    // lines are never textured, and the geometry shader only passes the colour through
+    if (m_supports_geometry_shaders)
+    {
+      prog = CompileBatchProgram(
+        shadergen.GenerateBatchVertexShader(false), shadergen.GenerateBatchLineExpandGeometryShader(),
+        shadergen.GenerateBatchUberFragmentShader(static_cast<BatchRenderMode>(render_mode), false), false);
+      if (!prog)
+        return false;
+      m_line_batch_uber_programs[render_mode] = std::move(*prog);
     }
   }
 
@@ -518,20 +603,29 @@ bool GPU_HW_OpenGL::CompilePrograms()
   return true;
 }
 
-void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_OpenGL::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
 {
+  const bool expand_lines =
+    (batch.primitive < BatchPrimitive::Triangles && m_supports_geometry_shaders && m_resolution_scale > 1);
   const GL::Program& prog =
-    ((m_batch.primitive < BatchPrimitive::Triangles && m_supports_geometry_shaders && m_resolution_scale > 1) ?
-       m_line_render_programs[static_cast<u8>(render_mode)][BoolToUInt8(m_batch.dithering)]
-                             [BoolToUInt8(m_batch.interlacing)] :
-       m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                        [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]);
-  prog.Bind();
-
-  if (m_batch.texture_mode != TextureMode::Disabled)
+    (expand_lines ? m_line_render_programs[static_cast<u8>(render_mode)][BoolToUInt8(batch.dithering)]
+                                          [BoolToUInt8(batch.interlacing)] :
+                    m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(batch.texture_mode)]
+                                     [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)]);
+
+  // fall back to the ubershader until the specialised program is compiled
+  if (prog.IsVaild())
+    prog.Bind();
+  else if (expand_lines)
+    m_line_batch_uber_programs[static_cast<u8>(render_mode)].Bind();
+  else
+    m_batch_uber_programs[static_cast<u8>(render_mode)].Bind();
+
+  if (batch.texture_mode != TextureMode::Disabled)
     m_vram_read_texture.Bind();
 
-  if (m_batch.transparency_mode == TransparencyMode::Disabled || render_mode == BatchRenderMode::OnlyOpaque)
+  if (batch.transparency_mode == TransparencyMode::Disabled || render_mode == BatchRenderMode::OnlyOpaque)
   {
     glDisable(GL_BLEND);
   }
@@ -539,15 +633,15 @@ void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vert
   {
     glEnable(GL_BLEND);
     glBlendEquationSeparate(
-      m_batch.transparency_mode == TransparencyMode::BackgroundMinusForeground ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD,
+      batch.transparency_mode == TransparencyMode::BackgroundMinusForeground ? GL_FUNC_REVERSE_SUBTRACT : GL_FUNC_ADD,
       GL_FUNC_ADD);
     glBlendFuncSeparate(GL_ONE, m_supports_dual_source_blend ? GL_SRC1_ALPHA : GL_SRC_ALPHA, GL_ONE, GL_ZERO);
   }
 
-  glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+  glDepthFunc(batch.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
 
   static constexpr std::array<GLenum, 2> gl_primitives = {{GL_LINES, GL_TRIANGLES}};
-  glDrawArrays(gl_primitives[static_cast<u8>(m_batch.primitive)], m_batch_base_vertex, num_vertices);
+  glDrawArrays(gl_primitives[static_cast<u8>(batch.primitive)], base_vertex, num_vertices);
 }
 
 void GPU_HW_OpenGL::SetScissorFromDrawingArea()
@@ -579,14 +673,18 @@ void GPU_HW_OpenGL::UpdateDisplay()
 {
   GPU_HW::UpdateDisplay();
 
+  RunOnGPUThread([this]() { CompilePendingBatchPrograms(); });
+
   if (m_system->GetSettings().debugging.show_vram)
   {
-    m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_vram_texture.GetGLId())),
-                                      m_vram_texture.GetWidth(), static_cast<s32>(m_vram_texture.GetHeight()), 0,
-                                      m_vram_texture.GetHeight(), m_vram_texture.GetWidth(),
-                                      -static_cast<s32>(m_vram_texture.GetHeight()));
-    m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
-                                         static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+    RunOnGPUThread([this]() {
+      m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_vram_texture.GetGLId())),
+                                        m_vram_texture.GetWidth(), static_cast<s32>(m_vram_texture.GetHeight()), 0,
+                                        m_vram_texture.GetHeight(), m_vram_texture.GetWidth(),
+                                        -static_cast<s32>(m_vram_texture.GetHeight()));
+      m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
+                                           static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+    });
   }
   else
   {
@@ -599,75 +697,77 @@ void GPU_HW_OpenGL::UpdateDisplay()
     const u32 scaled_display_width = display_width * m_resolution_scale;
     const u32 scaled_display_height = display_height * m_resolution_scale;
     const InterlacedRenderMode interlaced = GetInterlacedRenderMode();
+    const bool display_disabled = IsDisplayDisabled();
+    const bool display_24bit = m_GPUSTAT.display_area_color_depth_24;
+    const u32 reinterpret_field_offset = (interlaced != InterlacedRenderMode::None) ? GetInterlacedDisplayField() : 0;
+    const u32 reinterpret_start_x = m_crtc_state.regs.X * m_resolution_scale;
+    const u32 reinterpret_crop_left = (m_crtc_state.display_vram_left - m_crtc_state.regs.X) * m_resolution_scale;
+
+    RunOnGPUThread([this, scaled_vram_offset_x, scaled_vram_offset_y, scaled_display_width, scaled_display_height,
+                    interlaced, display_disabled, display_24bit, reinterpret_field_offset, reinterpret_start_x,
+                    reinterpret_crop_left, crtc = m_crtc_state]() {
+      if (display_disabled)
+      {
+        m_host_display->ClearDisplayTexture();
+      }
+      else if (!display_24bit && interlaced == GPU_HW::InterlacedRenderMode::None &&
+               (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
+               (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
+      {
+        m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_vram_texture.GetGLId())),
+                                          m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), scaled_vram_offset_x,
+                                          m_vram_texture.GetHeight() - scaled_vram_offset_y, scaled_display_width,
+                                          -static_cast<s32>(scaled_display_height));
+      }
+      else
+      {
+        glDisable(GL_BLEND);
+        glDisable(GL_SCISSOR_TEST);
+        glDisable(GL_DEPTH_TEST);
+
+        m_display_programs[BoolToUInt8(display_24bit)][static_cast<u8>(interlaced)].Bind();
+        m_display_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+        m_vram_texture.Bind();
+
+        const u8 height_div2 = BoolToUInt8(interlaced == GPU_HW::InterlacedRenderMode::SeparateFields);
+        const u32 scaled_flipped_vram_offset_y = m_vram_texture.GetHeight() - scaled_vram_offset_y -
+                                                 reinterpret_field_offset - (scaled_display_height >> height_div2);
+        const u32 uniforms[4] = {reinterpret_start_x, scaled_flipped_vram_offset_y, reinterpret_crop_left,
+                                 reinterpret_field_offset};
+        UploadUniformBuffer(uniforms, sizeof(uniforms));
+        m_batch_ubo_invalidated = true;
+
+        glViewport(0, 0, scaled_display_width, scaled_display_height);
+        glBindVertexArray(m_attributeless_vao_id);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_display_texture.GetGLId())),
+                                          m_display_texture.GetWidth(), m_display_texture.GetHeight(), 0,
+                                          scaled_display_height, scaled_display_width,
+                                          -static_cast<s32>(scaled_display_height));
+
+        // restore state
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
+        glBindVertexArray(m_vao_id);
+        glViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+        glEnable(GL_DEPTH_TEST);
+        glEnable(GL_SCISSOR_TEST);
+      }
 
-    if (IsDisplayDisabled())
-    {
-      m_host_display->ClearDisplayTexture();
-    }
-    else if (!m_GPUSTAT.display_area_color_depth_24 && interlaced == GPU_HW::InterlacedRenderMode::None &&
-             (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
-             (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
-    {
-      m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_vram_texture.GetGLId())),
-                                        m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), scaled_vram_offset_x,
-                                        m_vram_texture.GetHeight() - scaled_vram_offset_y, scaled_display_width,
-                                        -static_cast<s32>(scaled_display_height));
-    }
-    else
-    {
-      glDisable(GL_BLEND);
-      glDisable(GL_SCISSOR_TEST);
-      glDisable(GL_DEPTH_TEST);
-
-      m_display_programs[BoolToUInt8(m_GPUSTAT.display_area_color_depth_24)][static_cast<u8>(interlaced)].Bind();
-      m_display_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
-      m_vram_texture.Bind();
-
-      const u8 height_div2 = BoolToUInt8(interlaced == GPU_HW::InterlacedRenderMode::SeparateFields);
-      const u32 reinterpret_field_offset = (interlaced != InterlacedRenderMode::None) ? GetInterlacedDisplayField() : 0;
-      const u32 scaled_flipped_vram_offset_y = m_vram_texture.GetHeight() - scaled_vram_offset_y -
-                                               reinterpret_field_offset - (scaled_display_height >> height_div2);
-      const u32 reinterpret_start_x = m_crtc_state.regs.X * m_resolution_scale;
-      const u32 reinterpret_crop_left = (m_crtc_state.display_vram_left - m_crtc_state.regs.X) * m_resolution_scale;
-      const u32 uniforms[4] = {reinterpret_start_x, scaled_flipped_vram_offset_y, reinterpret_crop_left,
-                               reinterpret_field_offset};
-      UploadUniformBuffer(uniforms, sizeof(uniforms));
-      m_batch_ubo_dirty = true;
-
-      glViewport(0, 0, scaled_display_width, scaled_display_height);
-      glBindVertexArray(m_attributeless_vao_id);
-      glDrawArrays(GL_TRIANGLES, 0, 3);
-
-      m_host_display->SetDisplayTexture(reinterpret_cast<void*>(static_cast<uintptr_t>(m_display_texture.GetGLId())),
-                                        m_display_texture.GetWidth(), m_display_texture.GetHeight(), 0,
-                                        scaled_display_height, scaled_display_width,
-                                        -static_cast<s32>(scaled_display_height));
-
-      // restore state
-      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
-      glBindVertexArray(m_vao_id);
-      glViewport(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
-      glEnable(GL_DEPTH_TEST);
-      glEnable(GL_SCISSOR_TEST);
-    }
-
-    m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
-                                         m_crtc_state.display_origin_left, m_crtc_state.display_origin_top,
-                                         m_crtc_state.display_vram_width, m_crtc_state.display_vram_height,
-                                         m_crtc_state.display_aspect_ratio);
+      m_host_display->SetDisplayParameters(crtc.display_width, crtc.display_height, crtc.display_origin_left,
+                                           crtc.display_origin_top, crtc.display_vram_width,
+                                           crtc.display_vram_height, crtc.display_aspect_ratio);
+    });
   }
 }
 
-void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+void GPU_HW_OpenGL::BeginVRAMReadback(const Common::Rectangle<u32>& rect)
 {
-  // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
-  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
-  const u32 encoded_height = copy_rect.GetHeight();
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
 
   // Encode the 24-bit texture as 16-bit.
-  const u32 uniforms[4] = {copy_rect.left, VRAM_HEIGHT - copy_rect.top - copy_rect.GetHeight(), copy_rect.GetWidth(),
-                           copy_rect.GetHeight()};
+  const u32 uniforms[4] = {rect.left, VRAM_HEIGHT - rect.top - rect.GetHeight(), rect.GetWidth(), rect.GetHeight()};
   m_vram_encoding_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
   m_vram_texture.Bind();
   m_vram_read_program.Bind();
@@ -678,15 +778,65 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   glBindVertexArray(m_attributeless_vao_id);
   glDrawArrays(GL_TRIANGLES, 0, 3);
 
-  // Readback encoded texture.
+  // Readback encoded texture. Without sync objects it has to go straight to the shadow buffer.
   m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
   glPixelStorei(GL_PACK_ALIGNMENT, 2);
-  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
-  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
-               &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
+  if (m_supports_sync)
+  {
+    if (m_vram_readback_fence)
+      glDeleteSync(m_vram_readback_fence);
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+    glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_vram_readback_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  }
+  else
+  {
+    glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
+    glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
+                 &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left]);
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+  }
   glPixelStorei(GL_PACK_ALIGNMENT, 4);
-  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
-  RestoreGraphicsAPIState();
+
+  DoRestoreGraphicsAPIState();
+}
+
+void GPU_HW_OpenGL::FinishVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  if (!m_supports_sync)
+    return;
+
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
+
+  glClientWaitSync(m_vram_readback_fence, GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+  glDeleteSync(m_vram_readback_fence);
+  m_vram_readback_fence = nullptr;
+
+  // And copy it into our shadow buffer.
+  const u32 row_size = encoded_width * sizeof(u32);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+  const u8* src_ptr =
+    static_cast<const u8*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, row_size * encoded_height, GL_MAP_READ_BIT));
+  if (src_ptr)
+  {
+    u16* dst_ptr = &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left];
+    for (u32 row = 0; row < encoded_height; row++)
+    {
+      std::memcpy(dst_ptr, src_ptr, row_size);
+      src_ptr += row_size;
+      dst_ptr += VRAM_WIDTH;
+    }
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  else
+  {
+    Log_ErrorPrintf("Failed to map VRAM readback buffer");
+  }
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
 }
 
 void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -695,7 +845,7 @@ void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   {
     // CPU round trip if oversized for now.
     Log_WarningPrintf("Oversized VRAM fill (%u-%u, %u-%u), CPU round trip", x, x + width, y, y + height);
-    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    ReadAllVRAMForRoundTrip();
     GPU::FillVRAM(x, y, width, height, color);
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_shadow.data());
     return;
@@ -709,29 +859,35 @@ void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
-
   // fast path when not using interlaced rendering
   if (!IsInterlacedRenderingEnabled())
   {
-    const auto [r, g, b, a] = RGBA8ToFloat(m_true_color ? color : RGBA5551ToRGBA8888(RGBA8888ToRGBA5551(color)));
-    glClearColor(r, g, b, a);
-    IsGLES() ? glClearDepthf(a) : glClearDepth(a);
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    SetScissorFromDrawingArea();
+    const u32 clear_color = m_true_color ? color : RGBA5551ToRGBA8888(RGBA8888ToRGBA5551(color));
+    RunOnGPUThread([this, x, y, width, height, clear_color]() {
+      glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
+
+      const auto [r, g, b, a] = RGBA8ToFloat(clear_color);
+      glClearColor(r, g, b, a);
+      IsGLES() ? glClearDepthf(a) : glClearDepth(a);
+      glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+      SetScissorFromDrawingArea();
+    });
   }
   else
   {
     const VRAMFillUBOData uniforms = GetVRAMFillUBOData(x, y, width, height, color);
+    RunOnGPUThread([this, x, y, width, height, uniforms]() {
+      glScissor(x, m_vram_texture.GetHeight() - y - height, width, height);
 
-    m_vram_interlaced_fill_program.Bind();
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
-    glDisable(GL_BLEND);
-    glDepthFunc(GL_ALWAYS);
-    glBindVertexArray(m_attributeless_vao_id);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+      m_vram_interlaced_fill_program.Bind();
+      UploadUniformBuffer(&uniforms, sizeof(uniforms));
+      glDisable(GL_BLEND);
+      glDepthFunc(GL_ALWAYS);
+      glBindVertexArray(m_attributeless_vao_id);
+      glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    RestoreGraphicsAPIState();
+      DoRestoreGraphicsAPIState();
+    });
   }
 }
 
@@ -743,32 +899,39 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     const Common::Rectangle<u32> bounds = GetVRAMTransferBounds(x, y, width, height);
     GPU_HW::UpdateVRAM(bounds.left, bounds.top, bounds.GetWidth(), bounds.GetHeight(), data);
 
-    const auto map_result = m_texture_stream_buffer->Map(sizeof(u16), num_pixels * sizeof(u16));
-    std::memcpy(map_result.pointer, data, num_pixels * sizeof(u16));
-    m_texture_stream_buffer->Unmap(num_pixels * sizeof(u16));
-    m_texture_stream_buffer->Unbind();
-
-    glDisable(GL_BLEND);
-    glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
-
-    m_vram_write_program.Bind();
-    if (m_use_ssbo_for_vram_writes)
-      glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_texture_stream_buffer->GetGLBufferId());
-    else
-      glBindTexture(GL_TEXTURE_BUFFER, m_texture_buffer_r16ui_texture);
-
-    const VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, map_result.index_aligned);
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
-
-    // the viewport should already be set to the full vram, so just adjust the scissor
-    const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
-    glScissor(scaled_bounds.left, m_vram_texture.GetHeight() - scaled_bounds.top - scaled_bounds.GetHeight(),
-              scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
-
-    glBindVertexArray(m_attributeless_vao_id);
-    glDrawArrays(GL_TRIANGLES, 0, 3);
-
-    RestoreGraphicsAPIState();
+    const bool check_mask = m_GPUSTAT.check_mask_before_draw;
+    RunOnGPUThreadWithData(
+      data, num_pixels * sizeof(u16),
+      [this, num_pixels, bounds, check_mask,
+       uniforms = GetVRAMWriteUBOData(x, y, width, height, 0)](const void* pixels) {
+        const auto map_result = m_texture_stream_buffer->Map(sizeof(u16), num_pixels * sizeof(u16));
+        std::memcpy(map_result.pointer, pixels, num_pixels * sizeof(u16));
+        m_texture_stream_buffer->Unmap(num_pixels * sizeof(u16));
+        m_texture_stream_buffer->Unbind();
+
+        glDisable(GL_BLEND);
+        glDepthFunc(check_mask ? GL_GEQUAL : GL_ALWAYS);
+
+        m_vram_write_program.Bind();
+        if (m_use_ssbo_for_vram_writes)
+          glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, m_texture_stream_buffer->GetGLBufferId());
+        else
+          glBindTexture(GL_TEXTURE_BUFFER, m_texture_buffer_r16ui_texture);
+
+        VRAMWriteUBOData buffer_uniforms = uniforms;
+        buffer_uniforms.u_buffer_base_offset = map_result.index_aligned;
+        UploadUniformBuffer(&buffer_uniforms, sizeof(buffer_uniforms));
+
+        // the viewport should already be set to the full vram, so just adjust the scissor
+        const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
+        glScissor(scaled_bounds.left, m_vram_texture.GetHeight() - scaled_bounds.top - scaled_bounds.GetHeight(),
+                  scaled_bounds.GetWidth(), scaled_bounds.GetHeight());
+
+        glBindVertexArray(m_attributeless_vao_id);
+        glDrawArrays(GL_TRIANGLES, 0, 3);
+
+        DoRestoreGraphicsAPIState();
+      });
   }
   else
   {
@@ -776,7 +939,7 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     {
       // CPU round trip if oversized for now.
       Log_WarningPrintf("Oversized VRAM update (%u-%u, %u-%u), CPU round trip", x, x + width, y, y + height);
-      ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+      ReadAllVRAMForRoundTrip();
       GPU::UpdateVRAM(x, y, width, height, data);
       UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_shadow.data());
       return;
@@ -784,59 +947,62 @@ void GPU_HW_OpenGL::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 
     GPU_HW::UpdateVRAM(x, y, width, height, data);
 
-    const auto map_result = m_texture_stream_buffer->Map(sizeof(u32), num_pixels * sizeof(u32));
+    RunOnGPUThreadWithData(
+      data, num_pixels * sizeof(u16), [this, x, y, width, height, num_pixels](const void* pixels) {
+        const auto map_result = m_texture_stream_buffer->Map(sizeof(u32), num_pixels * sizeof(u32));
 
-    // reverse copy the rows so it matches opengl's lower-left origin
-    const u32 source_stride = width * sizeof(u16);
-    const u8* source_ptr = static_cast<const u8*>(data) + (source_stride * (height - 1));
-    u32* dest_ptr = static_cast<u32*>(map_result.pointer);
-    for (u32 row = 0; row < height; row++)
-    {
-      const u8* source_row_ptr = source_ptr;
+        // reverse copy the rows so it matches opengl's lower-left origin
+        const u32 source_stride = width * sizeof(u16);
+        const u8* source_ptr = static_cast<const u8*>(pixels) + (source_stride * (height - 1));
+        u32* dest_ptr = static_cast<u32*>(map_result.pointer);
+        for (u32 row = 0; row < height; row++)
+        {
+          const u8* source_row_ptr = source_ptr;
 
-      for (u32 col = 0; col < width; col++)
-      {
-        u16 src_col;
-        std::memcpy(&src_col, source_row_ptr, sizeof(src_col));
-        source_row_ptr += sizeof(src_col);
+          for (u32 col = 0; col < width; col++)
+          {
+            u16 src_col;
+            std::memcpy(&src_col, source_row_ptr, sizeof(src_col));
+            source_row_ptr += sizeof(src_col);
 
-        *(dest_ptr++) = RGBA5551ToRGBA8888(src_col);
-      }
+            *(dest_ptr++) = RGBA5551ToRGBA8888(src_col);
+          }
 
-      source_ptr -= source_stride;
-    }
+          source_ptr -= source_stride;
+        }
 
-    m_texture_stream_buffer->Unmap(num_pixels * sizeof(u32));
-    m_texture_stream_buffer->Bind();
+        m_texture_stream_buffer->Unmap(num_pixels * sizeof(u32));
+        m_texture_stream_buffer->Bind();
 
-    // have to write to the 1x texture first
-    if (m_resolution_scale > 1)
-      m_vram_encoding_texture.Bind();
-    else
-      m_vram_texture.Bind();
+        // have to write to the 1x texture first
+        if (m_resolution_scale > 1)
+          m_vram_encoding_texture.Bind();
+        else
+          m_vram_texture.Bind();
 
-    // lower-left origin flip happens here
-    const u32 flipped_y = VRAM_HEIGHT - y - height;
+        // lower-left origin flip happens here
+        const u32 flipped_y = VRAM_HEIGHT - y - height;
 
-    // update texture data
-    glTexSubImage2D(GL_TEXTURE_2D, 0, x, flipped_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
-                    reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
-    m_texture_stream_buffer->Unbind();
+        // update texture data
+        glTexSubImage2D(GL_TEXTURE_2D, 0, x, flipped_y, width, height, GL_RGBA, GL_UNSIGNED_BYTE,
+                        reinterpret_cast<void*>(static_cast<uintptr_t>(map_result.buffer_offset)));
+        m_texture_stream_buffer->Unbind();
 
-    if (m_resolution_scale > 1)
-    {
-      // scale to internal resolution
-      const u32 scaled_width = width * m_resolution_scale;
-      const u32 scaled_height = height * m_resolution_scale;
-      const u32 scaled_x = x * m_resolution_scale;
-      const u32 scaled_y = y * m_resolution_scale;
-      const u32 scaled_flipped_y = m_vram_texture.GetHeight() - scaled_y - scaled_height;
-      glDisable(GL_SCISSOR_TEST);
-      m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
-      glBlitFramebuffer(x, flipped_y, x + width, flipped_y + height, scaled_x, scaled_flipped_y,
-                        scaled_x + scaled_width, scaled_flipped_y + scaled_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-      glEnable(GL_SCISSOR_TEST);
-    }
+        if (m_resolution_scale > 1)
+        {
+          // scale to internal resolution
+          const u32 scaled_width = width * m_resolution_scale;
+          const u32 scaled_height = height * m_resolution_scale;
+          const u32 scaled_x = x * m_resolution_scale;
+          const u32 scaled_y = y * m_resolution_scale;
+          const u32 scaled_flipped_y = m_vram_texture.GetHeight() - scaled_y - scaled_height;
+          glDisable(GL_SCISSOR_TEST);
+          m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
+          glBlitFramebuffer(x, flipped_y, x + width, flipped_y + height, scaled_x, scaled_flipped_y,
+                            scaled_x + scaled_width, scaled_flipped_y + scaled_height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+          glEnable(GL_SCISSOR_TEST);
+        }
+      });
   }
 }
 
@@ -846,30 +1012,33 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexture(src_bounds);
     IncludeVRAMDityRectangle(dst_bounds);
 
     VRAMCopyUBOData uniforms = GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height);
     uniforms.u_src_y = m_vram_texture.GetHeight() - uniforms.u_src_y - uniforms.u_height;
     uniforms.u_dst_y = m_vram_texture.GetHeight() - uniforms.u_dst_y - uniforms.u_height;
-    UploadUniformBuffer(&uniforms, sizeof(uniforms));
 
-    glDisable(GL_SCISSOR_TEST);
-    glDisable(GL_BLEND);
-    glDepthFunc(m_GPUSTAT.check_mask_before_draw ? GL_GEQUAL : GL_ALWAYS);
+    const bool check_mask = m_GPUSTAT.check_mask_before_draw;
+    RunOnGPUThread([this, uniforms, check_mask, dst_bounds]() {
+      UploadUniformBuffer(&uniforms, sizeof(uniforms));
 
-    const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
-    glViewport(dst_bounds_scaled.left,
-               m_vram_texture.GetHeight() - dst_bounds_scaled.top - dst_bounds_scaled.GetHeight(),
-               dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
-    m_vram_read_texture.Bind();
-    m_vram_copy_program.Bind();
-    glDrawArrays(GL_TRIANGLES, 0, 3);
+      glDisable(GL_SCISSOR_TEST);
+      glDisable(GL_BLEND);
+      glDepthFunc(check_mask ? GL_GEQUAL : GL_ALWAYS);
+
+      const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
+      glViewport(dst_bounds_scaled.left,
+                 m_vram_texture.GetHeight() - dst_bounds_scaled.top - dst_bounds_scaled.GetHeight(),
+                 dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
+      m_vram_read_texture.Bind();
+      m_vram_copy_program.Bind();
+      glDrawArrays(GL_TRIANGLES, 0, 3);
 
-    RestoreGraphicsAPIState();
+      DoRestoreGraphicsAPIState();
+    });
 
-    if (m_GPUSTAT.check_mask_before_draw)
+    if (check_mask)
       m_current_depth++;
 
     return;
@@ -888,55 +1057,69 @@ void GPU_HW_OpenGL::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   src_y = m_vram_texture.GetHeight() - src_y - height;
   dst_y = m_vram_texture.GetHeight() - dst_y - height;
 
-  if (GLAD_GL_VERSION_4_3)
-  {
-    glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
-                       GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
-  }
-  else if (GLAD_GL_EXT_copy_image)
-  {
-    glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
-                          GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
-  }
-  else
-  {
-    glDisable(GL_SCISSOR_TEST);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
-    glBlitFramebuffer(src_x, src_y, src_x + width, src_y + height, dst_x, dst_y, dst_x + width, dst_y + height,
-                      GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glEnable(GL_SCISSOR_TEST);
-  }
+  RunOnGPUThread([this, src_x, src_y, dst_x, dst_y, width, height]() {
+    if (GLAD_GL_VERSION_4_3)
+    {
+      glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
+                         GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
+    }
+    else if (GLAD_GL_EXT_copy_image)
+    {
+      glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, src_x, src_y, 0, m_vram_texture.GetGLId(),
+                            GL_TEXTURE_2D, 0, dst_x, dst_y, 0, width, height, 1);
+    }
+    else
+    {
+      glDisable(GL_SCISSOR_TEST);
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
+      glBlitFramebuffer(src_x, src_y, src_x + width, src_y + height, dst_x, dst_y, dst_x + width, dst_y + height,
+                        GL_COLOR_BUFFER_BIT, GL_NEAREST);
+      glEnable(GL_SCISSOR_TEST);
+    }
+  });
 }
 
-void GPU_HW_OpenGL::UpdateVRAMReadTexture()
+void GPU_HW_OpenGL::CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects)
 {
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-  const u32 width = scaled_rect.GetWidth();
-  const u32 height = scaled_rect.GetHeight();
-  const u32 x = scaled_rect.left;
-  const u32 y = m_vram_texture.GetHeight() - scaled_rect.top - height;
+  RunOnGPUThreadWithData(rects, sizeof(Common::Rectangle<u32>) * num_rects, [this, num_rects](const void* data) {
+    const Common::Rectangle<u32>* copy_rects = static_cast<const Common::Rectangle<u32>*>(data);
+    const bool use_blit = !GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image;
+    if (use_blit)
+    {
+      m_vram_read_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
+      glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
+      glDisable(GL_SCISSOR_TEST);
+    }
 
-  if (GLAD_GL_VERSION_4_3)
-  {
-    glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, x, y, 0, m_vram_read_texture.GetGLId(),
-                       GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
-  }
-  else if (GLAD_GL_EXT_copy_image)
-  {
-    glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, x, y, 0, m_vram_read_texture.GetGLId(),
-                          GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
-  }
-  else
-  {
-    m_vram_read_texture.BindFramebuffer(GL_DRAW_FRAMEBUFFER);
-    glBindFramebuffer(GL_READ_FRAMEBUFFER, m_vram_fbo_id);
-    glDisable(GL_SCISSOR_TEST);
-    glBlitFramebuffer(x, y, x + width, y + height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
-    glEnable(GL_SCISSOR_TEST);
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
-  }
+    for (u32 i = 0; i < num_rects; i++)
+    {
+      const auto scaled_rect = copy_rects[i] * m_resolution_scale;
+      const u32 width = scaled_rect.GetWidth();
+      const u32 height = scaled_rect.GetHeight();
+      const u32 x = scaled_rect.left;
+      const u32 y = m_vram_texture.GetHeight() - scaled_rect.top - height;
+      if (GLAD_GL_VERSION_4_3)
+      {
+        glCopyImageSubData(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, x, y, 0, m_vram_read_texture.GetGLId(),
+                           GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
+      }
+      else if (GLAD_GL_EXT_copy_image)
+      {
+        glCopyImageSubDataEXT(m_vram_texture.GetGLId(), GL_TEXTURE_2D, 0, x, y, 0, m_vram_read_texture.GetGLId(),
+                              GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
+      }
+      else
+      {
+        glBlitFramebuffer(x, y, x + width, y + height, x, y, x + width, y + height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+      }
+    }
 
-  GPU_HW::UpdateVRAMReadTexture();
+    if (use_blit)
+    {
+      glEnable(GL_SCISSOR_TEST);
+      glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_vram_fbo_id);
+    }
+  });
 }
 
 void GPU_HW_OpenGL::UpdateDepthBufferFromMaskBit()
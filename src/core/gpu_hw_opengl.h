@@ -7,6 +7,8 @@
 #include "gpu_hw.h"
 #include <array>
 #include <memory>
+#include <optional>
+#include <string>
 #include <tuple>
 
 class GPU_HW_OpenGL : public GPU_HW
@@ -18,26 +20,34 @@ public:
   bool Initialize(HostDisplay* host_display, System* system, DMA* dma, InterruptController* interrupt_controller,
                   Timers* timers) override;
   void Reset() override;
-
-  void ResetGraphicsAPIState() override;
-  void RestoreGraphicsAPIState() override;
   void UpdateSettings() override;
 
 protected:
+  void DoResetGraphicsAPIState() override;
+  void DoRestoreGraphicsAPIState() override;
   void UpdateDisplay() override;
-  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  void BeginVRAMReadback(const Common::Rectangle<u32>& rect) override;
+  void FinishVRAMReadback(const Common::Rectangle<u32>& rect) override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
-  void MapBatchVertexPointer(u32 required_vertices) override;
+  BatchVertex* MapBatchVertexPointer(u32 required_vertices, u32* space_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
 
 private:
+  enum : u32
+  {
+    NUM_BATCH_PROGRAMS = 4 * 9 * 2 * 2
+  };
+
+  static constexpr float BATCH_PROGRAM_COMPILE_BUDGET_MS = 2.0f;
+
   struct GLStats
   {
     u32 num_batches;
@@ -60,6 +70,9 @@ private:
   bool CreateUniformBuffer();
   bool CreateTextureBuffer();
 
+  std::optional<GL::Program> CompileBatchProgram(const std::string& vs, const std::string& gs, const std::string& fs,
+                                                 bool textured);
+  void CompilePendingBatchPrograms();
   bool CompilePrograms();
 
   GL::ShaderCache m_shader_cache;
@@ -81,10 +94,16 @@ private:
   std::unique_ptr<GL::StreamBuffer> m_texture_stream_buffer;
   GLuint m_texture_buffer_r16ui_texture = 0;
 
+  // pixel pack buffer which readbacks are copied to, and the fence signalled once the copy is done
+  GLuint m_vram_readback_pbo_id = 0;
+  GLsync m_vram_readback_fence = nullptr;
+
   std::array<std::array<std::array<std::array<GL::Program, 2>, 2>, 9>, 4>
     m_render_programs; // [render_mode][texture_mode][dithering][interlacing]
   std::array<std::array<std::array<GL::Program, 2>, 2>, 4>
     m_line_render_programs;                                     // [render_mode][dithering][interlacing]
+  std::array<GL::Program, 4> m_batch_uber_programs;             // [render_mode]
+  std::array<GL::Program, 4> m_line_batch_uber_programs;        // [render_mode]
   std::array<std::array<GL::Program, 3>, 2> m_display_programs; // [depth_24][interlaced]
   GL::Program m_vram_interlaced_fill_program;
   GL::Program m_vram_read_program;
@@ -92,10 +111,14 @@ private:
   GL::Program m_vram_copy_program;
   GL::Program m_vram_update_depth_program;
 
+  // next of m_render_programs to compile, once this reaches NUM_BATCH_PROGRAMS they're all done
+  u32 m_next_pending_batch_program = 0;
+
   u32 m_uniform_buffer_alignment = 1;
   u32 m_max_texture_buffer_size = 0;
 
   bool m_supports_texture_buffer = false;
   bool m_supports_geometry_shaders = false;
   bool m_use_ssbo_for_vram_writes = false;
+  bool m_supports_sync = false;
 };
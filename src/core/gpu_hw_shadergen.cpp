@@ -496,12 +496,141 @@ void GPU_HW_ShaderGen::DeclareFragmentEntryPoint(
 void GPU_HW_ShaderGen::WriteBatchUniformBuffer(std::stringstream& ss)
 {
   DeclareUniformBuffer(ss,
-                       {"uint2 u_texture_window_mask", "uint2 u_texture_window_offset", "float u_src_alpha_factor",
-                        "float u_dst_alpha_factor", "uint u_interlaced_displayed_field",
-                        "bool u_set_mask_while_drawing"},
+                       {"float u_src_alpha_factor", "float u_dst_alpha_factor", "uint u_interlaced_displayed_field",
+                        "bool u_set_mask_while_drawing", "uint u_texture_mode", "bool u_dithering",
+                        "bool u_interlacing"},
                        false);
 }
 
+void GPU_HW_ShaderGen::WriteBatchDitheringFunctions(std::stringstream& ss)
+{
+  if (m_glsl)
+    ss << "CONSTANT int[16] s_dither_values = int[16]( ";
+  else
+    ss << "CONSTANT int s_dither_values[] = {";
+  for (u32 i = 0; i < 16; i++)
+  {
+    if (i > 0)
+      ss << ", ";
+    ss << GPU::DITHER_MATRIX[i / 4][i % 4];
+  }
+  if (m_glsl)
+    ss << " );\n";
+  else
+    ss << "};\n";
+
+  ss << R"(
+uint3 ApplyDithering(uint2 coord, uint3 icol)
+{
+  #if DITHERING_SCALED
+    uint2 fc = coord & uint2(3u, 3u);
+  #else
+    uint2 fc = (coord / uint2(RESOLUTION_SCALE, RESOLUTION_SCALE)) & uint2(3u, 3u);
+  #endif
+  int offset = s_dither_values[fc.y * 4u + fc.x];
+
+  #if !TRUE_COLOR
+    return uint3(clamp((int3(icol) + int3(offset, offset, offset)) >> 3, 0, 31));
+  #else
+    return uint3(clamp(int3(icol) + int3(offset, offset, offset), 0, 255));
+  #endif
+}
+)";
+}
+
+void GPU_HW_ShaderGen::WriteBatchTextureWindowFunctions(std::stringstream& ss)
+{
+  ss << R"(
+CONSTANT float4 TRANSPARENT_PIXEL_COLOR = float4(0.0, 0.0, 0.0, 0.0);
+
+// texwindow is the mask in xy and the masked offset in zw, in pixels
+uint2 ApplyTextureWindow(uint4 texwindow, uint2 coords)
+{
+  return (coords & ~texwindow.xy) | texwindow.zw;
+}
+
+uint2 ApplyUpscaledTextureWindow(uint4 texwindow, uint2 coords)
+{
+  uint2 scale = uint2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+  return (coords & ~(texwindow.xy * scale)) | (texwindow.zw * scale);
+}
+
+uint2 FloatToIntegerCoords(float2 coords)
+{
+  // With the vertex offset applied at 1x resolution scale, we want to round the texture coordinates.
+  // Floor them otherwise, as it currently breaks when upscaling as the vertex offset is not applied.
+  return uint2((RESOLUTION_SCALE == 1u) ? roundEven(coords) : floor(coords));
+}
+)";
+}
+
+void GPU_HW_ShaderGen::WriteBatchFragmentOutput(std::stringstream& ss)
+{
+  ss << R"(
+  // Premultiply alpha so we don't need to use a colour output for it.
+  float premultiply_alpha = ialpha;
+  #if TRANSPARENCY
+    premultiply_alpha = ialpha * (semitransparent ? u_src_alpha_factor : 1.0);
+  #endif
+
+  float3 color;
+  #if !TRUE_COLOR
+    // We want to apply the alpha before the truncation to 16-bit, otherwise we'll be passing a 32-bit precision color
+    // into the blend unit, which can cause a small amount of error to accumulate.
+    color = floor(float3(icolor) * premultiply_alpha) / float3(31.0, 31.0, 31.0);
+  #else
+    // True color is actually simpler here since we want to preserve the precision.
+    color = (float3(icolor) * premultiply_alpha) / float3(255.0, 255.0, 255.0);
+  #endif
+
+  #if TRANSPARENCY
+    // Apply semitransparency. If not a semitransparent texel, destination alpha is ignored.
+    if (semitransparent)
+    {
+      #if TRANSPARENCY_ONLY_OPAQUE
+        discard;
+      #endif
+
+      #if USE_DUAL_SOURCE
+        o_col0 = float4(color, oalpha);
+        o_col1 = float4(0.0, 0.0, 0.0, u_dst_alpha_factor / ialpha);
+      #else
+        o_col0 = float4(color, u_dst_alpha_factor / ialpha);
+      #endif
+
+      o_depth = oalpha * v_pos.z;
+    }
+    else
+    {
+      #if TRANSPARENCY_ONLY_TRANSPARENCY
+        discard;
+      #endif
+
+      #if TRANSPARENCY_ONLY_OPAQUE
+        // We don't output the second color here because it's not used.
+        o_col0 = float4(color, oalpha);
+      #elif USE_DUAL_SOURCE
+        o_col0 = float4(color, oalpha);
+        o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
+      #else
+        o_col0 = float4(color, 1.0 - ialpha);
+      #endif
+
+      o_depth = oalpha * v_pos.z;
+    }
+  #else
+    // Non-transparency won't enable blending so we can write the mask here regardless.
+    o_col0 = float4(color, oalpha);
+
+    #if USE_DUAL_SOURCE
+      o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
+    #endif
+
+    o_depth = oalpha * v_pos.z;
+  #endif
+)";
+}
+
 std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
 {
   std::stringstream ss;
@@ -515,8 +644,9 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
 
   if (textured)
   {
-    DeclareVertexEntryPoint(ss, {"int3 a_pos", "float4 a_col0", "uint a_texcoord", "uint a_texpage"}, 1, 1,
-                            {{"nointerpolation", "uint4 v_texpage"}}, false);
+    DeclareVertexEntryPoint(
+      ss, {"int3 a_pos", "float4 a_col0", "uint a_texcoord", "uint a_texpage", "uint a_texwindow"}, 1, 1,
+      {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "uint4 v_texwindow"}}, false);
   }
   else
   {
@@ -563,6 +693,11 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
     v_texpage.y = ((a_texpage >> 4) & 1u) * 256u * RESOLUTION_SCALE;
     v_texpage.z = ((a_texpage >> 16) & 63u) * 16u * RESOLUTION_SCALE;
     v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
+
+    // mask_x,mask_y,offset_x,offset_y in 8 pixel steps, with the offset only applying to masked bits
+    uint2 texwindow_mask = uint2(a_texwindow & 31u, (a_texwindow >> 5) & 31u);
+    uint2 texwindow_offset = uint2((a_texwindow >> 10) & 31u, (a_texwindow >> 15) & 31u) & texwindow_mask;
+    v_texwindow = uint4(texwindow_mask, texwindow_offset) * 8u;
   #endif
 }
 )";
@@ -604,64 +739,13 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
   WriteCommonFunctions(ss);
   WriteBatchUniformBuffer(ss);
   DeclareTexture(ss, "samp0", 0);
+  WriteBatchDitheringFunctions(ss);
 
-  if (m_glsl)
-    ss << "CONSTANT int[16] s_dither_values = int[16]( ";
-  else
-    ss << "CONSTANT int s_dither_values[] = {";
-  for (u32 i = 0; i < 16; i++)
-  {
-    if (i > 0)
-      ss << ", ";
-    ss << GPU::DITHER_MATRIX[i / 4][i % 4];
-  }
-  if (m_glsl)
-    ss << " );\n";
-  else
-    ss << "};\n";
+  ss << "#if TEXTURED\n";
+  WriteBatchTextureWindowFunctions(ss);
 
   ss << R"(
-uint3 ApplyDithering(uint2 coord, uint3 icol)
-{
-  #if DITHERING_SCALED
-    uint2 fc = coord & uint2(3u, 3u);
-  #else
-    uint2 fc = (coord / uint2(RESOLUTION_SCALE, RESOLUTION_SCALE)) & uint2(3u, 3u);
-  #endif
-  int offset = s_dither_values[fc.y * 4u + fc.x];
-
-  #if !TRUE_COLOR
-    return uint3(clamp((int3(icol) + int3(offset, offset, offset)) >> 3, 0, 31));
-  #else
-    return uint3(clamp(int3(icol) + int3(offset, offset, offset), 0, 255));
-  #endif
-}
-
-#if TEXTURED
-CONSTANT float4 TRANSPARENT_PIXEL_COLOR = float4(0.0, 0.0, 0.0, 0.0);
-
-uint2 ApplyTextureWindow(uint2 coords)
-{
-  uint x = (uint(coords.x) & ~(u_texture_window_mask.x * 8u)) | ((u_texture_window_offset.x & u_texture_window_mask.x) * 8u);
-  uint y = (uint(coords.y) & ~(u_texture_window_mask.y * 8u)) | ((u_texture_window_offset.y & u_texture_window_mask.y) * 8u);
-  return uint2(x, y);
-}
-
-uint2 ApplyUpscaledTextureWindow(uint2 coords)
-{
-  uint x = (uint(coords.x) & ~(u_texture_window_mask.x * 8u * RESOLUTION_SCALE)) | ((u_texture_window_offset.x & u_texture_window_mask.x) * 8u * RESOLUTION_SCALE);
-  uint y = (uint(coords.y) & ~(u_texture_window_mask.y * 8u * RESOLUTION_SCALE)) | ((u_texture_window_offset.y & u_texture_window_mask.y) * 8u * RESOLUTION_SCALE);
-  return uint2(x, y);
-}
-
-uint2 FloatToIntegerCoords(float2 coords)
-{
-  // With the vertex offset applied at 1x resolution scale, we want to round the texture coordinates.
-  // Floor them otherwise, as it currently breaks when upscaling as the vertex offset is not applied.
-  return uint2((RESOLUTION_SCALE == 1u) ? roundEven(coords) : floor(coords));
-}
-
-float4 SampleFromVRAM(uint4 texpage, float2 coords)
+float4 SampleFromVRAM(uint4 texpage, uint4 texwindow, float2 coords)
 {
   #if PALETTE
     // We can't currently use upscaled coordinate for palettes because of how they're packed.
@@ -669,7 +753,7 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     #if !TEXTURE_FILTERING
       coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
     #endif
-    uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
+    uint2 icoord = ApplyTextureWindow(texwindow, FloatToIntegerCoords(coords));
 
     uint2 index_coord = icoord;
     #if PALETTE_4_BIT
@@ -699,7 +783,7 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     return LOAD_TEXTURE(samp0, int2(palette_icoord), 0);
   #else
     // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
-    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));    
+    uint2 icoord = ApplyUpscaledTextureWindow(texwindow, FloatToIntegerCoords(coords));    
     uint2 direct_icoord = uint2(texpage.x + icoord.x, fixYCoord(texpage.y + icoord.y));
     return LOAD_TEXTURE(samp0, int2(direct_icoord), 0);
   #endif
@@ -709,7 +793,9 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
 
   if (textured)
   {
-    DeclareFragmentEntryPoint(ss, 1, 1, {{"nointerpolation", "uint4 v_texpage"}}, true, use_dual_source ? 2 : 1, true);
+    DeclareFragmentEntryPoint(ss, 1, 1,
+                              {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "uint4 v_texwindow"}},
+                              true, use_dual_source ? 2 : 1, true);
   }
   else
   {
@@ -744,10 +830,10 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
                            float4(0.0, 0.0, 0.0, 0.0));
 
       // Load four texels.
-      float4 s00 = SampleFromVRAM(v_texpage, fcoords.xy);
-      float4 s10 = SampleFromVRAM(v_texpage, fcoords.zy);
-      float4 s01 = SampleFromVRAM(v_texpage, fcoords.xw);
-      float4 s11 = SampleFromVRAM(v_texpage, fcoords.zw);
+      float4 s00 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.xy);
+      float4 s10 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.zy);
+      float4 s01 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.xw);
+      float4 s11 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.zw);
 
       // Compute alpha from how many texels aren't pixel color 0000h.
       float a00 = float(VECTOR_NEQ(s00, TRANSPARENT_PIXEL_COLOR));
@@ -765,7 +851,7 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
       texcol.rgb /= float3(ialpha, ialpha, ialpha);
       semitransparent = (texcol.a != 0.0);
     #else
-      float4 texcol = SampleFromVRAM(v_texpage, v_tex0);
+      float4 texcol = SampleFromVRAM(v_texpage, v_texwindow, v_tex0);
       if (VECTOR_EQ(texcol, TRANSPARENT_PIXEL_COLOR))
         discard;
 
@@ -816,70 +902,216 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     oalpha = float(u_set_mask_while_drawing);
   #endif
 
-  // Premultiply alpha so we don't need to use a colour output for it.
-  float premultiply_alpha = ialpha;
-  #if TRANSPARENCY
-    premultiply_alpha = ialpha * (semitransparent ? u_src_alpha_factor : 1.0);
-  #endif
+)";
 
-  float3 color;
-  #if !TRUE_COLOR
-    // We want to apply the alpha before the truncation to 16-bit, otherwise we'll be passing a 32-bit precision color
-    // into the blend unit, which can cause a small amount of error to accumulate.
-    color = floor(float3(icolor) * premultiply_alpha) / float3(31.0, 31.0, 31.0);
-  #else
-    // True color is actually simpler here since we want to preserve the precision.
-    color = (float3(icolor) * premultiply_alpha) / float3(255.0, 255.0, 255.0);
-  #endif
+  WriteBatchFragmentOutput(ss);
+  ss << "}\n";
 
-  #if TRANSPARENCY
-    // Apply semitransparency. If not a semitransparent texel, destination alpha is ignored.
-    if (semitransparent)
-    {
-      #if TRANSPARENCY_ONLY_OPAQUE
-        discard;
-      #endif
+  return ss.str();
+}
 
-      #if USE_DUAL_SOURCE
-        o_col0 = float4(color, oalpha);
-        o_col1 = float4(0.0, 0.0, 0.0, u_dst_alpha_factor / ialpha);
-      #else
-        o_col0 = float4(color, u_dst_alpha_factor / ialpha);
-      #endif
+std::string GPU_HW_ShaderGen::GenerateBatchUberFragmentShader(GPU_HW::BatchRenderMode transparency, bool textured)
+{
+  const bool use_dual_source =
+    m_supports_dual_source_blend && ((transparency != GPU_HW::BatchRenderMode::TransparencyDisabled &&
+                                      transparency != GPU_HW::BatchRenderMode::OnlyOpaque) ||
+                                     m_texture_filering);
 
-      o_depth = oalpha * v_pos.z;
-    }
+  // Blending is part of the pipeline state, so the render mode stays static. Everything else which is a compile-time
+  // switch in the specialised shaders is read from the uniform buffer.
+  std::stringstream ss;
+  WriteHeader(ss);
+  DefineMacro(ss, "TRANSPARENCY", transparency != GPU_HW::BatchRenderMode::TransparencyDisabled);
+  DefineMacro(ss, "TRANSPARENCY_ONLY_OPAQUE", transparency == GPU_HW::BatchRenderMode::OnlyOpaque);
+  DefineMacro(ss, "TRANSPARENCY_ONLY_TRANSPARENCY", transparency == GPU_HW::BatchRenderMode::OnlyTransparent);
+  DefineMacro(ss, "TEXTURED", textured);
+  DefineMacro(ss, "DITHERING_SCALED", m_scaled_dithering);
+  DefineMacro(ss, "TRUE_COLOR", m_true_color);
+  DefineMacro(ss, "TEXTURE_FILTERING", m_texture_filering);
+  DefineMacro(ss, "USE_DUAL_SOURCE", use_dual_source);
+
+  WriteCommonFunctions(ss);
+  WriteBatchUniformBuffer(ss);
+  DeclareTexture(ss, "samp0", 0);
+  WriteBatchDitheringFunctions(ss);
+
+  ss << "#if TEXTURED\n";
+  WriteBatchTextureWindowFunctions(ss);
+
+  ss << "CONSTANT uint TEXTURE_MODE_DISABLED = " << static_cast<u32>(GPU::TextureMode::Disabled) << "u;\n";
+  ss << "CONSTANT uint TEXTURE_MODE_RAW_TEXTURE_BIT = " << static_cast<u32>(GPU::TextureMode::RawTextureBit)
+     << "u;\n";
+  ss << "CONSTANT uint TEXTURE_MODE_PALETTE_4_BIT = " << static_cast<u32>(GPU::TextureMode::Palette4Bit) << "u;\n";
+  ss << "CONSTANT uint TEXTURE_MODE_PALETTE_8_BIT = " << static_cast<u32>(GPU::TextureMode::Palette8Bit) << "u;\n";
+
+  ss << R"(
+bool IsPaletteTextureMode()
+{
+  return ((u_texture_mode & ~TEXTURE_MODE_RAW_TEXTURE_BIT) <= TEXTURE_MODE_PALETTE_8_BIT);
+}
+
+float4 SampleFromVRAM(uint4 texpage, uint4 texwindow, float2 coords)
+{
+  uint texture_mode = u_texture_mode & ~TEXTURE_MODE_RAW_TEXTURE_BIT;
+  if (texture_mode <= TEXTURE_MODE_PALETTE_8_BIT)
+  {
+    #if !TEXTURE_FILTERING
+      coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+    #endif
+    uint2 icoord = ApplyTextureWindow(texwindow, FloatToIntegerCoords(coords));
+
+    uint2 index_coord = icoord;
+    index_coord.x /= (texture_mode == TEXTURE_MODE_PALETTE_4_BIT) ? 4u : 2u;
+
+    // fixup coords
+    uint2 vicoord = uint2(texpage.x + index_coord.x * RESOLUTION_SCALE, fixYCoord(texpage.y + index_coord.y * RESOLUTION_SCALE));
+
+    // load colour/palette
+    float4 texel = LOAD_TEXTURE(samp0, int2(vicoord), 0);
+    uint vram_value = RGBA8ToRGBA5551(texel);
+
+    // apply palette
+    uint palette_index;
+    if (texture_mode == TEXTURE_MODE_PALETTE_4_BIT)
+      palette_index = (vram_value >> ((icoord.x & 3u) * 4u)) & 0x0Fu;
     else
-    {
-      #if TRANSPARENCY_ONLY_TRANSPARENCY
+      palette_index = (vram_value >> ((icoord.x & 1u) * 8u)) & 0xFFu;
+
+    // sample palette
+    uint2 palette_icoord = uint2(texpage.z + (palette_index * RESOLUTION_SCALE), fixYCoord(texpage.w));
+    return LOAD_TEXTURE(samp0, int2(palette_icoord), 0);
+  }
+  else
+  {
+    // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
+    uint2 icoord = ApplyUpscaledTextureWindow(texwindow, FloatToIntegerCoords(coords));
+    uint2 direct_icoord = uint2(texpage.x + icoord.x, fixYCoord(texpage.y + icoord.y));
+    return LOAD_TEXTURE(samp0, int2(direct_icoord), 0);
+  }
+}
+#endif
+)";
+
+  // The untextured variant is for lines, which have to match the geometry shader's outputs when they're expanded.
+  if (textured)
+    DeclareFragmentEntryPoint(ss, 1, 1,
+                              {{"nointerpolation", "uint4 v_texpage"}, {"nointerpolation", "uint4 v_texwindow"}},
+                              true, use_dual_source ? 2 : 1, true);
+  else
+    DeclareFragmentEntryPoint(ss, 1, 0, {}, true, use_dual_source ? 2 : 1, true);
+
+  ss << R"(
+{
+  uint3 vertcol = uint3(v_col0.rgb * float3(255.0, 255.0, 255.0));
+
+  bool semitransparent;
+  uint3 icolor;
+  float ialpha;
+  float oalpha;
+
+  if (u_interlacing)
+  {
+    if ((fixYCoord(uint(v_pos.y)) & 1u) == u_interlaced_displayed_field)
+      discard;
+  }
+
+#if TEXTURED
+  if (u_texture_mode != TEXTURE_MODE_DISABLED)
+  {
+    float4 texcol;
+    #if TEXTURE_FILTERING
+      // Compute the coordinates of the four texels we will be interpolating between.
+      float2 downscaled_coords = v_tex0;
+      if (IsPaletteTextureMode())
+        downscaled_coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
+      float2 texel_top_left = frac(downscaled_coords) - float2(0.5, 0.5);
+      float2 texel_offset = sign(texel_top_left);
+      float4 fcoords = max(downscaled_coords.xyxy + float4(0.0, 0.0, texel_offset.x, texel_offset.y),
+                           float4(0.0, 0.0, 0.0, 0.0));
+
+      // Load four texels.
+      float4 s00 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.xy);
+      float4 s10 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.zy);
+      float4 s01 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.xw);
+      float4 s11 = SampleFromVRAM(v_texpage, v_texwindow, fcoords.zw);
+
+      // Compute alpha from how many texels aren't pixel color 0000h.
+      float a00 = float(VECTOR_NEQ(s00, TRANSPARENT_PIXEL_COLOR));
+      float a10 = float(VECTOR_NEQ(s10, TRANSPARENT_PIXEL_COLOR));
+      float a01 = float(VECTOR_NEQ(s01, TRANSPARENT_PIXEL_COLOR));
+      float a11 = float(VECTOR_NEQ(s11, TRANSPARENT_PIXEL_COLOR));
+
+      // Bilinearly interpolate.
+      float2 weights = abs(texel_top_left);
+      texcol = lerp(lerp(s00, s10, weights.x), lerp(s01, s11, weights.x), weights.y);
+      ialpha = lerp(lerp(a00, a10, weights.x), lerp(a01, a11, weights.x), weights.y);
+      if (ialpha < 0.5)
         discard;
-      #endif
 
-      #if TRANSPARENCY_ONLY_OPAQUE
-        // We don't output the second color here because it's not used.
-        o_col0 = float4(color, oalpha);
-      #elif USE_DUAL_SOURCE
-        o_col0 = float4(color, oalpha);
-        o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
-      #else
-        o_col0 = float4(color, 1.0 - ialpha);
-      #endif
+      texcol.rgb /= float3(ialpha, ialpha, ialpha);
+      semitransparent = (texcol.a != 0.0);
+    #else
+      texcol = SampleFromVRAM(v_texpage, v_texwindow, v_tex0);
+      if (VECTOR_EQ(texcol, TRANSPARENT_PIXEL_COLOR))
+        discard;
 
-      o_depth = oalpha * v_pos.z;
-    }
-  #else
-    // Non-transparency won't enable blending so we can write the mask here regardless.
-    o_col0 = float4(color, oalpha);
+      semitransparent = (texcol.a != 0.0);
+      ialpha = 1.0;
+    #endif
 
-    #if USE_DUAL_SOURCE
-      o_col1 = float4(0.0, 0.0, 0.0, 1.0 - ialpha);
+    // If not using true color, truncate the framebuffer colors to 5-bit.
+    #if !TRUE_COLOR
+      icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0)) >> 3;
+      if ((u_texture_mode & TEXTURE_MODE_RAW_TEXTURE_BIT) == 0u)
+      {
+        icolor = (icolor * vertcol) >> 4;
+        if (u_dithering)
+          icolor = ApplyDithering(uint2(v_pos.xy), icolor);
+        else
+          icolor = min(icolor >> 3, uint3(31u, 31u, 31u));
+      }
+    #else
+      icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0));
+      if ((u_texture_mode & TEXTURE_MODE_RAW_TEXTURE_BIT) == 0u)
+      {
+        icolor = (icolor * vertcol) >> 7;
+        if (u_dithering)
+          icolor = ApplyDithering(uint2(v_pos.xy), icolor);
+        else
+          icolor = min(icolor, uint3(255u, 255u, 255u));
+      }
     #endif
 
-    o_depth = oalpha * v_pos.z;
-  #endif
-}
+    // Compute output alpha (mask bit)
+    oalpha = float(u_set_mask_while_drawing ? 1 : int(semitransparent));
+  }
+  else
+#endif
+  {
+    // All pixels are semitransparent for untextured polygons.
+    semitransparent = true;
+    icolor = vertcol;
+    ialpha = 1.0;
+
+    if (u_dithering)
+    {
+      icolor = ApplyDithering(uint2(v_pos.xy), icolor);
+    }
+    else
+    {
+      #if !TRUE_COLOR
+        icolor >>= 3;
+      #endif
+    }
+
+    // However, the mask bit is cleared if set mask bit is false.
+    oalpha = float(u_set_mask_while_drawing);
+  }
 )";
 
+  WriteBatchFragmentOutput(ss);
+  ss << "}\n";
+
   return ss.str();
 }
 
@@ -1276,3 +1508,84 @@ std::string GPU_HW_ShaderGen::GenerateVRAMUpdateDepthFragmentShader()
 
   return ss.str();
 }
+
+std::string GPU_HW_ShaderGen::GenerateVRAMTransferComputeShader(u32 max_transfers, u32 workgroup_size)
+{
+  Assert(IsVulkan());
+
+  std::stringstream ss;
+  WriteHeader(ss);
+  WriteCommonFunctions(ss);
+  ss << "CONSTANT uint TRANSFER_FILL = " << static_cast<u32>(GPU_HW::VRAMTransferType::Fill) << "u;\n";
+  ss << "CONSTANT uint TRANSFER_WRITE = " << static_cast<u32>(GPU_HW::VRAMTransferType::Write) << "u;\n";
+  ss << "CONSTANT uint TRANSFER_COPY = " << static_cast<u32>(GPU_HW::VRAMTransferType::Copy) << "u;\n";
+  ss << "CONSTANT uint2 NATIVE_VRAM_SIZE = uint2(" << GPU::VRAM_WIDTH << ", " << GPU::VRAM_HEIGHT << ");\n\n";
+  ss << R"(struct VRAMTransfer
+{
+  uint4 dst_rect;
+  uint4 src;
+  uint4 params;
+  float4 fill_color;
+};
+
+)";
+
+  std::string transfers_member("VRAMTransfer u_transfers[");
+  transfers_member += std::to_string(max_transfers);
+  transfers_member += "]";
+  DeclareUniformBuffer(ss, {transfers_member.c_str()}, false);
+
+  ss << "layout(set = 0, binding = 1, rgba8) uniform restrict image2D vram_image;\n";
+  DeclareTexture(ss, "samp0", 1);
+  DeclareTextureBuffer(ss, "samp1", 3, true, true);
+  ss << "layout(local_size_x = " << workgroup_size << ", local_size_y = " << workgroup_size
+     << ", local_size_z = 1) in;\n";
+
+  ss << R"(
+void main()
+{
+  // one transfer per z slice, the dispatch is sized for the largest so the others have threads to spare
+  VRAMTransfer t = u_transfers[gl_GlobalInvocationID.z];
+  uint2 offset = gl_GlobalInvocationID.xy;
+  if (VECTOR_GE(offset, t.dst_rect.zw * RESOLUTION_SCALE))
+    return;
+
+  // transfers wrap around in native coordinates, each native pixel covers RESOLUTION_SCALE^2 threads
+  uint2 native_offset = offset / RESOLUTION_SCALE;
+  uint2 sub_offset = offset % RESOLUTION_SCALE;
+  int2 dst_coords = int2(((t.dst_rect.xy + native_offset) % NATIVE_VRAM_SIZE) * RESOLUTION_SCALE + sub_offset);
+
+  float4 color;
+  if (t.params.x == TRANSFER_FILL)
+  {
+    // fills ignore the mask bit, but skip the displayed field when interlaced
+    if ((uint(dst_coords.y) & 1u) == t.params.w)
+      return;
+
+    color = t.fill_color;
+  }
+  else
+  {
+    if (t.params.z != 0u && imageLoad(vram_image, dst_coords).a != 0.0)
+      return;
+
+    if (t.params.x == TRANSFER_WRITE)
+    {
+      uint buffer_offset = t.src.x + (native_offset.y * t.dst_rect.z) + native_offset.x;
+      color = RGBA5551ToRGBA8(LOAD_TEXTURE_BUFFER(samp1, int(buffer_offset)).r | t.params.y);
+    }
+    else
+    {
+      int2 src_coords = int2(((t.src.xy + native_offset) % NATIVE_VRAM_SIZE) * RESOLUTION_SCALE + sub_offset);
+      color = LOAD_TEXTURE(samp0, src_coords, 0);
+      if (t.params.y != 0u)
+        color.a = 1.0;
+    }
+  }
+
+  imageStore(vram_image, dst_coords, color);
+}
+)";
+
+  return ss.str();
+}
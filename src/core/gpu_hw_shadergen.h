@@ -16,6 +16,7 @@ public:
   std::string GenerateBatchVertexShader(bool textured);
   std::string GenerateBatchFragmentShader(GPU_HW::BatchRenderMode transparency, GPU::TextureMode texture_mode,
                                           bool dithering, bool interlacing);
+  std::string GenerateBatchUberFragmentShader(GPU_HW::BatchRenderMode transparency, bool textured);
   std::string GenerateBatchLineExpandGeometryShader();
   std::string GenerateScreenQuadVertexShader();
   std::string GenerateFillFragmentShader();
@@ -26,6 +27,7 @@ public:
   std::string GenerateVRAMWriteFragmentShader(bool use_ssbo);
   std::string GenerateVRAMCopyFragmentShader();
   std::string GenerateVRAMUpdateDepthFragmentShader();
+  std::string GenerateVRAMTransferComputeShader(u32 max_transfers, u32 workgroup_size);
 
 private:
   ALWAYS_INLINE bool IsVulkan() const { return (m_render_api == HostDisplay::RenderAPI::Vulkan); }
@@ -46,6 +48,9 @@ private:
 
   void WriteCommonFunctions(std::stringstream& ss);
   void WriteBatchUniformBuffer(std::stringstream& ss);
+  void WriteBatchDitheringFunctions(std::stringstream& ss);
+  void WriteBatchTextureWindowFunctions(std::stringstream& ss);
+  void WriteBatchFragmentOutput(std::stringstream& ss);
 
   HostDisplay::RenderAPI m_render_api;
   u32 m_resolution_scale;
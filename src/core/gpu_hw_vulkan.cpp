@@ -16,10 +16,12 @@ GPU_HW_Vulkan::GPU_HW_Vulkan() = default;
 
 GPU_HW_Vulkan::~GPU_HW_Vulkan()
 {
+  StopGPUThread();
+
   if (m_host_display)
   {
     m_host_display->ClearDisplayTexture();
-    ResetGraphicsAPIState();
+    DoResetGraphicsAPIState();
   }
 
   DestroyResources();
@@ -83,7 +85,10 @@ bool GPU_HW_Vulkan::Initialize(HostDisplay* host_display, System* system, DMA* d
   }
 
   UpdateDepthBufferFromMaskBit();
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
+  if (system->GetSettings().gpu_use_thread)
+    StartGPUThread();
+
   return true;
 }
 
@@ -91,14 +96,13 @@ void GPU_HW_Vulkan::Reset()
 {
   GPU_HW::Reset();
 
-  EndRenderPass();
+  RunOnGPUThread([this]() { EndRenderPass(); });
   ClearFramebuffer();
 }
 
-void GPU_HW_Vulkan::ResetGraphicsAPIState()
+void GPU_HW_Vulkan::DoResetGraphicsAPIState()
 {
-  GPU_HW::ResetGraphicsAPIState();
-
+  FlushVRAMTransfers();
   EndRenderPass();
 
   // vram texture is probably going to be displayed now
@@ -109,7 +113,7 @@ void GPU_HW_Vulkan::ResetGraphicsAPIState()
   }
 }
 
-void GPU_HW_Vulkan::RestoreGraphicsAPIState()
+void GPU_HW_Vulkan::DoRestoreGraphicsAPIState()
 {
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
@@ -124,9 +128,13 @@ void GPU_HW_Vulkan::RestoreGraphicsAPIState()
 
 void GPU_HW_Vulkan::UpdateSettings()
 {
+  // the compile threads read the current settings
+  StopBatchPipelineCompileThreads();
+
   GPU_HW::UpdateSettings();
 
   // Everything should be finished executing before recreating resources.
+  FlushVRAMTransfers();
   g_vulkan_context->ExecuteCommandBuffer(true);
 
   CreateFramebuffer();
@@ -134,50 +142,49 @@ void GPU_HW_Vulkan::UpdateSettings()
   CompilePipelines();
   UpdateDepthBufferFromMaskBit();
   UpdateDisplay();
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
+
+  if (m_system->GetSettings().gpu_use_thread)
+    StartGPUThread();
 }
 
-void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices, u32* space_vertices)
 {
-  DebugAssert(!m_batch_start_vertex_ptr);
-
   const u32 required_space = required_vertices * sizeof(BatchVertex);
   if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
   {
     Log_PerfPrintf("Executing command buffer while waiting for %u bytes in vertex stream buffer", required_space);
+    FlushVRAMTransfers();
     EndRenderPass();
     g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
+    DoRestoreGraphicsAPIState();
     if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
       Panic("Failed to reserve vertex stream buffer memory");
   }
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + (m_vertex_stream_buffer.GetCurrentSpace() / sizeof(BatchVertex));
   m_batch_base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  *space_vertices = m_vertex_stream_buffer.GetCurrentSpace() / sizeof(BatchVertex);
+  return static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
 }
 
 void GPU_HW_Vulkan::UnmapBatchVertexPointer(u32 used_vertices)
 {
-  DebugAssert(m_batch_start_vertex_ptr);
   if (used_vertices > 0)
     m_vertex_stream_buffer.CommitMemory(used_vertices * sizeof(BatchVertex));
-
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 void GPU_HW_Vulkan::UploadUniformBuffer(const void* data, u32 data_size)
 {
+  // queued transfers hold a reservation in the uniform buffer
+  FlushVRAMTransfers();
+
   const u32 alignment = static_cast<u32>(g_vulkan_context->GetUniformBufferAlignment());
   if (!m_uniform_stream_buffer.ReserveMemory(data_size, alignment))
   {
     Log_PerfPrintf("Executing command buffer while waiting for %u bytes in uniform stream buffer", data_size);
     EndRenderPass();
     g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
+    DoRestoreGraphicsAPIState();
     if (!m_uniform_stream_buffer.ReserveMemory(data_size, alignment))
       Panic("Failed to reserve uniform stream buffer memory");
   }
@@ -199,6 +206,7 @@ void GPU_HW_Vulkan::SetCapabilities()
 
   m_max_resolution_scale = max_texture_scale;
   m_supports_dual_source_blend = g_vulkan_context->GetDeviceFeatures().dualSrcBlend;
+  m_supports_async_vram_readback = true;
 
 #ifdef __APPLE__
   // Partial texture buffer uploads appear to be broken in macOS/MoltenVK.
@@ -212,6 +220,9 @@ void GPU_HW_Vulkan::SetCapabilities()
     m_use_ssbos_for_vram_writes = true;
   }
 #endif
+
+  // the compute transfers read written data through the texel buffer
+  m_supports_compute_vram_transfers = !m_use_ssbos_for_vram_writes;
 }
 
 void GPU_HW_Vulkan::DestroyResources()
@@ -230,10 +241,12 @@ void GPU_HW_Vulkan::DestroyResources()
   m_uniform_stream_buffer.Destroy(false);
   m_texture_stream_buffer.Destroy(false);
 
+  Vulkan::Util::SafeDestroyPipelineLayout(m_vram_transfer_pipeline_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_vram_write_pipeline_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_single_sampler_pipeline_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_no_samplers_pipeline_layout);
   Vulkan::Util::SafeDestroyPipelineLayout(m_batch_pipeline_layout);
+  Vulkan::Util::SafeDestroyDescriptorSetLayout(m_vram_transfer_descriptor_set_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_vram_write_descriptor_set_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_single_sampler_descriptor_set_layout);
   Vulkan::Util::SafeDestroyDescriptorSetLayout(m_batch_descriptor_set_layout);
@@ -259,6 +272,7 @@ void GPU_HW_Vulkan::BeginRenderPass(VkRenderPass render_pass, VkFramebuffer fram
 
 void GPU_HW_Vulkan::BeginVRAMRenderPass()
 {
+  FlushVRAMTransfers();
   if (m_current_render_pass == m_vram_render_pass)
     return;
 
@@ -324,6 +338,22 @@ bool GPU_HW_Vulkan::CreatePipelineLayouts()
   if (m_vram_write_pipeline_layout == VK_NULL_HANDLE)
     return false;
 
+  if (m_supports_compute_vram_transfers)
+  {
+    dslbuilder.AddBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    dslbuilder.AddBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    dslbuilder.AddBinding(2, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    dslbuilder.AddBinding(3, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT);
+    m_vram_transfer_descriptor_set_layout = dslbuilder.Create(device);
+    if (m_vram_transfer_descriptor_set_layout == VK_NULL_HANDLE)
+      return false;
+
+    plbuilder.AddDescriptorSet(m_vram_transfer_descriptor_set_layout);
+    m_vram_transfer_pipeline_layout = plbuilder.Create(device);
+    if (m_vram_transfer_pipeline_layout == VK_NULL_HANDLE)
+      return false;
+  }
+
   return true;
 }
 
@@ -358,10 +388,13 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
   const VkFormat depth_format = VK_FORMAT_D16_UNORM;
   const VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
 
+  // storage usage can disable framebuffer compression on some GPUs, so it's only added when it's needed
+  const VkImageUsageFlags vram_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
+                                       VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                                       (m_compute_vram_transfers ? VK_IMAGE_USAGE_STORAGE_BIT : 0);
+
   if (!m_vram_texture.Create(texture_width, texture_height, 1, 1, texture_format, samples, VK_IMAGE_VIEW_TYPE_2D,
-                             VK_IMAGE_TILING_OPTIMAL,
-                             VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT |
-                               VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
+                             VK_IMAGE_TILING_OPTIMAL, vram_usage) ||
       !m_vram_depth_texture.Create(texture_width, texture_height, 1, 1, depth_format, samples, VK_IMAGE_VIEW_TYPE_2D,
                                    VK_IMAGE_TILING_OPTIMAL,
                                    VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
@@ -442,6 +475,25 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_read_descriptor_set, 1, m_vram_texture.GetView(),
                                                     m_point_sampler, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+  if (m_compute_vram_transfers)
+  {
+    m_vram_transfer_descriptor_set =
+      g_vulkan_context->AllocateGlobalDescriptorSet(m_vram_transfer_descriptor_set_layout);
+    if (m_vram_transfer_descriptor_set == VK_NULL_HANDLE)
+      return false;
+
+    dsubuilder.AddBufferDescriptorWrite(m_vram_transfer_descriptor_set, 0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC,
+                                        m_uniform_stream_buffer.GetBuffer(), 0,
+                                        sizeof(VRAMTransferUBOData) * MAX_VRAM_TRANSFERS_PER_DISPATCH);
+    dsubuilder.AddStorageImageDescriptorWrite(m_vram_transfer_descriptor_set, 1, m_vram_texture.GetView());
+    dsubuilder.AddCombinedImageSamplerDescriptorWrite(m_vram_transfer_descriptor_set, 2,
+                                                      m_vram_read_texture.GetView(), m_point_sampler,
+                                                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    dsubuilder.AddBufferViewDescriptorWrite(m_vram_transfer_descriptor_set, 3, VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER,
+                                            m_texture_stream_buffer_view);
+  }
+
   dsubuilder.Update(g_vulkan_context->GetDevice());
 
   if (old_vram_texture.IsValid())
@@ -474,21 +526,27 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
 
 void GPU_HW_Vulkan::ClearFramebuffer()
 {
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+  RunOnGPUThread([this]() {
+    FlushVRAMTransfers();
+    EndRenderPass();
 
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-  m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
-  static constexpr VkClearColorValue cc = {};
-  static constexpr VkImageSubresourceRange csrr = {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 1u, 0u, 1u};
-  static constexpr VkClearDepthStencilValue cds = {};
-  static constexpr VkImageSubresourceRange dsrr = {VK_IMAGE_ASPECT_DEPTH_BIT, 0u, 1u, 0u, 1u};
-  vkCmdClearColorImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), &cc, 1u, &csrr);
-  vkCmdClearDepthStencilImage(cmdbuf, m_vram_depth_texture.GetImage(), m_vram_depth_texture.GetLayout(), &cds, 1u,
-                              &dsrr);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
 
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-  m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    static constexpr VkClearColorValue cc = {};
+    static constexpr VkImageSubresourceRange csrr = {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 1u, 0u, 1u};
+    static constexpr VkClearDepthStencilValue cds = {};
+    static constexpr VkImageSubresourceRange dsrr = {VK_IMAGE_ASPECT_DEPTH_BIT, 0u, 1u, 0u, 1u};
+    vkCmdClearColorImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), &cc, 1u, &csrr);
+    vkCmdClearDepthStencilImage(cmdbuf, m_vram_depth_texture.GetImage(), m_vram_depth_texture.GetLayout(), &cds, 1u,
+                                &dsrr);
+
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    m_vram_depth_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+    m_vram_depth_dirty_rect.SetInvalid();
+  });
 
   SetFullVRAMDirtyRectangle();
 }
@@ -498,6 +556,7 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_batch_descriptor_set);
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_vram_copy_descriptor_set);
   Vulkan::Util::SafeFreeGlobalDescriptorSet(m_vram_read_descriptor_set);
+  Vulkan::Util::SafeFreeGlobalDescriptorSet(m_vram_transfer_descriptor_set);
 
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_framebuffer);
   Vulkan::Util::SafeDestroyFramebuffer(m_vram_update_depth_framebuffer);
@@ -564,12 +623,65 @@ bool GPU_HW_Vulkan::CreateTextureBuffer()
   return true;
 }
 
-bool GPU_HW_Vulkan::CompilePipelines()
+VkPipeline GPU_HW_Vulkan::CreateBatchPipeline(VkPipelineCache pipeline_cache, VkShaderModule fragment_shader,
+                                              BatchPrimitive primitive, bool depth_test, BatchRenderMode render_mode,
+                                              TransparencyMode transparency_mode, bool textured) const
 {
   static constexpr std::array<VkPrimitiveTopology, 2> primitive_mapping = {
     {VK_PRIMITIVE_TOPOLOGY_LINE_LIST, VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST}};
   static constexpr std::array<VkPolygonMode, 2> polygon_mode_mapping = {{VK_POLYGON_MODE_LINE, VK_POLYGON_MODE_FILL}};
 
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
+  gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+  gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+
+  gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+  gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32_SINT, offsetof(BatchVertex, x));
+  gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
+  if (textured)
+  {
+    gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
+    gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
+    gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texwindow));
+  }
+
+  gpbuilder.SetPrimitiveTopology(primitive_mapping[static_cast<u8>(primitive)]);
+  gpbuilder.SetVertexShader(m_batch_vertex_shaders[BoolToUInt8(textured)]);
+  gpbuilder.SetFragmentShader(fragment_shader);
+  if (primitive == BatchPrimitive::Lines && m_batch_line_geometry_shader != VK_NULL_HANDLE)
+  {
+    gpbuilder.SetGeometryShader(m_batch_line_geometry_shader);
+    gpbuilder.SetRasterizationState(polygon_mode_mapping[static_cast<u8>(BatchPrimitive::Triangles)],
+                                    VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+  }
+  else
+  {
+    gpbuilder.SetRasterizationState(polygon_mode_mapping[static_cast<u8>(primitive)], VK_CULL_MODE_NONE,
+                                    VK_FRONT_FACE_CLOCKWISE);
+  }
+
+  gpbuilder.SetDepthState(true, true, depth_test ? VK_COMPARE_OP_GREATER_OR_EQUAL : VK_COMPARE_OP_ALWAYS);
+
+  gpbuilder.SetNoBlendingState();
+
+  if ((transparency_mode != TransparencyMode::Disabled &&
+       (render_mode != BatchRenderMode::TransparencyDisabled && render_mode != BatchRenderMode::OnlyOpaque)) ||
+      m_texture_filtering)
+  {
+    gpbuilder.SetBlendAttachment(
+      0, true, VK_BLEND_FACTOR_ONE, m_supports_dual_source_blend ? VK_BLEND_FACTOR_SRC1_ALPHA : VK_BLEND_FACTOR_SRC_ALPHA,
+      (transparency_mode == TransparencyMode::BackgroundMinusForeground) ? VK_BLEND_OP_REVERSE_SUBTRACT :
+                                                                            VK_BLEND_OP_ADD,
+      VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+  }
+
+  gpbuilder.SetDynamicViewportAndScissorState();
+
+  return gpbuilder.Create(g_vulkan_context->GetDevice(), pipeline_cache);
+}
+
+bool GPU_HW_Vulkan::CompilePipelines()
+{
   VkDevice device = g_vulkan_context->GetDevice();
   VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
 
@@ -577,47 +689,12 @@ bool GPU_HW_Vulkan::CompilePipelines()
                              m_texture_filtering, m_supports_dual_source_blend);
 
   // vertex shaders - [textured]
-  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
-  DimensionalArray<VkShaderModule, 2> batch_vertex_shaders{};
-  DimensionalArray<VkShaderModule, 2, 2, 9, 4> batch_fragment_shaders{};
-  VkShaderModule batch_line_geometry_shader = VK_NULL_HANDLE;
-  Common::ScopeGuard batch_shader_guard(
-    [&batch_vertex_shaders, &batch_fragment_shaders, &batch_line_geometry_shader]() {
-      batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-      batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-      Vulkan::Util::SafeDestroyShaderModule(batch_line_geometry_shader);
-    });
-
   for (u8 textured = 0; textured < 2; textured++)
   {
     const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured));
-    VkShaderModule shader = g_vulkan_shader_cache->GetVertexShader(vs);
-    if (shader == VK_NULL_HANDLE)
+    m_batch_vertex_shaders[textured] = g_vulkan_shader_cache->GetVertexShader(vs);
+    if (m_batch_vertex_shaders[textured] == VK_NULL_HANDLE)
       return false;
-
-    batch_vertex_shaders[textured] = shader;
-  }
-
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
-  {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-    {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<TextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
-          if (shader == VK_NULL_HANDLE)
-            return false;
-
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
-        }
-      }
-    }
   }
 
   if (m_resolution_scale > 1 || !g_vulkan_context->GetDeviceFeatures().fillModeNonSolid)
@@ -625,8 +702,8 @@ bool GPU_HW_Vulkan::CompilePipelines()
     if (g_vulkan_context->GetDeviceFeatures().geometryShader)
     {
       const std::string gs = shadergen.GenerateBatchLineExpandGeometryShader();
-      batch_line_geometry_shader = g_vulkan_shader_cache->GetGeometryShader(gs);
-      if (batch_line_geometry_shader == VK_NULL_HANDLE)
+      m_batch_line_geometry_shader = g_vulkan_shader_cache->GetGeometryShader(gs);
+      if (m_batch_line_geometry_shader == VK_NULL_HANDLE)
         return false;
     }
     else
@@ -635,89 +712,44 @@ bool GPU_HW_Vulkan::CompilePipelines()
     }
   }
 
-  Vulkan::GraphicsPipelineBuilder gpbuilder;
-
-  // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  for (u8 primitive = 0; primitive < 2; primitive++)
+  // Only the ubershader pipelines are compiled up front, the specialised ones are built in the background.
+  // [primitive][depth_test][render_mode][transparency_mode]
+  for (u8 render_mode = 0; render_mode < 4; render_mode++)
   {
-    for (u8 depth_test = 0; depth_test < 2; depth_test++)
+    for (u8 primitive = 0; primitive < 2; primitive++)
     {
-      for (u8 render_mode = 0; render_mode < 4; render_mode++)
+      // lines are never textured, and the geometry shader only passes the colour through
+      const bool textured = (static_cast<BatchPrimitive>(primitive) != BatchPrimitive::Lines);
+      VkShaderModule fs = g_vulkan_shader_cache->GetFragmentShader(
+        shadergen.GenerateBatchUberFragmentShader(static_cast<BatchRenderMode>(render_mode), textured));
+      if (fs == VK_NULL_HANDLE)
+        return false;
+
+      for (u8 depth_test = 0; depth_test < 2; depth_test++)
       {
         for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
         {
-          for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+          VkPipeline pipeline =
+            CreateBatchPipeline(pipeline_cache, fs, static_cast<BatchPrimitive>(primitive),
+                                ConvertToBoolUnchecked(depth_test), static_cast<BatchRenderMode>(render_mode),
+                                static_cast<TransparencyMode>(transparency_mode), textured);
+          if (pipeline == VK_NULL_HANDLE)
           {
-            for (u8 dithering = 0; dithering < 2; dithering++)
-            {
-              for (u8 interlacing = 0; interlacing < 2; interlacing++)
-              {
-                const bool textured = (static_cast<TextureMode>(texture_mode) != TextureMode::Disabled);
-
-                gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
-                gpbuilder.SetRenderPass(m_vram_render_pass, 0);
-
-                gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
-                gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32_SINT, offsetof(BatchVertex, x));
-                gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
-                if (textured)
-                {
-                  gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
-                  gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
-                }
-
-                gpbuilder.SetPrimitiveTopology(primitive_mapping[primitive]);
-                gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
-                gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
-                if (static_cast<BatchPrimitive>(primitive) == BatchPrimitive::Lines &&
-                    batch_line_geometry_shader != VK_NULL_HANDLE)
-                {
-                  gpbuilder.SetGeometryShader(batch_line_geometry_shader);
-                  gpbuilder.SetRasterizationState(polygon_mode_mapping[static_cast<u8>(BatchPrimitive::Triangles)],
-                                                  VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
-                }
-                else
-                {
-                  gpbuilder.SetRasterizationState(polygon_mode_mapping[primitive], VK_CULL_MODE_NONE,
-                                                  VK_FRONT_FACE_CLOCKWISE);
-                }
-
-                gpbuilder.SetDepthState(true, true,
-                                        (depth_test != 0) ? VK_COMPARE_OP_GREATER_OR_EQUAL : VK_COMPARE_OP_ALWAYS);
-
-                gpbuilder.SetNoBlendingState();
-
-                if ((static_cast<TransparencyMode>(transparency_mode) != TransparencyMode::Disabled &&
-                     (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                      static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                    m_texture_filtering)
-                {
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE,
-                    m_supports_dual_source_blend ? VK_BLEND_FACTOR_SRC1_ALPHA : VK_BLEND_FACTOR_SRC_ALPHA,
-                    (static_cast<TransparencyMode>(transparency_mode) == TransparencyMode::BackgroundMinusForeground) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                }
-
-                gpbuilder.SetDynamicViewportAndScissorState();
-
-                VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
-                if (pipeline == VK_NULL_HANDLE)
-                  return false;
-
-                m_batch_pipelines[primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering]
-                                 [interlacing] = pipeline;
-              }
-            }
+            vkDestroyShaderModule(device, fs, nullptr);
+            return false;
           }
+
+          m_batch_uber_pipelines[primitive][depth_test][render_mode][transparency_mode] = pipeline;
         }
       }
+
+      vkDestroyShaderModule(device, fs, nullptr);
     }
   }
 
-  batch_shader_guard.Exit();
+  StartBatchPipelineCompileThreads();
+
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
 
   VkShaderModule fullscreen_quad_vertex_shader =
     g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateScreenQuadVertexShader());
@@ -824,6 +856,23 @@ bool GPU_HW_Vulkan::CompilePipelines()
       return false;
   }
 
+  // VRAM transfers
+  if (m_compute_vram_transfers)
+  {
+    VkShaderModule cs = g_vulkan_shader_cache->GetComputeShader(
+      shadergen.GenerateVRAMTransferComputeShader(MAX_VRAM_TRANSFERS_PER_DISPATCH, VRAM_TRANSFER_WORKGROUP_SIZE));
+    if (cs == VK_NULL_HANDLE)
+      return false;
+
+    Vulkan::ComputePipelineBuilder cpbuilder;
+    cpbuilder.SetPipelineLayout(m_vram_transfer_pipeline_layout);
+    cpbuilder.SetShader(cs);
+    m_vram_transfer_pipeline = cpbuilder.Create(device, pipeline_cache);
+    vkDestroyShaderModule(device, cs, nullptr);
+    if (m_vram_transfer_pipeline == VK_NULL_HANDLE)
+      return false;
+  }
+
   gpbuilder.Clear();
 
   // VRAM read
@@ -881,9 +930,112 @@ bool GPU_HW_Vulkan::CompilePipelines()
   return true;
 }
 
+void GPU_HW_Vulkan::StartBatchPipelineCompileThreads()
+{
+  // leave a core or two for the CPU and GPU threads, the ubershader keeps things drawing in the meantime
+  const u32 hardware_threads = std::thread::hardware_concurrency();
+  const u32 num_threads = std::clamp<u32>((hardware_threads > 2) ? (hardware_threads - 2) : 1, 1,
+                                          MAX_PIPELINE_COMPILE_THREADS);
+
+  m_batch_pipeline_next_job.store(0);
+  m_batch_pipeline_jobs_done.store(0);
+  m_batch_pipeline_compile_cancel.store(false);
+  m_batch_pipeline_compile_timer.Reset();
+
+  // The worker threads only use the handle, fetching it marks the cache dirty which isn't thread safe.
+  VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
+
+  m_batch_pipeline_compile_threads.reserve(num_threads);
+  for (u32 i = 0; i < num_threads; i++)
+  {
+    m_batch_pipeline_compile_threads.emplace_back(&GPU_HW_Vulkan::BatchPipelineCompileThreadEntryPoint, this,
+                                                  pipeline_cache);
+  }
+}
+
+void GPU_HW_Vulkan::StopBatchPipelineCompileThreads()
+{
+  // Jobs in progress finish their current pipeline, nothing else is started.
+  m_batch_pipeline_compile_cancel.store(true);
+  for (std::thread& thread : m_batch_pipeline_compile_threads)
+    thread.join();
+  m_batch_pipeline_compile_threads.clear();
+}
+
+void GPU_HW_Vulkan::BatchPipelineCompileThreadEntryPoint(VkPipelineCache pipeline_cache)
+{
+  VkDevice device = g_vulkan_context->GetDevice();
+  GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_true_color, m_scaled_dithering,
+                             m_texture_filtering, m_supports_dual_source_blend);
+
+  for (;;)
+  {
+    const u32 job = m_batch_pipeline_next_job.fetch_add(1);
+    if (job >= NUM_BATCH_PIPELINE_COMPILE_JOBS || m_batch_pipeline_compile_cancel.load())
+      break;
+
+    // job = [render_mode][texture_mode][dithering][interlacing]
+    const u8 interlacing = Truncate8(job % 2);
+    const u8 dithering = Truncate8((job / 2) % 2);
+    const u8 texture_mode = Truncate8((job / 4) % 9);
+    const u8 render_mode = Truncate8(job / 36);
+    const bool textured = (static_cast<TextureMode>(texture_mode) != TextureMode::Disabled);
+
+    const std::string fs_source = shadergen.GenerateBatchFragmentShader(
+      static_cast<BatchRenderMode>(render_mode), static_cast<TextureMode>(texture_mode),
+      ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+    VkShaderModule fs = g_vulkan_shader_cache->GetFragmentShader(fs_source);
+    if (fs == VK_NULL_HANDLE)
+    {
+      // not fatal, these permutations just stay on the ubershader
+      Log_ErrorPrintf("Failed to compile batch fragment shader %u", job);
+      m_batch_pipeline_jobs_done.fetch_add(1);
+      continue;
+    }
+
+    for (u8 primitive = 0; primitive < 2; primitive++)
+    {
+      for (u8 depth_test = 0; depth_test < 2; depth_test++)
+      {
+        for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
+        {
+          if (m_batch_pipeline_compile_cancel.load())
+            break;
+
+          VkPipeline pipeline =
+            CreateBatchPipeline(pipeline_cache, fs, static_cast<BatchPrimitive>(primitive),
+                                ConvertToBoolUnchecked(depth_test), static_cast<BatchRenderMode>(render_mode),
+                                static_cast<TransparencyMode>(transparency_mode), textured);
+          m_batch_pipelines[primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering]
+                           [interlacing]
+                             .store(pipeline, std::memory_order_release);
+        }
+      }
+    }
+
+    vkDestroyShaderModule(device, fs, nullptr);
+
+    if ((m_batch_pipeline_jobs_done.fetch_add(1) + 1) == NUM_BATCH_PIPELINE_COMPILE_JOBS)
+    {
+      Log_InfoPrintf("Batch pipelines compiled in the background in %.2f ms",
+                     m_batch_pipeline_compile_timer.GetTimeMilliseconds());
+    }
+  }
+}
+
 void GPU_HW_Vulkan::DestroyPipelines()
 {
-  m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+  StopBatchPipelineCompileThreads();
+
+  m_batch_pipelines.enumerate([](std::atomic<VkPipeline>& p) {
+    VkPipeline pipeline = p.exchange(VK_NULL_HANDLE);
+    Vulkan::Util::SafeDestroyPipeline(pipeline);
+  });
+  m_batch_uber_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+
+  for (VkShaderModule& sm : m_batch_vertex_shaders)
+    Vulkan::Util::SafeDestroyShaderModule(sm);
+  Vulkan::Util::SafeDestroyShaderModule(m_batch_line_geometry_shader);
 
   for (VkPipeline& p : m_vram_fill_pipelines)
     Vulkan::Util::SafeDestroyPipeline(p);
@@ -896,21 +1048,39 @@ void GPU_HW_Vulkan::DestroyPipelines()
 
   Vulkan::Util::SafeDestroyPipeline(m_vram_readback_pipeline);
   Vulkan::Util::SafeDestroyPipeline(m_vram_update_depth_pipeline);
+  Vulkan::Util::SafeDestroyPipeline(m_vram_transfer_pipeline);
 
   m_display_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
 }
 
-void GPU_HW_Vulkan::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
+void GPU_HW_Vulkan::DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                                      u32 num_vertices)
 {
+  // compute transfers don't write depth, so bring the areas they've touched up to date before testing the mask bit
+  if (batch.check_mask_before_draw)
+  {
+    FlushVRAMTransfers();
+    if (m_vram_depth_dirty_rect.Valid())
+      UpdateDepthBufferFromMaskBitInArea(m_vram_depth_dirty_rect);
+  }
+
   BeginVRAMRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
   // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
   VkPipeline pipeline =
-    m_batch_pipelines[static_cast<u8>(m_batch.primitive)][BoolToUInt8(m_batch.check_mask_before_draw)][static_cast<u8>(
-      render_mode)][static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(m_batch.transparency_mode)]
-                     [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+    m_batch_pipelines[static_cast<u8>(batch.primitive)][BoolToUInt8(batch.check_mask_before_draw)][static_cast<u8>(
+      render_mode)][static_cast<u8>(batch.texture_mode)][static_cast<u8>(batch.transparency_mode)]
+                     [BoolToUInt8(batch.dithering)][BoolToUInt8(batch.interlacing)]
+                       .load(std::memory_order_acquire);
+
+  // still compiling, the ubershader picks up the rest of the state from the batch UBO
+  if (pipeline == VK_NULL_HANDLE)
+  {
+    pipeline = m_batch_uber_pipelines[static_cast<u8>(batch.primitive)][BoolToUInt8(batch.check_mask_before_draw)]
+                                     [static_cast<u8>(render_mode)][static_cast<u8>(batch.transparency_mode)];
+  }
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
   vkCmdDraw(cmdbuf, num_vertices, 1, base_vertex, 0);
@@ -930,10 +1100,13 @@ void GPU_HW_Vulkan::UpdateDisplay()
 
   if (m_system->GetSettings().debugging.show_vram)
   {
-    m_host_display->SetDisplayTexture(&m_vram_texture, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 0, 0,
-                                      m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
-    m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
-                                         static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+    RunOnGPUThread([this]() {
+      FlushVRAMTransfers();
+      m_host_display->SetDisplayTexture(&m_vram_texture, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(), 0, 0,
+                                        m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+      m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
+                                           static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+    });
   }
   else
   {
@@ -946,70 +1119,77 @@ void GPU_HW_Vulkan::UpdateDisplay()
     const u32 scaled_display_width = display_width * m_resolution_scale;
     const u32 scaled_display_height = display_height * m_resolution_scale;
     const InterlacedRenderMode interlaced = GetInterlacedRenderMode();
+    const bool display_disabled = IsDisplayDisabled();
+    const bool display_24bit = m_GPUSTAT.display_area_color_depth_24;
+    const u32 reinterpret_field_offset = (interlaced != InterlacedRenderMode::None) ? GetInterlacedDisplayField() : 0;
+    const u32 reinterpret_start_x = m_crtc_state.regs.X * m_resolution_scale;
+    const u32 reinterpret_crop_left = (m_crtc_state.display_vram_left - m_crtc_state.regs.X) * m_resolution_scale;
+
+    RunOnGPUThread([this, scaled_vram_offset_x, scaled_vram_offset_y, scaled_display_width, scaled_display_height,
+                    interlaced, display_disabled, display_24bit, reinterpret_field_offset, reinterpret_start_x,
+                    reinterpret_crop_left, crtc = m_crtc_state]() {
+      FlushVRAMTransfers();
+
+      if (display_disabled)
+      {
+        m_host_display->ClearDisplayTexture();
+      }
+      else if (!display_24bit && interlaced == InterlacedRenderMode::None &&
+               (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
+               (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
+      {
+        m_host_display->SetDisplayTexture(&m_vram_texture, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(),
+                                          scaled_vram_offset_x, scaled_vram_offset_y, scaled_display_width,
+                                          scaled_display_height);
+      }
+      else
+      {
+        EndRenderPass();
 
-    if (IsDisplayDisabled())
-    {
-      m_host_display->ClearDisplayTexture();
-    }
-    else if (!m_GPUSTAT.display_area_color_depth_24 && interlaced == InterlacedRenderMode::None &&
-             (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
-             (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
-    {
-      m_host_display->SetDisplayTexture(&m_vram_texture, m_vram_texture.GetWidth(), m_vram_texture.GetHeight(),
-                                        scaled_vram_offset_x, scaled_vram_offset_y, scaled_display_width,
-                                        scaled_display_height);
-    }
-    else
-    {
-      EndRenderPass();
+        const u32 uniforms[4] = {reinterpret_start_x, scaled_vram_offset_y + reinterpret_field_offset,
+                                 reinterpret_crop_left, reinterpret_field_offset};
 
-      const u32 reinterpret_field_offset = (interlaced != InterlacedRenderMode::None) ? GetInterlacedDisplayField() : 0;
-      const u32 reinterpret_start_x = m_crtc_state.regs.X * m_resolution_scale;
-      const u32 reinterpret_crop_left = (m_crtc_state.display_vram_left - m_crtc_state.regs.X) * m_resolution_scale;
-      const u32 uniforms[4] = {reinterpret_start_x, scaled_vram_offset_y + reinterpret_field_offset,
-                               reinterpret_crop_left, reinterpret_field_offset};
+        VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+        m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-      VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-      m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-      m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        BeginRenderPass(m_display_render_pass, m_display_framebuffer, 0, 0, scaled_display_width,
+                        scaled_display_height);
 
-      BeginRenderPass(m_display_render_pass, m_display_framebuffer, 0, 0, scaled_display_width, scaled_display_height);
+        vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                          m_display_pipelines[BoolToUInt8(display_24bit)][static_cast<u8>(interlaced)]);
+        vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                           sizeof(uniforms), uniforms);
+        vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
+                                &m_vram_read_descriptor_set, 0, nullptr);
+        Vulkan::Util::SetViewportAndScissor(cmdbuf, 0, 0, scaled_display_width, scaled_display_height);
+        vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
-      vkCmdBindPipeline(
-        cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-        m_display_pipelines[BoolToUInt8(m_GPUSTAT.display_area_color_depth_24)][static_cast<u8>(interlaced)]);
-      vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                         uniforms);
-      vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
-                              &m_vram_read_descriptor_set, 0, nullptr);
-      Vulkan::Util::SetViewportAndScissor(cmdbuf, 0, 0, scaled_display_width, scaled_display_height);
-      vkCmdDraw(cmdbuf, 3, 1, 0, 0);
-
-      EndRenderPass();
+        EndRenderPass();
 
-      m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-      m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+        m_display_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-      m_host_display->SetDisplayTexture(&m_display_texture, m_display_texture.GetWidth(), m_display_texture.GetHeight(),
-                                        0, 0, scaled_display_width, scaled_display_height);
+        m_host_display->SetDisplayTexture(&m_display_texture, m_display_texture.GetWidth(),
+                                          m_display_texture.GetHeight(), 0, 0, scaled_display_width,
+                                          scaled_display_height);
 
-      RestoreGraphicsAPIState();
-    }
+        DoRestoreGraphicsAPIState();
+      }
 
-    m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
-                                         m_crtc_state.display_origin_left, m_crtc_state.display_origin_top,
-                                         m_crtc_state.display_vram_width, m_crtc_state.display_vram_height,
-                                         m_crtc_state.display_aspect_ratio);
+      m_host_display->SetDisplayParameters(crtc.display_width, crtc.display_height, crtc.display_origin_left,
+                                           crtc.display_origin_top, crtc.display_vram_width,
+                                           crtc.display_vram_height, crtc.display_aspect_ratio);
+    });
   }
 }
 
-void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+void GPU_HW_Vulkan::BeginVRAMReadback(const Common::Rectangle<u32>& rect)
 {
-  // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
-  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
-  const u32 encoded_height = copy_rect.GetHeight();
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
 
+  FlushVRAMTransfers();
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
@@ -1019,7 +1199,7 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   BeginRenderPass(m_vram_readback_render_pass, m_vram_readback_framebuffer, 0, 0, encoded_width, encoded_height);
 
   // Encode the 24-bit texture as 16-bit.
-  const u32 uniforms[4] = {copy_rect.left, copy_rect.top, copy_rect.GetWidth(), copy_rect.GetHeight()};
+  const u32 uniforms[4] = {rect.left, rect.top, rect.GetWidth(), rect.GetHeight()};
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_readback_pipeline);
   vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
                      uniforms);
@@ -1033,16 +1213,24 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-  // Stage the readback.
+  // Stage the readback. The staging texture tracks the fence of the command buffer it was recorded in, so if that's
+  // been submitted by the time it's read, it only has to wait for the GPU rather than submitting and stalling.
   m_vram_readback_staging_texture.CopyFromTexture(m_vram_readback_texture, 0, 0, 0, 0, 0, 0, encoded_width,
                                                   encoded_height);
 
-  // And copy it into our shadow buffer (will execute command buffer and stall).
+  DoRestoreGraphicsAPIState();
+}
+
+void GPU_HW_Vulkan::FinishVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  const u32 encoded_width = (rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = rect.GetHeight();
+
+  // And copy it into our shadow buffer (will execute command buffer and stall if it hasn't been submitted yet).
+  FlushVRAMTransfers();
   m_vram_readback_staging_texture.ReadTexels(0, 0, encoded_width, encoded_height,
-                                             &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
+                                             &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left],
                                              VRAM_WIDTH * sizeof(u16));
-
-  RestoreGraphicsAPIState();
 }
 
 void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
@@ -1051,7 +1239,7 @@ void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
   {
     // CPU round trip if oversized for now.
     Log_WarningPrintf("Oversized VRAM fill (%u-%u, %u-%u), CPU round trip", x, x + width, y, y + height);
-    ReadVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    ReadAllVRAMForRoundTrip();
     GPU::FillVRAM(x, y, width, height, color);
     UpdateVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, m_vram_shadow.data());
     return;
@@ -1059,23 +1247,34 @@ void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 
   GPU_HW::FillVRAM(x, y, width, height, color);
 
+  if (m_compute_vram_transfers)
+  {
+    RunOnGPUThread([this, transfer = GetVRAMFillTransferUBOData(x, y, width, height, color),
+                    scaled_rect = Common::Rectangle<u32>::FromExtents(x, y, width, height) * m_resolution_scale]() {
+      QueueVRAMTransfer(transfer, scaled_rect);
+    });
+    return;
+  }
+
   x *= m_resolution_scale;
   y *= m_resolution_scale;
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  BeginVRAMRenderPass();
-
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   const VRAMFillUBOData uniforms = GetVRAMFillUBOData(x, y, width, height, color);
-  vkCmdPushConstants(cmdbuf, m_no_samplers_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                     &uniforms);
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_vram_fill_pipelines[BoolToUInt8(IsInterlacedRenderingEnabled())]);
-  Vulkan::Util::SetViewportAndScissor(cmdbuf, x, y, width, height);
-  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+  const bool interlaced = IsInterlacedRenderingEnabled();
+  RunOnGPUThread([this, x, y, width, height, uniforms, interlaced]() {
+    BeginVRAMRenderPass();
 
-  RestoreGraphicsAPIState();
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    vkCmdPushConstants(cmdbuf, m_no_samplers_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                       &uniforms);
+    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_fill_pipelines[BoolToUInt8(interlaced)]);
+    Vulkan::Util::SetViewportAndScissor(cmdbuf, x, y, width, height);
+    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+
+    DoRestoreGraphicsAPIState();
+  });
 }
 
 void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
@@ -1084,42 +1283,79 @@ void GPU_HW_Vulkan::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
   GPU_HW::UpdateVRAM(bounds.left, bounds.top, bounds.GetWidth(), bounds.GetHeight(), data);
 
   const u32 data_size = width * height * sizeof(u16);
-  const u32 alignment = std::max<u32>(sizeof(u16), static_cast<u32>(g_vulkan_context->GetTexelBufferAlignment()));
-  if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+  if (m_compute_vram_transfers)
   {
-    Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
-    EndRenderPass();
-    g_vulkan_context->ExecuteCommandBuffer(false);
-    RestoreGraphicsAPIState();
-    if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
-    {
-      Panic("Failed to allocate space in stream buffer for VRAM write");
-      return;
-    }
+    RunOnGPUThreadWithData(
+      data, data_size,
+      [this, data_size, bounds, transfer = GetVRAMWriteTransferUBOData(x, y, width, height, 0)](const void* pixels) {
+        const u32 alignment =
+          std::max<u32>(sizeof(u16), static_cast<u32>(g_vulkan_context->GetTexelBufferAlignment()));
+        if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+        {
+          Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
+          FlushVRAMTransfers();
+          EndRenderPass();
+          g_vulkan_context->ExecuteCommandBuffer(false);
+          DoRestoreGraphicsAPIState();
+          if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+          {
+            Panic("Failed to allocate space in stream buffer for VRAM write");
+            return;
+          }
+        }
+
+        VRAMTransferUBOData buffer_transfer = transfer;
+        buffer_transfer.u_src[0] = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
+        std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), pixels, data_size);
+
+        // Queuing can submit the command buffer, which mustn't happen between committing the data and dispatching.
+        QueueVRAMTransfer(buffer_transfer, bounds * m_resolution_scale);
+        m_texture_stream_buffer.CommitMemory(data_size);
+      });
+    return;
   }
 
-  const u32 start_index = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
-  std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), data, data_size);
-  m_texture_stream_buffer.CommitMemory(data_size);
+  const bool check_mask = m_GPUSTAT.check_mask_before_draw;
+  RunOnGPUThreadWithData(
+    data, data_size,
+    [this, data_size, bounds, check_mask, uniforms = GetVRAMWriteUBOData(x, y, width, height, 0)](const void* pixels) {
+      const u32 alignment = std::max<u32>(sizeof(u16), static_cast<u32>(g_vulkan_context->GetTexelBufferAlignment()));
+      if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+      {
+        Log_PerfPrintf("Executing command buffer while waiting for %u bytes in stream buffer", data_size);
+        EndRenderPass();
+        g_vulkan_context->ExecuteCommandBuffer(false);
+        DoRestoreGraphicsAPIState();
+        if (!m_texture_stream_buffer.ReserveMemory(data_size, alignment))
+        {
+          Panic("Failed to allocate space in stream buffer for VRAM write");
+          return;
+        }
+      }
 
-  BeginVRAMRenderPass();
+      const u32 start_index = m_texture_stream_buffer.GetCurrentOffset() / sizeof(u16);
+      std::memcpy(m_texture_stream_buffer.GetCurrentHostPointer(), pixels, data_size);
+      m_texture_stream_buffer.CommitMemory(data_size);
 
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  const VRAMWriteUBOData uniforms = GetVRAMWriteUBOData(x, y, width, height, start_index);
-  vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                     &uniforms);
-  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                    m_vram_write_pipelines[BoolToUInt8(m_GPUSTAT.check_mask_before_draw)]);
-  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipeline_layout, 0, 1,
-                          &m_vram_write_descriptor_set, 0, nullptr);
-
-  // the viewport should already be set to the full vram, so just adjust the scissor
-  const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
-  Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
-                           scaled_bounds.GetHeight());
-  vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+      BeginVRAMRenderPass();
+
+      VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+      VRAMWriteUBOData buffer_uniforms = uniforms;
+      buffer_uniforms.u_buffer_base_offset = start_index;
+      vkCmdPushConstants(cmdbuf, m_vram_write_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                         sizeof(buffer_uniforms), &buffer_uniforms);
+      vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipelines[BoolToUInt8(check_mask)]);
+      vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_write_pipeline_layout, 0, 1,
+                              &m_vram_write_descriptor_set, 0, nullptr);
+
+      // the viewport should already be set to the full vram, so just adjust the scissor
+      const Common::Rectangle<u32> scaled_bounds = bounds * m_resolution_scale;
+      Vulkan::Util::SetScissor(cmdbuf, scaled_bounds.left, scaled_bounds.top, scaled_bounds.GetWidth(),
+                               scaled_bounds.GetHeight());
+      vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
-  RestoreGraphicsAPIState();
+      DoRestoreGraphicsAPIState();
+    });
 }
 
 void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
@@ -1128,28 +1364,42 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   {
     const Common::Rectangle<u32> src_bounds = GetVRAMTransferBounds(src_x, src_y, width, height);
     const Common::Rectangle<u32> dst_bounds = GetVRAMTransferBounds(dst_x, dst_y, width, height);
-    if (m_vram_dirty_rect.Intersects(src_bounds))
-      UpdateVRAMReadTexture();
+    UpdateVRAMReadTexture(src_bounds);
     IncludeVRAMDityRectangle(dst_bounds);
 
-    const VRAMCopyUBOData uniforms(GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height));
     const Common::Rectangle<u32> dst_bounds_scaled(dst_bounds * m_resolution_scale);
+    const bool check_mask = m_GPUSTAT.check_mask_before_draw;
 
-    BeginVRAMRenderPass();
+    if (m_compute_vram_transfers)
+    {
+      RunOnGPUThread(
+        [this, transfer = GetVRAMCopyTransferUBOData(src_x, src_y, dst_x, dst_y, width, height), dst_bounds_scaled]() {
+          QueueVRAMTransfer(transfer, dst_bounds_scaled);
+        });
 
-    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-    vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                      m_vram_copy_pipelines[BoolToUInt8(m_GPUSTAT.check_mask_before_draw)]);
-    vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
-                            &m_vram_copy_descriptor_set, 0, nullptr);
-    vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
-                       &uniforms);
-    Vulkan::Util::SetViewportAndScissor(cmdbuf, dst_bounds_scaled.left, dst_bounds_scaled.top,
-                                        dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
-    vkCmdDraw(cmdbuf, 3, 1, 0, 0);
-    RestoreGraphicsAPIState();
+      if (check_mask)
+        m_current_depth++;
+
+      return;
+    }
+
+    const VRAMCopyUBOData uniforms(GetVRAMCopyUBOData(src_x, src_y, dst_x, dst_y, width, height));
+    RunOnGPUThread([this, uniforms, dst_bounds_scaled, check_mask]() {
+      BeginVRAMRenderPass();
+
+      VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+      vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_copy_pipelines[BoolToUInt8(check_mask)]);
+      vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
+                              &m_vram_copy_descriptor_set, 0, nullptr);
+      vkCmdPushConstants(cmdbuf, m_single_sampler_pipeline_layout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(uniforms),
+                         &uniforms);
+      Vulkan::Util::SetViewportAndScissor(cmdbuf, dst_bounds_scaled.left, dst_bounds_scaled.top,
+                                          dst_bounds_scaled.GetWidth(), dst_bounds_scaled.GetHeight());
+      vkCmdDraw(cmdbuf, 3, 1, 0, 0);
+      DoRestoreGraphicsAPIState();
+    });
 
-    if (m_GPUSTAT.check_mask_before_draw)
+    if (check_mask)
       m_current_depth++;
 
     return;
@@ -1164,68 +1414,180 @@ void GPU_HW_Vulkan::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wid
   width *= m_resolution_scale;
   height *= m_resolution_scale;
 
-  EndRenderPass();
-
-  VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
-
   const VkImageCopy ic{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
                        {static_cast<s32>(src_x), static_cast<s32>(src_y), 0},
                        {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
                        {static_cast<s32>(dst_x), static_cast<s32>(dst_y), 0},
                        {width, height, 1u}};
-  vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_texture.GetImage(),
-                 m_vram_texture.GetLayout(), 1, &ic);
 
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  RunOnGPUThread([this, ic]() {
+    FlushVRAMTransfers();
+    EndRenderPass();
+
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
+    vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_texture.GetImage(),
+                   m_vram_texture.GetLayout(), 1, &ic);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  });
 }
 
-void GPU_HW_Vulkan::UpdateVRAMReadTexture()
+void GPU_HW_Vulkan::CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects)
 {
+  RunOnGPUThreadWithData(rects, sizeof(Common::Rectangle<u32>) * num_rects, [this, num_rects](const void* data) {
+    const Common::Rectangle<u32>* copy_rects = static_cast<const Common::Rectangle<u32>*>(data);
+    std::array<VkImageCopy, MAX_VRAM_READ_TEXTURE_COPY_RECTS> copies;
+    for (u32 i = 0; i < num_rects; i++)
+    {
+      const auto scaled_rect = copy_rects[i] * m_resolution_scale;
+      copies[i] = {{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                   {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
+                   {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
+                   {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
+                   {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u}};
+    }
+
+    FlushVRAMTransfers();
+    EndRenderPass();
+
+    VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+    vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
+                   m_vram_read_texture.GetLayout(), num_rects, copies.data());
+
+    m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  });
+}
+
+void GPU_HW_Vulkan::QueueVRAMTransfer(const VRAMTransferUBOData& transfer, const Common::Rectangle<u32>& scaled_rect)
+{
+  if (!scaled_rect.HasExtents())
+    return;
+
+  const u32 groups_x = (transfer.u_dst_rect[2] * m_resolution_scale + (VRAM_TRANSFER_WORKGROUP_SIZE - 1)) /
+                       VRAM_TRANSFER_WORKGROUP_SIZE;
+  const u32 groups_y = (transfer.u_dst_rect[3] * m_resolution_scale + (VRAM_TRANSFER_WORKGROUP_SIZE - 1)) /
+                       VRAM_TRANSFER_WORKGROUP_SIZE;
+
+  if (m_num_pending_vram_transfers > 0)
+  {
+    // Every transfer in the dispatch gets as many threads as the largest one, so don't mix small and large transfers.
+    const u32 max_groups_x = std::max(m_pending_vram_transfer_max_groups_x, groups_x);
+    const u32 max_groups_y = std::max(m_pending_vram_transfer_max_groups_y, groups_y);
+    bool flush = (m_num_pending_vram_transfers == MAX_VRAM_TRANSFERS_PER_DISPATCH ||
+                  (max_groups_x * max_groups_y * (m_num_pending_vram_transfers + 1)) >
+                    ((m_pending_vram_transfer_groups + groups_x * groups_y) * 2));
+
+    // They also run concurrently, so the destinations can't overlap.
+    for (u32 i = 0; i < m_num_pending_vram_transfers && !flush; i++)
+      flush = m_pending_vram_transfer_rects[i].Intersects(scaled_rect);
+
+    if (flush)
+      FlushVRAMTransfers();
+  }
+
+  constexpr u32 ubo_size = sizeof(VRAMTransferUBOData) * MAX_VRAM_TRANSFERS_PER_DISPATCH;
+  if (m_num_pending_vram_transfers == 0)
+  {
+    const u32 alignment = static_cast<u32>(g_vulkan_context->GetUniformBufferAlignment());
+    if (!m_uniform_stream_buffer.ReserveMemory(ubo_size, alignment))
+    {
+      Log_PerfPrintf("Executing command buffer while waiting for %u bytes in uniform stream buffer", ubo_size);
+      EndRenderPass();
+      g_vulkan_context->ExecuteCommandBuffer(false);
+      DoRestoreGraphicsAPIState();
+      if (!m_uniform_stream_buffer.ReserveMemory(ubo_size, alignment))
+        Panic("Failed to reserve uniform stream buffer memory");
+    }
+
+    m_pending_vram_transfer_ubo_offset = m_uniform_stream_buffer.GetCurrentOffset();
+  }
+
+  std::memcpy(static_cast<u8*>(m_uniform_stream_buffer.GetCurrentHostPointer()) +
+                (m_num_pending_vram_transfers * sizeof(VRAMTransferUBOData)),
+              &transfer, sizeof(transfer));
+
+  m_pending_vram_transfer_rects[m_num_pending_vram_transfers++] = scaled_rect;
+  m_pending_vram_transfer_groups += groups_x * groups_y;
+  m_pending_vram_transfer_max_groups_x = std::max(m_pending_vram_transfer_max_groups_x, groups_x);
+  m_pending_vram_transfer_max_groups_y = std::max(m_pending_vram_transfer_max_groups_y, groups_y);
+  m_pending_vram_transfer_copies |= (transfer.u_params[0] == static_cast<u32>(VRAMTransferType::Copy));
+}
+
+void GPU_HW_Vulkan::FlushVRAMTransfers()
+{
+  if (m_num_pending_vram_transfers == 0)
+    return;
+
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
-  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-  m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+  m_uniform_stream_buffer.CommitMemory(sizeof(VRAMTransferUBOData) * MAX_VRAM_TRANSFERS_PER_DISPATCH);
 
-  const auto scaled_rect = m_vram_dirty_rect * m_resolution_scale;
-  const VkImageCopy copy{{VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                         {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                         {VK_IMAGE_ASPECT_COLOR_BIT, 0u, 0u, 1u},
-                         {static_cast<s32>(scaled_rect.left), static_cast<s32>(scaled_rect.top), 0},
-                         {scaled_rect.GetWidth(), scaled_rect.GetHeight(), 1u}};
+  if (m_pending_vram_transfer_copies)
+  {
+    // the read texture is only made visible to fragment shaders when it's updated
+    const VkMemoryBarrier barrier = {VK_STRUCTURE_TYPE_MEMORY_BARRIER, nullptr, VK_ACCESS_TRANSFER_WRITE_BIT,
+                                     VK_ACCESS_SHADER_READ_BIT};
+    vkCmdPipelineBarrier(cmdbuf, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier,
+                         0, nullptr, 0, nullptr);
+  }
 
-  vkCmdCopyImage(cmdbuf, m_vram_texture.GetImage(), m_vram_texture.GetLayout(), m_vram_read_texture.GetImage(),
-                 m_vram_read_texture.GetLayout(), 1u, &copy);
+  m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_GENERAL);
+
+  vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_vram_transfer_pipeline);
+  vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_COMPUTE, m_vram_transfer_pipeline_layout, 0, 1,
+                          &m_vram_transfer_descriptor_set, 1, &m_pending_vram_transfer_ubo_offset);
+  vkCmdDispatch(cmdbuf, m_pending_vram_transfer_max_groups_x, m_pending_vram_transfer_max_groups_y,
+                m_num_pending_vram_transfers);
 
-  m_vram_read_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
 
-  GPU_HW::UpdateVRAMReadTexture();
+  for (u32 i = 0; i < m_num_pending_vram_transfers; i++)
+    m_vram_depth_dirty_rect.Include(m_pending_vram_transfer_rects[i]);
+
+  m_num_pending_vram_transfers = 0;
+  m_pending_vram_transfer_groups = 0;
+  m_pending_vram_transfer_max_groups_x = 0;
+  m_pending_vram_transfer_max_groups_y = 0;
+  m_pending_vram_transfer_copies = false;
 }
 
 void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBit()
+{
+  FlushVRAMTransfers();
+  UpdateDepthBufferFromMaskBitInArea(
+    Common::Rectangle<u32>(0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight()));
+}
+
+void GPU_HW_Vulkan::UpdateDepthBufferFromMaskBitInArea(const Common::Rectangle<u32>& scaled_rect)
 {
   EndRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
 
-  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, 0, 0, m_vram_texture.GetWidth(),
-                  m_vram_texture.GetHeight());
+  // the render area contents are undefined with this render pass, but every pixel in it is written
+  BeginRenderPass(m_vram_update_depth_render_pass, m_vram_update_depth_framebuffer, scaled_rect.left, scaled_rect.top,
+                  scaled_rect.GetWidth(), scaled_rect.GetHeight());
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_vram_update_depth_pipeline);
   vkCmdBindDescriptorSets(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, m_single_sampler_pipeline_layout, 0, 1,
                           &m_vram_read_descriptor_set, 0, nullptr);
-  Vulkan::Util::SetViewportAndScissor(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetViewport(cmdbuf, 0, 0, m_vram_texture.GetWidth(), m_vram_texture.GetHeight());
+  Vulkan::Util::SetScissor(cmdbuf, scaled_rect.left, scaled_rect.top, scaled_rect.GetWidth(), scaled_rect.GetHeight());
   vkCmdDraw(cmdbuf, 3, 1, 0, 0);
 
   EndRenderPass();
 
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+  m_vram_depth_dirty_rect.SetInvalid();
 
-  RestoreGraphicsAPIState();
+  DoRestoreGraphicsAPIState();
 }
 
 std::unique_ptr<GPU> GPU::CreateHardwareVulkanRenderer()
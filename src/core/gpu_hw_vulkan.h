@@ -1,12 +1,16 @@
 #pragma once
 #include "common/dimensional_array.h"
+#include "common/timer.h"
 #include "common/vulkan/staging_texture.h"
 #include "common/vulkan/stream_buffer.h"
 #include "common/vulkan/texture.h"
 #include "gpu_hw.h"
 #include <array>
+#include <atomic>
 #include <memory>
+#include <thread>
 #include <tuple>
+#include <vector>
 
 class GPU_HW_Vulkan : public GPU_HW
 {
@@ -17,30 +21,39 @@ public:
   bool Initialize(HostDisplay* host_display, System* system, DMA* dma, InterruptController* interrupt_controller,
                   Timers* timers) override;
   void Reset() override;
-
-  void ResetGraphicsAPIState() override;
-  void RestoreGraphicsAPIState() override;
   void UpdateSettings() override;
 
 protected:
+  void DoResetGraphicsAPIState() override;
+  void DoRestoreGraphicsAPIState() override;
   void UpdateDisplay() override;
-  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  void BeginVRAMReadback(const Common::Rectangle<u32>& rect) override;
+  void FinishVRAMReadback(const Common::Rectangle<u32>& rect) override;
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
-  void UpdateVRAMReadTexture() override;
+  void CopyVRAMToReadTexture(const Common::Rectangle<u32>* rects, u32 num_rects) override;
   void UpdateDepthBufferFromMaskBit() override;
   void SetScissorFromDrawingArea() override;
-  void MapBatchVertexPointer(u32 required_vertices) override;
+  BatchVertex* MapBatchVertexPointer(u32 required_vertices, u32* space_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
-  void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  void DrawBatchVertices(const BatchConfig& batch, BatchRenderMode render_mode, u32 base_vertex,
+                         u32 num_vertices) override;
 
 private:
   enum : u32
   {
     MAX_PUSH_CONSTANTS_SIZE = 64,
+    MAX_PIPELINE_COMPILE_THREADS = 4,
+
+    // one job per specialised fragment shader, [render_mode][texture_mode][dithering][interlacing]
+    NUM_BATCH_PIPELINE_COMPILE_JOBS = 4 * 9 * 2 * 2,
+
+    MAX_VRAM_TRANSFERS_PER_DISPATCH = 32,
+    VRAM_TRANSFER_WORKGROUP_SIZE = 8,
   };
+
   void SetCapabilities();
   void DestroyResources();
 
@@ -63,6 +76,23 @@ private:
   bool CompilePipelines();
   void DestroyPipelines();
 
+  VkPipeline CreateBatchPipeline(VkPipelineCache pipeline_cache, VkShaderModule fragment_shader,
+                                 BatchPrimitive primitive, bool depth_test, BatchRenderMode render_mode,
+                                 TransparencyMode transparency_mode, bool textured) const;
+  void StartBatchPipelineCompileThreads();
+  void StopBatchPipelineCompileThreads();
+  void BatchPipelineCompileThreadEntryPoint(VkPipelineCache pipeline_cache);
+
+  /// Adds a transfer to the next compute dispatch, flushing the pending ones first if they can't share it.
+  void QueueVRAMTransfer(const VRAMTransferUBOData& transfer, const Common::Rectangle<u32>& scaled_rect);
+
+  /// Records the dispatch for the queued transfers. Must be called before anything else uses the VRAM texture, or the
+  /// command buffer is submitted.
+  void FlushVRAMTransfers();
+
+  /// Copies the mask bit to the depth buffer in the specified area, in scaled coordinates.
+  void UpdateDepthBufferFromMaskBitInArea(const Common::Rectangle<u32>& scaled_rect);
+
   VkRenderPass m_current_render_pass = VK_NULL_HANDLE;
 
   VkRenderPass m_vram_render_pass = VK_NULL_HANDLE;
@@ -73,11 +103,13 @@ private:
   VkDescriptorSetLayout m_batch_descriptor_set_layout = VK_NULL_HANDLE;
   VkDescriptorSetLayout m_single_sampler_descriptor_set_layout = VK_NULL_HANDLE;
   VkDescriptorSetLayout m_vram_write_descriptor_set_layout = VK_NULL_HANDLE;
+  VkDescriptorSetLayout m_vram_transfer_descriptor_set_layout = VK_NULL_HANDLE;
 
   VkPipelineLayout m_batch_pipeline_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_no_samplers_pipeline_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_single_sampler_pipeline_layout = VK_NULL_HANDLE;
   VkPipelineLayout m_vram_write_pipeline_layout = VK_NULL_HANDLE;
+  VkPipelineLayout m_vram_transfer_pipeline_layout = VK_NULL_HANDLE;
 
   Vulkan::Texture m_vram_texture;
   Vulkan::Texture m_vram_depth_texture;
@@ -98,6 +130,7 @@ private:
   VkDescriptorSet m_vram_copy_descriptor_set = VK_NULL_HANDLE;
   VkDescriptorSet m_vram_read_descriptor_set = VK_NULL_HANDLE;
   VkDescriptorSet m_vram_write_descriptor_set = VK_NULL_HANDLE;
+  VkDescriptorSet m_vram_transfer_descriptor_set = VK_NULL_HANDLE;
 
   Vulkan::StreamBuffer m_vertex_stream_buffer;
   Vulkan::StreamBuffer m_uniform_stream_buffer;
@@ -106,8 +139,22 @@ private:
   u32 m_current_uniform_buffer_offset = 0;
   VkBufferView m_texture_stream_buffer_view = VK_NULL_HANDLE;
 
+  // [textured], shared by the ubershader and specialised batch pipelines
+  std::array<VkShaderModule, 2> m_batch_vertex_shaders{};
+  VkShaderModule m_batch_line_geometry_shader = VK_NULL_HANDLE;
+
+  // [primitive][depth_test][render_mode][transparency_mode], drawn with until the specialised pipeline is compiled
+  DimensionalArray<VkPipeline, 5, 4, 2, 2> m_batch_uber_pipelines{};
+
   // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  DimensionalArray<VkPipeline, 2, 2, 5, 9, 4, 2, 2> m_batch_pipelines{};
+  // Filled in by the compile threads, null until the pipeline is ready.
+  DimensionalArray<std::atomic<VkPipeline>, 2, 2, 5, 9, 4, 2, 2> m_batch_pipelines{};
+
+  std::vector<std::thread> m_batch_pipeline_compile_threads;
+  std::atomic<u32> m_batch_pipeline_next_job{0};
+  std::atomic<u32> m_batch_pipeline_jobs_done{0};
+  std::atomic_bool m_batch_pipeline_compile_cancel{false};
+  Common::Timer m_batch_pipeline_compile_timer;
 
   // [interlaced]
   std::array<VkPipeline, 2> m_vram_fill_pipelines{};
@@ -118,9 +165,24 @@ private:
 
   VkPipeline m_vram_readback_pipeline = VK_NULL_HANDLE;
   VkPipeline m_vram_update_depth_pipeline = VK_NULL_HANDLE;
+  VkPipeline m_vram_transfer_pipeline = VK_NULL_HANDLE;
 
   // [depth_24][interlace_mode]
   DimensionalArray<VkPipeline, 3, 2> m_display_pipelines{};
 
+  // Compute VRAM transfers waiting to be dispatched. The entries are written straight to space reserved in the
+  // uniform buffer when the first one is queued, so nothing else can use the uniform buffer until they're flushed.
+  std::array<Common::Rectangle<u32>, MAX_VRAM_TRANSFERS_PER_DISPATCH> m_pending_vram_transfer_rects;
+  u32 m_num_pending_vram_transfers = 0;
+  u32 m_pending_vram_transfer_ubo_offset = 0;
+  u32 m_pending_vram_transfer_groups = 0;
+  u32 m_pending_vram_transfer_max_groups_x = 0;
+  u32 m_pending_vram_transfer_max_groups_y = 0;
+  bool m_pending_vram_transfer_copies = false;
+
+  // Area written by compute transfers since the depth buffer was last updated from the mask bit, in scaled
+  // coordinates. Only brought up to date when a draw needs to test the mask bit.
+  Common::Rectangle<u32> m_vram_depth_dirty_rect;
+
   bool m_use_ssbos_for_vram_writes = false;
 };
@@ -1,19 +1,26 @@
 #include "gpu_sw.h"
+#include "common/align.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
+#include "gpu_sw_simd.h"
 #include "host_display.h"
 #include "system.h"
 #include <algorithm>
+#include <cstring>
 Log_SetChannel(GPU_SW);
 
 GPU_SW::GPU_SW()
 {
   m_vram.fill(0);
   m_vram_ptr = m_vram.data();
+  m_texture_cache.resize(TEXTURE_CACHE_SIZE);
 }
 
 GPU_SW::~GPU_SW()
 {
+  StopThreads();
+
   if (m_host_display)
     m_host_display->ClearDisplayTexture();
 }
@@ -29,125 +36,588 @@ bool GPU_SW::Initialize(HostDisplay* host_display, System* system, DMA* dma, Int
   if (!GPU::Initialize(host_display, system, dma, interrupt_controller, timers))
     return false;
 
-  m_display_texture = host_display->CreateTexture(VRAM_WIDTH, VRAM_HEIGHT, nullptr, 0, true);
-  if (!m_display_texture)
+  const Settings& settings = system->GetSettings();
+  m_scaled_dithering = settings.gpu_scaled_dithering;
+  if (!SetResolutionScale(
+        std::clamp<u32>(settings.gpu_software_resolution_scale, 1, MAX_SOFTWARE_RESOLUTION_SCALE)) &&
+      !SetResolutionScale(1))
+  {
     return false;
+  }
+
+  if (settings.gpu_use_thread)
+    StartThreads(std::clamp<u32>(settings.gpu_render_threads, 1, MAX_RENDER_THREADS));
 
   return true;
 }
 
 void GPU_SW::Reset()
 {
+  Sync();
+
   GPU::Reset();
 
   m_vram.fill(0);
+  std::fill(m_scaled_vram.begin(), m_scaled_vram.end(), u16(0));
+  MarkVRAMDirty(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
 }
 
-void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width, u32 height, bool interlaced,
-                          bool interleaved)
+void GPU_SW::UpdateSettings()
 {
-  const u8 interlaced_shift = BoolToUInt8(interlaced);
-  const u8 interleaved_shift = BoolToUInt8(interleaved);
+  GPU::UpdateSettings();
 
-  // Fast path when not wrapping around.
-  if ((src_x + width) <= VRAM_WIDTH && (src_y + height) <= VRAM_HEIGHT)
+  const Settings& settings = m_system->GetSettings();
+  const u32 num_threads =
+    settings.gpu_use_thread ? std::clamp<u32>(settings.gpu_render_threads, 1, MAX_RENDER_THREADS) : 0;
+  if (num_threads != m_render_thread_count)
   {
-    dst_stride <<= interlaced_shift;
-    height >>= interlaced_shift;
+    StopThreads();
+    StartThreads(num_threads);
+  }
 
-    const u16* src_ptr = &m_vram[src_y * VRAM_WIDTH + src_x];
-    const u32 src_stride = VRAM_WIDTH << interleaved_shift;
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = src_ptr;
-      u32* dst_row_ptr = dst_ptr;
-      for (u32 col = 0; col < width; col++)
-        *(dst_row_ptr++) = RGBA5551ToRGBA8888(*(src_row_ptr++));
+  const u32 resolution_scale =
+    std::clamp<u32>(settings.gpu_software_resolution_scale, 1, MAX_SOFTWARE_RESOLUTION_SCALE);
+  if (resolution_scale != m_resolution_scale || settings.gpu_scaled_dithering != m_scaled_dithering)
+  {
+    // The render threads read these.
+    Sync();
 
-      src_ptr += src_stride;
-      dst_ptr += dst_stride;
+    m_scaled_dithering = settings.gpu_scaled_dithering;
+    if (resolution_scale != m_resolution_scale && !SetResolutionScale(resolution_scale))
+    {
+      Log_ErrorPrintf("Failed to create %ux display texture, disabling upscaling", resolution_scale);
+      SetResolutionScale(1);
     }
   }
+}
+
+bool GPU_SW::SetResolutionScale(u32 scale)
+{
+  m_resolution_scale = scale;
+  if (scale > 1)
+  {
+    m_scaled_vram.resize((VRAM_WIDTH * scale) * (VRAM_HEIGHT * scale));
+    UpscaleVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+  }
   else
   {
-    dst_stride <<= interlaced_shift;
-    height >>= interlaced_shift;
+    std::vector<u16>().swap(m_scaled_vram);
+  }
 
-    const u32 end_x = src_x + width;
-    for (u32 row = 0; row < height; row++)
+  if (m_display_texture)
+  {
+    m_host_display->ClearDisplayTexture();
+    m_display_texture.reset();
+  }
+
+  InvalidateDisplayLines();
+  m_display_texture = m_host_display->CreateTexture(VRAM_WIDTH * scale, VRAM_HEIGHT * scale, nullptr, 0, true);
+  return static_cast<bool>(m_display_texture);
+}
+
+void GPU_SW::UpscaleVRAM(u32 x, u32 y, u32 width, u32 height)
+{
+  const u32 scale = m_resolution_scale;
+  const u32 scaled_stride = VRAM_WIDTH * scale;
+
+  // Rows are one or two (when crossing the right edge of VRAM) runs, as with fills.
+  const u32 first_width = std::min<u32>(width, VRAM_WIDTH - x);
+  const u32 second_width = width - first_width;
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
+  {
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    const u16* src_row_ptr = GetPixelPtr(0, row);
+    u16* dst_row_ptr = &m_scaled_vram[row * scale * scaled_stride];
+    for (u32 col = x; col < (x + first_width); col++)
+      std::fill_n(&dst_row_ptr[col * scale], scale, src_row_ptr[col]);
+    for (u32 col = 0; col < second_width; col++)
+      std::fill_n(&dst_row_ptr[col * scale], scale, src_row_ptr[col]);
+
+    for (u32 i = 1; i < scale; i++)
     {
-      const u16* src_row_ptr = &m_vram[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
-      u32* dst_row_ptr = dst_ptr;
+      u16* copy_row_ptr = dst_row_ptr + (i * scaled_stride);
+      std::copy_n(&dst_row_ptr[x * scale], first_width * scale, &copy_row_ptr[x * scale]);
+      std::copy_n(dst_row_ptr, second_width * scale, copy_row_ptr);
+    }
+  }
+}
+
+void GPU_SW::FillScaledVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u32 active_field)
+{
+  const u16 color16 = RGBA8888ToRGBA5551(color);
+  const u32 scale = m_resolution_scale;
+  const u32 scaled_stride = VRAM_WIDTH * scale;
 
-      for (u32 col = src_x; col < end_x; col++)
-        *(dst_row_ptr++) = RGBA5551ToRGBA8888(src_row_ptr[col % VRAM_WIDTH]);
+  const u32 first_width = std::min<u32>(width, VRAM_WIDTH - x);
+  const u32 second_width = width - first_width;
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
+  {
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    if (interlaced && (row & u32(1)) == active_field)
+      continue;
 
-      src_y += (1 << interleaved_shift);
-      dst_ptr += dst_stride;
+    for (u32 i = 0; i < scale; i++)
+    {
+      u16* row_ptr = &m_scaled_vram[(row * scale + i) * scaled_stride];
+      std::fill_n(&row_ptr[x * scale], first_width * scale, color16);
+      std::fill_n(row_ptr, second_width * scale, color16);
     }
   }
 }
 
-void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width, u32 height, bool interlaced,
-                          bool interleaved)
+void GPU_SW::CopyScaledVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, u16 mask_and,
+                            u16 mask_or)
 {
-  const u8 interlaced_shift = BoolToUInt8(interlaced);
-  const u8 interleaved_shift = BoolToUInt8(interleaved);
+  const u32 scale = m_resolution_scale;
+  const u32 scaled_width = VRAM_WIDTH * scale;
+  const u32 scaled_height = VRAM_HEIGHT * scale;
+  const u32 scaled_src_x = src_x * scale;
+  const u32 scaled_dst_x = dst_x * scale;
+  const u32 scaled_copy_width = width * scale;
+  const bool wraps = (src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH;
+
+  for (u32 row = 0; row < (height * scale); row++)
+  {
+    const u16* src_row_ptr = &m_scaled_vram[((src_y * scale + row) % scaled_height) * scaled_width];
+    u16* dst_row_ptr = &m_scaled_vram[((dst_y * scale + row) % scaled_height) * scaled_width];
+
+    if (!wraps && mask_and == 0)
+    {
+      std::memmove(&dst_row_ptr[scaled_dst_x], &src_row_ptr[scaled_src_x], scaled_copy_width * sizeof(u16));
+      if (mask_or != 0)
+      {
+        for (u32 col = 0; col < scaled_copy_width; col++)
+          dst_row_ptr[scaled_dst_x + col] |= mask_or;
+      }
+    }
+    else if (src_x < dst_x)
+    {
+      for (s32 col = static_cast<s32>(scaled_copy_width - 1); col >= 0; col--)
+      {
+        u16& dst_pixel = dst_row_ptr[(scaled_dst_x + static_cast<u32>(col)) % scaled_width];
+        if ((dst_pixel & mask_and) == 0)
+          dst_pixel = src_row_ptr[(scaled_src_x + static_cast<u32>(col)) % scaled_width] | mask_or;
+      }
+    }
+    else
+    {
+      for (u32 col = 0; col < scaled_copy_width; col++)
+      {
+        u16& dst_pixel = dst_row_ptr[(scaled_dst_x + col) % scaled_width];
+        if ((dst_pixel & mask_and) == 0)
+          dst_pixel = src_row_ptr[(scaled_src_x + col) % scaled_width] | mask_or;
+      }
+    }
+  }
+}
+
+void GPU_SW::StartThreads(u32 count)
+{
+  if (IsUsingThread() || count == 0)
+    return;
+
+  m_shutdown_flag = false;
+  m_pending_read_rect.SetInvalid();
+  m_pending_write_rect.SetInvalid();
+  for (u32 i = 0; i < count; i++)
+    m_command_queue_read_pos[i].store(m_command_queue_write_pos);
+
+  // The threads can't look at m_render_threads, it's still being populated when the first ones start.
+  m_render_thread_count = count;
+  m_render_threads.reserve(count);
+  for (u32 i = 0; i < count; i++)
+    m_render_threads.emplace_back(&GPU_SW::RenderThreadEntryPoint, this, i);
+}
+
+void GPU_SW::StopThreads()
+{
+  if (!IsUsingThread())
+    return;
+
+  // The threads drain the queue before exiting.
+  {
+    std::unique_lock<std::mutex> lock(m_command_queue_mutex);
+    m_shutdown_flag = true;
+    m_command_queue_pushed_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_render_threads)
+    thread.join();
+  m_render_threads.clear();
+  m_render_thread_count = 0;
+}
+
+void GPU_SW::QueueCommand(SWCommand&& cmd)
+{
+  if (!IsUsingThread())
+  {
+    ExecuteCommand(cmd, 0, 1);
+    return;
+  }
+
+  // Everything before an exclusive command is complete by the time the threads move past it.
+  if (cmd.exclusive)
+  {
+    m_pending_read_rect.SetInvalid();
+    m_pending_write_rect.SetInvalid();
+  }
 
-  if ((src_x + width) <= VRAM_WIDTH && (src_y + height) <= VRAM_HEIGHT)
+  std::unique_lock<std::mutex> lock(m_command_queue_mutex);
+  if ((m_command_queue_write_pos - GetCommandQueueReadPosition()) == COMMAND_QUEUE_SIZE)
   {
-    dst_stride <<= interlaced_shift;
-    height >>= interlaced_shift;
+    m_command_queue_consumed_cv.wait(
+      lock, [this]() { return (m_command_queue_write_pos - GetCommandQueueReadPosition()) < COMMAND_QUEUE_SIZE; });
+  }
+
+  m_command_queue[m_command_queue_write_pos % COMMAND_QUEUE_SIZE] = std::move(cmd);
+  m_command_queue_write_pos++;
+  m_command_queue_pushed_cv.notify_all();
+}
+
+void GPU_SW::Sync()
+{
+  if (!IsUsingThread())
+    return;
+
+  std::unique_lock<std::mutex> lock(m_command_queue_mutex);
+  m_command_queue_consumed_cv.wait(lock,
+                                   [this]() { return GetCommandQueueReadPosition() == m_command_queue_write_pos; });
+}
+
+u32 GPU_SW::GetCommandQueueReadPosition() const
+{
+  u32 max_pending = 0;
+  for (u32 i = 0; i < m_render_thread_count; i++)
+    max_pending = std::max(max_pending, m_command_queue_write_pos - m_command_queue_read_pos[i].load());
 
-    const u8* src_ptr = reinterpret_cast<const u8*>(&m_vram[src_y * VRAM_WIDTH + src_x]);
-    const u32 src_stride = (VRAM_WIDTH << interleaved_shift) * sizeof(u16);
-    for (u32 row = 0; row < height; row++)
+  return m_command_queue_write_pos - max_pending;
+}
+
+void GPU_SW::WaitForRenderThreads(u32 pos) const
+{
+  for (u32 i = 0; i < m_render_thread_count; i++)
+    WaitForRenderThread(i, pos);
+}
+
+void GPU_SW::WaitForRenderThread(u32 index, u32 pos) const
+{
+  // These waits are short, the other threads are working through the same commands.
+  while (static_cast<s32>(m_command_queue_read_pos[index].load() - pos) < 0)
+    std::this_thread::yield();
+}
+
+void GPU_SW::RenderThreadEntryPoint(u32 index)
+{
+  std::unique_lock<std::mutex> lock(m_command_queue_mutex);
+  for (;;)
+  {
+    m_command_queue_pushed_cv.wait(
+      lock, [this, index]() { return m_command_queue_read_pos[index] != m_command_queue_write_pos || m_shutdown_flag; });
+    if (m_command_queue_read_pos[index] == m_command_queue_write_pos)
+      break;
+
+    // Run everything which has been queued so far without holding the lock. The CPU thread can't overwrite these
+    // slots until every thread's read position is moved past them.
+    const u32 end_pos = m_command_queue_write_pos;
+    lock.unlock();
+
+    for (u32 pos = m_command_queue_read_pos[index]; pos != end_pos; pos++)
     {
-      const u8* src_row_ptr = src_ptr;
-      u8* dst_row_ptr = reinterpret_cast<u8*>(dst_ptr);
-      for (u32 col = 0; col < width; col++)
+      SWCommand& cmd = m_command_queue[pos % COMMAND_QUEUE_SIZE];
+      if (!cmd.exclusive)
       {
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = *(src_row_ptr++);
-        *(dst_row_ptr++) = 0xFF;
+        ExecuteCommand(cmd, index, m_render_thread_count);
+      }
+      else
+      {
+        WaitForRenderThreads(pos);
+        if (index == 0)
+          ExecuteCommand(cmd, 0, 1);
+        else
+          WaitForRenderThread(0, pos + 1);
       }
 
-      src_ptr += src_stride;
-      dst_ptr += dst_stride;
+      m_command_queue_read_pos[index].store(pos + 1);
     }
+
+    lock.lock();
+    m_command_queue_consumed_cv.notify_all();
   }
-  else
-  {
-    dst_stride <<= interlaced_shift;
-    height >>= interlaced_shift;
+}
 
-    const u32 end_x = src_x + width;
-    for (u32 row = 0; row < height; row++)
+void GPU_SW::ExecuteCommand(SWCommand& cmd, u32 band_index, u32 band_count)
+{
+  switch (cmd.type)
+  {
+    case SWCommandType::DrawTriangle:
+    case SWCommandType::DrawRectangle:
+    case SWCommandType::DrawLine:
     {
-      const u16* src_row_ptr = &m_vram[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
-      u32* dst_row_ptr = dst_ptr;
+      // The upscaled copy is drawn first, as primitives which sample from their own drawing area read VRAM.
+      if (m_resolution_scale > 1)
+      {
+        const u32 scale = m_resolution_scale;
+        ExecuteDrawCommand(cmd, SWDrawContext{&cmd.state, band_index, band_count, m_scaled_vram.data(),
+                                              VRAM_WIDTH * scale, scale, m_scaled_dithering ? scale : 1u});
+      }
+
+      ExecuteDrawCommand(cmd, SWDrawContext{&cmd.state, band_index, band_count, m_vram.data(), VRAM_WIDTH, 1, 1});
+    }
+    break;
+
+    case SWCommandType::FillVRAM:
+      DoFillVRAM(cmd.x, cmd.y, cmd.width, cmd.height, cmd.color, cmd.state.interlaced_rendering,
+                 cmd.state.active_line_lsb);
+      if (m_resolution_scale > 1)
+      {
+        FillScaledVRAM(cmd.x, cmd.y, cmd.width, cmd.height, cmd.color, cmd.state.interlaced_rendering,
+                       cmd.state.active_line_lsb);
+      }
+      break;
 
-      for (u32 col = 0; col < width; col++)
+    case SWCommandType::UpdateVRAM:
+      DoUpdateVRAM(cmd.x, cmd.y, cmd.width, cmd.height, cmd.data.data(), cmd.state.mask_and, cmd.state.mask_or);
+      if (m_resolution_scale > 1)
+        UpscaleVRAM(cmd.x, cmd.y, cmd.width, cmd.height);
+
+      // Don't hang on to the memory for large uploads while the slot is unused.
+      std::vector<u16>().swap(cmd.data);
+      break;
+
+    case SWCommandType::CopyVRAM:
+      DoCopyVRAM(cmd.src_x, cmd.src_y, cmd.x, cmd.y, cmd.width, cmd.height, cmd.state.mask_and, cmd.state.mask_or);
+      if (m_resolution_scale > 1)
       {
-        const u32 offset = (src_x + ((col * 3) / 2));
-        const u16 s0 = src_row_ptr[offset % VRAM_WIDTH];
-        const u16 s1 = src_row_ptr[(offset + 1) % VRAM_WIDTH];
-        const u8 shift = static_cast<u8>(col & 1u) * 8;
-        *(dst_row_ptr++) = (((ZeroExtend32(s1) << 16) | ZeroExtend32(s0)) >> shift) | 0xFF000000u;
+        CopyScaledVRAM(cmd.src_x, cmd.src_y, cmd.x, cmd.y, cmd.width, cmd.height, cmd.state.mask_and,
+                       cmd.state.mask_or);
       }
+      break;
+
+    case SWCommandType::DecodeTexturePage:
+      DecodeTexturePage(cmd.state, cmd.decode_texels, cmd.y, cmd.height);
+      break;
+
+    case SWCommandType::Barrier:
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
+void GPU_SW::ExecuteDrawCommand(const SWCommand& cmd, const SWDrawContext& ctx)
+{
+  switch (cmd.type)
+  {
+    case SWCommandType::DrawTriangle:
+      (this->*cmd.draw_triangle)(ctx, &cmd.vertices[0], &cmd.vertices[1], &cmd.vertices[2]);
+      break;
+
+    case SWCommandType::DrawRectangle:
+    {
+      const SWVertex& origin = cmd.vertices[0];
+      (this->*cmd.draw_rectangle)(ctx, origin.x, origin.y, cmd.width, cmd.height, origin.color_r, origin.color_g,
+                                  origin.color_b, origin.texcoord_x, origin.texcoord_y);
+    }
+    break;
+
+    case SWCommandType::DrawLine:
+      (this->*cmd.draw_line)(ctx, &cmd.vertices[0], &cmd.vertices[1]);
+      break;
+
+    default:
+      UnreachableCode();
+      break;
+  }
+}
+
+void GPU_SW::ConvertRGBA5551Span(const u16* src_ptr, u32* dst_ptr, u32 count)
+{
+#ifdef GPU_SW_SIMD
+  // Same expansion as RGBA5551ToRGBA8888(), with the red/green and blue/alpha halves interleaved on store.
+  const SWVector mask_5bit = SWVector::Broadcast(0x1F);
+  const SWVector mask_3bit = SWVector::Broadcast(0x07);
+  const SWVector mask_alpha = SWVector::Broadcast(0xFF00);
+  for (; count >= SWVector::NUM_LANES; count -= SWVector::NUM_LANES)
+  {
+    const SWVector color = SWVector::Load(src_ptr);
+    const SWVector r = color & mask_5bit;
+    const SWVector g = color.ShiftRightLogical<5>() & mask_5bit;
+    const SWVector b = color.ShiftRightLogical<10>() & mask_5bit;
+    const SWVector r8 = r.ShiftLeft<3>() | (r & mask_3bit);
+    const SWVector g8 = g.ShiftLeft<3>() | (g & mask_3bit);
+    const SWVector b8 = b.ShiftLeft<3>() | (b & mask_3bit);
+    const SWVector a8 = color.ShiftRightArithmetic<15>() & mask_alpha;
+    SWVector::StoreInterleaved(reinterpret_cast<u16*>(dst_ptr), r8 | g8.ShiftLeft<8>(), b8 | a8);
+    src_ptr += SWVector::NUM_LANES;
+    dst_ptr += SWVector::NUM_LANES;
+  }
+#endif
+
+  for (; count > 0; count--)
+    *(dst_ptr++) = RGBA5551ToRGBA8888(*(src_ptr++));
+}
+
+void GPU_SW::ConvertRGB888Span(const u8* src_ptr, u32* dst_ptr, u32 count)
+{
+#if defined(CPU_AARCH64)
+  const uint8x16_t alpha = vdupq_n_u8(0xFF);
+  for (; count >= 16; count -= 16)
+  {
+    const uint8x16x3_t rgb = vld3q_u8(src_ptr);
+    vst4q_u8(reinterpret_cast<u8*>(dst_ptr), uint8x16x4_t{{rgb.val[0], rgb.val[1], rgb.val[2], alpha}});
+    src_ptr += 16 * 3;
+    dst_ptr += 16;
+  }
+#endif
+
+  // Read each pixel as a word and replace the fourth byte, except for the last which could be at the end of VRAM.
+  for (; count > 1; count--)
+  {
+    u32 value;
+    std::memcpy(&value, src_ptr, sizeof(value));
+    *(dst_ptr++) = (value & 0x00FFFFFFu) | 0xFF000000u;
+    src_ptr += 3;
+  }
+  if (count > 0)
+  {
+    *dst_ptr = ZeroExtend32(src_ptr[0]) | (ZeroExtend32(src_ptr[1]) << 8) | (ZeroExtend32(src_ptr[2]) << 16) |
+               0xFF000000u;
+  }
+}
+
+void GPU_SW::CopyOut15Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 width)
+{
+  // Lines wrap around to the left edge of VRAM.
+  const u16* src_row_ptr = GetPixelPtr(0, src_y);
+  while (width > 0)
+  {
+    const u32 count = std::min(width, VRAM_WIDTH - src_x);
+    ConvertRGBA5551Span(&src_row_ptr[src_x], dst_ptr, count);
+    dst_ptr += count;
+    width -= count;
+    src_x = 0;
+  }
+}
+
+void GPU_SW::CopyOut24Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 width)
+{
+  const u16* src_row_ptr = GetPixelPtr(0, src_y);
+  if ((src_x * 2 + width * 3) <= (VRAM_WIDTH * 2))
+  {
+    ConvertRGB888Span(reinterpret_cast<const u8*>(&src_row_ptr[src_x]), dst_ptr, width);
+    return;
+  }
+
+  for (u32 col = 0; col < width; col++)
+  {
+    const u32 offset = (src_x + ((col * 3) / 2));
+    const u16 s0 = src_row_ptr[offset % VRAM_WIDTH];
+    const u16 s1 = src_row_ptr[(offset + 1) % VRAM_WIDTH];
+    const u8 shift = static_cast<u8>(col & 1u) * 8;
+    *(dst_ptr++) = (((ZeroExtend32(s1) << 16) | ZeroExtend32(s0)) >> shift) | 0xFF000000u;
+  }
+}
+
+void GPU_SW::CopyOut15BitScaled(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width)
+{
+  const u32 scale = m_resolution_scale;
+  const u32 scaled_width = VRAM_WIDTH * scale;
+  for (u32 i = 0; i < scale; i++)
+  {
+    const u16* src_row_ptr = &m_scaled_vram[(src_y * scale + i) * scaled_width];
+    u32* dst_row_ptr = dst_ptr + (i * dst_stride);
+    u32 scaled_src_x = src_x * scale;
+    u32 remaining = width * scale;
+    while (remaining > 0)
+    {
+      const u32 count = std::min(remaining, scaled_width - scaled_src_x);
+      ConvertRGBA5551Span(&src_row_ptr[scaled_src_x], dst_row_ptr, count);
+      dst_row_ptr += count;
+      remaining -= count;
+      scaled_src_x = 0;
+    }
+  }
+}
+
+bool GPU_SW::CopyOut(u32 src_x, u32 src_y, u32 width, u32 height, bool interlaced, bool interleaved, u32 field,
+                     bool rgb24, u32 scale, u32* first_line, u32* last_line)
+{
+  // The display texture is only as tall as VRAM.
+  height = std::min<u32>(height, VRAM_HEIGHT);
+
+  // When the layout changes, every line is converted, and the whole area is uploaded so that the lines of the other
+  // field are consistent with the buffer.
+  const DisplayLayout layout{src_x, width, height, scale, rgb24};
+  const bool full_update = (std::memcmp(&layout, &m_display_layout, sizeof(layout)) != 0);
+  if (full_update)
+  {
+    m_display_layout = layout;
+    for (DisplayLineSource& source : m_display_line_sources)
+      source.vram_row = INVALID_VRAM_ROW;
+  }
+
+  const u8 interlaced_shift = BoolToUInt8(interlaced);
+  const u8 interleaved_shift = BoolToUInt8(interleaved);
+  const u32 dst_stride = VRAM_WIDTH * m_resolution_scale;
+  const u32 num_lines = height >> interlaced_shift;
 
-      src_y += (1 << interleaved_shift);
-      dst_ptr += dst_stride;
+  // Each VRAM line is scale lines of the output, which are skipped over together for the other field.
+  bool changed = false;
+  for (u32 row = 0; row < num_lines; row++)
+  {
+    const u32 line = (row << interlaced_shift) + field;
+    const u32 vram_row = (src_y + (row << interleaved_shift)) % VRAM_HEIGHT;
+    DisplayLineSource& source = m_display_line_sources[line];
+    if (source.vram_row == vram_row && source.version == m_vram_row_versions[vram_row])
+      continue;
+
+    source.vram_row = vram_row;
+    source.version = m_vram_row_versions[vram_row];
+
+    u32* dst_ptr = &m_display_texture_buffer[line * scale * dst_stride];
+    if (rgb24)
+      CopyOut24Bit(src_x, vram_row, dst_ptr, width);
+    else if (scale > 1)
+      CopyOut15BitScaled(src_x, vram_row, dst_ptr, dst_stride, width);
+    else
+      CopyOut15Bit(src_x, vram_row, dst_ptr, width);
+
+    if (!changed)
+    {
+      *first_line = line;
+      changed = true;
     }
+    *last_line = line;
+  }
+
+  if (full_update && height > 0)
+  {
+    *first_line = 0;
+    *last_line = height - 1;
+    return true;
   }
+
+  return changed;
+}
+
+void GPU_SW::InvalidateDisplayLines()
+{
+  m_display_layout = {};
 }
 
 void GPU_SW::UpdateDisplay()
 {
+  Sync();
+
   // fill display texture
-  m_display_texture_buffer.resize(VRAM_WIDTH * VRAM_HEIGHT);
+  const u32 texture_width = VRAM_WIDTH * m_resolution_scale;
+  const u32 texture_height = VRAM_HEIGHT * m_resolution_scale;
+  m_display_texture_buffer.resize(texture_width * texture_height);
 
+  // Only lines which have changed since they were last converted are uploaded, the rest are still in the texture.
+  u32 first_line, last_line;
   if (!m_system->GetSettings().debugging.show_vram)
   {
     if (IsDisplayDisabled())
@@ -156,57 +626,309 @@ void GPU_SW::UpdateDisplay()
       return;
     }
 
-    const u32 vram_offset_x = m_crtc_state.display_vram_left;
     const u32 vram_offset_y = m_crtc_state.display_vram_top;
     const u32 display_width = m_crtc_state.display_vram_width;
     const u32 display_height = m_crtc_state.display_vram_height;
     const u32 texture_offset_x = m_crtc_state.display_vram_left - m_crtc_state.regs.X;
-    if (IsInterlacedDisplayEnabled())
+    const u32 copy_width = display_width + texture_offset_x;
+
+    // 24-bit pixels straddle VRAM pixels, so they can't be upscaled, and are always read from VRAM.
+    const bool rgb24 = m_GPUSTAT.display_area_color_depth_24;
+    const u32 scale = rgb24 ? 1u : m_resolution_scale;
+    const bool interlaced = IsInterlacedDisplayEnabled();
+    const u32 field = interlaced ? GetInterlacedDisplayField() : 0u;
+    if (CopyOut(m_crtc_state.regs.X, vram_offset_y + field, copy_width, display_height, interlaced,
+                interlaced && m_GPUSTAT.vertical_resolution, field, rgb24, scale, &first_line, &last_line))
     {
-      const u32 field = GetInterlacedDisplayField();
-      if (m_GPUSTAT.display_area_color_depth_24)
-      {
-        CopyOut24Bit(m_crtc_state.regs.X, vram_offset_y + field, m_display_texture_buffer.data() + field * VRAM_WIDTH,
-                     VRAM_WIDTH, display_width + texture_offset_x, display_height, true, m_GPUSTAT.vertical_resolution);
-      }
-      else
-      {
-        CopyOut15Bit(m_crtc_state.regs.X, vram_offset_y + field, m_display_texture_buffer.data() + field * VRAM_WIDTH,
-                     VRAM_WIDTH, display_width + texture_offset_x, display_height, true, m_GPUSTAT.vertical_resolution);
-      }
+      m_host_display->UpdateTexture(m_display_texture.get(), 0, first_line * scale, copy_width * scale,
+                                    (last_line - first_line + 1) * scale,
+                                    &m_display_texture_buffer[first_line * scale * texture_width],
+                                    texture_width * sizeof(u32));
     }
-    else
+
+    m_host_display->SetDisplayTexture(m_display_texture->GetHandle(), texture_width, texture_height,
+                                      texture_offset_x * scale, 0, display_width * scale, display_height * scale);
+    m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
+                                         m_crtc_state.display_origin_left, m_crtc_state.display_origin_top,
+                                         m_crtc_state.display_vram_width, m_crtc_state.display_vram_height,
+                                         m_crtc_state.display_aspect_ratio);
+  }
+  else
+  {
+    const u32 scale = m_resolution_scale;
+    if (CopyOut(0, 0, VRAM_WIDTH, VRAM_HEIGHT, false, false, 0, false, scale, &first_line, &last_line))
     {
-      if (m_GPUSTAT.display_area_color_depth_24)
-      {
-        CopyOut24Bit(m_crtc_state.regs.X, vram_offset_y, m_display_texture_buffer.data(), VRAM_WIDTH,
-                     display_width + texture_offset_x, display_height, false, false);
-      }
-      else
-      {
-        CopyOut15Bit(m_crtc_state.regs.X, vram_offset_y, m_display_texture_buffer.data(), VRAM_WIDTH,
-                     display_width + texture_offset_x, display_height, false, false);
-      }
+      m_host_display->UpdateTexture(m_display_texture.get(), 0, first_line * scale, texture_width,
+                                    (last_line - first_line + 1) * scale,
+                                    &m_display_texture_buffer[first_line * scale * texture_width],
+                                    texture_width * sizeof(u32));
+    }
+
+    m_host_display->SetDisplayTexture(m_display_texture->GetHandle(), texture_width, texture_height, 0, 0,
+                                      texture_width, texture_height);
+    m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
+                                         static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+  }
+}
+
+void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
+{
+  Sync();
+}
+
+void GPU_SW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
+{
+  // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
+  if (IsInterlacedRenderingEnabled() && IsCRTCScanlinePending())
+    SynchronizeCRTC();
+
+  MarkVRAMDirty(x, y, width, height);
+
+  SWCommand cmd;
+  cmd.type = SWCommandType::FillVRAM;
+  cmd.state = GetRenderState();
+  cmd.exclusive = true;
+  cmd.x = x;
+  cmd.y = y;
+  cmd.width = width;
+  cmd.height = height;
+  cmd.color = color;
+  QueueCommand(std::move(cmd));
+}
+
+void GPU_SW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data)
+{
+  MarkVRAMDirty(x, y, width, height);
+
+  // No need to copy the data when we're going to use it straight away.
+  if (!IsUsingThread())
+  {
+    GPU::UpdateVRAM(x, y, width, height, data);
+    if (m_resolution_scale > 1)
+      UpscaleVRAM(x, y, width, height);
+
+    return;
+  }
+
+  SWCommand cmd;
+  cmd.type = SWCommandType::UpdateVRAM;
+  cmd.state = GetRenderState();
+  cmd.exclusive = true;
+  cmd.x = x;
+  cmd.y = y;
+  cmd.width = width;
+  cmd.height = height;
+  cmd.data.assign(static_cast<const u16*>(data), static_cast<const u16*>(data) + (width * height));
+  QueueCommand(std::move(cmd));
+}
+
+void GPU_SW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height)
+{
+  MarkVRAMDirty(dst_x, dst_y, width, height);
+
+  SWCommand cmd;
+  cmd.type = SWCommandType::CopyVRAM;
+  cmd.state = GetRenderState();
+  cmd.exclusive = true;
+  cmd.src_x = src_x;
+  cmd.src_y = src_y;
+  cmd.x = dst_x;
+  cmd.y = dst_y;
+  cmd.width = width;
+  cmd.height = height;
+  QueueCommand(std::move(cmd));
+}
+
+GPU_SW::SWRenderState GPU_SW::GetRenderState() const
+{
+  SWRenderState state;
+  state.drawing_offset = m_drawing_offset;
+  state.drawing_area = m_drawing_area;
+  state.texture_page_x = m_draw_mode.texture_page_x;
+  state.texture_page_y = m_draw_mode.texture_page_y;
+  state.texture_palette_x = m_draw_mode.texture_palette_x;
+  state.texture_palette_y = m_draw_mode.texture_palette_y;
+  state.texture_window_mask_x = m_draw_mode.texture_window_mask_x;
+  state.texture_window_mask_y = m_draw_mode.texture_window_mask_y;
+  state.texture_window_offset_x = m_draw_mode.texture_window_offset_x;
+  state.texture_window_offset_y = m_draw_mode.texture_window_offset_y;
+  state.texture_mode = m_draw_mode.GetTextureMode();
+  state.transparency_mode = m_draw_mode.GetTransparencyMode();
+  state.mask_and = m_GPUSTAT.GetMaskAND();
+  state.mask_or = m_GPUSTAT.GetMaskOR();
+  state.interlaced_rendering = IsInterlacedRenderingEnabled();
+  state.active_line_lsb = GetActiveLineLSB();
+  state.texture_cache_page = nullptr;
+  return state;
+}
+
+Common::Rectangle<u32> GPU_SW::GetPrimitiveWriteRect(s32 min_x, s32 min_y, s32 max_x, s32 max_y) const
+{
+  const s32 left = static_cast<s32>(m_drawing_area.left);
+  const s32 top = static_cast<s32>(m_drawing_area.top);
+  const s32 right = static_cast<s32>(m_drawing_area.right);
+  const s32 bottom = static_cast<s32>(m_drawing_area.bottom);
+  return Common::Rectangle<u32>(
+    static_cast<u32>(std::clamp(min_x, left, right)), static_cast<u32>(std::clamp(min_y, top, bottom)),
+    static_cast<u32>(std::clamp(max_x, left, right)) + 1u, static_cast<u32>(std::clamp(max_y, top, bottom)) + 1u);
+}
+
+bool GPU_SW::CheckForRenderThreadHazards(const Common::Rectangle<u32>& write_rect, bool textured)
+{
+  if (m_render_thread_count <= 1)
+    return false;
+
+  Common::Rectangle<u32> read_rect;
+  if (textured)
+  {
+    read_rect = m_draw_mode.GetTexturePageRectangle();
+    if (m_draw_mode.IsUsingPalette())
+      read_rect.Include(m_draw_mode.GetTexturePaletteRectangle());
+  }
+
+  if (read_rect.Intersects(m_pending_write_rect) || write_rect.Intersects(m_pending_read_rect))
+  {
+    SWCommand cmd;
+    cmd.type = SWCommandType::Barrier;
+    cmd.exclusive = true;
+    QueueCommand(std::move(cmd));
+  }
+
+  m_pending_read_rect.Include(read_rect);
+  m_pending_write_rect.Include(write_rect);
+  return read_rect.Intersects(write_rect);
+}
+
+/// Returns a mask of the texture cache strips covering rows first_row to last_row.
+static constexpr u32 GetTextureCacheStripMask(u32 first_row, u32 last_row, u32 strip_height)
+{
+  return ((2u << (last_row / strip_height)) - 1u) & ~((1u << (first_row / strip_height)) - 1u);
+}
+
+const u16* GPU_SW::GetTextureCachePage(const Common::Rectangle<u32>& write_rect, u32 min_texcoord_y,
+                                       u32 max_texcoord_y)
+{
+  const bool uses_palette = m_draw_mode.IsUsingPalette();
+  const Common::Rectangle<u32> page_rect = m_draw_mode.GetTexturePageRectangle();
+  const Common::Rectangle<u32> palette_rect =
+    uses_palette ? m_draw_mode.GetTexturePaletteRectangle() : Common::Rectangle<u32>();
+
+  // Primitives which draw over their own texture can see their own output, so have to sample VRAM directly.
+  if (write_rect.Intersects(page_rect) || write_rect.Intersects(palette_rect))
+    return nullptr;
+
+  // The texture window can map any row to any other.
+  if (m_draw_mode.texture_window_mask_y != 0)
+  {
+    min_texcoord_y = 0;
+    max_texcoord_y = TEXTURE_PAGE_HEIGHT - 1;
+  }
+
+  const TextureMode texture_mode = m_draw_mode.GetTextureMode();
+  const u32 texture_palette_x = uses_palette ? m_draw_mode.texture_palette_x : 0;
+  const u32 texture_palette_y = uses_palette ? m_draw_mode.texture_palette_y : 0;
+
+  TextureCacheEntry* entry = nullptr;
+  TextureCacheEntry* lru_entry = &m_texture_cache[0];
+  for (TextureCacheEntry& it : m_texture_cache)
+  {
+    if (it.texture_page_x == m_draw_mode.texture_page_x && it.texture_page_y == m_draw_mode.texture_page_y &&
+        it.texture_palette_x == texture_palette_x && it.texture_palette_y == texture_palette_y &&
+        it.texture_mode == texture_mode)
+    {
+      entry = &it;
+      break;
+    }
+
+    if (it.last_used < lru_entry->last_used)
+      lru_entry = &it;
+  }
+
+  if (!entry)
+  {
+    entry = lru_entry;
+    entry->texture_page_x = m_draw_mode.texture_page_x;
+    entry->texture_page_y = m_draw_mode.texture_page_y;
+    entry->texture_palette_x = texture_palette_x;
+    entry->texture_palette_y = texture_palette_y;
+    entry->texture_mode = texture_mode;
+    entry->page_rect = page_rect;
+    entry->palette_rect = palette_rect;
+    entry->valid_strips = 0;
+  }
+
+  entry->last_used = ++m_texture_cache_use_counter;
+
+  const u32 missing_strips =
+    GetTextureCacheStripMask(min_texcoord_y, max_texcoord_y, TEXTURE_CACHE_STRIP_HEIGHT) & ~entry->valid_strips;
+  if (missing_strips != 0)
+  {
+    // Decode everything between the first and last missing strip in one go. The decode has to wait for all earlier
+    // primitives, as they could be sampling the strips which are being replaced.
+    const u32 first_strip = CountTrailingZeros(missing_strips);
+    const u32 last_strip = 31u - CountLeadingZeros(missing_strips);
+
+    SWCommand cmd;
+    cmd.type = SWCommandType::DecodeTexturePage;
+    cmd.state = GetRenderState();
+    cmd.decode_texels = entry->texels.data();
+    cmd.y = first_strip * TEXTURE_CACHE_STRIP_HEIGHT;
+    cmd.height = (last_strip - first_strip + 1) * TEXTURE_CACHE_STRIP_HEIGHT;
+    cmd.exclusive = true;
+    QueueCommand(std::move(cmd));
+
+    entry->valid_strips |= GetTextureCacheStripMask(cmd.y, cmd.y + cmd.height - 1, TEXTURE_CACHE_STRIP_HEIGHT);
+  }
+
+  return entry->texels.data();
+}
+
+void GPU_SW::InvalidateTextureCache(const Common::Rectangle<u32>& rect)
+{
+  for (TextureCacheEntry& entry : m_texture_cache)
+  {
+    if (entry.valid_strips == 0)
+      continue;
+
+    if (rect.Intersects(entry.palette_rect))
+    {
+      entry.valid_strips = 0;
+      continue;
     }
 
-    m_host_display->UpdateTexture(m_display_texture.get(), 0, 0, display_width, display_height,
-                                  m_display_texture_buffer.data(), VRAM_WIDTH * sizeof(u32));
-    m_host_display->SetDisplayTexture(m_display_texture->GetHandle(), VRAM_WIDTH, VRAM_HEIGHT, texture_offset_x, 0,
-                                      display_width, display_height);
-    m_host_display->SetDisplayParameters(m_crtc_state.display_width, m_crtc_state.display_height,
-                                         m_crtc_state.display_origin_left, m_crtc_state.display_origin_top,
-                                         m_crtc_state.display_vram_width, m_crtc_state.display_vram_height,
-                                         m_crtc_state.display_aspect_ratio);
+    // Only the strips covering the rows which were written to need to be decoded again.
+    if (rect.Intersects(entry.page_rect))
+    {
+      const u32 first_row = std::max(rect.top, entry.page_rect.top) - entry.page_rect.top;
+      const u32 last_row = std::min(rect.bottom, entry.page_rect.bottom) - 1u - entry.page_rect.top;
+      entry.valid_strips &= ~GetTextureCacheStripMask(first_row, last_row, TEXTURE_CACHE_STRIP_HEIGHT);
+    }
   }
+}
+
+void GPU_SW::MarkVRAMDirty(const Common::Rectangle<u32>& rect)
+{
+  InvalidateTextureCache(rect);
+  for (u32 row = rect.top; row < rect.bottom; row++)
+    m_vram_row_versions[row]++;
+}
+
+void GPU_SW::MarkVRAMDirty(u32 x, u32 y, u32 width, u32 height)
+{
+  // Writes which wrap around the edge of VRAM are rare, so just treat them as covering all of it.
+  if ((x + width) > VRAM_WIDTH || (y + height) > VRAM_HEIGHT)
+    MarkVRAMDirty(Common::Rectangle<u32>(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
   else
+    MarkVRAMDirty(Common::Rectangle<u32>::FromExtents(x, y, width, height));
+}
+
+void GPU_SW::DecodeTexturePage(const SWRenderState& state, u16* texels, u32 first_row, u32 num_rows)
+{
+  for (u32 row = first_row; row < (first_row + num_rows); row++)
   {
-    CopyOut15Bit(0, 0, m_display_texture_buffer.data(), VRAM_WIDTH, VRAM_WIDTH, VRAM_HEIGHT, false, false);
-    m_host_display->UpdateTexture(m_display_texture.get(), 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
-                                  m_display_texture_buffer.data(), VRAM_WIDTH * sizeof(u32));
-    m_host_display->SetDisplayTexture(m_display_texture->GetHandle(), VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH,
-                                      VRAM_HEIGHT);
-    m_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
-                                         static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
+    u16* row_texels = &texels[row * TEXTURE_PAGE_WIDTH];
+    for (u32 col = 0; col < TEXTURE_PAGE_WIDTH; col++)
+      row_texels[col] = ReadTexel(state, Truncate8(col), Truncate8(row));
   }
 }
 
@@ -251,12 +973,53 @@ void GPU_SW::DispatchRenderCommand()
       if (!IsDrawingAreaIsValid())
         return;
 
-      const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
-        rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
+      s32 min_x = vertices[0].x;
+      s32 max_x = vertices[0].x;
+      s32 min_y = vertices[0].y;
+      s32 max_y = vertices[0].y;
+      u32 min_texcoord_y = vertices[0].texcoord_y;
+      u32 max_texcoord_y = vertices[0].texcoord_y;
+      for (u32 i = 1; i < num_vertices; i++)
+      {
+        min_x = std::min(min_x, vertices[i].x);
+        max_x = std::max(max_x, vertices[i].x);
+        min_y = std::min(min_y, vertices[i].y);
+        max_y = std::max(max_y, vertices[i].y);
+        min_texcoord_y = std::min<u32>(min_texcoord_y, vertices[i].texcoord_y);
+        max_texcoord_y = std::max<u32>(max_texcoord_y, vertices[i].texcoord_y);
+      }
 
-      (this->*DrawFunction)(&vertices[0], &vertices[1], &vertices[2]);
+      const Common::Rectangle<u32> write_rect =
+        GetPrimitiveWriteRect(min_x + m_drawing_offset.x, min_y + m_drawing_offset.y, max_x + m_drawing_offset.x,
+                              max_y + m_drawing_offset.y);
+
+      SWCommand cmd;
+      cmd.type = SWCommandType::DrawTriangle;
+      cmd.state = GetRenderState();
+      if (textured)
+        cmd.state.texture_cache_page = GetTextureCachePage(write_rect, min_texcoord_y, max_texcoord_y);
+      cmd.draw_triangle = GetDrawTriangleFunction(rc.shading_enable, rc.texture_enable, rc.raw_texture_enable,
+                                                  rc.transparency_enable, dithering_enable);
+      cmd.exclusive = CheckForRenderThreadHazards(write_rect, textured && !cmd.state.texture_cache_page);
+      MarkVRAMDirty(write_rect);
+
+      cmd.vertices = {vertices[0], vertices[1], vertices[2]};
+      AddTriangleTicks(&vertices[0], &vertices[1], &vertices[2], rc.shading_enable, rc.texture_enable,
+                       rc.transparency_enable);
       if (num_vertices > 3)
-        (this->*DrawFunction)(&vertices[2], &vertices[1], &vertices[3]);
+      {
+        SWCommand cmd2 = cmd;
+        cmd2.vertices = {vertices[2], vertices[1], vertices[3]};
+        AddTriangleTicks(&vertices[2], &vertices[1], &vertices[3], rc.shading_enable, rc.texture_enable,
+                         rc.transparency_enable);
+
+        QueueCommand(std::move(cmd));
+        QueueCommand(std::move(cmd2));
+      }
+      else
+      {
+        QueueCommand(std::move(cmd));
+      }
     }
     break;
 
@@ -302,10 +1065,41 @@ void GPU_SW::DispatchRenderCommand()
       if (!IsDrawingAreaIsValid())
         return;
 
-      const DrawRectangleFunction DrawFunction =
-        GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+      const s32 start_x = TruncateVertexPosition(m_drawing_offset.x + vp.x);
+      const s32 start_y = TruncateVertexPosition(m_drawing_offset.y + vp.y);
+      const Common::Rectangle<u32> write_rect =
+        GetPrimitiveWriteRect(start_x, start_y, start_x + width - 1, start_y + height - 1);
+
+      SWCommand cmd;
+      cmd.type = SWCommandType::DrawRectangle;
+      cmd.state = GetRenderState();
+      if (rc.texture_enable)
+      {
+        // Texture coordinates wrap around within the page when the rectangle is taller than the remaining rows.
+        const u32 last_texcoord_y = ZeroExtend32(texcoord_y) + static_cast<u32>(std::max(height, 1)) - 1u;
+        const bool wraps = (last_texcoord_y >= TEXTURE_PAGE_HEIGHT);
+        cmd.state.texture_cache_page = GetTextureCachePage(write_rect, wraps ? 0u : ZeroExtend32(texcoord_y),
+                                                           wraps ? (TEXTURE_PAGE_HEIGHT - 1u) : last_texcoord_y);
+      }
+      cmd.draw_rectangle = GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+      cmd.exclusive = CheckForRenderThreadHazards(write_rect, rc.texture_enable && !cmd.state.texture_cache_page);
+      MarkVRAMDirty(write_rect);
+      cmd.vertices[0] = SWVertex{vp.x, vp.y, r, g, b, texcoord_x, texcoord_y};
+      cmd.width = static_cast<u32>(width);
+      cmd.height = static_cast<u32>(height);
+
+      {
+        const u32 clip_left = static_cast<u32>(std::clamp<s32>(start_x, m_drawing_area.left, m_drawing_area.right));
+        const u32 clip_right =
+          static_cast<u32>(std::clamp<s32>(start_x + width, m_drawing_area.left, m_drawing_area.right)) + 1u;
+        const u32 clip_top = static_cast<u32>(std::clamp<s32>(start_y, m_drawing_area.top, m_drawing_area.bottom));
+        const u32 clip_bottom =
+          static_cast<u32>(std::clamp<s32>(start_y + height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
+        AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable,
+                              rc.transparency_enable);
+      }
 
-      (this->*DrawFunction)(vp.x, vp.y, width, height, r, g, b, texcoord_x, texcoord_y);
+      QueueCommand(std::move(cmd));
     }
     break;
 
@@ -315,6 +1109,7 @@ void GPU_SW::DispatchRenderCommand()
       const bool shaded = rc.shading_enable;
 
       const DrawLineFunction DrawFunction = GetDrawLineFunction(shaded, rc.transparency_enable, dithering_enable);
+      const SWRenderState state = GetRenderState();
 
       std::array<SWVertex, 2> vertices = {};
       u32 buffer_pos = 0;
@@ -342,7 +1137,36 @@ void GPU_SW::DispatchRenderCommand()
 
         // down here because of the FIFO pops
         if (IsDrawingAreaIsValid())
-          (this->*DrawFunction)(p0, p1);
+        {
+          // TODO: Move to base class
+          const s32 min_x = std::min(p0->x, p1->x);
+          const s32 max_x = std::max(p0->x, p1->x);
+          const s32 min_y = std::min(p0->y, p1->y);
+          const s32 max_y = std::max(p0->y, p1->y);
+
+          const u32 clip_left = static_cast<u32>(std::clamp<s32>(min_x, m_drawing_area.left, m_drawing_area.left));
+          const u32 clip_right =
+            static_cast<u32>(std::clamp<s32>(max_x, m_drawing_area.left, m_drawing_area.right)) + 1u;
+          const u32 clip_top = static_cast<u32>(std::clamp<s32>(min_y, m_drawing_area.top, m_drawing_area.bottom));
+          const u32 clip_bottom =
+            static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
+          AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, shaded);
+
+          // The line can land a pixel outside of its end points due to rounding.
+          const Common::Rectangle<u32> write_rect =
+            GetPrimitiveWriteRect(min_x + m_drawing_offset.x - 1, min_y + m_drawing_offset.y - 1,
+                                  max_x + m_drawing_offset.x + 1, max_y + m_drawing_offset.y + 1);
+          CheckForRenderThreadHazards(write_rect, false);
+          MarkVRAMDirty(write_rect);
+
+          SWCommand cmd;
+          cmd.type = SWCommandType::DrawLine;
+          cmd.state = state;
+          cmd.draw_line = DrawFunction;
+          cmd.vertices[0] = *p0;
+          cmd.vertices[1] = *p1;
+          QueueCommand(std::move(cmd));
+        }
 
         // swap p0/p1 so that the last vertex is used as the first for the next line
         std::swap(p0, p1);
@@ -395,30 +1219,118 @@ static constexpr bool IsTopLeftEdge(s32 ex, s32 ey)
   return (ey < 0 || (ey == 0 && ex < 0));
 }
 
-static constexpr u8 Interpolate(u8 v0, u8 v1, u8 v2, s32 w0, s32 w1, s32 w2, s32 ws, s32 half_ws)
+/// Narrows [min_k, max_k] to the pixel offsets along a line where an edge function starting at w and increasing by a
+/// for each pixel is not negative. Returns false if there are none.
+static ALWAYS_INLINE bool ClipSpanToEdge(s32 w, s32 a, s32& min_k, s32& max_k)
 {
-  const s32 v = w0 * static_cast<s32>(static_cast<u32>(v0)) + w1 * static_cast<s32>(static_cast<u32>(v1)) +
-                w2 * static_cast<s32>(static_cast<u32>(v2));
-  const s32 vd = (v + half_ws) / ws;
-  return (vd < 0) ? 0 : ((vd > 0xFF) ? 0xFF : static_cast<u8>(vd));
+  if (a > 0)
+  {
+    if (w < 0)
+      min_k = std::max(min_k, (-w + a - 1) / a);
+  }
+  else if (a < 0)
+  {
+    if (w < 0)
+      return false;
+
+    max_k = std::min(max_k, w / -a);
+  }
+  else if (w < 0)
+  {
+    return false;
+  }
+
+  return min_k <= max_k;
 }
 
-template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
-         bool dithering_enable>
-void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2)
+/// A vertex attribute which is stepped along a line of a triangle. The value is kept as a quotient and remainder of the
+/// triangle area, so that stepping produces exactly the same result as dividing the weighted sum of the vertex
+/// attributes by the area at every pixel.
+struct TriangleAttribute
 {
-#define orient2d(ax, ay, bx, by, cx, cy) ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax))
+  s32 value;
+  s32 remainder;
+  s32 step_value;
+  s32 step_remainder;
 
-  // ensure the vertices follow a counter-clockwise order
-  if (IsClockwiseWinding(v0, v1, v2))
-    std::swap(v1, v2);
+  /// Sets up stepping by step (sum of per-pixel edge function increments multiplied by the vertex attributes).
+  ALWAYS_INLINE void SetStep(s32 step, s32 ws)
+  {
+    step_value = step / ws;
+    step_remainder = step % ws;
+    if (step_remainder < 0)
+    {
+      step_remainder += ws;
+      step_value--;
+    }
+  }
+
+  /// Starts at the specified weighted sum, which can't be negative for a pixel inside the triangle. The sum can exceed
+  /// 32 bits for large upscaled triangles, but the quotient and remainder can't.
+  ALWAYS_INLINE void SetValue(s64 weighted_sum, s32 ws)
+  {
+    value = static_cast<s32>(weighted_sum / ws);
+    remainder = static_cast<s32>(weighted_sum % ws);
+  }
+
+  ALWAYS_INLINE void Step(s32 ws)
+  {
+    value += step_value;
+    remainder += step_remainder;
+    if (remainder >= ws)
+    {
+      remainder -= ws;
+      value++;
+    }
+  }
+};
 
+void GPU_SW::AddTriangleTicks(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2, bool shaded, bool textured,
+                              bool semitransparent)
+{
+  // Must match the rejection and clipping in DrawTriangle().
   const s32 px0 = v0->x + m_drawing_offset.x;
   const s32 py0 = v0->y + m_drawing_offset.y;
   const s32 px1 = v1->x + m_drawing_offset.x;
   const s32 py1 = v1->y + m_drawing_offset.y;
   const s32 px2 = v2->x + m_drawing_offset.x;
   const s32 py2 = v2->y + m_drawing_offset.y;
+  if (((px1 - px0) * (py2 - py0) - (py1 - py0) * (px2 - px0)) == 0)
+    return;
+
+  s32 min_x = std::min(px0, std::min(px1, px2));
+  s32 max_x = std::max(px0, std::max(px1, px2));
+  s32 min_y = std::min(py0, std::min(py1, py2));
+  s32 max_y = std::max(py0, std::max(py1, py2));
+  if (static_cast<u32>(max_x - min_x) > MAX_PRIMITIVE_WIDTH || static_cast<u32>(max_y - min_y) > MAX_PRIMITIVE_HEIGHT)
+    return;
+
+  min_x = std::clamp(min_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
+  max_x = std::clamp(max_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
+  min_y = std::clamp(min_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
+  max_y = std::clamp(max_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
+  AddDrawTriangleTicks(max_x - min_x + 1, max_y - min_y + 1, shaded, textured, semitransparent);
+}
+
+template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+         bool dithering_enable>
+void GPU_SW::DrawTriangle(const SWDrawContext& ctx, const SWVertex* v0, const SWVertex* v1, const SWVertex* v2)
+{
+  const SWRenderState& state = *ctx.state;
+#define orient2d(ax, ay, bx, by, cx, cy) ((bx - ax) * (cy - ay) - (by - ay) * (cx - ax))
+
+  // ensure the vertices follow a counter-clockwise order
+  if (IsClockwiseWinding(v0, v1, v2))
+    std::swap(v1, v2);
+
+  // vertex positions in the resolution of the target, all of the setup below works at any scale
+  const s32 scale = static_cast<s32>(ctx.scale);
+  const s32 px0 = (v0->x + state.drawing_offset.x) * scale;
+  const s32 py0 = (v0->y + state.drawing_offset.y) * scale;
+  const s32 px1 = (v1->x + state.drawing_offset.x) * scale;
+  const s32 py1 = (v1->y + state.drawing_offset.y) * scale;
+  const s32 px2 = (v2->x + state.drawing_offset.x) * scale;
+  const s32 py2 = (v2->y + state.drawing_offset.y) * scale;
 
   // Barycentric coordinates at minX/minY corner
   const s32 ws = orient2d(px0, py0, px1, py1, px2, py2);
@@ -433,15 +1345,21 @@ void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex
   s32 max_y = std::max(py0, std::max(py1, py2));
 
   // reject triangles which cover the whole vram area
-  if (static_cast<u32>(max_x - min_x) > MAX_PRIMITIVE_WIDTH || static_cast<u32>(max_y - min_y) > MAX_PRIMITIVE_HEIGHT)
+  if (static_cast<u32>(max_x - min_x) > (MAX_PRIMITIVE_WIDTH * ctx.scale) ||
+      static_cast<u32>(max_y - min_y) > (MAX_PRIMITIVE_HEIGHT * ctx.scale))
+  {
     return;
+  }
 
-  // clip to drawing area
-  min_x = std::clamp(min_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
-  max_x = std::clamp(max_x, static_cast<s32>(m_drawing_area.left), static_cast<s32>(m_drawing_area.right));
-  min_y = std::clamp(min_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
-  max_y = std::clamp(max_y, static_cast<s32>(m_drawing_area.top), static_cast<s32>(m_drawing_area.bottom));
-  AddDrawTriangleTicks(max_x - min_x + 1, max_y - min_y + 1, shading_enable, texture_enable, transparency_enable);
+  // clip to drawing area, the right and bottom edges are inclusive
+  const s32 clip_left = static_cast<s32>(state.drawing_area.left) * scale;
+  const s32 clip_right = static_cast<s32>(state.drawing_area.right) * scale + (scale - 1);
+  const s32 clip_top = static_cast<s32>(state.drawing_area.top) * scale;
+  const s32 clip_bottom = static_cast<s32>(state.drawing_area.bottom) * scale + (scale - 1);
+  min_x = std::clamp(min_x, clip_left, clip_right);
+  max_x = std::clamp(max_x, clip_left, clip_right);
+  min_y = std::clamp(min_y, clip_top, clip_bottom);
+  max_y = std::clamp(max_y, clip_top, clip_bottom);
 
   // compute per-pixel increments
   const s32 a01 = py0 - py1, b01 = px1 - px0;
@@ -458,38 +1376,92 @@ void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex
   s32 w1 = orient2d(px2, py2, px0, py0, min_x, min_y);
   s32 w2 = orient2d(px0, py0, px1, py1, min_x, min_y);
 
+  // Every pixel inside the triangle has non-negative barycentric coordinates which sum to ws, so interpolated values
+  // always lie between those of the vertices, and can be stepped along the line without dividing.
+  TriangleAttribute attr_r, attr_g, attr_b, attr_u, attr_v;
+#define attribute_step(attr) (a12 * s32(v0->attr) + a20 * s32(v1->attr) + a01 * s32(v2->attr))
+#define attribute_sum(attr, b0, b1, b2)                                                                                \
+  (s64(b0) * s32(v0->attr) + s64(b1) * s32(v1->attr) + s64(b2) * s32(v2->attr) + half_ws)
+  if constexpr (shading_enable)
+  {
+    attr_r.SetStep(attribute_step(color_r), ws);
+    attr_g.SetStep(attribute_step(color_g), ws);
+    attr_b.SetStep(attribute_step(color_b), ws);
+  }
+  if constexpr (texture_enable)
+  {
+    attr_u.SetStep(attribute_step(texcoord_x), ws);
+    attr_v.SetStep(attribute_step(texcoord_y), ws);
+  }
+
+  SWSpan span = {};
+
   // *exclusive* of max coordinate in PSX
   for (s32 y = min_y; y <= max_y; y++)
   {
-    s32 row_w0 = w0;
-    s32 row_w1 = w1;
-    s32 row_w2 = w2;
+    s32 min_k = 0;
+    s32 max_k = max_x - min_x;
 
-    for (s32 x = min_x; x <= max_x; x++)
+    // skip rows which another render thread is drawing, and find the pixels on this row which are inside every edge
+    if (ctx.IsLineInBand(static_cast<u32>(y)) && ClipSpanToEdge(w0 + w0_bias, a12, min_k, max_k) &&
+        ClipSpanToEdge(w1 + w1_bias, a20, min_k, max_k) && ClipSpanToEdge(w2 + w2_bias, a01, min_k, max_k))
     {
-      if (((row_w0 + w0_bias) | (row_w1 + w1_bias) | (row_w2 + w2_bias)) >= 0)
+      const s32 b0 = w0 + a12 * min_k;
+      const s32 b1 = w1 + a20 * min_k;
+      const s32 b2 = w2 + a01 * min_k;
+      if constexpr (shading_enable)
+      {
+        attr_r.SetValue(attribute_sum(color_r, b0, b1, b2), ws);
+        attr_g.SetValue(attribute_sum(color_g, b0, b1, b2), ws);
+        attr_b.SetValue(attribute_sum(color_b, b0, b1, b2), ws);
+      }
+      if constexpr (texture_enable)
+      {
+        attr_u.SetValue(attribute_sum(texcoord_x, b0, b1, b2), ws);
+        attr_v.SetValue(attribute_sum(texcoord_y, b0, b1, b2), ws);
+      }
+
+      span.y = static_cast<u32>(y);
+      span.x = static_cast<u32>(min_x + min_k);
+      span.count = 0;
+
+      for (s32 k = min_k; k <= max_k; k++)
       {
-        const s32 b0 = row_w0;
-        const s32 b1 = row_w1;
-        const s32 b2 = row_w2;
-
-        const u8 r =
-          shading_enable ? Interpolate(v0->color_r, v1->color_r, v2->color_r, b0, b1, b2, ws, half_ws) : v0->color_r;
-        const u8 g =
-          shading_enable ? Interpolate(v0->color_g, v1->color_g, v2->color_g, b0, b1, b2, ws, half_ws) : v0->color_g;
-        const u8 b =
-          shading_enable ? Interpolate(v0->color_b, v1->color_b, v2->color_b, b0, b1, b2, ws, half_ws) : v0->color_b;
-
-        const u8 texcoord_x = Interpolate(v0->texcoord_x, v1->texcoord_x, v2->texcoord_x, b0, b1, b2, ws, half_ws);
-        const u8 texcoord_y = Interpolate(v0->texcoord_y, v1->texcoord_y, v2->texcoord_y, b0, b1, b2, ws, half_ws);
-
-        ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
+        const u32 i = span.count++;
+        if constexpr (shading_enable)
+        {
+          span.color_r[i] = static_cast<u16>(attr_r.value);
+          span.color_g[i] = static_cast<u16>(attr_g.value);
+          span.color_b[i] = static_cast<u16>(attr_b.value);
+          attr_r.Step(ws);
+          attr_g.Step(ws);
+          attr_b.Step(ws);
+        }
+        else
+        {
+          span.color_r[i] = v0->color_r;
+          span.color_g[i] = v0->color_g;
+          span.color_b[i] = v0->color_b;
+        }
+
+        if constexpr (texture_enable)
+        {
+          span.texcoord_x[i] = Truncate8(attr_u.value);
+          span.texcoord_y[i] = Truncate8(attr_v.value);
+          attr_u.Step(ws);
+          attr_v.Step(ws);
+        }
+
+        if (span.count == SWSpan::MAX_PIXELS)
+        {
+          ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(ctx, span);
+          span.x += span.count;
+          span.count = 0;
+        }
       }
 
-      row_w0 += a12;
-      row_w1 += a20;
-      row_w2 += a01;
+      if (span.count > 0)
+        ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(ctx, span);
     }
 
     w0 += b12;
@@ -497,6 +1469,8 @@ void GPU_SW::DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex
     w2 += b01;
   }
 
+#undef attribute_sum
+#undef attribute_step
 #undef orient2d
 }
 
@@ -532,42 +1506,89 @@ GPU_SW::DrawTriangleFunction GPU_SW::GetDrawTriangleFunction(bool shading_enable
 }
 
 template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW::DrawRectangle(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x,
-                           u8 origin_texcoord_y)
+void GPU_SW::DrawRectangle(const SWDrawContext& ctx, s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g,
+                           u8 b, u8 origin_texcoord_x, u8 origin_texcoord_y)
 {
-  const s32 start_x = TruncateVertexPosition(m_drawing_offset.x + origin_x);
-  const s32 start_y = TruncateVertexPosition(m_drawing_offset.y + origin_y);
+  const SWRenderState& state = *ctx.state;
+  const s32 start_x = TruncateVertexPosition(state.drawing_offset.x + origin_x);
+  const s32 start_y = TruncateVertexPosition(state.drawing_offset.y + origin_y);
+
+  // Clip horizontally up front, each row is a single span.
+  const s32 clip_left = std::max(start_x, static_cast<s32>(state.drawing_area.left));
+  const s32 clip_right = std::min(start_x + static_cast<s32>(width) - 1, static_cast<s32>(state.drawing_area.right));
+  if (clip_left > clip_right)
+    return;
+
+  // When upscaling, each pixel of the rectangle is drawn as a block of scale x scale pixels with the same texcoord.
+  const u32 scale = ctx.scale;
 
+  if constexpr (!texture_enable && !transparency_enable)
   {
-    const u32 clip_left = static_cast<u32>(std::clamp<s32>(start_x, m_drawing_area.left, m_drawing_area.right));
-    const u32 clip_right =
-      static_cast<u32>(std::clamp<s32>(start_x + static_cast<s32>(width), m_drawing_area.left, m_drawing_area.right)) +
-      1u;
-    const u32 clip_top = static_cast<u32>(std::clamp<s32>(start_y, m_drawing_area.top, m_drawing_area.bottom));
-    const u32 clip_bottom =
-      static_cast<u32>(std::clamp<s32>(start_y + static_cast<s32>(height), m_drawing_area.top, m_drawing_area.bottom)) +
-      1u;
-    AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, texture_enable, transparency_enable);
+    // Opaque flat rectangles don't need to read VRAM unless the mask bit is checked, so each row is a solid run.
+    // Rectangles aren't dithered, which leaves the color truncated to 5 bits per channel.
+    if (state.mask_and == 0)
+    {
+      const u16 color16 = static_cast<u16>((ZeroExtend32(r) >> 3) | ((ZeroExtend32(g) >> 3) << 5) |
+                                           ((ZeroExtend32(b) >> 3) << 10) | state.mask_or);
+      const u32 run_width = static_cast<u32>(clip_right - clip_left + 1) * scale;
+      for (u32 offset_y = 0; offset_y < height; offset_y++)
+      {
+        const s32 y = start_y + static_cast<s32>(offset_y);
+        if (y < static_cast<s32>(state.drawing_area.top) || y > static_cast<s32>(state.drawing_area.bottom))
+          continue;
+
+        for (u32 line = static_cast<u32>(y) * scale; line < (static_cast<u32>(y) + 1) * scale; line++)
+        {
+          if (ctx.IsLineInBand(line) && !ctx.IsInterlacedLineSkipped(line))
+            std::fill_n(ctx.GetPixelPtr(static_cast<u32>(clip_left) * scale, line), run_width, color16);
+        }
+      }
+
+      return;
+    }
   }
 
+  SWSpan span = {};
   for (u32 offset_y = 0; offset_y < height; offset_y++)
   {
     const s32 y = start_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom))
+    if (y < static_cast<s32>(state.drawing_area.top) || y > static_cast<s32>(state.drawing_area.bottom))
       continue;
 
     const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
 
-    for (u32 offset_x = 0; offset_x < width; offset_x++)
+    for (u32 line = static_cast<u32>(y) * scale; line < (static_cast<u32>(y) + 1) * scale; line++)
     {
-      const s32 x = start_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
+      if (!ctx.IsLineInBand(line))
         continue;
 
-      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
+      span.y = line;
+      span.count = 0;
+      for (s32 x = clip_left; x <= clip_right; x++)
+      {
+        const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + static_cast<u32>(x - start_x));
+        for (u32 column = static_cast<u32>(x) * scale; column < (static_cast<u32>(x) + 1) * scale; column++)
+        {
+          if (span.count == 0)
+            span.x = column;
+
+          const u32 i = span.count++;
+          span.color_r[i] = r;
+          span.color_g[i] = g;
+          span.color_b[i] = b;
+          span.texcoord_x[i] = texcoord_x;
+          span.texcoord_y[i] = texcoord_y;
+
+          if (span.count == SWSpan::MAX_PIXELS)
+          {
+            ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, false>(ctx, span);
+            span.count = 0;
+          }
+        }
+      }
 
-      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
-        static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
+      if (span.count > 0)
+        ShadeSpan<texture_enable, raw_texture_enable, transparency_enable, false>(ctx, span);
     }
   }
 }
@@ -591,56 +1612,62 @@ constexpr GPU_SW::DitherLUT GPU_SW::ComputeDitherLUT()
 
 static constexpr GPU_SW::DitherLUT s_dither_lut = GPU_SW::ComputeDitherLUT();
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+ALWAYS_INLINE u16 GPU_SW::ReadTexel(const SWRenderState& state, u8 texcoord_x, u8 texcoord_y) const
 {
-  VRAMPixel color;
-  bool transparent;
-  if constexpr (texture_enable)
+  switch (state.texture_mode)
   {
-    // Apply texture window
-    // TODO: Precompute the second half
-    texcoord_x = (texcoord_x & ~(m_draw_mode.texture_window_mask_x * 8u)) |
-                 ((m_draw_mode.texture_window_offset_x & m_draw_mode.texture_window_mask_x) * 8u);
-    texcoord_y = (texcoord_y & ~(m_draw_mode.texture_window_mask_y * 8u)) |
-                 ((m_draw_mode.texture_window_offset_y & m_draw_mode.texture_window_mask_y) * 8u);
+    case GPU::TextureMode::Palette4Bit:
+    {
+      const u16 palette_value =
+        GetPixel(std::min<u32>(state.texture_page_x + ZeroExtend32(texcoord_x / 4), VRAM_WIDTH - 1),
+                 std::min<u32>(state.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      return GetPixel(std::min<u32>(state.texture_palette_x + ZeroExtend32(palette_index), VRAM_WIDTH - 1),
+                      state.texture_palette_y);
+    }
 
-    VRAMPixel texture_color;
-    switch (m_draw_mode.GetTextureMode())
+    case GPU::TextureMode::Palette8Bit:
     {
-      case GPU::TextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel(std::min<u32>(m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x / 4), VRAM_WIDTH - 1),
-                   std::min<u32>(m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
-        texture_color.bits =
-          GetPixel(std::min<u32>(m_draw_mode.texture_palette_x + ZeroExtend32(palette_index), VRAM_WIDTH - 1),
-                   m_draw_mode.texture_palette_y);
-      }
-      break;
+      const u16 palette_value =
+        GetPixel(std::min<u32>(state.texture_page_x + ZeroExtend32(texcoord_x / 2), VRAM_WIDTH - 1),
+                 std::min<u32>(state.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel(std::min<u32>(state.texture_palette_x + ZeroExtend32(palette_index), VRAM_WIDTH - 1),
+                      state.texture_palette_y);
+    }
 
-      case GPU::TextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel(std::min<u32>(m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x / 2), VRAM_WIDTH - 1),
-                   std::min<u32>(m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel(std::min<u32>(m_draw_mode.texture_palette_x + ZeroExtend32(palette_index), VRAM_WIDTH - 1),
-                   m_draw_mode.texture_palette_y);
-      }
-      break;
+    default:
+      return GetPixel(std::min<u32>(state.texture_page_x + ZeroExtend32(texcoord_x), VRAM_WIDTH - 1),
+                      std::min<u32>(state.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
+  }
+}
 
-      default:
-      {
-        texture_color.bits =
-          GetPixel(std::min<u32>(m_draw_mode.texture_page_x + ZeroExtend32(texcoord_x), VRAM_WIDTH - 1),
-                   std::min<u32>(m_draw_mode.texture_page_y + ZeroExtend32(texcoord_y), VRAM_HEIGHT - 1));
-      }
-      break;
-    }
+ALWAYS_INLINE u16 GPU_SW::GetTexel(const SWRenderState& state, u8 texcoord_x, u8 texcoord_y) const
+{
+  // Apply texture window
+  // TODO: Precompute the second half
+  texcoord_x = (texcoord_x & ~(state.texture_window_mask_x * 8u)) |
+               ((state.texture_window_offset_x & state.texture_window_mask_x) * 8u);
+  texcoord_y = (texcoord_y & ~(state.texture_window_mask_y * 8u)) |
+               ((state.texture_window_offset_y & state.texture_window_mask_y) * 8u);
+
+  if (state.texture_cache_page)
+    return state.texture_cache_page[ZeroExtend32(texcoord_y) * TEXTURE_PAGE_WIDTH + ZeroExtend32(texcoord_x)];
+
+  return ReadTexel(state, texcoord_x, texcoord_y);
+}
 
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void GPU_SW::ShadePixel(const SWDrawContext& ctx, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
+                        u8 texcoord_y)
+{
+  const SWRenderState& state = *ctx.state;
+  VRAMPixel color;
+  bool transparent;
+  if constexpr (texture_enable)
+  {
+    VRAMPixel texture_color;
+    texture_color.bits = GetTexel(state, texcoord_x, texcoord_y);
     if (texture_color.bits == 0)
       return;
 
@@ -652,8 +1679,8 @@ void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 tex
     }
     else
     {
-      const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-      const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+      const u32 dither_y = (dithering_enable) ? ((y / ctx.dither_scale) & 3u) : 2u;
+      const u32 dither_x = (dithering_enable) ? ((x / ctx.dither_scale) & 3u) : 3u;
 
       color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.r) * u16(color_r)) >> 4]) << 0) |
                    (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.g) * u16(color_g)) >> 4]) << 5) |
@@ -665,15 +1692,16 @@ void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 tex
   {
     transparent = true;
 
-    const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-    const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+    const u32 dither_y = (dithering_enable) ? ((y / ctx.dither_scale) & 3u) : 2u;
+    const u32 dither_x = (dithering_enable) ? ((x / ctx.dither_scale) & 3u) : 3u;
 
     color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_r]) << 0) |
                  (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_g]) << 5) |
                  (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_b]) << 10);
   }
 
-  const VRAMPixel bg_color{GetPixel(static_cast<u32>(x), static_cast<u32>(y))};
+  u16* pixel_ptr = ctx.GetPixelPtr(x, y);
+  const VRAMPixel bg_color{*pixel_ptr};
   if constexpr (transparency_enable)
   {
     if (transparent)
@@ -687,7 +1715,7 @@ void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 tex
   color.Set(func(bg_color.r.GetValue(), color.r.GetValue()), func(bg_color.g.GetValue(), color.g.GetValue()),          \
             func(bg_color.b.GetValue(), color.b.GetValue()), color.c.GetValue())
 
-      switch (m_draw_mode.GetTransparencyMode())
+      switch (state.transparency_mode)
       {
         case GPU::TransparencyMode::HalfBackgroundPlusHalfForeground:
           BLEND_RGB(BLEND_AVERAGE);
@@ -718,14 +1746,218 @@ void GPU_SW::ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 tex
     UNREFERENCED_VARIABLE(transparent);
   }
 
-  const u16 mask_and = m_GPUSTAT.GetMaskAND();
+  const u16 mask_and = state.mask_and;
   if ((bg_color.bits & mask_and) != 0)
     return;
 
-  if (IsInterlacedRenderingEnabled() && GetActiveLineLSB() == (static_cast<u32>(y) & 1u))
+  if (ctx.IsInterlacedLineSkipped(y))
+    return;
+
+  *pixel_ptr = color.bits | state.mask_or;
+}
+
+GPU_SW::ShadePixelFunction GPU_SW::GetShadePixelFunction(bool texture_enable, bool raw_texture_enable,
+                                                         bool transparency_enable, bool dithering_enable)
+{
+#define F(TEXTURE, RAW_TEXTURE, TRANSPARENCY, DITHERING)                                                               \
+  &GPU_SW::ShadePixel<TEXTURE, RAW_TEXTURE, TRANSPARENCY, DITHERING>
+
+  static constexpr ShadePixelFunction funcs[2][2][2][2] = {
+    {{{F(false, false, false, false), F(false, false, false, true)},
+      {F(false, false, true, false), F(false, false, true, true)}},
+     {{F(false, true, false, false), F(false, true, false, true)},
+      {F(false, true, true, false), F(false, true, true, true)}}},
+    {{{F(true, false, false, false), F(true, false, false, true)},
+      {F(true, false, true, false), F(true, false, true, true)}},
+     {{F(true, true, false, false), F(true, true, false, true)},
+      {F(true, true, true, false), F(true, true, true, true)}}}};
+
+#undef F
+
+  return funcs[u8(texture_enable)][u8(raw_texture_enable)][u8(transparency_enable)][u8(dithering_enable)];
+}
+
+#ifdef GPU_SW_SIMD
+
+using DitherOffsets = std::array<std::array<s16, GPU::DITHER_MATRIX_SIZE + SWVector::NUM_LANES>, GPU::DITHER_MATRIX_SIZE>;
+
+// Each row of the dither matrix repeated, so that a vector's worth can be loaded starting at any column.
+static constexpr DitherOffsets ComputeDitherOffsets()
+{
+  DitherOffsets offsets = {};
+  for (u32 i = 0; i < GPU::DITHER_MATRIX_SIZE; i++)
+  {
+    for (u32 j = 0; j < GPU::DITHER_MATRIX_SIZE + SWVector::NUM_LANES; j++)
+      offsets[i][j] = static_cast<s16>(GPU::DITHER_MATRIX[i][j % GPU::DITHER_MATRIX_SIZE]);
+  }
+  return offsets;
+}
+
+static constexpr DitherOffsets s_dither_offsets = ComputeDitherOffsets();
+
+// ShadePixel() uses this entry of the LUT when dithering is disabled, so it can be replaced with a zero offset.
+static_assert(GPU::DITHER_MATRIX[2][3] == 0, "no-dither entry has no offset");
+
+/// Vector equivalent of s_dither_lut, value must be <= DITHER_LUT_SIZE.
+ALWAYS_INLINE static SWVector DitherVector(const SWVector& value, const SWVector& offsets)
+{
+  return (value + offsets).ShiftRightArithmetic<3>().MaxSigned(SWVector::Zero()).MinSigned(SWVector::Broadcast(0x1F));
+}
+
+ALWAYS_INLINE static SWVector BlendVector(GPU::TransparencyMode mode, const SWVector& bg, const SWVector& fg)
+{
+  const SWVector channel_mask = SWVector::Broadcast(0x1F);
+  const SWVector bg_r = bg & channel_mask;
+  const SWVector bg_g = bg.ShiftRightLogical<5>() & channel_mask;
+  const SWVector bg_b = bg.ShiftRightLogical<10>() & channel_mask;
+  const SWVector fg_r = fg & channel_mask;
+  const SWVector fg_g = fg.ShiftRightLogical<5>() & channel_mask;
+  const SWVector fg_b = fg.ShiftRightLogical<10>() & channel_mask;
+
+  SWVector r, g, b;
+  switch (mode)
+  {
+    case GPU::TransparencyMode::HalfBackgroundPlusHalfForeground:
+    {
+      // Can't exceed 0x1F, so no clamping is needed.
+      r = bg_r.ShiftRightLogical<1>() + fg_r.ShiftRightLogical<1>();
+      g = bg_g.ShiftRightLogical<1>() + fg_g.ShiftRightLogical<1>();
+      b = bg_b.ShiftRightLogical<1>() + fg_b.ShiftRightLogical<1>();
+    }
+    break;
+
+    case GPU::TransparencyMode::BackgroundPlusForeground:
+    {
+      r = (bg_r + fg_r).MinSigned(channel_mask);
+      g = (bg_g + fg_g).MinSigned(channel_mask);
+      b = (bg_b + fg_b).MinSigned(channel_mask);
+    }
+    break;
+
+    case GPU::TransparencyMode::BackgroundMinusForeground:
+    {
+      r = bg_r.SubSaturateUnsigned(fg_r);
+      g = bg_g.SubSaturateUnsigned(fg_g);
+      b = bg_b.SubSaturateUnsigned(fg_b);
+    }
+    break;
+
+    case GPU::TransparencyMode::BackgroundPlusQuarterForeground:
+    {
+      r = (bg_r + fg_r.ShiftRightLogical<2>()).MinSigned(channel_mask);
+      g = (bg_g + fg_g.ShiftRightLogical<2>()).MinSigned(channel_mask);
+      b = (bg_b + fg_b.ShiftRightLogical<2>()).MinSigned(channel_mask);
+    }
+    break;
+
+    default:
+      return fg;
+  }
+
+  return r | g.ShiftLeft<5>() | b.ShiftLeft<10>() | (fg & SWVector::Broadcast(0x8000));
+}
+
+#endif
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+void GPU_SW::ShadeSpan(const SWDrawContext& ctx, const SWSpan& span)
+{
+#ifdef GPU_SW_SIMD
+  const SWRenderState& state = *ctx.state;
+  if (ctx.IsInterlacedLineSkipped(span.y))
     return;
 
-  SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | m_GPUSTAT.GetMaskOR());
+  // Texture fetches can't be vectorized, but everything after them can.
+  std::array<u16, SWSpan::MAX_PIXELS> texels;
+  if constexpr (texture_enable)
+  {
+    for (u32 i = 0; i < span.count; i++)
+      texels[i] = GetTexel(state, span.texcoord_x[i], span.texcoord_y[i]);
+    for (u32 i = span.count; i < Common::AlignUpPow2(span.count, SWVector::NUM_LANES); i++)
+      texels[i] = 0;
+  }
+
+  const SWVector zero = SWVector::Zero();
+  const SWVector channel_mask = SWVector::Broadcast(0x1F);
+  const SWVector semitransparent_bit = SWVector::Broadcast(0x8000);
+  const SWVector mask_and = SWVector::Broadcast(state.mask_and);
+  const SWVector mask_or = SWVector::Broadcast(state.mask_or);
+
+  // The dither pattern repeats every four pixels, so it's the same for every group of pixels in the span, unless it's
+  // being stretched to the resolution scale.
+  const u32 dither_y = (span.y / ctx.dither_scale) & 3u;
+  SWVector dither_offsets =
+    dithering_enable ? SWVector::Load(&s_dither_offsets[dither_y][span.x & 3u]) : SWVector::Zero();
+
+  u16* row = ctx.GetPixelPtr(0, span.y);
+  for (u32 i = 0; i < span.count; i += SWVector::NUM_LANES)
+  {
+    if (dithering_enable && ctx.dither_scale > 1)
+    {
+      std::array<s16, SWVector::NUM_LANES> offsets;
+      for (u32 lane = 0; lane < SWVector::NUM_LANES; lane++)
+        offsets[lane] = s_dither_offsets[dither_y][((span.x + i + lane) / ctx.dither_scale) & 3u];
+      dither_offsets = SWVector::Load(offsets.data());
+    }
+
+    // The last group of pixels can be partial, go through a temporary buffer so we don't touch pixels past the end.
+    const u32 num_pixels = std::min<u32>(span.count - i, SWVector::NUM_LANES);
+    std::array<u16, SWVector::NUM_LANES> partial_pixels;
+    u16* pixels = &row[span.x + i];
+    if (num_pixels < SWVector::NUM_LANES)
+    {
+      std::copy_n(pixels, num_pixels, partial_pixels.begin());
+      pixels = partial_pixels.data();
+    }
+
+    const SWVector bg_color = SWVector::Load(pixels);
+    SWVector write_mask = (bg_color & mask_and).Equal(zero);
+    SWVector color;
+    SWVector transparent_mask;
+    if constexpr (texture_enable)
+    {
+      const SWVector texture_color = SWVector::Load(&texels[i]);
+      const SWVector texture_bit15 = texture_color & semitransparent_bit;
+      write_mask = write_mask.AndNot(texture_color.Equal(zero));
+      transparent_mask = texture_bit15.Equal(semitransparent_bit);
+
+      if constexpr (raw_texture_enable)
+      {
+        color = texture_color;
+      }
+      else
+      {
+        const SWVector r = (texture_color & channel_mask) * SWVector::Load(&span.color_r[i]);
+        const SWVector g = (texture_color.ShiftRightLogical<5>() & channel_mask) * SWVector::Load(&span.color_g[i]);
+        const SWVector b = (texture_color.ShiftRightLogical<10>() & channel_mask) * SWVector::Load(&span.color_b[i]);
+        color = DitherVector(r.ShiftRightLogical<4>(), dither_offsets) |
+                DitherVector(g.ShiftRightLogical<4>(), dither_offsets).ShiftLeft<5>() |
+                DitherVector(b.ShiftRightLogical<4>(), dither_offsets).ShiftLeft<10>() | texture_bit15;
+      }
+    }
+    else
+    {
+      color = DitherVector(SWVector::Load(&span.color_r[i]), dither_offsets) |
+              DitherVector(SWVector::Load(&span.color_g[i]), dither_offsets).ShiftLeft<5>() |
+              DitherVector(SWVector::Load(&span.color_b[i]), dither_offsets).ShiftLeft<10>();
+      transparent_mask = zero.Equal(zero);
+    }
+
+    if constexpr (transparency_enable)
+      color = SWVector::Select(transparent_mask, BlendVector(state.transparency_mode, bg_color, color), color);
+
+    SWVector::Select(write_mask, color | mask_or, bg_color).Store(pixels);
+    if (num_pixels < SWVector::NUM_LANES)
+      std::copy_n(partial_pixels.begin(), num_pixels, &row[span.x + i]);
+  }
+#else
+  for (u32 i = 0; i < span.count; i++)
+  {
+    ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
+      ctx, span.x + i, span.y, Truncate8(span.color_r[i]), Truncate8(span.color_g[i]), Truncate8(span.color_b[i]),
+      span.texcoord_x[i], span.texcoord_y[i]);
+  }
+#endif
 }
 
 constexpr FixedPointCoord GetLineCoordStep(s32 delta, s32 k)
@@ -750,8 +1982,9 @@ constexpr FixedPointColor GetLineColorStep(s32 delta, s32 k)
 }
 
 template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
+void GPU_SW::DrawLine(const SWDrawContext& ctx, const SWVertex* p0, const SWVertex* p1)
 {
+  const SWRenderState& state = *ctx.state;
   // Algorithm based on Mednafen.
   if (p0->x > p1->x)
     std::swap(p0, p1);
@@ -760,21 +1993,6 @@ void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
   const s32 dy = p1->y - p0->y;
   const s32 k = std::max(std::abs(dx), std::abs(dy));
 
-  {
-    // TODO: Move to base class
-    const s32 min_x = std::min(p0->x, p1->x);
-    const s32 max_x = std::max(p0->x, p1->x);
-    const s32 min_y = std::min(p0->y, p1->y);
-    const s32 max_y = std::max(p0->y, p1->y);
-
-    const u32 clip_left = static_cast<u32>(std::clamp<s32>(min_x, m_drawing_area.left, m_drawing_area.left));
-    const u32 clip_right = static_cast<u32>(std::clamp<s32>(max_x, m_drawing_area.left, m_drawing_area.right)) + 1u;
-    const u32 clip_top = static_cast<u32>(std::clamp<s32>(min_y, m_drawing_area.top, m_drawing_area.bottom));
-    const u32 clip_bottom = static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
-
-    AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, shading_enable);
-  }
-
   FixedPointCoord step_x, step_y;
   FixedPointColor step_r, step_g, step_b;
   if (k > 0)
@@ -812,18 +2030,25 @@ void GPU_SW::DrawLine(const SWVertex* p0, const SWVertex* p1)
 
   for (s32 i = 0; i <= k; i++)
   {
-    const s32 x = m_drawing_offset.x + FixedToIntCoord(current_x);
-    const s32 y = m_drawing_offset.y + FixedToIntCoord(current_y);
+    const s32 x = state.drawing_offset.x + FixedToIntCoord(current_x);
+    const s32 y = state.drawing_offset.y + FixedToIntCoord(current_y);
 
     const u8 r = shading_enable ? FixedColorToInt(current_r) : p0->color_r;
     const u8 g = shading_enable ? FixedColorToInt(current_g) : p0->color_g;
     const u8 b = shading_enable ? FixedColorToInt(current_b) : p0->color_b;
 
-    if (x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+    if (x >= static_cast<s32>(state.drawing_area.left) && x <= static_cast<s32>(state.drawing_area.right) &&
+        y >= static_cast<s32>(state.drawing_area.top) && y <= static_cast<s32>(state.drawing_area.bottom))
     {
-      ShadePixel<false, false, transparency_enable, dithering_enable>(static_cast<u32>(x), static_cast<u32>(y), r, g, b,
-                                                                      0, 0);
+      // When upscaling, each pixel of the line is drawn as a block of scale x scale pixels.
+      for (u32 line = static_cast<u32>(y) * ctx.scale; line < (static_cast<u32>(y) + 1) * ctx.scale; line++)
+      {
+        if (!ctx.IsLineInBand(line))
+          continue;
+
+        for (u32 column = static_cast<u32>(x) * ctx.scale; column < (static_cast<u32>(x) + 1) * ctx.scale; column++)
+          ShadePixel<false, false, transparency_enable, dithering_enable>(ctx, column, line, r, g, b, 0, 0);
+      }
     }
 
     current_x += step_x;
@@ -1,13 +1,20 @@
 #pragma once
 #include "gpu.h"
 #include <array>
+#include <atomic>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class HostDisplayTexture;
 
 class GPU_SW final : public GPU
 {
+  // Compares the span rasterizer against drawing pixel by pixel.
+  friend class GPU_SWRasterizerTest;
+
 public:
   GPU_SW();
   ~GPU_SW() override;
@@ -17,6 +24,7 @@ public:
   bool Initialize(HostDisplay* host_display, System* system, DMA* dma, InterruptController* interrupt_controller,
                   Timers* timers) override;
   void Reset() override;
+  void UpdateSettings() override;
 
   u16 GetPixel(u32 x, u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   const u16* GetPixelPtr(u32 x, u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
@@ -45,51 +53,349 @@ protected:
     ALWAYS_INLINE void SetTexcoord(u16 value) { std::tie(texcoord_x, texcoord_y) = UnpackTexcoord(value); }
   };
 
+  /// GPU state which affects rasterization, captured on the CPU thread when a command is queued.
+  struct SWRenderState
+  {
+    DrawingOffset drawing_offset;
+    Common::Rectangle<u32> drawing_area;
+    u32 texture_page_x;
+    u32 texture_page_y;
+    u32 texture_palette_x;
+    u32 texture_palette_y;
+    u8 texture_window_mask_x;
+    u8 texture_window_mask_y;
+    u8 texture_window_offset_x;
+    u8 texture_window_offset_y;
+    TextureMode texture_mode;
+    TransparencyMode transparency_mode;
+    u16 mask_and;
+    u16 mask_or;
+    bool interlaced_rendering;
+    u32 active_line_lsb;
+
+    // Decoded texture page to sample from instead of VRAM, if the primitive can use the texture cache.
+    const u16* texture_cache_page;
+  };
+
+  /// Where and which scanlines a rasterizer invocation draws. When a primitive is split between render threads, each
+  /// thread owns an interleaved set of bands, so every pixel is always written by the same thread in command order.
+  struct SWDrawContext
+  {
+    enum : u32
+    {
+      BAND_HEIGHT = 8
+    };
+
+    const SWRenderState* state;
+    u32 band_index;
+    u32 band_count;
+
+    // Buffer which is drawn to, either VRAM or the upscaled copy, where each VRAM pixel covers scale x scale pixels.
+    // Coordinates passed to the methods below are in the buffer's resolution.
+    u16* pixels;
+    u32 stride;
+    u32 scale;
+    u32 dither_scale;
+
+    ALWAYS_INLINE bool IsLineInBand(u32 y) const { return ((y / BAND_HEIGHT) % band_count) == band_index; }
+    ALWAYS_INLINE u16* GetPixelPtr(u32 x, u32 y) const { return &pixels[y * stride + x]; }
+
+    /// Returns true if the line belongs to the field which is being displayed, and can't be drawn to.
+    ALWAYS_INLINE bool IsInterlacedLineSkipped(u32 y) const
+    {
+      return state->interlaced_rendering && state->active_line_lsb == ((y / scale) & 1u);
+    }
+  };
+
+  /// A run of horizontally adjacent pixels on one line which are shaded together by ShadeSpan().
+  struct SWSpan
+  {
+    enum : u32
+    {
+      MAX_PIXELS = 64
+    };
+
+    u32 x;
+    u32 y;
+    u32 count;
+
+    // Colors are stored as 16-bit so they can be loaded straight into vector lanes.
+    std::array<u16, MAX_PIXELS> color_r;
+    std::array<u16, MAX_PIXELS> color_g;
+    std::array<u16, MAX_PIXELS> color_b;
+    std::array<u8, MAX_PIXELS> texcoord_x;
+    std::array<u8, MAX_PIXELS> texcoord_y;
+  };
+
+  enum class SWCommandType : u8
+  {
+    DrawTriangle,
+    DrawRectangle,
+    DrawLine,
+    FillVRAM,
+    UpdateVRAM,
+    CopyVRAM,
+    DecodeTexturePage,
+
+    // Waits for all render threads to complete the preceding commands.
+    Barrier
+  };
+
   //////////////////////////////////////////////////////////////////////////
   // Scanout
   //////////////////////////////////////////////////////////////////////////
-  void CopyOut15Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width, u32 height, bool interlaced,
-                    bool interleaved);
-  void CopyOut24Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width, u32 height, bool interlaced,
-                    bool interleaved);
+  /// Converts pixels from VRAM to RGBA8, as RGBA5551ToRGBA8888() does, or from packed 24-bit.
+  static void ConvertRGBA5551Span(const u16* src_ptr, u32* dst_ptr, u32 count);
+  static void ConvertRGB888Span(const u8* src_ptr, u32* dst_ptr, u32 count);
+
+  /// Converts one line of the display area to RGBA8. src_x/width are in VRAM pixels, and lines wrap at the right edge.
+  void CopyOut15Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 width);
+  void CopyOut24Bit(u32 src_x, u32 src_y, u32* dst_ptr, u32 width);
+
+  /// Same as CopyOut15Bit(), but reads the scale lines covering the VRAM line from the upscaled copy of VRAM.
+  void CopyOut15BitScaled(u32 src_x, u32 src_y, u32* dst_ptr, u32 dst_stride, u32 width);
+
+  /// Converts the lines of the display area which have changed since they were last converted into the display
+  /// texture buffer. Returns false if there were none, otherwise the range of (unscaled) lines to upload.
+  bool CopyOut(u32 src_x, u32 src_y, u32 width, u32 height, bool interlaced, bool interleaved, u32 field, bool rgb24,
+               u32 scale, u32* first_line, u32* last_line);
+
+  /// Forces every line of the display to be converted again, e.g. when the display texture is recreated.
+  void InvalidateDisplayLines();
+
   void UpdateDisplay() override;
 
+  //////////////////////////////////////////////////////////////////////////
+  // VRAM Access
+  //////////////////////////////////////////////////////////////////////////
+  void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
+  void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color) override;
+  void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data) override;
+  void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Upscaling
+  //////////////////////////////////////////////////////////////////////////
+
+  /// Changes the resolution of the upscaled copy of VRAM, which is initialized from the current VRAM contents.
+  bool SetResolutionScale(u32 scale);
+
+  /// Copies an area of VRAM to the upscaled copy, duplicating each pixel.
+  void UpscaleVRAM(u32 x, u32 y, u32 width, u32 height);
+
+  // Equivalents of DoFillVRAM()/DoCopyVRAM() for the upscaled copy, coordinates are in VRAM pixels.
+  void FillScaledVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, bool interlaced, u32 active_field);
+  void CopyScaledVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, u16 mask_and, u16 mask_or);
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
 
   void DispatchRenderCommand() override;
 
+  SWRenderState GetRenderState() const;
+
+  /// Returns the area of VRAM which a primitive with the specified inclusive bounds (after the drawing offset) can
+  /// write to.
+  Common::Rectangle<u32> GetPrimitiveWriteRect(s32 min_x, s32 min_y, s32 max_x, s32 max_y) const;
+
+  /// Inserts a barrier if the next primitive reads or writes an area which a preceding primitive on another render
+  /// thread may still be writing or reading. Returns true if the primitive reads from the area it draws to, in which
+  /// case it can't be split between render threads.
+  bool CheckForRenderThreadHazards(const Common::Rectangle<u32>& write_rect, bool textured);
+  void AddTriangleTicks(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2, bool shaded, bool textured,
+                        bool semitransparent);
+
   static bool IsClockwiseWinding(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
 
+  /// Returns the texel at the specified texture coordinates, after applying the texture window and palette.
+  u16 GetTexel(const SWRenderState& state, u8 texcoord_x, u8 texcoord_y) const;
+
+  /// Reads the texel at the specified texture coordinates from VRAM, without applying the texture window.
+  u16 ReadTexel(const SWRenderState& state, u8 texcoord_x, u8 texcoord_y) const;
+
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-  void ShadePixel(u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y);
+  void ShadePixel(const SWDrawContext& ctx, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
+                  u8 texcoord_y);
+
+  using ShadePixelFunction = void (GPU_SW::*)(const SWDrawContext& ctx, u32 x, u32 y, u8 color_r, u8 color_g,
+                                              u8 color_b, u8 texcoord_x, u8 texcoord_y);
+  ShadePixelFunction GetShadePixelFunction(bool texture_enable, bool raw_texture_enable, bool transparency_enable,
+                                           bool dithering_enable);
+
+  /// Equivalent to calling ShadePixel() for each pixel in the span, but processes multiple pixels at once where the
+  /// host supports it.
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
+  void ShadeSpan(const SWDrawContext& ctx, const SWSpan& span);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
            bool dithering_enable>
-  void DrawTriangle(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
+  void DrawTriangle(const SWDrawContext& ctx, const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
 
-  using DrawTriangleFunction = void (GPU_SW::*)(const SWVertex* v0, const SWVertex* v1, const SWVertex* v2);
+  using DrawTriangleFunction = void (GPU_SW::*)(const SWDrawContext& ctx, const SWVertex* v0, const SWVertex* v1,
+                                                const SWVertex* v2);
   DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable, bool texture_enable, bool raw_texture_enable,
                                                bool transparency_enable, bool dithering_enable);
 
   template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x,
-                     u8 origin_texcoord_y);
+  void DrawRectangle(const SWDrawContext& ctx, s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b,
+                     u8 origin_texcoord_x, u8 origin_texcoord_y);
 
-  using DrawRectangleFunction = void (GPU_SW::*)(s32 origin_x, s32 origin_y, u32 width, u32 height, u8 r, u8 g, u8 b,
-                                                 u8 origin_texcoord_x, u8 origin_texcoord_y);
+  using DrawRectangleFunction = void (GPU_SW::*)(const SWDrawContext& ctx, s32 origin_x, s32 origin_y, u32 width,
+                                                 u32 height, u8 r, u8 g, u8 b, u8 origin_texcoord_x,
+                                                 u8 origin_texcoord_y);
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
   template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const SWVertex* p0, const SWVertex* p1);
+  void DrawLine(const SWDrawContext& ctx, const SWVertex* p0, const SWVertex* p1);
 
-  using DrawLineFunction = void (GPU_SW::*)(const SWVertex* p0, const SWVertex* p1);
+  using DrawLineFunction = void (GPU_SW::*)(const SWDrawContext& ctx, const SWVertex* p0, const SWVertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
+  //////////////////////////////////////////////////////////////////////////
+  // Texture Cache
+  //////////////////////////////////////////////////////////////////////////
+  static constexpr u32 TEXTURE_CACHE_SIZE = 16;
+  static constexpr u32 TEXTURE_CACHE_STRIP_HEIGHT = 16;
+
+  /// A texture page expanded through its palette to 16-bit texels. Pages are decoded in strips of rows as they are
+  /// needed, and strips are invalidated when the page or palette is written to.
+  struct TextureCacheEntry
+  {
+    std::array<u16, TEXTURE_PAGE_WIDTH * TEXTURE_PAGE_HEIGHT> texels;
+
+    // Everything below is only used on the CPU thread.
+    u32 texture_page_x;
+    u32 texture_page_y;
+    u32 texture_palette_x;
+    u32 texture_palette_y;
+    TextureMode texture_mode;
+    Common::Rectangle<u32> page_rect;
+    Common::Rectangle<u32> palette_rect;
+    u32 valid_strips;
+    u32 last_used;
+  };
+
+  /// Returns the decoded current texture page for a primitive which samples rows min_texcoord_y to max_texcoord_y and
+  /// writes to write_rect, queuing decoding of any missing rows. Returns nullptr if the primitive can't use the cache.
+  const u16* GetTextureCachePage(const Common::Rectangle<u32>& write_rect, u32 min_texcoord_y, u32 max_texcoord_y);
+
+  /// Marks any decoded rows which depend on the specified area of VRAM as invalid.
+  void InvalidateTextureCache(const Common::Rectangle<u32>& rect);
+
+  /// Called on the CPU thread when an area of VRAM is going to be written to, to invalidate the texture cache and the
+  /// display lines which were converted from it.
+  void MarkVRAMDirty(const Common::Rectangle<u32>& rect);
+  void MarkVRAMDirty(u32 x, u32 y, u32 width, u32 height);
+
+  void DecodeTexturePage(const SWRenderState& state, u16* texels, u32 first_row, u32 num_rows);
+
+  std::vector<TextureCacheEntry> m_texture_cache;
+  u32 m_texture_cache_use_counter = 0;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Command Queue
+  //////////////////////////////////////////////////////////////////////////
+  static constexpr u32 COMMAND_QUEUE_SIZE = 4096;
+
+  struct SWCommand
+  {
+    SWCommandType type;
+    SWRenderState state;
+    union
+    {
+      DrawTriangleFunction draw_triangle;
+      DrawRectangleFunction draw_rectangle;
+      DrawLineFunction draw_line;
+      u16* decode_texels;
+    };
+
+    // Triangles use all three vertices, lines the first two, and rectangles the first for the origin/color/texcoord.
+    std::array<SWVertex, 3> vertices;
+
+    // Rectangle size, VRAM operation area, and rows of a texture page to decode.
+    u32 x;
+    u32 y;
+    u32 width;
+    u32 height;
+    u32 src_x;
+    u32 src_y;
+    u32 color;
+    std::vector<u16> data;
+
+    // Run by the first render thread alone, once all threads have completed the preceding commands.
+    bool exclusive = false;
+  };
+
+  bool IsUsingThread() const { return !m_render_threads.empty(); }
+  void StartThreads(u32 count);
+  void StopThreads();
+
+  /// Executes the command immediately when not using the thread, otherwise adds it to the queue.
+  void QueueCommand(SWCommand&& cmd);
+
+  /// Waits for the render threads to finish all queued commands. Must be called before VRAM is read on the CPU
+  /// thread.
+  void Sync();
+
+  /// Returns the position of the slowest render thread in the queue. Slots before this can be reused.
+  u32 GetCommandQueueReadPosition() const;
+
+  /// Waits until the specified render thread(s) have executed all commands before the specified position.
+  void WaitForRenderThreads(u32 pos) const;
+  void WaitForRenderThread(u32 index, u32 pos) const;
+
+  void ExecuteCommand(SWCommand& cmd, u32 band_index, u32 band_count);
+  void ExecuteDrawCommand(const SWCommand& cmd, const SWDrawContext& ctx);
+  void RenderThreadEntryPoint(u32 index);
+
+  std::array<SWCommand, COMMAND_QUEUE_SIZE> m_command_queue;
+  std::array<std::atomic<u32>, MAX_RENDER_THREADS> m_command_queue_read_pos{};
+  u32 m_command_queue_write_pos = 0;
+  bool m_shutdown_flag = false;
+
+  std::mutex m_command_queue_mutex;
+  std::condition_variable m_command_queue_pushed_cv;
+  std::condition_variable m_command_queue_consumed_cv;
+  std::vector<std::thread> m_render_threads;
+  u32 m_render_thread_count = 0;
+
+  // Areas of VRAM which primitives queued since the last barrier read from and write to.
+  Common::Rectangle<u32> m_pending_read_rect;
+  Common::Rectangle<u32> m_pending_write_rect;
+
   std::vector<u32> m_display_texture_buffer;
   std::unique_ptr<HostDisplayTexture> m_display_texture;
 
+  // Display scanout state. Each line of the display texture remembers the VRAM row it was converted from and the
+  // number of writes to that row at the time, so lines which haven't changed aren't converted or uploaded again.
+  static constexpr u32 INVALID_VRAM_ROW = 0xFFFFFFFFu;
+
+  struct DisplayLayout
+  {
+    u32 src_x;
+    u32 width;
+    u32 height;
+    u32 scale;
+    u32 rgb24;
+  };
+
+  struct DisplayLineSource
+  {
+    u32 vram_row;
+    u32 version;
+  };
+
+  DisplayLayout m_display_layout{};
+  std::array<u32, VRAM_HEIGHT> m_vram_row_versions{};
+  std::array<DisplayLineSource, VRAM_HEIGHT> m_display_line_sources{};
+
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  // VRAM at m_resolution_scale times the resolution in each direction, which primitives are also drawn to when
+  // upscaling. VRAM remains authoritative, so reads from VRAM and texture sampling are unaffected.
+  std::vector<u16> m_scaled_vram;
+  u32 m_resolution_scale = 1;
+  bool m_scaled_dithering = false;
 };
@@ -0,0 +1,152 @@
+#pragma once
+#include "common/cpu_detect.h"
+#include "types.h"
+
+// Vector of eight 16-bit lanes, used by the software renderer to shade spans of pixels. SSE2 and NEON are part of the
+// baseline instruction set on x64 and AArch64 respectively, so no runtime selection is needed.
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#define GPU_SW_SIMD 1
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#define GPU_SW_SIMD 1
+#endif
+
+#ifdef GPU_SW_SIMD
+
+class SWVector
+{
+public:
+  static constexpr u32 NUM_LANES = 8;
+
+#if defined(CPU_X64)
+  using NativeType = __m128i;
+#elif defined(CPU_AARCH64)
+  using NativeType = uint16x8_t;
+#endif
+
+  ALWAYS_INLINE SWVector() = default;
+  ALWAYS_INLINE explicit SWVector(NativeType v_) : v(v_) {}
+
+#if defined(CPU_X64)
+
+  ALWAYS_INLINE static SWVector Zero() { return SWVector(_mm_setzero_si128()); }
+  ALWAYS_INLINE static SWVector Broadcast(u16 value) { return SWVector(_mm_set1_epi16(static_cast<s16>(value))); }
+  ALWAYS_INLINE static SWVector Load(const u16* ptr)
+  {
+    return SWVector(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+  }
+  ALWAYS_INLINE static SWVector Load(const s16* ptr)
+  {
+    return SWVector(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+  }
+  ALWAYS_INLINE void Store(u16* ptr) const { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), v); }
+
+  ALWAYS_INLINE SWVector operator&(const SWVector& rhs) const { return SWVector(_mm_and_si128(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator|(const SWVector& rhs) const { return SWVector(_mm_or_si128(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator+(const SWVector& rhs) const { return SWVector(_mm_add_epi16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator*(const SWVector& rhs) const { return SWVector(_mm_mullo_epi16(v, rhs.v)); }
+
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftLeft() const
+  {
+    return SWVector(_mm_slli_epi16(v, shift));
+  }
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftRightLogical() const
+  {
+    return SWVector(_mm_srli_epi16(v, shift));
+  }
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftRightArithmetic() const
+  {
+    return SWVector(_mm_srai_epi16(v, shift));
+  }
+
+  ALWAYS_INLINE SWVector MinSigned(const SWVector& rhs) const { return SWVector(_mm_min_epi16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector MaxSigned(const SWVector& rhs) const { return SWVector(_mm_max_epi16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector SubSaturateUnsigned(const SWVector& rhs) const { return SWVector(_mm_subs_epu16(v, rhs.v)); }
+
+  /// Returns all bits set in lanes which are equal.
+  ALWAYS_INLINE SWVector Equal(const SWVector& rhs) const { return SWVector(_mm_cmpeq_epi16(v, rhs.v)); }
+
+  /// Returns this & ~rhs.
+  ALWAYS_INLINE SWVector AndNot(const SWVector& rhs) const { return SWVector(_mm_andnot_si128(rhs.v, v)); }
+
+  /// Picks lanes from a where the mask is set, otherwise from b. Mask lanes must be all or nothing.
+  ALWAYS_INLINE static SWVector Select(const SWVector& mask, const SWVector& a, const SWVector& b)
+  {
+    return SWVector(_mm_or_si128(_mm_and_si128(mask.v, a.v), _mm_andnot_si128(mask.v, b.v)));
+  }
+
+  /// Stores the lanes of even and odd alternately, i.e. as eight 32-bit values with even in the low halves.
+  ALWAYS_INLINE static void StoreInterleaved(u16* ptr, const SWVector& even, const SWVector& odd)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), _mm_unpacklo_epi16(even.v, odd.v));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr + NUM_LANES), _mm_unpackhi_epi16(even.v, odd.v));
+  }
+
+#elif defined(CPU_AARCH64)
+
+  ALWAYS_INLINE static SWVector Zero() { return SWVector(vdupq_n_u16(0)); }
+  ALWAYS_INLINE static SWVector Broadcast(u16 value) { return SWVector(vdupq_n_u16(value)); }
+  ALWAYS_INLINE static SWVector Load(const u16* ptr) { return SWVector(vld1q_u16(ptr)); }
+  ALWAYS_INLINE static SWVector Load(const s16* ptr) { return SWVector(vreinterpretq_u16_s16(vld1q_s16(ptr))); }
+  ALWAYS_INLINE void Store(u16* ptr) const { vst1q_u16(ptr, v); }
+
+  ALWAYS_INLINE SWVector operator&(const SWVector& rhs) const { return SWVector(vandq_u16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator|(const SWVector& rhs) const { return SWVector(vorrq_u16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator+(const SWVector& rhs) const { return SWVector(vaddq_u16(v, rhs.v)); }
+  ALWAYS_INLINE SWVector operator*(const SWVector& rhs) const { return SWVector(vmulq_u16(v, rhs.v)); }
+
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftLeft() const
+  {
+    return SWVector(vshlq_n_u16(v, shift));
+  }
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftRightLogical() const
+  {
+    return SWVector(vshrq_n_u16(v, shift));
+  }
+  template<int shift>
+  ALWAYS_INLINE SWVector ShiftRightArithmetic() const
+  {
+    return SWVector(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(v), shift)));
+  }
+
+  ALWAYS_INLINE SWVector MinSigned(const SWVector& rhs) const
+  {
+    return SWVector(vreinterpretq_u16_s16(vminq_s16(vreinterpretq_s16_u16(v), vreinterpretq_s16_u16(rhs.v))));
+  }
+  ALWAYS_INLINE SWVector MaxSigned(const SWVector& rhs) const
+  {
+    return SWVector(vreinterpretq_u16_s16(vmaxq_s16(vreinterpretq_s16_u16(v), vreinterpretq_s16_u16(rhs.v))));
+  }
+  ALWAYS_INLINE SWVector SubSaturateUnsigned(const SWVector& rhs) const { return SWVector(vqsubq_u16(v, rhs.v)); }
+
+  /// Returns all bits set in lanes which are equal.
+  ALWAYS_INLINE SWVector Equal(const SWVector& rhs) const { return SWVector(vceqq_u16(v, rhs.v)); }
+
+  /// Returns this & ~rhs.
+  ALWAYS_INLINE SWVector AndNot(const SWVector& rhs) const { return SWVector(vbicq_u16(v, rhs.v)); }
+
+  /// Picks lanes from a where the mask is set, otherwise from b. Mask lanes must be all or nothing.
+  ALWAYS_INLINE static SWVector Select(const SWVector& mask, const SWVector& a, const SWVector& b)
+  {
+    return SWVector(vbslq_u16(mask.v, a.v, b.v));
+  }
+
+  /// Stores the lanes of even and odd alternately, i.e. as eight 32-bit values with even in the low halves.
+  ALWAYS_INLINE static void StoreInterleaved(u16* ptr, const SWVector& even, const SWVector& odd)
+  {
+    vst2q_u16(ptr, uint16x8x2_t{{even.v, odd.v}});
+  }
+
+#endif
+
+private:
+  NativeType v;
+};
+
+#endif
@@ -14,6 +14,26 @@ ALWAYS_INLINE u32 CountLeadingBits(u32 value)
 
 namespace GTE {
 
+const std::array<u8, 257> Core::s_unr_table = {{
+  0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
+  0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
+  0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
+  0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
+  0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
+  0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
+  0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
+  0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
+  0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
+  0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
+  0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
+  0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
+  0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
+  0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
+  0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
+  0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
+  0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
+}};
+
 Core::Core() = default;
 
 Core::~Core() = default;
@@ -343,28 +363,8 @@ u32 Core::UNRDivide(u32 lhs, u32 rhs)
   lhs <<= shift;
   rhs <<= shift;
 
-  static constexpr std::array<u8, 257> unr_table = {{
-    0xFF, 0xFD, 0xFB, 0xF9, 0xF7, 0xF5, 0xF3, 0xF1, 0xEF, 0xEE, 0xEC, 0xEA, 0xE8, 0xE6, 0xE4, 0xE3, //
-    0xE1, 0xDF, 0xDD, 0xDC, 0xDA, 0xD8, 0xD6, 0xD5, 0xD3, 0xD1, 0xD0, 0xCE, 0xCD, 0xCB, 0xC9, 0xC8, //  00h..3Fh
-    0xC6, 0xC5, 0xC3, 0xC1, 0xC0, 0xBE, 0xBD, 0xBB, 0xBA, 0xB8, 0xB7, 0xB5, 0xB4, 0xB2, 0xB1, 0xB0, //
-    0xAE, 0xAD, 0xAB, 0xAA, 0xA9, 0xA7, 0xA6, 0xA4, 0xA3, 0xA2, 0xA0, 0x9F, 0x9E, 0x9C, 0x9B, 0x9A, //
-    0x99, 0x97, 0x96, 0x95, 0x94, 0x92, 0x91, 0x90, 0x8F, 0x8D, 0x8C, 0x8B, 0x8A, 0x89, 0x87, 0x86, //
-    0x85, 0x84, 0x83, 0x82, 0x81, 0x7F, 0x7E, 0x7D, 0x7C, 0x7B, 0x7A, 0x79, 0x78, 0x77, 0x75, 0x74, //  40h..7Fh
-    0x73, 0x72, 0x71, 0x70, 0x6F, 0x6E, 0x6D, 0x6C, 0x6B, 0x6A, 0x69, 0x68, 0x67, 0x66, 0x65, 0x64, //
-    0x63, 0x62, 0x61, 0x60, 0x5F, 0x5E, 0x5D, 0x5D, 0x5C, 0x5B, 0x5A, 0x59, 0x58, 0x57, 0x56, 0x55, //
-    0x54, 0x53, 0x53, 0x52, 0x51, 0x50, 0x4F, 0x4E, 0x4D, 0x4D, 0x4C, 0x4B, 0x4A, 0x49, 0x48, 0x48, //
-    0x47, 0x46, 0x45, 0x44, 0x43, 0x43, 0x42, 0x41, 0x40, 0x3F, 0x3F, 0x3E, 0x3D, 0x3C, 0x3C, 0x3B, //  80h..BFh
-    0x3A, 0x39, 0x39, 0x38, 0x37, 0x36, 0x36, 0x35, 0x34, 0x33, 0x33, 0x32, 0x31, 0x31, 0x30, 0x2F, //
-    0x2E, 0x2E, 0x2D, 0x2C, 0x2C, 0x2B, 0x2A, 0x2A, 0x29, 0x28, 0x28, 0x27, 0x26, 0x26, 0x25, 0x24, //
-    0x24, 0x23, 0x22, 0x22, 0x21, 0x20, 0x20, 0x1F, 0x1E, 0x1E, 0x1D, 0x1D, 0x1C, 0x1B, 0x1B, 0x1A, //
-    0x19, 0x19, 0x18, 0x18, 0x17, 0x16, 0x16, 0x15, 0x15, 0x14, 0x14, 0x13, 0x12, 0x12, 0x11, 0x11, //  C0h..FFh
-    0x10, 0x0F, 0x0F, 0x0E, 0x0E, 0x0D, 0x0D, 0x0C, 0x0C, 0x0B, 0x0A, 0x0A, 0x09, 0x09, 0x08, 0x08, //
-    0x07, 0x07, 0x06, 0x06, 0x05, 0x05, 0x04, 0x04, 0x03, 0x03, 0x02, 0x02, 0x01, 0x01, 0x00, 0x00, //
-    0x00 // <-- one extra table entry (for "(d-7FC0h)/80h"=100h)
-  }};
-
   const u32 divisor = rhs | 0x8000;
-  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
+  const s32 x = static_cast<s32>(0x101 + ZeroExtend32(s_unr_table[((divisor & 0x7FFF) + 0x40) >> 7]));
   const s32 d = ((static_cast<s32>(ZeroExtend32(divisor)) * -x) + 0x80) >> 8;
   const u32 recip = static_cast<u32>(((x * (0x20000 + d)) + 0x80) >> 8);
 
@@ -375,7 +375,7 @@ u32 Core::UNRDivide(u32 lhs, u32 rhs)
   return std::min<u32>(0x1FFFF, result);
 }
 
-void Core::MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+ALWAYS_INLINE void Core::MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
 {
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(SignExtendMACResult<i + 1>((s64(M[i][0]) * s64(Vx)) + (s64(M[i][1]) * s64(Vy))) +      \
@@ -389,7 +389,8 @@ void Core::MulMatVec(const s16 M[3][3], const s16 Vx, const s16 Vy, const s16 Vz
 #undef dot3
 }
 
-void Core::MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz, u8 shift, bool lm)
+ALWAYS_INLINE void Core::MulMatVec(const s16 M[3][3], const s32 T[3], const s16 Vx, const s16 Vy, const s16 Vz,
+                                   u8 shift, bool lm)
 {
 #define dot3(i)                                                                                                        \
   TruncateAndSetMACAndIR<i + 1>(                                                                                       \
@@ -426,10 +427,8 @@ void Core::MulMatVecBuggy(const s16 M[3][3], const s32 T[3], const s16 Vx, const
 #undef dot3
 }
 
-void Core::Execute_MVMVA(Instruction inst)
+ALWAYS_INLINE void Core::MVMVA(Instruction inst, u8 shift, bool lm)
 {
-  m_regs.FLAG.Clear();
-
   // TODO: Remove memcpy..
   s16 M[3][3];
   switch (inst.mvmva_multiply_matrix)
@@ -488,19 +487,24 @@ void Core::Execute_MVMVA(Instruction inst)
   switch (inst.mvmva_translation_vector)
   {
     case 0:
-      MulMatVec(M, m_regs.TR, Vx, Vy, Vz, inst.GetShift(), inst.lm);
+      MulMatVec(M, m_regs.TR, Vx, Vy, Vz, shift, lm);
       break;
     case 1:
-      MulMatVec(M, m_regs.BK, Vx, Vy, Vz, inst.GetShift(), inst.lm);
+      MulMatVec(M, m_regs.BK, Vx, Vy, Vz, shift, lm);
       break;
     case 2:
-      MulMatVecBuggy(M, m_regs.FC, Vx, Vy, Vz, inst.GetShift(), inst.lm);
+      MulMatVecBuggy(M, m_regs.FC, Vx, Vy, Vz, shift, lm);
       break;
     default:
-      MulMatVec(M, zero_T, Vx, Vy, Vz, inst.GetShift(), inst.lm);
+      MulMatVec(M, zero_T, Vx, Vy, Vz, shift, lm);
       break;
   }
+}
 
+void Core::Execute_MVMVA(Instruction inst)
+{
+  m_regs.FLAG.Clear();
+  MVMVA(inst, inst.GetShift(), inst.lm);
   m_regs.FLAG.UpdateError();
 }
 
@@ -545,7 +549,7 @@ void Core::Execute_OP(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
-void Core::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
+ALWAYS_INLINE void Core::RTPS(const s16 V[3], u8 shift, bool lm, bool last)
 {
 #define dot3(i)                                                                                                        \
   SignExtendMACResult<i + 1>(                                                                                          \
@@ -652,7 +656,7 @@ void Core::Execute_AVSZ4(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
-void Core::InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm)
+ALWAYS_INLINE void Core::InterpolateColor(s64 in_MAC1, s64 in_MAC2, s64 in_MAC3, u8 shift, bool lm)
 {
   // [MAC1,MAC2,MAC3] = MAC+(FC-MAC)*IR0
   //   [IR1,IR2,IR3] = (([RFC,GFC,BFC] SHL 12) - [MAC1,MAC2,MAC3]) SAR (sf*12)
@@ -743,7 +747,7 @@ void Core::Execute_NCCT(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
-void Core::NCDS(const s16 V[3], u8 shift, bool lm)
+ALWAYS_INLINE void Core::NCDS(const s16 V[3], u8 shift, bool lm)
 {
   // [IR1,IR2,IR3] = [MAC1,MAC2,MAC3] = (LLM*V0) SAR (sf*12)
   MulMatVec(m_regs.LLM, V[0], V[1], V[2], shift, lm);
@@ -950,4 +954,102 @@ void Core::Execute_GPF(Instruction inst)
   m_regs.FLAG.UpdateError();
 }
 
+template<bool sf, bool lm>
+void Core::Impl_MVMVA(Core* gte, u32 instruction_bits)
+{
+  gte->m_regs.FLAG.Clear();
+  gte->MVMVA(Instruction{instruction_bits}, sf ? 12 : 0, lm);
+  gte->m_regs.FLAG.UpdateError();
+}
+
+template<bool sf, bool lm>
+void Core::Impl_RTPS(Core* gte, u32 instruction_bits)
+{
+  gte->m_regs.FLAG.Clear();
+  gte->RTPS(gte->m_regs.V0, sf ? 12 : 0, lm, true);
+  gte->m_regs.FLAG.UpdateError();
+}
+
+template<bool sf, bool lm>
+void Core::Impl_RTPT(Core* gte, u32 instruction_bits)
+{
+  gte->m_regs.FLAG.Clear();
+  gte->RTPS(gte->m_regs.V0, sf ? 12 : 0, lm, false);
+  gte->RTPS(gte->m_regs.V1, sf ? 12 : 0, lm, false);
+  gte->RTPS(gte->m_regs.V2, sf ? 12 : 0, lm, true);
+  gte->m_regs.FLAG.UpdateError();
+}
+
+template<bool sf, bool lm>
+void Core::Impl_NCDS(Core* gte, u32 instruction_bits)
+{
+  gte->m_regs.FLAG.Clear();
+  gte->NCDS(gte->m_regs.V0, sf ? 12 : 0, lm);
+  gte->m_regs.FLAG.UpdateError();
+}
+
+template<bool sf, bool lm>
+void Core::Impl_NCDT(Core* gte, u32 instruction_bits)
+{
+  gte->m_regs.FLAG.Clear();
+  gte->NCDS(gte->m_regs.V0, sf ? 12 : 0, lm);
+  gte->NCDS(gte->m_regs.V1, sf ? 12 : 0, lm);
+  gte->NCDS(gte->m_regs.V2, sf ? 12 : 0, lm);
+  gte->m_regs.FLAG.UpdateError();
+}
+
+void Core::Impl_NCLIP(Core* gte, u32 instruction_bits)
+{
+  gte->Execute_NCLIP(Instruction{instruction_bits});
+}
+
+void Core::Impl_AVSZ3(Core* gte, u32 instruction_bits)
+{
+  gte->Execute_AVSZ3(Instruction{instruction_bits});
+}
+
+void Core::Impl_AVSZ4(Core* gte, u32 instruction_bits)
+{
+  gte->Execute_AVSZ4(Instruction{instruction_bits});
+}
+
+Core::InstructionImpl Core::GetInstructionImpl(Instruction inst)
+{
+#define GET_IMPL(name)                                                                                                 \
+  (inst.sf ? (inst.lm ? &Core::Impl_##name<true, true> : &Core::Impl_##name<true, false>) :                           \
+             (inst.lm ? &Core::Impl_##name<false, true> : &Core::Impl_##name<false, false>))
+
+  switch (inst.command)
+  {
+    case 0x01:
+      return GET_IMPL(RTPS);
+
+    case 0x06:
+      return &Core::Impl_NCLIP;
+
+    case 0x12:
+      return GET_IMPL(MVMVA);
+
+    case 0x13:
+      return GET_IMPL(NCDS);
+
+    case 0x16:
+      return GET_IMPL(NCDT);
+
+    case 0x2D:
+      return &Core::Impl_AVSZ3;
+
+    case 0x2E:
+      return &Core::Impl_AVSZ4;
+
+    case 0x30:
+      return GET_IMPL(RTPT);
+
+    default:
+      return nullptr;
+  }
+
+#undef GET_IMPL
+}
+
 } // namespace GTE
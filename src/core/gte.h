@@ -1,6 +1,7 @@
 #pragma once
 #include "common/state_wrapper.h"
 #include "gte_types.h"
+#include <array>
 
 namespace CPU {
 class Core;
@@ -33,6 +34,12 @@ public:
 
   void ExecuteInstruction(Instruction inst);
 
+  using InstructionImpl = void (*)(Core* gte, u32 instruction_bits);
+
+  // Returns a handler for the instruction with the shift/lm bits resolved at compile time, so the matrix and flag
+  // calculations can be constant-folded. Returns nullptr for commands which should go through ExecuteInstruction().
+  static InstructionImpl GetInstructionImpl(Instruction inst);
+
 private:
   static constexpr s64 MAC0_MIN_VALUE = -(INT64_C(1) << 31);
   static constexpr s64 MAC0_MAX_VALUE = (INT64_C(1) << 31) - 1;
@@ -87,6 +94,8 @@ private:
   void NCDS(const s16 V[3], u8 shift, bool lm);
   void DPCS(const u8 color[3], u8 shift, bool lm);
 
+  void MVMVA(Instruction inst, u8 shift, bool lm);
+
   void Execute_MVMVA(Instruction inst);
   void Execute_SQR(Instruction inst);
   void Execute_OP(Instruction inst);
@@ -110,6 +119,24 @@ private:
   void Execute_GPL(Instruction inst);
   void Execute_GPF(Instruction inst);
 
+  // Specialized versions of the commands used by the recompiler, sf/lm are template parameters.
+  template<bool sf, bool lm>
+  static void Impl_MVMVA(Core* gte, u32 instruction_bits);
+  template<bool sf, bool lm>
+  static void Impl_RTPS(Core* gte, u32 instruction_bits);
+  template<bool sf, bool lm>
+  static void Impl_RTPT(Core* gte, u32 instruction_bits);
+  template<bool sf, bool lm>
+  static void Impl_NCDS(Core* gte, u32 instruction_bits);
+  template<bool sf, bool lm>
+  static void Impl_NCDT(Core* gte, u32 instruction_bits);
+  static void Impl_NCLIP(Core* gte, u32 instruction_bits);
+  static void Impl_AVSZ3(Core* gte, u32 instruction_bits);
+  static void Impl_AVSZ4(Core* gte, u32 instruction_bits);
+
+  // Reciprocal table for UNRDivide(), also used by the recompiler's inline RTPS/RTPT.
+  static const std::array<u8, 257> s_unr_table;
+
   Regs m_regs = {};
   bool m_widescreen_hack = false;
 };
@@ -6,13 +6,68 @@
 #include "stb_image_write.h"
 #include <cmath>
 #include <cstring>
+#include <imgui.h>
 #include <vector>
 Log_SetChannel(HostDisplay);
 
+// The lists are kept between frames so that their buffers can be reused.
+struct HostDisplay::SavedImGuiDrawData
+{
+  ImDrawData draw_data;
+  std::vector<std::unique_ptr<ImDrawList>> lists;
+  std::vector<ImDrawList*> list_pointers;
+  bool valid = false;
+};
+
 HostDisplayTexture::~HostDisplayTexture() = default;
 
+HostDisplay::HostDisplay() = default;
+
 HostDisplay::~HostDisplay() = default;
 
+void HostDisplay::SaveImGuiDrawData()
+{
+  if (!ImGui::GetCurrentContext())
+    return;
+
+  if (!m_saved_imgui_draw_data)
+    m_saved_imgui_draw_data = std::make_unique<SavedImGuiDrawData>();
+
+  ImGui::Render();
+  const ImDrawData* draw_data = ImGui::GetDrawData();
+  SavedImGuiDrawData& saved = *m_saved_imgui_draw_data;
+  saved.draw_data = *draw_data;
+  saved.list_pointers.clear();
+  for (int i = 0; i < draw_data->CmdListsCount; i++)
+  {
+    if (static_cast<size_t>(i) == saved.lists.size())
+      saved.lists.push_back(std::make_unique<ImDrawList>(ImGui::GetDrawListSharedData()));
+
+    const ImDrawList* src = draw_data->CmdLists[i];
+    ImDrawList* dst = saved.lists[i].get();
+    dst->CmdBuffer = src->CmdBuffer;
+    dst->IdxBuffer = src->IdxBuffer;
+    dst->VtxBuffer = src->VtxBuffer;
+    dst->Flags = src->Flags;
+    saved.list_pointers.push_back(dst);
+  }
+
+  saved.draw_data.CmdLists = saved.list_pointers.data();
+  saved.valid = true;
+}
+
+ImDrawData* HostDisplay::GetImGuiDrawData()
+{
+  if (m_saved_imgui_draw_data && m_saved_imgui_draw_data->valid)
+  {
+    m_saved_imgui_draw_data->valid = false;
+    return &m_saved_imgui_draw_data->draw_data;
+  }
+
+  ImGui::Render();
+  return ImGui::GetDrawData();
+}
+
 void HostDisplay::SetSoftwareCursor(std::unique_ptr<HostDisplayTexture> texture, float scale /*= 1.0f*/)
 {
   m_cursor_texture = std::move(texture);
@@ -7,6 +7,8 @@
 #include <tuple>
 #include <vector>
 
+struct ImDrawData;
+
 // An abstracted RGBA8 texture.
 class HostDisplayTexture
 {
@@ -31,6 +33,7 @@ public:
     OpenGLES
   };
 
+  HostDisplay();
   virtual ~HostDisplay();
 
   ALWAYS_INLINE s32 GetWindowWidth() const { return static_cast<s32>(m_window_info.surface_width); }
@@ -75,6 +78,10 @@ public:
   /// Returns false if the window was completely occluded.
   virtual bool Render() = 0;
 
+  /// Finishes the UI's frame and keeps a copy of its draw data for the next Render(), so that Render() can be called
+  /// on a different thread to the one which builds the UI.
+  void SaveImGuiDrawData();
+
   virtual void SetVSync(bool enabled) = 0;
 
   const s32 GetDisplayTopMargin() const { return m_display_top_margin; }
@@ -156,6 +163,9 @@ protected:
   ALWAYS_INLINE bool HasSoftwareCursor() const { return static_cast<bool>(m_cursor_texture); }
   ALWAYS_INLINE bool HasDisplayTexture() const { return (m_display_texture_handle != nullptr); }
 
+  /// Returns the draw data kept by SaveImGuiDrawData() if there is some, otherwise finishes the UI's frame.
+  ImDrawData* GetImGuiDrawData();
+
   void CalculateDrawRect(s32 window_width, s32 window_height, s32* out_left, s32* out_top, s32* out_width,
                          s32* out_height, s32* out_left_padding, s32* out_top_padding, float* out_scale,
                          float* out_y_scale, bool apply_aspect_ratio = true) const;
@@ -189,6 +199,9 @@ protected:
   std::unique_ptr<HostDisplayTexture> m_cursor_texture;
   float m_cursor_texture_scale = 1.0f;
 
+  struct SavedImGuiDrawData;
+  std::unique_ptr<SavedImGuiDrawData> m_saved_imgui_draw_data;
+
   bool m_display_linear_filtering = false;
   bool m_display_changed = false;
   bool m_display_integer_scaling = false;
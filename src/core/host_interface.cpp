@@ -344,6 +344,10 @@ void HostInterface::SetDefaultSettings(SettingsInterface& si)
   si.SetBoolValue("GPU", "DisableInterlacing", false);
   si.SetBoolValue("GPU", "ForceNTSCTimings", false);
   si.SetBoolValue("GPU", "WidescreenHack", false);
+  si.SetBoolValue("GPU", "UseThread", false);
+  si.SetBoolValue("GPU", "ComputeVRAMTransfers", false);
+  si.SetIntValue("GPU", "RenderThreads", 1);
+  si.SetIntValue("GPU", "SoftwareResolutionScale", 1);
 
   si.SetStringValue("Display", "CropMode", Settings::GetDisplayCropModeName(Settings::DEFAULT_DISPLAY_CROP_MODE));
   si.SetStringValue("Display", "AspectRatio",
@@ -446,6 +450,18 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
       m_system->SetCPUExecutionMode(m_settings.cpu_execution_mode);
     }
 
+    if (m_settings.cpu_fastmem != old_settings.cpu_fastmem)
+    {
+      ReportFormattedMessage("%s CPU fastmem.", m_settings.cpu_fastmem ? "Enabling" : "Disabling");
+      m_system->SetCPUFastmem(m_settings.cpu_fastmem);
+    }
+
+    if (m_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping)
+    {
+      ReportFormattedMessage("%s CPU idle loop skipping.", m_settings.cpu_idle_loop_skipping ? "Enabling" : "Disabling");
+      m_system->SetCPUIdleLoopSkipping(m_settings.cpu_idle_loop_skipping);
+    }
+
     m_audio_stream->SetOutputVolume(m_settings.audio_output_muted ? 0 : m_settings.audio_output_volume);
 
     if (m_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
@@ -456,6 +472,10 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
         m_settings.gpu_texture_filtering != old_settings.gpu_texture_filtering ||
         m_settings.gpu_disable_interlacing != old_settings.gpu_disable_interlacing ||
         m_settings.gpu_force_ntsc_timings != old_settings.gpu_force_ntsc_timings ||
+        m_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        m_settings.gpu_compute_vram_transfers != old_settings.gpu_compute_vram_transfers ||
+        m_settings.gpu_render_threads != old_settings.gpu_render_threads ||
+        m_settings.gpu_software_resolution_scale != old_settings.gpu_software_resolution_scale ||
         m_settings.display_crop_mode != old_settings.display_crop_mode ||
         m_settings.display_aspect_ratio != old_settings.display_aspect_ratio)
     {
@@ -646,6 +666,9 @@ void HostInterface::UpdateSoftwareCursor()
       break;
   }
 
+  // the GPU may be rendering on its own thread
+  m_system->GetGPU()->ResetGraphicsAPIState();
+
   if (image && image->IsValid())
   {
     m_display->SetSoftwareCursor(image->GetPixels(), image->GetWidth(), image->GetHeight(), image->GetByteStride(),
@@ -655,6 +678,8 @@ void HostInterface::UpdateSoftwareCursor()
   {
     m_display->ClearSoftwareCursor();
   }
+
+  m_system->GetGPU()->RestoreGraphicsAPIState();
 }
 
 void HostInterface::RecreateSystem()
@@ -87,6 +87,8 @@ void Settings::Load(SettingsInterface& si)
     ParseCPUExecutionMode(
       si.GetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(DEFAULT_CPU_EXECUTION_MODE)).c_str())
       .value_or(DEFAULT_CPU_EXECUTION_MODE);
+  cpu_fastmem = si.GetBoolValue("CPU", "Fastmem", false);
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", false);
 
   gpu_renderer = ParseRendererName(si.GetStringValue("GPU", "Renderer", GetRendererName(DEFAULT_GPU_RENDERER)).c_str())
                    .value_or(DEFAULT_GPU_RENDERER);
@@ -99,6 +101,10 @@ void Settings::Load(SettingsInterface& si)
   gpu_disable_interlacing = si.GetBoolValue("GPU", "DisableInterlacing", false);
   gpu_force_ntsc_timings = si.GetBoolValue("GPU", "ForceNTSCTimings", false);
   gpu_widescreen_hack = si.GetBoolValue("GPU", "WidescreenHack", false);
+  gpu_use_thread = si.GetBoolValue("GPU", "UseThread", false);
+  gpu_compute_vram_transfers = si.GetBoolValue("GPU", "ComputeVRAMTransfers", false);
+  gpu_render_threads = static_cast<u32>(si.GetIntValue("GPU", "RenderThreads", 1));
+  gpu_software_resolution_scale = static_cast<u32>(si.GetIntValue("GPU", "SoftwareResolutionScale", 1));
 
   display_crop_mode =
     ParseDisplayCropMode(
@@ -190,6 +196,8 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("Main", "LoadDevicesFromSaveStates", load_devices_from_save_states);
 
   si.SetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(cpu_execution_mode));
+  si.SetBoolValue("CPU", "Fastmem", cpu_fastmem);
+  si.SetBoolValue("CPU", "IdleLoopSkipping", cpu_idle_loop_skipping);
 
   si.SetStringValue("GPU", "Renderer", GetRendererName(gpu_renderer));
   si.SetStringValue("GPU", "Adapter", gpu_adapter.c_str());
@@ -201,6 +209,10 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("GPU", "DisableInterlacing", gpu_disable_interlacing);
   si.SetBoolValue("GPU", "ForceNTSCTimings", gpu_force_ntsc_timings);
   si.SetBoolValue("GPU", "WidescreenHack", gpu_widescreen_hack);
+  si.SetBoolValue("GPU", "UseThread", gpu_use_thread);
+  si.SetBoolValue("GPU", "ComputeVRAMTransfers", gpu_compute_vram_transfers);
+  si.SetIntValue("GPU", "RenderThreads", static_cast<long>(gpu_render_threads));
+  si.SetIntValue("GPU", "SoftwareResolutionScale", static_cast<long>(gpu_software_resolution_scale));
 
   si.SetStringValue("Display", "CropMode", GetDisplayCropModeName(display_crop_mode));
   si.SetStringValue("Display", "AspectRatio", GetDisplayAspectRatioName(display_aspect_ratio));
@@ -349,9 +361,10 @@ const char* Settings::GetDiscRegionDisplayName(DiscRegion region)
   return s_disc_region_display_names[static_cast<int>(region)];
 }
 
-static std::array<const char*, 3> s_cpu_execution_mode_names = {{"Interpreter", "CachedInterpreter", "Recompiler"}};
-static std::array<const char*, 3> s_cpu_execution_mode_display_names = {
-  {"Intepreter (Slowest)", "Cached Interpreter (Faster)", "Recompiler (Fastest)"}};
+static std::array<const char*, 4> s_cpu_execution_mode_names = {
+  {"Interpreter", "CachedInterpreter", "ThreadedInterpreter", "Recompiler"}};
+static std::array<const char*, 4> s_cpu_execution_mode_display_names = {
+  {"Intepreter (Slowest)", "Cached Interpreter (Faster)", "Threaded Interpreter (Faster)", "Recompiler (Fastest)"}};
 
 std::optional<CPUExecutionMode> Settings::ParseCPUExecutionMode(const char* str)
 {
@@ -68,6 +68,8 @@ struct Settings
   ConsoleRegion region = ConsoleRegion::Auto;
 
   CPUExecutionMode cpu_execution_mode = CPUExecutionMode::Interpreter;
+  bool cpu_fastmem = false;
+  bool cpu_idle_loop_skipping = false;
 
   float emulation_speed = 1.0f;
   bool speed_limiter_enabled = true;
@@ -88,6 +90,10 @@ struct Settings
   bool gpu_disable_interlacing = false;
   bool gpu_force_ntsc_timings = false;
   bool gpu_widescreen_hack = false;
+  bool gpu_use_thread = false;
+  bool gpu_compute_vram_transfers = false;
+  u32 gpu_render_threads = 1;
+  u32 gpu_software_resolution_scale = 1;
   DisplayCropMode display_crop_mode = DisplayCropMode::None;
   DisplayAspectRatio display_aspect_ratio = DisplayAspectRatio::R4_3;
   bool display_linear_filtering = true;
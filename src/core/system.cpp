@@ -12,6 +12,7 @@
 #include "dma.h"
 #include "game_list.h"
 #include "gpu.h"
+#include "gpu_dump.h"
 #include "host_display.h"
 #include "host_interface.h"
 #include "host_interface_progress_callback.h"
@@ -110,6 +111,9 @@ bool System::RecreateGPU(GPURenderer renderer)
     return false;
   }
 
+  // the command stream doesn't depend on the renderer, so keep recording
+  m_gpu->SetDumpRecorder(m_gpu_dump_recorder.get());
+
   if (state_valid)
   {
     state_stream->SeekAbsolute(0);
@@ -126,11 +130,58 @@ void System::UpdateGPUSettings()
   m_gpu->UpdateSettings();
 }
 
+bool System::StartDumpingGPU(const char* filename)
+{
+  StopDumpingGPU();
+
+  std::unique_ptr<GrowableMemoryByteStream> state_stream = ByteStream_CreateGrowableMemoryStream();
+  if (!SaveState(state_stream.get(), 0))
+  {
+    Log_ErrorPrintf("Failed to save state for GPU dump");
+    return false;
+  }
+
+  // replays only need the GPU state, so don't make them look for the disc
+  SAVE_STATE_HEADER* header = reinterpret_cast<SAVE_STATE_HEADER*>(state_stream->GetMemoryPointer());
+  header->media_filename_length = 0;
+
+  m_gpu_dump_recorder = GPUDump::Recorder::Create(filename, state_stream->GetMemoryPointer(),
+                                                  static_cast<u32>(state_stream->GetSize()));
+  if (!m_gpu_dump_recorder)
+    return false;
+
+  Log_InfoPrintf("Started dumping GPU commands to '%s'", filename);
+  m_gpu->SetDumpRecorder(m_gpu_dump_recorder.get());
+  return true;
+}
+
+bool System::StopDumpingGPU()
+{
+  if (!m_gpu_dump_recorder)
+    return false;
+
+  if (m_gpu)
+    m_gpu->SetDumpRecorder(nullptr);
+
+  m_gpu_dump_recorder.reset();
+  return true;
+}
+
 void System::SetCPUExecutionMode(CPUExecutionMode mode)
 {
   m_cpu_execution_mode = mode;
   m_cpu_code_cache->Flush();
-  m_cpu_code_cache->SetUseRecompiler(mode == CPUExecutionMode::Recompiler);
+  m_cpu_code_cache->SetExecutionMode(mode);
+}
+
+void System::SetCPUFastmem(bool enabled)
+{
+  m_cpu_code_cache->SetUseFastmem(enabled);
+}
+
+void System::SetCPUIdleLoopSkipping(bool enabled)
+{
+  m_cpu_code_cache->SetIdleLoopSkipping(enabled);
 }
 
 std::unique_ptr<CDImage> System::OpenCDImage(const char* path, bool force_preload)
@@ -295,7 +346,8 @@ bool System::InitializeComponents(bool force_software_renderer)
     return false;
 
   m_cpu->Initialize(m_bus.get());
-  m_cpu_code_cache->Initialize(this, m_cpu.get(), m_bus.get(), m_cpu_execution_mode == CPUExecutionMode::Recompiler);
+  m_cpu_code_cache->Initialize(this, m_cpu.get(), m_bus.get(), m_cpu_execution_mode, settings.cpu_fastmem,
+                               settings.cpu_idle_loop_skipping);
   m_bus->Initialize(m_cpu.get(), m_cpu_code_cache.get(), m_dma.get(), m_interrupt_controller.get(), m_gpu.get(),
                     m_cdrom.get(), m_pad.get(), m_timers.get(), m_spu.get(), m_mdec.get(), m_sio.get());
 
@@ -319,6 +371,7 @@ bool System::InitializeComponents(bool force_software_renderer)
 
 void System::DestroyComponents()
 {
+  StopDumpingGPU();
   m_mdec.reset();
   m_spu.reset();
   m_timers.reset();
@@ -429,6 +482,9 @@ bool System::DoState(StateWrapper& sw)
 
 void System::Reset()
 {
+  // the dump would be replayed from the wrong state
+  StopDumpingGPU();
+
   m_cpu->Reset();
   m_cpu_code_cache->Flush();
   m_bus->Reset();
@@ -455,6 +511,8 @@ bool System::LoadState(ByteStream* state)
 
 bool System::DoLoadState(ByteStream* state, bool init_components, bool force_software_renderer)
 {
+  StopDumpingGPU();
+
   SAVE_STATE_HEADER header;
   if (!state->Read2(&header, sizeof(header)))
     return false;
@@ -620,6 +678,10 @@ void System::RunFrame()
       m_cpu_code_cache->Execute();
       RunEvents();
     } while (!m_frame_done);
+
+    m_idle_loop_skipped_ticks = m_cpu_code_cache->GetIdleLoopSkippedTicks();
+    m_cpu_code_cache->ResetIdleLoopSkippedTicks();
+    m_idle_loop_skipped_ticks_accumulator += static_cast<u32>(m_idle_loop_skipped_ticks);
   }
 
   // Generate any pending samples from the SPU before sleeping, this way we reduce the chances of underruns.
@@ -701,6 +763,13 @@ void System::UpdatePerformanceCounters()
   m_speed = static_cast<float>(static_cast<double>(m_global_tick_counter - m_last_global_tick_counter) /
                                (static_cast<double>(MASTER_CLOCK) * time)) *
             100.0f;
+  m_idle_loop_skip_percent =
+    (m_global_tick_counter != m_last_global_tick_counter) ?
+      (static_cast<float>(static_cast<double>(m_idle_loop_skipped_ticks_accumulator) /
+                          static_cast<double>(m_global_tick_counter - m_last_global_tick_counter)) *
+       100.0f) :
+      0.0f;
+  m_idle_loop_skipped_ticks_accumulator = 0;
   m_last_global_tick_counter = m_global_tick_counter;
   m_fps_timer.Reset();
 
@@ -712,6 +781,7 @@ void System::ResetPerformanceCounters()
   m_last_frame_number = m_frame_number;
   m_last_internal_frame_number = m_internal_frame_number;
   m_last_global_tick_counter = m_global_tick_counter;
+  m_idle_loop_skipped_ticks_accumulator = 0;
   m_average_frame_time_accumulator = 0.0f;
   m_worst_frame_time_accumulator = 0.0f;
   m_fps_timer.Reset();
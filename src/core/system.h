@@ -11,6 +11,10 @@ class ByteStream;
 class CDImage;
 class StateWrapper;
 
+namespace GPUDump {
+class Recorder;
+}
+
 namespace CPU {
 class Core;
 class CodeCache;
@@ -66,6 +70,7 @@ public:
   // Accessing components.
   HostInterface* GetHostInterface() const { return m_host_interface; }
   CPU::Core* GetCPU() const { return m_cpu.get(); }
+  CPU::CodeCache* GetCPUCodeCache() const { return m_cpu_code_cache.get(); }
   Bus* GetBus() const { return m_bus.get(); }
   DMA* GetDMA() const { return m_dma.get(); }
   InterruptController* GetInterruptController() const { return m_interrupt_controller.get(); }
@@ -101,6 +106,12 @@ public:
   float GetWorstFrameTime() const { return m_worst_frame_time; }
   float GetThrottleFrequency() const { return m_throttle_frequency; }
 
+  /// Returns the number of cycles skipped by idle loop detection in the last frame.
+  TickCount GetIdleLoopSkippedTicks() const { return m_idle_loop_skipped_ticks; }
+
+  /// Returns the percentage of emulated time which was skipped by idle loop detection, over the last second.
+  float GetIdleLoopSkipPercent() const { return m_idle_loop_skip_percent; }
+
   bool Boot(const SystemBootParameters& params);
   void Reset();
 
@@ -113,9 +124,24 @@ public:
   /// Updates GPU settings, without recreating the renderer.
   void UpdateGPUSettings();
 
+  /// Returns true if the GPU command stream is being recorded.
+  bool IsDumpingGPU() const { return static_cast<bool>(m_gpu_dump_recorder); }
+
+  /// Starts recording the GPU command stream to a file, along with the current state for replays to start from.
+  bool StartDumpingGPU(const char* filename);
+
+  /// Stops recording the GPU command stream, if started.
+  bool StopDumpingGPU();
+
   /// Forcibly changes the CPU execution mode, ignoring settings.
   void SetCPUExecutionMode(CPUExecutionMode mode);
 
+  /// Enables or disables direct RAM access from recompiled code.
+  void SetCPUFastmem(bool enabled);
+
+  /// Enables or disables fast-forwarding through loops which are waiting for an event.
+  void SetCPUIdleLoopSkipping(bool enabled);
+
   void RunFrame();
 
   /// Adjusts the throttle frequency, i.e. how many times we should sleep per second.
@@ -229,6 +255,7 @@ private:
   std::unique_ptr<SPU> m_spu;
   std::unique_ptr<MDEC> m_mdec;
   std::unique_ptr<SIO> m_sio;
+  std::unique_ptr<GPUDump::Recorder> m_gpu_dump_recorder;
   ConsoleRegion m_region = ConsoleRegion::NTSC_U;
   CPUExecutionMode m_cpu_execution_mode = CPUExecutionMode::Interpreter;
   u32 m_frame_number = 1;
@@ -259,6 +286,9 @@ private:
   float m_speed = 0.0f;
   float m_worst_frame_time = 0.0f;
   float m_average_frame_time = 0.0f;
+  float m_idle_loop_skip_percent = 0.0f;
+  TickCount m_idle_loop_skipped_ticks = 0;
+  u32 m_idle_loop_skipped_ticks_accumulator = 0;
   u32 m_last_frame_number = 0;
   u32 m_last_internal_frame_number = 0;
   u32 m_last_global_tick_counter = 0;
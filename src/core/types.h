@@ -44,6 +44,7 @@ enum class CPUExecutionMode : u8
 {
   Interpreter,
   CachedInterpreter,
+  ThreadedInterpreter,
   Recompiler,
   Count
 };
@@ -0,0 +1,226 @@
+#include "common/log.h"
+#include "common/md5_digest.h"
+#include "common/timer.h"
+#include "core/gpu.h"
+#include "core/gpu_dump.h"
+#include "core/settings.h"
+#include "replay_host_interface.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+static void PrintUsage(const char* progname)
+{
+  std::fprintf(stderr,
+               "Usage: %s [-renderer <name>] [-scale <factor>] [-threads <count>] [-gputhread] [-loops <count>] "
+               "[-hashes] <filename>\n"
+               "Replays a GPU dump as fast as possible, and reports the frame rate and number of draws.\n"
+               "  -renderer <name>: Renderer to replay with, defaults to Software. OpenGL and Vulkan render "
+               "without a window, e.g. with Mesa's surfaceless EGL or lavapipe.\n"
+               "  -scale <factor>: Internal resolution scale, defaults to 1.\n"
+               "  -threads <count>: Number of software renderer threads, defaults to 1.\n"
+               "  -gputhread: Runs the renderer on its own thread, as with the GPU thread setting.\n"
+               "  -loops <count>: Number of times to replay the dump, defaults to 1.\n"
+               "  -hashes: Prints a hash of VRAM after each frame, for comparing against other renderers or builds. "
+               "Reading VRAM back is included in the timings.\n"
+               "  filename: GPU dump to replay.\n",
+               progname);
+}
+
+static void PrintVRAMHash(u32 frame, u32 num_polygons, GPU* gpu)
+{
+  u8 hash[16];
+  MD5Digest digest;
+  digest.Update(gpu->GetVRAM(), GPU::VRAM_SIZE);
+  digest.Final(hash);
+
+  char hash_str[33];
+  for (u32 i = 0; i < 16; i++)
+    std::snprintf(&hash_str[i * 2], 3, "%02x", hash[i]);
+
+  std::printf("Frame %u: %s (%u polygons)\n", frame, hash_str, num_polygons);
+}
+
+/// Replays every packet in the dump, returning the number of frames.
+static u32 ReplayDump(GPUDump::Reader& reader, GPU* gpu, bool print_hashes)
+{
+  GPUDump::Packet packet;
+  u32 num_frames = 0;
+  u32 frame_start_polygons = gpu->GetStats().num_polygons;
+
+  while (reader.ReadPacket(&packet))
+  {
+    switch (packet.type)
+    {
+      case GPUDump::PacketType::GP0Write:
+        gpu->WriteRegister(0x00, packet.value);
+        break;
+
+      case GPUDump::PacketType::GP1Write:
+        gpu->WriteRegister(0x04, packet.value);
+        break;
+
+      case GPUDump::PacketType::DMAWrite:
+        gpu->DMAWrite(packet.words.data(), packet.value);
+        break;
+
+      case GPUDump::PacketType::GPUREADRead:
+        gpu->ReplayGPUREADRead(packet.value);
+        break;
+
+      case GPUDump::PacketType::CommandTicks:
+        gpu->ReplayCommandTicks(static_cast<TickCount>(packet.value));
+        break;
+
+      case GPUDump::PacketType::ActiveLineLSB:
+        gpu->ReplayActiveLineLSB(static_cast<u8>(packet.value));
+        break;
+
+      case GPUDump::PacketType::VBlank:
+      {
+        gpu->ReplayVBlank();
+        if (print_hashes)
+          PrintVRAMHash(num_frames, gpu->GetStats().num_polygons - frame_start_polygons, gpu);
+
+        frame_start_polygons = gpu->GetStats().num_polygons;
+        num_frames++;
+      }
+      break;
+
+      default:
+        break;
+    }
+  }
+
+  return num_frames;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string filename;
+  GPURenderer renderer = GPURenderer::Software;
+  u32 resolution_scale = 1;
+  u32 render_threads = 1;
+  u32 num_loops = 1;
+  bool use_gpu_thread = false;
+  bool print_hashes = false;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const bool has_value = (i + 1) < argc;
+    if (std::strcmp(argv[i], "-renderer") == 0 && has_value)
+    {
+      std::optional<GPURenderer> parsed_renderer = Settings::ParseRendererName(argv[++i]);
+      if (!parsed_renderer)
+      {
+        std::fprintf(stderr, "Unknown renderer '%s'\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+
+      renderer = *parsed_renderer;
+    }
+    else if (std::strcmp(argv[i], "-scale") == 0 && has_value)
+    {
+      resolution_scale = std::max<u32>(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1);
+    }
+    else if (std::strcmp(argv[i], "-threads") == 0 && has_value)
+    {
+      render_threads = std::max<u32>(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1);
+    }
+    else if (std::strcmp(argv[i], "-gputhread") == 0)
+    {
+      use_gpu_thread = true;
+    }
+    else if (std::strcmp(argv[i], "-loops") == 0 && has_value)
+    {
+      num_loops = std::max<u32>(static_cast<u32>(std::strtoul(argv[++i], nullptr, 10)), 1);
+    }
+    else if (std::strcmp(argv[i], "-hashes") == 0)
+    {
+      print_hashes = true;
+    }
+    else if (argv[i][0] != '-' && filename.empty())
+    {
+      filename = argv[i];
+    }
+    else
+    {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (filename.empty())
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  // D3D11 can't render without a window
+#ifdef WITH_FRONTEND_COMMON
+  const bool renderer_supported = (renderer == GPURenderer::Software || renderer == GPURenderer::HardwareOpenGL ||
+                                   renderer == GPURenderer::HardwareVulkan);
+#else
+  const bool renderer_supported = (renderer == GPURenderer::Software);
+#endif
+  if (!renderer_supported)
+  {
+    std::fprintf(stderr, "The %s renderer is not supported for replays in this build\n",
+                 Settings::GetRendererName(renderer));
+    return EXIT_FAILURE;
+  }
+
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_WARNING);
+
+  GPUDump::Reader reader;
+  if (!reader.Open(filename.c_str()))
+  {
+    std::fprintf(stderr, "Failed to open GPU dump '%s'\n", filename.c_str());
+    return EXIT_FAILURE;
+  }
+
+  std::unique_ptr<ReplayHostInterface> host_interface = std::make_unique<ReplayHostInterface>();
+  if (!host_interface->Initialize() ||
+      !host_interface->Boot(reader, renderer, resolution_scale, render_threads, use_gpu_thread))
+  {
+    std::fprintf(stderr, "Failed to restore state from GPU dump\n");
+    return EXIT_FAILURE;
+  }
+
+  GPU* gpu = host_interface->GetGPU();
+  u32 num_frames = 0;
+  Common::Timer timer;
+  for (u32 loop = 0; loop < num_loops; loop++)
+  {
+    if (loop > 0)
+    {
+      reader.Rewind();
+      if (!host_interface->Restart(reader))
+      {
+        std::fprintf(stderr, "Failed to restore state from GPU dump\n");
+        host_interface->Shutdown();
+        return EXIT_FAILURE;
+      }
+    }
+
+    num_frames += ReplayDump(reader, gpu, print_hashes);
+  }
+
+  // make sure everything has actually been drawn before stopping the clock
+  gpu->GetVRAM();
+
+  const double seconds = timer.GetTimeSeconds();
+  const GPU::Stats& stats = gpu->GetStats();
+  std::printf("%u frames in %.3f seconds, %.2f FPS with the %s renderer\n", num_frames, seconds,
+              (seconds > 0.0) ? (static_cast<double>(num_frames) / seconds) : 0.0,
+              Settings::GetRendererName(renderer));
+  std::printf("%u polygons, %u vertices, %u VRAM fills, %u VRAM writes, %u VRAM copies, %u VRAM reads\n",
+              stats.num_polygons, stats.num_vertices, stats.num_vram_fills, stats.num_vram_writes,
+              stats.num_vram_copies, stats.num_vram_reads);
+
+  host_interface->Shutdown();
+  return EXIT_SUCCESS;
+}
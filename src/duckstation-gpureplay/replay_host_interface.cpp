@@ -0,0 +1,216 @@
+#include "replay_host_interface.h"
+#include "common/audio_stream.h"
+#include "common/byte_stream.h"
+#include "common/log.h"
+#include "common/window_info.h"
+#include "core/dma.h"
+#include "core/gpu.h"
+#include "core/gpu_dump.h"
+#include "core/host_display.h"
+#include "core/system.h"
+Log_SetChannel(ReplayHostInterface);
+
+#ifdef WITH_FRONTEND_COMMON
+#include "frontend-common/opengl_host_display.h"
+#include "frontend-common/vulkan_host_display.h"
+#endif
+
+namespace {
+
+class NullHostDisplayTexture final : public HostDisplayTexture
+{
+public:
+  NullHostDisplayTexture(u32 width, u32 height) : m_width(width), m_height(height) {}
+  ~NullHostDisplayTexture() override = default;
+
+  void* GetHandle() const override { return const_cast<NullHostDisplayTexture*>(this); }
+  u32 GetWidth() const override { return m_width; }
+  u32 GetHeight() const override { return m_height; }
+
+private:
+  u32 m_width;
+  u32 m_height;
+};
+
+// Accepts and discards everything written to the display, for the software renderer.
+class NullHostDisplay final : public HostDisplay
+{
+public:
+  RenderAPI GetRenderAPI() const override { return RenderAPI::None; }
+  void* GetRenderDevice() const override { return nullptr; }
+  void* GetRenderContext() const override { return nullptr; }
+
+  bool HasRenderDevice() const override { return true; }
+  bool HasRenderSurface() const override { return false; }
+
+  bool CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device) override
+  {
+    return true;
+  }
+  bool InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device) override { return true; }
+  bool MakeRenderContextCurrent() override { return true; }
+  bool DoneRenderContextCurrent() override { return true; }
+  void DestroyRenderDevice() override {}
+  void DestroyRenderSurface() override {}
+  bool ChangeRenderWindow(const WindowInfo& wi) override { return true; }
+  void ResizeRenderWindow(s32 new_window_width, s32 new_window_height) override {}
+
+  std::unique_ptr<HostDisplayTexture> CreateTexture(u32 width, u32 height, const void* data, u32 data_stride,
+                                                    bool dynamic = false) override
+  {
+    return std::make_unique<NullHostDisplayTexture>(width, height);
+  }
+  void UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height, const void* data,
+                     u32 data_stride) override
+  {
+  }
+  bool DownloadTexture(const void* texture_handle, u32 x, u32 y, u32 width, u32 height, void* out_data,
+                       u32 out_data_stride) override
+  {
+    return false;
+  }
+
+  bool Render() override { return true; }
+  void SetVSync(bool enabled) override {}
+};
+
+} // namespace
+
+ReplayHostInterface::ReplayHostInterface() = default;
+
+ReplayHostInterface::~ReplayHostInterface() = default;
+
+bool ReplayHostInterface::Initialize()
+{
+  if (!HostInterface::Initialize())
+    return false;
+
+  // nothing other than the GPU runs, so keep the rest of the system as light as possible
+  m_settings.speed_limiter_enabled = false;
+  m_settings.video_sync_enabled = false;
+  m_settings.cdrom_read_thread = false;
+  m_settings.audio_backend = AudioBackend::Null;
+  m_settings.controller_types.fill(ControllerType::None);
+  m_settings.memory_card_types.fill(MemoryCardType::None);
+  return true;
+}
+
+void ReplayHostInterface::Shutdown()
+{
+  DestroySystem();
+  HostInterface::Shutdown();
+}
+
+void ReplayHostInterface::ReportError(const char* message)
+{
+  Log_ErrorPrint(message);
+}
+
+void ReplayHostInterface::ReportMessage(const char* message)
+{
+  Log_InfoPrint(message);
+}
+
+bool ReplayHostInterface::ConfirmMessage(const char* message)
+{
+  Log_WarningPrint(message);
+  return true;
+}
+
+void ReplayHostInterface::AddOSDMessage(std::string message, float duration)
+{
+  Log_InfoPrint(message.c_str());
+}
+
+std::string ReplayHostInterface::GetStringSettingValue(const char* section, const char* key,
+                                                       const char* default_value)
+{
+  return default_value;
+}
+
+bool ReplayHostInterface::Boot(const GPUDump::Reader& reader, GPURenderer renderer, u32 resolution_scale,
+                               u32 render_threads, bool use_gpu_thread)
+{
+  m_settings.gpu_renderer = renderer;
+  m_settings.gpu_resolution_scale = resolution_scale;
+  m_settings.gpu_software_resolution_scale = resolution_scale;
+  m_settings.gpu_render_threads = render_threads;
+  m_settings.gpu_use_thread = use_gpu_thread;
+
+  SystemBootParameters boot_params;
+  boot_params.state_stream = ByteStream_CreateReadOnlyMemoryStream(reader.GetStateData(), reader.GetStateSize());
+  if (!BootSystem(boot_params))
+    return false;
+
+  BeginReplay();
+  return true;
+}
+
+bool ReplayHostInterface::Restart(const GPUDump::Reader& reader)
+{
+  std::unique_ptr<ByteStream> stream =
+    ByteStream_CreateReadOnlyMemoryStream(reader.GetStateData(), reader.GetStateSize());
+  if (!m_system->LoadState(stream.get()))
+    return false;
+
+  BeginReplay();
+  return true;
+}
+
+GPU* ReplayHostInterface::GetGPU() const
+{
+  return m_system->GetGPU();
+}
+
+void ReplayHostInterface::BeginReplay()
+{
+  // DMA blocks are part of the dump, so don't let the GPU's DMA requests pull anything from RAM
+  m_system->GetDMA()->Reset();
+  m_system->GetGPU()->BeginReplay();
+}
+
+bool ReplayHostInterface::AcquireHostDisplay()
+{
+  switch (m_settings.gpu_renderer)
+  {
+#ifdef WITH_FRONTEND_COMMON
+    case GPURenderer::HardwareOpenGL:
+      m_display = std::make_unique<FrontendCommon::OpenGLHostDisplay>();
+      break;
+
+    case GPURenderer::HardwareVulkan:
+      m_display = std::make_unique<FrontendCommon::VulkanHostDisplay>();
+      break;
+#endif
+
+    default:
+      m_display = std::make_unique<NullHostDisplay>();
+      return true;
+  }
+
+  // no window, the renderer only draws to its own framebuffers
+  const WindowInfo wi;
+  if (!m_display->CreateRenderDevice(wi, m_settings.gpu_adapter, m_settings.gpu_use_debug_device) ||
+      !m_display->InitializeRenderDevice(GetShaderCacheBasePath(), m_settings.gpu_use_debug_device))
+  {
+    ReportError("Failed to create/initialize display render device");
+    m_display.reset();
+    return false;
+  }
+
+  return true;
+}
+
+void ReplayHostInterface::ReleaseHostDisplay()
+{
+  if (!m_display)
+    return;
+
+  m_display->DestroyRenderDevice();
+  m_display.reset();
+}
+
+std::unique_ptr<AudioStream> ReplayHostInterface::CreateAudioStream(AudioBackend backend)
+{
+  return AudioStream::CreateNullAudioStream();
+}
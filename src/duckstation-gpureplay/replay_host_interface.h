@@ -0,0 +1,46 @@
+#pragma once
+#include "core/host_interface.h"
+#include "core/types.h"
+#include <string>
+
+class GPU;
+
+namespace GPUDump {
+class Reader;
+}
+
+// Headless host interface which restores the state from a GPU dump, and hands the GPU to the replay loop. Nothing
+// other than the GPU is run.
+class ReplayHostInterface final : public HostInterface
+{
+public:
+  ReplayHostInterface();
+  ~ReplayHostInterface() override;
+
+  bool Initialize() override;
+  void Shutdown() override;
+
+  void ReportError(const char* message) override;
+  void ReportMessage(const char* message) override;
+  bool ConfirmMessage(const char* message) override;
+  void AddOSDMessage(std::string message, float duration = 2.0f) override;
+
+  std::string GetStringSettingValue(const char* section, const char* key, const char* default_value = "") override;
+
+  /// Boots the system from the state at the start of the dump, with the specified renderer.
+  bool Boot(const GPUDump::Reader& reader, GPURenderer renderer, u32 resolution_scale, u32 render_threads,
+            bool use_gpu_thread);
+
+  /// Restores the state at the start of the dump again, for replaying it multiple times.
+  bool Restart(const GPUDump::Reader& reader);
+
+  GPU* GetGPU() const;
+
+protected:
+  bool AcquireHostDisplay() override;
+  void ReleaseHostDisplay() override;
+  std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend) override;
+
+private:
+  void BeginReplay();
+};
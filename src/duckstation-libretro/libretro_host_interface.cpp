@@ -15,6 +15,7 @@
 #include "libretro_opengl_host_display.h"
 #include "libretro_settings_interface.h"
 #include "libretro_vulkan_host_display.h"
+#include <algorithm>
 #include <array>
 #include <cstring>
 #include <tuple>
@@ -178,7 +179,11 @@ void LibretroHostInterface::retro_get_system_av_info(struct retro_system_av_info
 
 void LibretroHostInterface::GetSystemAVInfo(struct retro_system_av_info* info, bool use_resolution_scale)
 {
-  const u32 resolution_scale = use_resolution_scale ? m_settings.gpu_resolution_scale : 1u;
+  // The software renderer has its own resolution scale.
+  const u32 resolution_scale =
+    use_resolution_scale ?
+      m_settings.gpu_resolution_scale :
+      std::clamp<u32>(m_settings.gpu_software_resolution_scale, 1, GPU::MAX_SOFTWARE_RESOLUTION_SCALE);
   Assert(m_system);
 
   std::memset(info, 0, sizeof(*info));
@@ -350,7 +355,7 @@ void LibretroHostInterface::OnSystemDestroyed()
   m_using_hardware_renderer = false;
 }
 
-static std::array<retro_core_option_definition, 23> s_option_definitions = {{
+static std::array<retro_core_option_definition, 28> s_option_definitions = {{
   {"Console.Region",
    "Console Region",
    "Determines which region/hardware to emulate. Auto-Detect will use the region of the disc inserted.",
@@ -377,8 +382,21 @@ static std::array<retro_core_option_definition, 23> s_option_definitions = {{
   {"CPU.ExecutionMode",
    "CPU Execution Mode",
    "Which mode to use for CPU emulation. Recompiler provides the best performance.",
-   {{"Interpreter", "Interpreter"}, {"CachedIntepreter", "Cached Interpreter"}, {"Recompiler", "Recompiler"}},
+   {{"Interpreter", "Interpreter"},
+    {"CachedIntepreter", "Cached Interpreter"},
+    {"ThreadedInterpreter", "Threaded Interpreter"},
+    {"Recompiler", "Recompiler"}},
    "Recompiler"},
+  {"CPU.Fastmem",
+   "CPU Fastmem",
+   "Lets the recompiler access RAM directly through host memory mappings. Faster, but may be unstable.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "false"},
+  {"CPU.IdleLoopSkipping",
+   "CPU Idle Loop Skipping",
+   "Skips ahead to the next event when the game is waiting in a loop which doesn't change any state.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "false"},
   {"GPU.Renderer",
    "GPU Renderer",
    "Which renderer to use to emulate the GPU",
@@ -416,6 +434,26 @@ static std::array<retro_core_option_definition, 23> s_option_definitions = {{
     {"15", "15x (15360x7680 VRAM)"},
     {"16", "16x (16384x8192 VRAM)"}},
    "1"},
+  {"GPU.UseThread",
+   "GPU Thread",
+   "Rasterizes on a separate thread when using the software renderer. Faster on multi-core systems. Not available "
+   "with the hardware renderers.",
+   {{"true", "Enabled"}, {"false", "Disabled"}},
+   "false"},
+  {"GPU.RenderThreads",
+   "Software Renderer Threads",
+   "Number of threads to split rasterization between when the software renderer thread is enabled.",
+   {{"1", "1"}, {"2", "2"}, {"3", "3"}, {"4", "4"}, {"6", "6"}, {"8", "8"}, {"12", "12"}, {"16", "16"}},
+   "1"},
+  {"GPU.SoftwareResolutionScale",
+   "Software Renderer Resolution Scale",
+   "Renders at a multiple of the native resolution when using the software renderer. Games still see native VRAM. "
+   "Larger values are much slower.",
+   {{"1", "1x (1024x512 VRAM)"},
+    {"2", "2x (2048x1024 VRAM)"},
+    {"3", "3x (3072x1536 VRAM)"},
+    {"4", "4x (4096x2048 VRAM)"}},
+   "1"},
   {"GPU.TrueColor",
    "True Color Rendering",
    "Disables dithering and uses the full 8 bits per channel of color information. May break rendering in some games.",
@@ -558,6 +596,10 @@ void LibretroHostInterface::LoadSettings()
   // Ensure we don't use the standalone memcard directory in shared mode.
   for (u32 i = 0; i < NUM_CONTROLLER_AND_CARD_PORTS; i++)
     m_settings.memory_card_paths[i] = GetSharedMemoryCardPath(i);
+
+  // The frontend owns the hardware context and expects it to be used on its thread.
+  if (m_settings.gpu_renderer != GPURenderer::Software)
+    m_settings.gpu_use_thread = false;
 }
 
 void LibretroHostInterface::UpdateSettings()
@@ -585,6 +627,13 @@ void LibretroHostInterface::UpdateSettings()
     old_settings.gpu_resolution_scale = m_settings.gpu_resolution_scale;
   }
 
+  if (m_settings.gpu_software_resolution_scale != old_settings.gpu_software_resolution_scale &&
+      m_settings.gpu_renderer == GPURenderer::Software)
+  {
+    ReportMessage("Resolution changed, updating system AV info...");
+    UpdateSystemAVInfo(false);
+  }
+
   if (m_settings.gpu_renderer != old_settings.gpu_renderer)
   {
     ReportFormattedMessage("Switch to %s renderer pending, please restart the core to apply.",
@@ -0,0 +1,219 @@
+#include "lockstep_host_interface.h"
+#include "common/assert.h"
+#include "common/audio_stream.h"
+#include "common/byte_stream.h"
+#include "common/log.h"
+#include "common/md5_digest.h"
+#include "core/bus.h"
+#include "core/cpu_code_cache.h"
+#include "core/cpu_core.h"
+#include "core/host_display.h"
+#include "core/system.h"
+Log_SetChannel(LockstepHostInterface);
+
+namespace {
+
+class NullHostDisplayTexture final : public HostDisplayTexture
+{
+public:
+  NullHostDisplayTexture(u32 width, u32 height) : m_width(width), m_height(height) {}
+  ~NullHostDisplayTexture() override = default;
+
+  void* GetHandle() const override { return const_cast<NullHostDisplayTexture*>(this); }
+  u32 GetWidth() const override { return m_width; }
+  u32 GetHeight() const override { return m_height; }
+
+private:
+  u32 m_width;
+  u32 m_height;
+};
+
+// Accepts and discards everything written to the display.
+class NullHostDisplay final : public HostDisplay
+{
+public:
+  RenderAPI GetRenderAPI() const override { return RenderAPI::None; }
+  void* GetRenderDevice() const override { return nullptr; }
+  void* GetRenderContext() const override { return nullptr; }
+
+  bool HasRenderDevice() const override { return true; }
+  bool HasRenderSurface() const override { return false; }
+
+  bool CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device) override
+  {
+    return true;
+  }
+  bool InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device) override { return true; }
+  bool MakeRenderContextCurrent() override { return true; }
+  bool DoneRenderContextCurrent() override { return true; }
+  void DestroyRenderDevice() override {}
+  void DestroyRenderSurface() override {}
+  bool ChangeRenderWindow(const WindowInfo& wi) override { return true; }
+  void ResizeRenderWindow(s32 new_window_width, s32 new_window_height) override {}
+
+  std::unique_ptr<HostDisplayTexture> CreateTexture(u32 width, u32 height, const void* data, u32 data_stride,
+                                                    bool dynamic = false) override
+  {
+    return std::make_unique<NullHostDisplayTexture>(width, height);
+  }
+  void UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height, const void* data,
+                     u32 data_stride) override
+  {
+  }
+  bool DownloadTexture(const void* texture_handle, u32 x, u32 y, u32 width, u32 height, void* out_data,
+                       u32 out_data_stride) override
+  {
+    return false;
+  }
+
+  bool Render() override { return true; }
+  void SetVSync(bool enabled) override {}
+};
+
+} // namespace
+
+LockstepHostInterface::LockstepHostInterface(std::string name) : m_name(std::move(name)) {}
+
+LockstepHostInterface::~LockstepHostInterface() = default;
+
+bool LockstepHostInterface::Initialize()
+{
+  if (!HostInterface::Initialize())
+    return false;
+
+  // nothing which would make the instances behave differently, other than the execution mode
+  m_settings.cpu_fastmem = false;
+  m_settings.cpu_idle_loop_skipping = false;
+  m_settings.speed_limiter_enabled = false;
+  m_settings.gpu_renderer = GPURenderer::Software;
+  m_settings.cdrom_read_thread = false;
+  m_settings.audio_backend = AudioBackend::Null;
+  m_settings.controller_types.fill(ControllerType::None);
+  m_settings.memory_card_types.fill(MemoryCardType::None);
+  return true;
+}
+
+void LockstepHostInterface::Shutdown()
+{
+  DestroySystem();
+  HostInterface::Shutdown();
+}
+
+void LockstepHostInterface::ReportError(const char* message)
+{
+  Log_ErrorPrintf("[%s] %s", m_name.c_str(), message);
+}
+
+void LockstepHostInterface::ReportMessage(const char* message)
+{
+  Log_InfoPrintf("[%s] %s", m_name.c_str(), message);
+}
+
+bool LockstepHostInterface::ConfirmMessage(const char* message)
+{
+  Log_WarningPrintf("[%s] %s", m_name.c_str(), message);
+  return true;
+}
+
+void LockstepHostInterface::AddOSDMessage(std::string message, float duration)
+{
+  Log_InfoPrintf("[%s] %s", m_name.c_str(), message.c_str());
+}
+
+std::string LockstepHostInterface::GetStringSettingValue(const char* section, const char* key,
+                                                         const char* default_value)
+{
+  return default_value;
+}
+
+bool LockstepHostInterface::Boot(const std::string& bios_path, const std::string& filename,
+                                 CPUExecutionMode execution_mode)
+{
+  m_settings.bios_path = bios_path;
+  m_settings.cpu_execution_mode = execution_mode;
+
+  SystemBootParameters boot_params(filename);
+  if (!BootSystem(boot_params))
+    return false;
+
+  m_system->GetCPUCodeCache()->SetBlockExecutedCallback(
+    [this](const CPU::CodeBlock& block) { OnBlockExecuted(block); });
+  return true;
+}
+
+bool LockstepHostInterface::RunFrame()
+{
+  // no screenshot, the display isn't used
+  m_frame_state = ByteStream_CreateGrowableMemoryStream();
+  if (!m_system->SaveState(m_frame_state.get(), 0))
+  {
+    Log_ErrorPrintf("[%s] Failed to save state at start of frame", m_name.c_str());
+    return false;
+  }
+
+  m_block_states.clear();
+  m_system->RunFrame();
+  return true;
+}
+
+bool LockstepHostInterface::ReplayFrame(size_t ram_block_index)
+{
+  if (!m_frame_state->SeekAbsolute(0) || !m_system->LoadState(m_frame_state.get()))
+  {
+    Log_ErrorPrintf("[%s] Failed to load state at start of frame", m_name.c_str());
+    return false;
+  }
+
+  m_block_states.clear();
+  m_block_ram.clear();
+  m_ram_block_index = ram_block_index;
+  m_system->RunFrame();
+  m_ram_block_index = SIZE_MAX;
+  return true;
+}
+
+std::array<u8, 16> LockstepHostInterface::GetRAMHash() const
+{
+  std::array<u8, 16> hash;
+  MD5Digest digest;
+  digest.Update(m_system->GetBus()->GetRAM(), Bus::RAM_SIZE);
+  digest.Final(hash.data());
+  return hash;
+}
+
+bool LockstepHostInterface::AcquireHostDisplay()
+{
+  m_display = std::make_unique<NullHostDisplay>();
+  return true;
+}
+
+void LockstepHostInterface::ReleaseHostDisplay()
+{
+  m_display.reset();
+}
+
+std::unique_ptr<AudioStream> LockstepHostInterface::CreateAudioStream(AudioBackend backend)
+{
+  return AudioStream::CreateNullAudioStream();
+}
+
+void LockstepHostInterface::OnBlockExecuted(const CPU::CodeBlock& block)
+{
+  const CPU::Core* cpu = m_system->GetCPU();
+  const CPU::Registers& regs = cpu->GetRegs();
+
+  BlockState bs;
+  bs.block_pc = block.GetPC();
+  bs.tick = m_system->GetGlobalTickCounter() + static_cast<u32>(cpu->GetPendingTicks());
+  std::copy_n(regs.r, 32, bs.regs.begin());
+  bs.regs[32] = regs.hi;
+  bs.regs[33] = regs.lo;
+  bs.regs[34] = regs.pc;
+  m_block_states.push_back(bs);
+
+  if ((m_block_states.size() - 1) == m_ram_block_index)
+  {
+    const u8* ram = m_system->GetBus()->GetRAM();
+    m_block_ram.assign(ram, ram + Bus::RAM_SIZE);
+  }
+}
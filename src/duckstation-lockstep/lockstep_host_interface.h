@@ -0,0 +1,75 @@
+#pragma once
+#include "core/host_interface.h"
+#include "core/types.h"
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GrowableMemoryByteStream;
+
+namespace CPU {
+struct CodeBlock;
+}
+
+// Headless host interface which runs a single system with no display or audio output, recording the CPU state
+// after each block for comparing against another instance.
+class LockstepHostInterface final : public HostInterface
+{
+public:
+  struct BlockState
+  {
+    u32 block_pc;
+    u32 tick;
+
+    // r0-r31, hi, lo, pc after the block executes
+    std::array<u32, 35> regs;
+  };
+
+  LockstepHostInterface(std::string name);
+  ~LockstepHostInterface() override;
+
+  ALWAYS_INLINE const std::string& GetName() const { return m_name; }
+  ALWAYS_INLINE const std::vector<BlockState>& GetBlockStates() const { return m_block_states; }
+  ALWAYS_INLINE const std::vector<u8>& GetBlockRAM() const { return m_block_ram; }
+
+  bool Initialize() override;
+  void Shutdown() override;
+
+  void ReportError(const char* message) override;
+  void ReportMessage(const char* message) override;
+  bool ConfirmMessage(const char* message) override;
+  void AddOSDMessage(std::string message, float duration = 2.0f) override;
+
+  std::string GetStringSettingValue(const char* section, const char* key, const char* default_value = "") override;
+
+  /// Boots the system with the specified execution mode, which must go through the code cache, and hooks block
+  /// execution.
+  bool Boot(const std::string& bios_path, const std::string& filename, CPUExecutionMode execution_mode);
+
+  /// Runs one frame, replacing the block states with those from this frame. The state at the start of the frame is
+  /// saved so that the frame can be replayed.
+  bool RunFrame();
+
+  /// Loads the state from the start of the last frame and runs it again, copying RAM after the specified block.
+  bool ReplayFrame(size_t ram_block_index);
+
+  /// Computes a hash of the contents of RAM.
+  std::array<u8, 16> GetRAMHash() const;
+
+protected:
+  bool AcquireHostDisplay() override;
+  void ReleaseHostDisplay() override;
+  std::unique_ptr<AudioStream> CreateAudioStream(AudioBackend backend) override;
+
+private:
+  void OnBlockExecuted(const CPU::CodeBlock& block);
+
+  std::string m_name;
+  std::vector<BlockState> m_block_states;
+
+  std::unique_ptr<GrowableMemoryByteStream> m_frame_state;
+  std::vector<u8> m_block_ram;
+  size_t m_ram_block_index = SIZE_MAX;
+};
@@ -0,0 +1,222 @@
+#include "common/log.h"
+#include "core/settings.h"
+#include "core/system.h"
+#include "lockstep_host_interface.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+static const char* s_register_names[35] = {"zero", "at", "v0", "v1", "a0", "a1", "a2", "a3", "t0", "t1", "t2", "t3",
+                                           "t4",   "t5", "t6", "t7", "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7",
+                                           "t8",   "t9", "k0", "k1", "gp", "sp", "fp", "ra", "hi", "lo", "pc"};
+
+static void PrintUsage(const char* progname)
+{
+  std::fprintf(stderr,
+               "Usage: %s -bios <path> [-frames <count>] [-reference <mode>] [-test <mode>] [filename]\n"
+               "Runs two instances of the system side by side, and reports the first block where the CPU state "
+               "diverges.\n"
+               "  -bios <path>: BIOS image to boot with.\n"
+               "  -frames <count>: Number of frames to run for, defaults to 3600.\n"
+               "  -reference <mode>: CPU execution mode of the reference instance, defaults to CachedInterpreter.\n"
+               "  -test <mode>: CPU execution mode of the instance being tested, defaults to Recompiler.\n"
+               "  filename: Disc image or PS-EXE to boot, otherwise the BIOS shell is booted.\n"
+               "Registers are compared after every block, including blocks which are linked to or run by the "
+               "dispatcher, and RAM at the end of each frame. If RAM diverges, the frame is replayed to find the "
+               "first block after which it differs. Both modes must go through the code cache, i.e. the Interpreter "
+               "mode can't be used, as it doesn't execute in blocks.\n",
+               progname);
+}
+
+static bool CompareBlockStates(u32 frame, const LockstepHostInterface& reference, const LockstepHostInterface& test)
+{
+  const auto& ref_states = reference.GetBlockStates();
+  const auto& test_states = test.GetBlockStates();
+
+  const size_t count = std::min(ref_states.size(), test_states.size());
+  for (size_t i = 0; i < count; i++)
+  {
+    const LockstepHostInterface::BlockState& rs = ref_states[i];
+    const LockstepHostInterface::BlockState& ts = test_states[i];
+    if (rs.block_pc == ts.block_pc && rs.tick == ts.tick && rs.regs == ts.regs)
+      continue;
+
+    std::fprintf(stderr, "Frame %u, block %zu: state diverged after executing block at 0x%08X", frame, i, rs.block_pc);
+    if (i > 0)
+      std::fprintf(stderr, " (previous block 0x%08X)", ref_states[i - 1].block_pc);
+    std::fprintf(stderr, "\n");
+
+    if (rs.block_pc != ts.block_pc)
+      std::fprintf(stderr, "  block pc: %s=0x%08X %s=0x%08X\n", reference.GetName().c_str(), rs.block_pc,
+                   test.GetName().c_str(), ts.block_pc);
+    if (rs.tick != ts.tick)
+      std::fprintf(stderr, "  tick: %s=%u %s=%u\n", reference.GetName().c_str(), rs.tick, test.GetName().c_str(),
+                   ts.tick);
+
+    for (u32 reg = 0; reg < static_cast<u32>(rs.regs.size()); reg++)
+    {
+      if (rs.regs[reg] != ts.regs[reg])
+      {
+        std::fprintf(stderr, "  %s: %s=0x%08X %s=0x%08X\n", s_register_names[reg], reference.GetName().c_str(),
+                     rs.regs[reg], test.GetName().c_str(), ts.regs[reg]);
+      }
+    }
+
+    return false;
+  }
+
+  if (ref_states.size() != test_states.size())
+  {
+    std::fprintf(stderr, "Frame %u: %s executed %zu blocks, %s executed %zu blocks\n", frame,
+                 reference.GetName().c_str(), ref_states.size(), test.GetName().c_str(), test_states.size());
+    return false;
+  }
+
+  return true;
+}
+
+/// Replays the frame in both instances, bisecting over the blocks to find the first one after which RAM differs. The
+/// registers matched after every block, so the block indices line up.
+static void FindRAMDivergence(u32 frame, LockstepHostInterface& reference, LockstepHostInterface& test)
+{
+  const size_t num_blocks = reference.GetBlockStates().size();
+  std::vector<LockstepHostInterface::BlockState> block_states = reference.GetBlockStates();
+
+  // RAM is known to match before the first block, and to differ after the last
+  size_t low = 0;
+  size_t high = num_blocks;
+  while (low < high)
+  {
+    const size_t mid = low + (high - low) / 2;
+    if (!reference.ReplayFrame(mid) || !test.ReplayFrame(mid))
+      return;
+
+    if (reference.GetBlockRAM() != test.GetBlockRAM())
+      high = mid;
+    else
+      low = mid + 1;
+  }
+
+  if (low == num_blocks)
+  {
+    std::fprintf(stderr, "  RAM matched after every block, so it changed after the last block of the frame\n");
+    return;
+  }
+
+  // copy RAM after the block we found, in case the last replay was for a different one
+  if (!reference.ReplayFrame(low) || !test.ReplayFrame(low))
+    return;
+
+  const std::vector<u8>& ref_ram = reference.GetBlockRAM();
+  const std::vector<u8>& test_ram = test.GetBlockRAM();
+  const size_t address = static_cast<size_t>(
+    std::mismatch(ref_ram.begin(), ref_ram.end(), test_ram.begin()).first - ref_ram.begin());
+  std::fprintf(stderr, "Frame %u, block %zu: RAM diverged after executing block at 0x%08X", frame, low,
+               block_states[low].block_pc);
+  if (low > 0)
+    std::fprintf(stderr, " (previous block 0x%08X)", block_states[low - 1].block_pc);
+  std::fprintf(stderr, "\n  first difference at 0x%08zX: %s=0x%02X %s=0x%02X\n", address, reference.GetName().c_str(),
+               ref_ram[address], test.GetName().c_str(), test_ram[address]);
+}
+
+int main(int argc, char* argv[])
+{
+  std::string bios_path;
+  std::string filename;
+  u32 num_frames = 3600;
+  CPUExecutionMode reference_mode = CPUExecutionMode::CachedInterpreter;
+  CPUExecutionMode test_mode = CPUExecutionMode::Recompiler;
+
+  for (int i = 1; i < argc; i++)
+  {
+    const bool has_value = (i + 1) < argc;
+    if (std::strcmp(argv[i], "-bios") == 0 && has_value)
+    {
+      bios_path = argv[++i];
+    }
+    else if (std::strcmp(argv[i], "-frames") == 0 && has_value)
+    {
+      num_frames = static_cast<u32>(std::strtoul(argv[++i], nullptr, 10));
+    }
+    else if ((std::strcmp(argv[i], "-reference") == 0 || std::strcmp(argv[i], "-test") == 0) && has_value)
+    {
+      const bool is_reference = (argv[i][1] == 'r');
+      std::optional<CPUExecutionMode> mode = Settings::ParseCPUExecutionMode(argv[++i]);
+      if (!mode)
+      {
+        std::fprintf(stderr, "Unknown CPU execution mode '%s'\n", argv[i]);
+        return EXIT_FAILURE;
+      }
+
+      if (*mode == CPUExecutionMode::Interpreter)
+      {
+        std::fprintf(stderr, "The interpreter doesn't execute in blocks, so it can't be compared block by block\n");
+        return EXIT_FAILURE;
+      }
+
+      (is_reference ? reference_mode : test_mode) = *mode;
+    }
+    else if (argv[i][0] != '-' && filename.empty())
+    {
+      filename = argv[i];
+    }
+    else
+    {
+      PrintUsage(argv[0]);
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (bios_path.empty())
+  {
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_WARNING);
+
+  std::unique_ptr<LockstepHostInterface> reference =
+    std::make_unique<LockstepHostInterface>(Settings::GetCPUExecutionModeName(reference_mode));
+  std::unique_ptr<LockstepHostInterface> test =
+    std::make_unique<LockstepHostInterface>(Settings::GetCPUExecutionModeName(test_mode));
+  if (!reference->Initialize() || !test->Initialize() || !reference->Boot(bios_path, filename, reference_mode) ||
+      !test->Boot(bios_path, filename, test_mode))
+  {
+    std::fprintf(stderr, "Failed to boot system\n");
+    return EXIT_FAILURE;
+  }
+
+  int result = EXIT_SUCCESS;
+  for (u32 frame = 0; frame < num_frames; frame++)
+  {
+    if (!reference->RunFrame() || !test->RunFrame())
+    {
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    if (!CompareBlockStates(frame, *reference, *test))
+    {
+      result = EXIT_FAILURE;
+      break;
+    }
+
+    if (reference->GetRAMHash() != test->GetRAMHash())
+    {
+      std::fprintf(stderr, "Frame %u: RAM contents diverged\n", frame);
+      FindRAMDivergence(frame, *reference, *test);
+      result = EXIT_FAILURE;
+      break;
+    }
+  }
+
+  if (result == EXIT_SUCCESS)
+    std::fprintf(stderr, "No divergence after %u frames\n", num_frames);
+
+  test->Shutdown();
+  reference->Shutdown();
+  return result;
+}
@@ -20,6 +20,12 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
                                                &Settings::ParseRendererName, &Settings::GetRendererName,
                                                Settings::DEFAULT_GPU_RENDERER);
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.useDebugDevice, "GPU", "UseDebugDevice");
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.useThread, "GPU", "UseThread", false);
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.renderThreads, "GPU", "RenderThreads", 1);
+  SettingWidgetBinder::BindWidgetToIntSetting(m_host_interface, m_ui.softwareResolutionScale, "GPU",
+                                              "SoftwareResolutionScale", 1);
+  SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.computeVRAMTransfers, "GPU",
+                                               "ComputeVRAMTransfers", false);
   SettingWidgetBinder::BindWidgetToEnumSetting(m_host_interface, m_ui.displayAspectRatio, "Display", "AspectRatio",
                                                &Settings::ParseDisplayAspectRatio, &Settings::GetDisplayAspectRatioName,
                                                Settings::DEFAULT_DISPLAY_ASPECT_RATIO);
@@ -59,6 +65,22 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
   dialog->registerWidgetHelp(m_ui.useDebugDevice, "Use Debug Device", "Unchecked",
                              "Enables the usage of debug devices and shaders for rendering APIs which support them. "
                              "Should only be used when debugging the emulator.");
+  dialog->registerWidgetHelp(m_ui.useThread, "Use GPU Thread", "Unchecked",
+                             "Runs rasterization for the software renderer, or the rendering API calls for the "
+                             "OpenGL and Vulkan renderers, on a separate thread, so that the CPU thread only has to decode "
+                             "GPU commands. Improves performance on multi-core systems.");
+  dialog->registerWidgetHelp(m_ui.renderThreads, "Render Threads", "1",
+                             "Number of threads the software renderer splits rasterization between when the software "
+                             "renderer thread is enabled. Primitives are divided into bands of scanlines, so higher "
+                             "values help the most in games which draw large primitives.");
+  dialog->registerWidgetHelp(m_ui.softwareResolutionScale, "Software Resolution Scale", "1x",
+                             "Renders at a multiple of the console's resolution when using the software renderer. The "
+                             "game still sees native resolution VRAM, so this is compatible with all games, but each "
+                             "step increases the rendering cost considerably. Works best with multiple render threads.");
+  dialog->registerWidgetHelp(m_ui.computeVRAMTransfers, "Compute Shader VRAM Transfers", "Unchecked",
+                             "Performs VRAM writes, copies and fills with compute shaders in the Vulkan renderer, "
+                             "batching runs of small uploads such as FMV frames into a single dispatch instead of "
+                             "drawing each one separately. Has no effect in the other renderers.");
   dialog->registerWidgetHelp(m_ui.displayAspectRatio, "Aspect Ratio", "4:3",
                              "Changes the aspect ratio used to display the console's output to the screen. The default "
                              "is 4:3 which matches a typical TV of the era.");
@@ -98,7 +120,7 @@ GPUSettingsWidget::GPUSettingsWidget(QtHostInterface* host_interface, QWidget* p
   dialog->registerWidgetHelp(
     m_ui.scaledDithering, "Scaled Dithering (scale dither pattern to resolution)", "Checked",
     "Scales the dither pattern to the resolution scale of the emulated GPU. This makes the dither pattern much less "
-    "obvious at higher resolutions. Usually safe to enable, and only supported by the hardware renderers.");
+    "obvious at higher resolutions. Usually safe to enable.");
   dialog->registerWidgetHelp(
     m_ui.forceNTSCTimings, "Force NTSC Timings (60hz-on-PAL)", "Unchecked",
     "Uses NTSC frame timings when the console is in PAL mode, forcing PAL games to run at 60hz. For most games which "
@@ -626,6 +626,12 @@ void MainWindow::connectSignals()
     else
       m_host_interface->stopDumpingAudio();
   });
+  connect(m_ui.actionDumpGPU, &QAction::toggled, [this](bool checked) {
+    if (checked)
+      m_host_interface->startDumpingGPU();
+    else
+      m_host_interface->stopDumpingGPU();
+  });
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowVRAM, "Debug", "ShowVRAM");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowGPUState, "Debug", "ShowGPUState");
   SettingWidgetBinder::BindWidgetToBoolSetting(m_host_interface, m_ui.actionDebugShowCDROMState, "Debug",
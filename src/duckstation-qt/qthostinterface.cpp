@@ -378,11 +378,17 @@ void QtHostInterface::onHostDisplayWindowResized(int width, int height)
   if (!m_display)
     return;
 
-  m_display->ResizeRenderWindow(width, height);
+  // the GPU may be rendering on its own thread
+  if (!m_system)
+  {
+    m_display->ResizeRenderWindow(width, height);
+    return;
+  }
+
+  m_system->GetGPU()->ResizeDisplayWindow(width, height);
 
   // re-render the display, since otherwise it will be out of date and stretched if paused
-  if (m_system)
-    renderDisplay();
+  renderDisplay();
 }
 
 void QtHostInterface::redrawDisplayWindow()
@@ -487,6 +493,10 @@ void QtHostInterface::updateDisplayState()
   if (!m_display)
     return;
 
+  // the GPU may be rendering on its own thread, so take the context back first
+  if (m_system)
+    m_system->GetGPU()->ResetGraphicsAPIState();
+
   // this expects the context to get moved back to us afterwards
   m_display->DoneRenderContextCurrent();
 
@@ -495,6 +505,9 @@ void QtHostInterface::updateDisplayState()
     Panic("Failed to make device context current after updating");
 
   connectDisplaySignals(display_widget);
+  if (m_system)
+    m_system->GetGPU()->RestoreGraphicsAPIState();
+
   redrawDisplayWindow();
   UpdateSpeedLimiterState();
 }
@@ -937,6 +950,28 @@ void QtHostInterface::stopDumpingAudio()
   StopDumpingAudio();
 }
 
+void QtHostInterface::startDumpingGPU()
+{
+  if (!isOnWorkerThread())
+  {
+    QMetaObject::invokeMethod(this, "startDumpingGPU");
+    return;
+  }
+
+  StartDumpingGPU();
+}
+
+void QtHostInterface::stopDumpingGPU()
+{
+  if (!isOnWorkerThread())
+  {
+    QMetaObject::invokeMethod(this, "stopDumpingGPU");
+    return;
+  }
+
+  StopDumpingGPU();
+}
+
 void QtHostInterface::saveScreenshot()
 {
   if (!isOnWorkerThread())
@@ -1053,14 +1088,10 @@ void QtHostInterface::threadEntryPoint()
 
 void QtHostInterface::renderDisplay()
 {
-  m_system->GetGPU()->ResetGraphicsAPIState();
-
   DrawImGuiWindows();
 
-  m_display->Render();
+  m_system->GetGPU()->PresentDisplay();
   ImGui::NewFrame();
-
-  m_system->GetGPU()->RestoreGraphicsAPIState();
 }
 
 void QtHostInterface::wakeThread()
@@ -139,6 +139,8 @@ public Q_SLOTS:
   void setAudioOutputMuted(bool muted);
   void startDumpingAudio();
   void stopDumpingAudio();
+  void startDumpingGPU();
+  void stopDumpingGPU();
   void saveScreenshot();
   void redrawDisplayWindow();
   void toggleFullscreen();
@@ -204,6 +204,15 @@ void SDLHostInterface::UpdateFramebufferScale()
   ImGui::GetIO().DisplayFramebufferScale.y = framebuffer_scale;
 }
 
+void SDLHostInterface::ResizeRenderWindow(s32 new_window_width, s32 new_window_height)
+{
+  // the GPU may be rendering on its own thread
+  if (m_system)
+    m_system->GetGPU()->ResizeDisplayWindow(new_window_width, new_window_height);
+  else
+    m_display->ResizeRenderWindow(new_window_width, new_window_height);
+}
+
 bool SDLHostInterface::AcquireHostDisplay()
 {
   // Handle renderer switch if required.
@@ -369,7 +378,7 @@ bool SDLHostInterface::SetFullscreen(bool enabled)
 
   int window_width, window_height;
   SDL_GetWindowSize(m_window, &window_width, &window_height);
-  m_display->ResizeRenderWindow(window_width, window_height);
+  ResizeRenderWindow(window_width, window_height);
   m_fullscreen = enabled;
   return true;
 }
@@ -521,7 +530,7 @@ void SDLHostInterface::HandleSDLEvent(const SDL_Event* event)
     {
       if (event->window.event == SDL_WINDOWEVENT_RESIZED)
       {
-        m_display->ResizeRenderWindow(event->window.data1, event->window.data2);
+        ResizeRenderWindow(event->window.data1, event->window.data2);
         UpdateFramebufferScale();
       }
       else if (event->window.event == SDL_WINDOWEVENT_MOVED)
@@ -758,6 +767,12 @@ void SDLHostInterface::DrawMainMenuBar()
 
     if (!m_paused)
     {
+      if (m_settings.cpu_idle_loop_skipping)
+      {
+        ImGui::SetCursorPosX(ImGui::GetIO().DisplaySize.x - (510.0f * framebuffer_scale));
+        ImGui::Text("Idle: %.0f%%", m_system->GetIdleLoopSkipPercent());
+      }
+
       ImGui::SetCursorPosX(ImGui::GetIO().DisplaySize.x - (420.0f * framebuffer_scale));
       ImGui::Text("Average: %.2fms", m_system->GetAverageFrameTime());
 
@@ -876,6 +891,14 @@ void SDLHostInterface::DrawQuickSettingsMenu()
       StopDumpingAudio();
   }
 
+  if (ImGui::MenuItem("Dump GPU Commands", nullptr, IsDumpingGPU(), HasSystem()))
+  {
+    if (!IsDumpingGPU())
+      StartDumpingGPU();
+    else
+      StopDumpingGPU();
+  }
+
   if (ImGui::MenuItem("Save Screenshot"))
     RunLater([this]() { SaveScreenshot(); });
 
@@ -1212,6 +1235,9 @@ void SDLHostInterface::DrawSettingsWindow()
         settings_changed = true;
       }
 
+      settings_changed |= ImGui::Checkbox("Enable Fastmem (Recompiler Only)", &m_settings_copy.cpu_fastmem);
+      settings_changed |= ImGui::Checkbox("Enable Idle Loop Skipping", &m_settings_copy.cpu_idle_loop_skipping);
+
       ImGui::EndTabItem();
     }
 
@@ -1271,7 +1297,31 @@ void SDLHostInterface::DrawSettingsWindow()
           settings_changed = true;
         }
 
+        ImGui::Text("Render Threads:");
+        ImGui::SameLine(indent);
+
+        int render_threads = static_cast<int>(m_settings_copy.gpu_render_threads);
+        if (ImGui::SliderInt("##render_threads", &render_threads, 1, GPU::MAX_RENDER_THREADS))
+        {
+          m_settings_copy.gpu_render_threads = static_cast<u32>(render_threads);
+          settings_changed = true;
+        }
+
+        ImGui::Text("Software Scale:");
+        ImGui::SameLine(indent);
+
+        int software_resolution_scale = static_cast<int>(m_settings_copy.gpu_software_resolution_scale);
+        if (ImGui::SliderInt("##software_resolution_scale", &software_resolution_scale, 1,
+                             GPU::MAX_SOFTWARE_RESOLUTION_SCALE, "%dx"))
+        {
+          m_settings_copy.gpu_software_resolution_scale = static_cast<u32>(software_resolution_scale);
+          settings_changed = true;
+        }
+
         settings_changed |= ImGui::Checkbox("Use Debug Device", &m_settings_copy.gpu_use_debug_device);
+        settings_changed |= ImGui::Checkbox("Use GPU Thread", &m_settings_copy.gpu_use_thread);
+        settings_changed |=
+          ImGui::Checkbox("Compute Shader VRAM Transfers", &m_settings_copy.gpu_compute_vram_transfers);
         settings_changed |= ImGui::Checkbox("Linear Filtering", &m_settings_copy.display_linear_filtering);
         settings_changed |= ImGui::Checkbox("Integer Scaling", &m_settings_copy.display_integer_scaling);
         settings_changed |= ImGui::Checkbox("VSync", &m_settings_copy.video_sync_enabled);
@@ -1506,15 +1556,15 @@ void SDLHostInterface::Run()
       DrawImGuiWindows();
 
       if (m_system)
-        m_system->GetGPU()->ResetGraphicsAPIState();
+        m_system->GetGPU()->PresentDisplay();
+      else
+        m_display->Render();
 
-      m_display->Render();
       ImGui_ImplSDL2_NewFrame(m_window);
       ImGui::NewFrame();
 
       if (m_system)
       {
-        m_system->GetGPU()->RestoreGraphicsAPIState();
         m_system->UpdatePerformanceCounters();
 
         if (m_speed_limiter_enabled)
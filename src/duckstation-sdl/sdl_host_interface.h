@@ -70,6 +70,9 @@ private:
   void CreateImGuiContext();
   void UpdateFramebufferScale();
 
+  /// Resizes the display's swap chain, taking the render context back from the GPU thread while it happens.
+  void ResizeRenderWindow(s32 new_window_width, s32 new_window_height);
+
   /// Executes a callback later, after the UI has finished rendering. Needed to boot while rendering ImGui.
   void RunLater(std::function<void()> callback);
 
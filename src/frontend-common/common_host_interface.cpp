@@ -134,6 +134,7 @@ void CommonHostInterface::InitializeUserDirectory()
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("cache").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump/audio").c_str(), false);
+  result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("dump/gpu").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("inputprofiles").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("savestates").c_str(), false);
   result &= FileSystem::CreateDirectory(GetUserDirectoryRelativePath("screenshots").c_str(), false);
@@ -568,7 +569,10 @@ void CommonHostInterface::UpdateSpeedLimiterState()
   if (audio_sync_enabled)
     m_audio_stream->EmptyBuffers();
 
+  // the GPU may be rendering on its own thread
+  m_system->GetGPU()->ResetGraphicsAPIState();
   m_display->SetVSync(video_sync_enabled);
+  m_system->GetGPU()->RestoreGraphicsAPIState();
 
   if (m_settings.increase_timer_resolution)
     SetTimerResolutionIncreased(m_speed_limiter_enabled);
@@ -1973,6 +1977,54 @@ void CommonHostInterface::StopDumpingAudio()
   AddOSDMessage("Stopped dumping audio.", 5.0f);
 }
 
+bool CommonHostInterface::IsDumpingGPU() const
+{
+  return m_system ? m_system->IsDumpingGPU() : false;
+}
+
+bool CommonHostInterface::StartDumpingGPU(const char* filename)
+{
+  if (!m_system)
+    return false;
+
+  std::string auto_filename;
+  if (!filename)
+  {
+    const auto& code = m_system->GetRunningCode();
+    if (code.empty())
+    {
+      auto_filename =
+        GetUserDirectoryRelativePath("dump/gpu/%s.gpudump", GetTimestampStringForFileName().GetCharArray());
+    }
+    else
+    {
+      auto_filename = GetUserDirectoryRelativePath("dump/gpu/%s_%s.gpudump", code.c_str(),
+                                                   GetTimestampStringForFileName().GetCharArray());
+    }
+
+    filename = auto_filename.c_str();
+  }
+
+  if (m_system->StartDumpingGPU(filename))
+  {
+    AddFormattedOSDMessage(5.0f, "Started dumping GPU commands to '%s'.", filename);
+    return true;
+  }
+  else
+  {
+    AddFormattedOSDMessage(10.0f, "Failed to start dumping GPU commands to '%s'.", filename);
+    return false;
+  }
+}
+
+void CommonHostInterface::StopDumpingGPU()
+{
+  if (!m_system || !m_system->StopDumpingGPU())
+    return;
+
+  AddOSDMessage("Stopped dumping GPU commands.", 5.0f);
+}
+
 bool CommonHostInterface::SaveScreenshot(const char* filename /* = nullptr */, bool full_resolution /* = true */,
                                          bool apply_aspect_ratio /* = true */)
 {
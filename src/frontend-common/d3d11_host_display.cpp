@@ -584,8 +584,7 @@ bool D3D11HostDisplay::Render()
 
 void D3D11HostDisplay::RenderImGui()
 {
-  ImGui::Render();
-  ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
+  ImGui_ImplDX11_RenderDrawData(GetImGuiDrawData());
 }
 
 #endif
@@ -439,8 +439,7 @@ bool OpenGLHostDisplay::Render()
 
 void OpenGLHostDisplay::RenderImGui()
 {
-  ImGui::Render();
-  ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+  ImGui_ImplOpenGL3_RenderDrawData(GetImGuiDrawData());
   GL::Program::ResetLastProgram();
 }
 
@@ -1,6 +1,7 @@
 #include "save_state_selector_ui.h"
 #include "common/log.h"
 #include "common/timestamp.h"
+#include "core/gpu.h"
 #include "core/host_display.h"
 #include "core/system.h"
 #include "icon.h"
@@ -42,7 +43,11 @@ void SaveStateSelectorUI::RefreshList()
 {
   ClearList();
 
-  const System* system = m_host_interface->GetSystem();
+  // screenshot textures are created on the display, which the GPU thread may be using
+  System* system = m_host_interface->GetSystem();
+  if (system)
+    system->GetGPU()->ResetGraphicsAPIState();
+
   if (system && !system->GetRunningCode().empty())
   {
     for (s32 i = 1; i <= CommonHostInterface::GLOBAL_SAVE_STATE_SLOTS; i++)
@@ -74,6 +79,9 @@ void SaveStateSelectorUI::RefreshList()
     m_slots.push_back(std::move(li));
   }
 
+  if (system)
+    system->GetGPU()->RestoreGraphicsAPIState();
+
   if (m_slots.empty() || m_current_selection >= m_slots.size())
     m_current_selection = 0;
 }
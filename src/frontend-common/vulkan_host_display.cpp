@@ -565,8 +565,7 @@ void VulkanHostDisplay::RenderDisplay(s32 left, s32 top, s32 width, s32 height,
 
 void VulkanHostDisplay::RenderImGui()
 {
-  ImGui::Render();
-  ImGui_ImplVulkan_RenderDrawData(ImGui::GetDrawData(), g_vulkan_context->GetCurrentCommandBuffer());
+  ImGui_ImplVulkan_RenderDrawData(GetImGuiDrawData(), g_vulkan_context->GetCurrentCommandBuffer());
 }
 
 void VulkanHostDisplay::RenderSoftwareCursor()